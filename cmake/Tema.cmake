@@ -85,3 +85,53 @@ function(AddTemaTest NAME)
         set_property(GLOBAL PROPERTY TEST_BINARY_FILES "${tmp}")
     endif ()
 endfunction()
+
+# Generates C++ code for the .tema module MODULE at build time, by running the generator TOOL (see
+# src/compiler/codegen_tool.h), in the library NAME linked with LINK. The generated header is included as
+# "generated/NAME.h" and declares its functions in namespace tema::NAMESPACE (NAME by default). Used by the functions
+# below.
+function(AddTemaGeneratedLibrary NAME)
+    cmake_parse_arguments(P "" "MODULE;NAMESPACE;TOOL;COMMENT" "LINK" ${ARGN})
+    if (NOT P_NAMESPACE)
+        set(P_NAMESPACE ${NAME})
+    endif ()
+    get_filename_component(MODULE_PATH ${P_MODULE} ABSOLUTE)
+    set(GENERATED_DIR ${CMAKE_CURRENT_BINARY_DIR}/${NAME}_generated)
+    set(HEADER ${GENERATED_DIR}/generated/${NAME}.h)
+    set(SOURCE ${GENERATED_DIR}/generated/${NAME}.cpp)
+    add_custom_command(
+            OUTPUT ${HEADER} ${SOURCE}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${GENERATED_DIR}/generated
+            COMMAND ${P_TOOL} ${MODULE_PATH} ${P_NAMESPACE} generated/${NAME}.h ${HEADER} ${SOURCE}
+            DEPENDS ${P_TOOL} ${MODULE_PATH}
+            COMMENT "${P_COMMENT}"
+            VERBATIM)
+    add_library(${NAME} STATIC ${SOURCE} ${HEADER})
+    AddTargetCompileFlags(${NAME})
+    target_include_directories(${NAME} PUBLIC ${GENERATED_DIR})
+    target_link_libraries(${NAME} PUBLIC ${P_LINK})
+endfunction()
+
+# Generates C++ code for the laws of a .tema module at build time (see src/compiler/matcher_codegen.h), in the library
+# NAME. The generated header is included as "generated/NAME.h" and declares tema::NAMESPACE::laws().
+function(AddTemaGeneratedMatchers NAME)
+    cmake_parse_arguments(P "" "MODULE;NAMESPACE" "" ${ARGN})
+    AddTemaGeneratedLibrary(${NAME}
+            MODULE ${P_MODULE}
+            NAMESPACE ${P_NAMESPACE}
+            TOOL tema_matcher_codegen
+            COMMENT "Generating the laws of ${P_MODULE}"
+            LINK tema_algorithms)
+endfunction()
+
+# Embeds the image of a .tema module in the library NAME at build time (see src/compiler/module_image.h). The generated
+# header is included as "generated/NAME.h" and declares tema::NAMESPACE::module_image() and tema::NAMESPACE::load().
+function(AddTemaEmbeddedModule NAME)
+    cmake_parse_arguments(P "" "MODULE;NAMESPACE" "" ${ARGN})
+    AddTemaGeneratedLibrary(${NAME}
+            MODULE ${P_MODULE}
+            NAMESPACE ${P_NAMESPACE}
+            TOOL tema_module_embed
+            COMMENT "Embedding the image of ${P_MODULE}"
+            LINK tema_compiler)
+endfunction()
@@ -181,4 +181,15 @@ apply_vars_result apply_vars(const statement_ptr& law, const match_result& repla
     return result;
 }
 
+apply_vars_expr_result apply_vars(const expr_ptr& law, const match_result& replacements) {
+    apply_vars_visitor visitor{replacements};
+    apply_vars_expr_result result;
+    result.expr = law->accept_r<expr_ptr>(visitor);
+    result.unmatched_vars = std::move(visitor.unmatched_vars);
+    if (result.expr == nullptr) {
+        result.expr = law;
+    }
+    return result;
+}
+
 }  // namespace tema
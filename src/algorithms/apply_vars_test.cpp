@@ -256,4 +256,21 @@ TEST_CASE("algorithms.apply_vars") {
                    throwsA<std::runtime_error>);
         });
     });
+
+    test("expressions", [&] {
+        test("replace variables", [&] {
+            const auto law = binop(var_expr(p), binop_type::set_union, call(var_expr(q), {var_expr(p)}));
+            const auto result = apply_vars(law, match_result{{}, {{p, var_expr(r)}}});
+            expect(equals(*result.expr, *binop(var_expr(r), binop_type::set_union, call(var_expr(q), {var_expr(r)}))),
+                   isTrue);
+            expect(result.unmatched_vars, std::set<variable_ptr>{q});
+        });
+
+        test("replace no variables returns the law itself", [&] {
+            const auto law = binop(var_expr(p), binop_type::set_difference, var_expr(q));
+            const auto result = apply_vars(law, match_result{});
+            expect(result.expr == law, isTrue);
+            expect(result.unmatched_vars, std::set<variable_ptr>{p, q});
+        });
+    });
 }
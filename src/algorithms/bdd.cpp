@@ -0,0 +1,437 @@
+#include "algorithms/bdd.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "algorithms/occurs.h"
+
+namespace tema {
+
+namespace {
+
+constexpr std::uint32_t no_node = std::numeric_limits<std::uint32_t>::max();
+constexpr std::uint32_t terminal_level = std::numeric_limits<std::uint32_t>::max();
+constexpr std::uint32_t free_level = terminal_level - 1;
+
+std::size_t hash_triple(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+    constexpr std::size_t multiplier = 0x9E3779B97F4A7C15ULL;
+    std::size_t h = a;
+    h = h * multiplier + b;
+    h = h * multiplier + c;
+    return h ^ (h >> 29U);
+}
+
+bool is_propositional_forall(const statement& stmt) {
+    return stmt.is_forall() && !occurs_as_expression(*stmt.as_forall().inner, stmt.as_forall().var.get());
+}
+
+}  // namespace
+
+bdd_node_limit_exceeded::bdd_node_limit_exceeded(): std::runtime_error("BDD node budget exceeded") {}
+
+bdd::bdd(bdd_manager* manager, std::uint32_t node): manager(manager), node(node) {
+    manager->ref(node);
+}
+
+bdd::bdd(const bdd& other): manager(other.manager), node(other.node) {
+    if (manager != nullptr) {
+        manager->ref(node);
+    }
+}
+
+bdd::bdd(bdd&& other) noexcept: manager(other.manager), node(other.node) {
+    other.manager = nullptr;
+}
+
+bdd& bdd::operator=(const bdd& other) {
+    if (this != &other) {
+        if (other.manager != nullptr) {
+            other.manager->ref(other.node);
+        }
+        if (manager != nullptr) {
+            manager->unref(node);
+        }
+        manager = other.manager;
+        node = other.node;
+    }
+    return *this;
+}
+
+bdd& bdd::operator=(bdd&& other) noexcept {
+    if (this != &other) {
+        if (manager != nullptr) {
+            manager->unref(node);
+        }
+        manager = other.manager;
+        node = other.node;
+        other.manager = nullptr;
+    }
+    return *this;
+}
+
+bdd::~bdd() {
+    if (manager != nullptr) {
+        manager->unref(node);
+    }
+}
+
+bool bdd::is_true() const {
+    return node == bdd_manager::true_id;
+}
+
+bool bdd::is_false() const {
+    return node == bdd_manager::false_id;
+}
+
+std::uint32_t bdd::id() const {
+    return node;
+}
+
+bool bdd::operator==(const bdd& other) const {
+    return manager == other.manager && node == other.node;
+}
+
+bdd_manager::bdd_manager(std::size_t node_budget, std::size_t cache_size)
+    : node_budget(std::max(node_budget, std::size_t{2})), buckets(1024, no_node), free_list(no_node),
+      cache(std::bit_ceil(std::max(cache_size, std::size_t{1})), cache_entry{no_node, 0, 0, 0}) {
+    // Terminals are always alive and never part of the unique table.
+    nodes.push_back(node{terminal_level, false_id, false_id, no_node, 1});
+    nodes.push_back(node{terminal_level, true_id, true_id, no_node, 1});
+    statistics.live_nodes = statistics.peak_nodes = num_live;
+}
+
+void bdd_manager::ref(std::uint32_t id) {
+    nodes[id].refs++;
+}
+
+void bdd_manager::unref(std::uint32_t id) {
+    nodes[id].refs--;
+}
+
+bdd bdd_manager::handle(std::uint32_t id) {
+    return bdd(this, id);
+}
+
+std::uint32_t bdd_manager::make_node(std::uint32_t level, std::uint32_t low, std::uint32_t high) {
+    if (low == high) {
+        return low;
+    }
+    const auto bucket = hash_triple(level, low, high) & (buckets.size() - 1);
+    for (auto id = buckets[bucket]; id != no_node; id = nodes[id].next) {
+        const auto& n = nodes[id];
+        if (n.level == level && n.low == low && n.high == high) {
+            return id;
+        }
+    }
+    if (num_live >= node_budget) {
+        throw bdd_node_limit_exceeded();
+    }
+    std::uint32_t id;
+    if (free_list != no_node) {
+        id = free_list;
+        free_list = nodes[id].next;
+        nodes[id] = node{level, low, high, buckets[bucket], 0};
+    } else {
+        id = static_cast<std::uint32_t>(nodes.size());
+        nodes.push_back(node{level, low, high, buckets[bucket], 0});
+    }
+    buckets[bucket] = id;
+    num_live++;
+    statistics.live_nodes = num_live;
+    statistics.peak_nodes = std::max(statistics.peak_nodes, num_live);
+    if (num_live > buckets.size() * 2) {
+        rehash();
+    }
+    return id;
+}
+
+void bdd_manager::rehash() {
+    std::size_t size = buckets.size();
+    while (num_live > size) {
+        size *= 2;
+    }
+    buckets.assign(size, no_node);
+    for (std::uint32_t id = 2; id < nodes.size(); id++) {
+        auto& n = nodes[id];
+        if (n.level == free_level) {
+            continue;
+        }
+        const auto bucket = hash_triple(n.level, n.low, n.high) & (size - 1);
+        n.next = buckets[bucket];
+        buckets[bucket] = id;
+    }
+}
+
+std::uint32_t bdd_manager::ite_rec(std::uint32_t f, std::uint32_t g, std::uint32_t h) {
+    if (f == true_id || g == h) {
+        return g;
+    }
+    if (f == false_id) {
+        return h;
+    }
+    if (g == true_id && h == false_id) {
+        return f;
+    }
+    if (g == f) {
+        g = true_id;
+    }
+    if (h == f) {
+        h = false_id;
+    }
+
+    auto& slot = cache[hash_triple(f, g, h) & (cache.size() - 1)];
+    if (slot.f == f && slot.g == g && slot.h == h) {
+        statistics.cache_hits++;
+        return slot.result;
+    }
+    statistics.cache_misses++;
+
+    const auto level = std::min({nodes[f].level, nodes[g].level, nodes[h].level});
+    const auto cofactor = [&](std::uint32_t id, bool value) {
+        const auto& n = nodes[id];
+        if (n.level != level) {
+            return id;
+        }
+        return value ? n.high : n.low;
+    };
+    const auto f0 = cofactor(f, false), g0 = cofactor(g, false), h0 = cofactor(h, false);
+    const auto f1 = cofactor(f, true), g1 = cofactor(g, true), h1 = cofactor(h, true);
+    const auto low = ite_rec(f0, g0, h0);
+    const auto high = ite_rec(f1, g1, h1);
+    const auto result = make_node(level, low, high);
+    // The cache vector is never resized, so the slot reference is still valid after the recursive calls.
+    slot = cache_entry{f, g, h, result};
+    return result;
+}
+
+std::uint32_t bdd_manager::restrict_rec(std::uint32_t f,
+                                        std::uint32_t level,
+                                        bool value,
+                                        std::unordered_map<std::uint32_t, std::uint32_t>& memo) {
+    const auto f_level = nodes[f].level;
+    if (f_level > level) {
+        return f;
+    }
+    if (f_level == level) {
+        return value ? nodes[f].high : nodes[f].low;
+    }
+    const auto it = memo.find(f);
+    if (it != memo.end()) {
+        return it->second;
+    }
+    const auto f_low = nodes[f].low, f_high = nodes[f].high;
+    const auto low = restrict_rec(f_low, level, value, memo);
+    const auto high = restrict_rec(f_high, level, value, memo);
+    const auto result = make_node(f_level, low, high);
+    memo.emplace(f, result);
+    return result;
+}
+
+std::uint32_t bdd_manager::level_of(const variable_ptr& var) {
+    const auto [it, inserted] = var_levels.emplace(var.get(), std::pair{var, num_levels});
+    if (inserted) {
+        num_levels++;
+    }
+    return it->second.second;
+}
+
+std::uint32_t bdd_manager::level_of_atom(const statement_ptr& atom) {
+    const auto [it, inserted] = atom_levels.emplace(atom, num_levels);
+    if (inserted) {
+        num_levels++;
+    }
+    return it->second;
+}
+
+std::uint32_t bdd_manager::build_rec(const statement_ptr& stmt) {
+    const auto it = built.find(stmt.get());
+    if (it != built.end()) {
+        return it->second.second;
+    }
+    std::uint32_t result;
+    if (stmt->is_truth()) {
+        result = true_id;
+    } else if (stmt->is_contradiction()) {
+        result = false_id;
+    } else if (stmt->is_var()) {
+        result = make_node(level_of(stmt->as_var()), false_id, true_id);
+    } else if (stmt->is_neg()) {
+        result = ite_rec(build_rec(stmt->as_neg().inner), false_id, true_id);
+    } else if (stmt->is_conj()) {
+        result = true_id;
+        for (const auto& child: stmt->as_conj().inner) {
+            result = ite_rec(result, build_rec(child), false_id);
+        }
+    } else if (stmt->is_disj()) {
+        result = false_id;
+        for (const auto& child: stmt->as_disj().inner) {
+            result = ite_rec(result, true_id, build_rec(child));
+        }
+    } else if (stmt->is_implies()) {
+        const auto from = build_rec(stmt->as_implies().from);
+        result = ite_rec(from, build_rec(stmt->as_implies().to), true_id);
+    } else if (stmt->is_equiv()) {
+        const auto left = build_rec(stmt->as_equiv().left);
+        const auto right = build_rec(stmt->as_equiv().right);
+        result = ite_rec(left, right, ite_rec(right, false_id, true_id));
+    } else if (is_propositional_forall(*stmt)) {
+        const auto level = level_of(stmt->as_forall().var);
+        const auto inner = build_rec(stmt->as_forall().inner);
+        std::unordered_map<std::uint32_t, std::uint32_t> memo0, memo1;
+        const auto when_false = restrict_rec(inner, level, false, memo0);
+        result = ite_rec(when_false, restrict_rec(inner, level, true, memo1), false_id);
+    } else {
+        result = make_node(level_of_atom(stmt), false_id, true_id);
+    }
+    built.emplace(stmt.get(), std::pair{stmt, result});
+    return result;
+}
+
+void bdd_manager::order_rec(const statement_ptr& stmt) {
+    if (stmt->is_var()) {
+        (void)level_of(stmt->as_var());
+    } else if (stmt->is_neg()) {
+        order_rec(stmt->as_neg().inner);
+    } else if (stmt->is_conj() || stmt->is_disj()) {
+        for (const auto& child: stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner) {
+            order_rec(child);
+        }
+    } else if (stmt->is_implies()) {
+        order_rec(stmt->as_implies().from);
+        order_rec(stmt->as_implies().to);
+    } else if (stmt->is_equiv()) {
+        order_rec(stmt->as_equiv().left);
+        order_rec(stmt->as_equiv().right);
+    } else if (is_propositional_forall(*stmt)) {
+        order_rec(stmt->as_forall().inner);
+    } else if (stmt->is_rel() || stmt->is_forall()) {
+        (void)level_of_atom(stmt);
+    }
+}
+
+template<class F>
+std::uint32_t bdd_manager::run_operation(F&& operation) {
+    if (num_live * 4 > node_budget * 3) {
+        collect_garbage();
+    }
+    try {
+        return operation();
+    } catch (const bdd_node_limit_exceeded&) {
+        // Whatever the failed attempt created is unreferenced, so collecting it may free enough room for a retry.
+        collect_garbage();
+        return operation();
+    }
+}
+
+void bdd_manager::order_variables(const std::vector<statement_ptr>& stmts) {
+    for (const auto& stmt: stmts) {
+        order_rec(stmt);
+    }
+}
+
+bdd bdd_manager::make_true() {
+    return handle(true_id);
+}
+
+bdd bdd_manager::make_false() {
+    return handle(false_id);
+}
+
+bdd bdd_manager::make_var(const variable_ptr& var) {
+    return handle(run_operation([&] {
+        return make_node(level_of(var), false_id, true_id);
+    }));
+}
+
+bdd bdd_manager::ite(const bdd& f, const bdd& g, const bdd& h) {
+    return handle(run_operation([&] {
+        return ite_rec(f.node, g.node, h.node);
+    }));
+}
+
+bdd bdd_manager::negate(const bdd& f) {
+    return handle(run_operation([&] {
+        return ite_rec(f.node, false_id, true_id);
+    }));
+}
+
+bdd bdd_manager::conj(const bdd& f, const bdd& g) {
+    return handle(run_operation([&] {
+        return ite_rec(f.node, g.node, false_id);
+    }));
+}
+
+bdd bdd_manager::disj(const bdd& f, const bdd& g) {
+    return handle(run_operation([&] {
+        return ite_rec(f.node, true_id, g.node);
+    }));
+}
+
+bdd bdd_manager::equiv(const bdd& f, const bdd& g) {
+    return handle(run_operation([&] {
+        return ite_rec(f.node, g.node, ite_rec(g.node, false_id, true_id));
+    }));
+}
+
+bdd bdd_manager::forall(const variable_ptr& var, const bdd& f) {
+    return handle(run_operation([&] {
+        const auto level = level_of(var);
+        std::unordered_map<std::uint32_t, std::uint32_t> memo0, memo1;
+        const auto when_false = restrict_rec(f.node, level, false, memo0);
+        return ite_rec(when_false, restrict_rec(f.node, level, true, memo1), false_id);
+    }));
+}
+
+bdd bdd_manager::build(const statement_ptr& stmt) {
+    return handle(run_operation([&] {
+        return build_rec(stmt);
+    }));
+}
+
+bool bdd_manager::equivalent(const statement_ptr& a, const statement_ptr& b) {
+    const auto bdd_a = build(a);
+    return build(b) == bdd_a;
+}
+
+void bdd_manager::collect_garbage() {
+    std::vector<bool> marked(nodes.size(), false);
+    std::vector<std::uint32_t> stack;
+    for (std::uint32_t id = 0; id < nodes.size(); id++) {
+        if (nodes[id].level != free_level && nodes[id].refs > 0) {
+            stack.push_back(id);
+        }
+    }
+    while (!stack.empty()) {
+        const auto id = stack.back();
+        stack.pop_back();
+        if (marked[id]) {
+            continue;
+        }
+        marked[id] = true;
+        if (nodes[id].level != terminal_level) {
+            stack.push_back(nodes[id].low);
+            stack.push_back(nodes[id].high);
+        }
+    }
+    for (std::uint32_t id = 2; id < nodes.size(); id++) {
+        auto& n = nodes[id];
+        if (!marked[id] && n.level != free_level) {
+            n.level = free_level;
+            n.next = free_list;
+            free_list = id;
+            num_live--;
+        }
+    }
+    rehash();
+    std::fill(cache.begin(), cache.end(), cache_entry{no_node, 0, 0, 0});
+    built.clear();
+    statistics.live_nodes = num_live;
+    statistics.garbage_collections++;
+}
+
+const bdd_statistics& bdd_manager::stats() const {
+    return statistics;
+}
+
+}  // namespace tema
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "algorithms/hash.h"
+#include "core/statement.h"
+
+namespace tema {
+
+struct bdd_node_limit_exceeded : std::runtime_error {
+    bdd_node_limit_exceeded();
+};
+
+class bdd_manager;
+
+// A handle to a node of a bdd_manager. While a handle exists, its node (and all the nodes reachable from it) are
+// kept alive by the garbage collector. Handles must not outlive their manager.
+//
+// As BDDs in a manager are reduced and share all their nodes, two handles represent equivalent functions if and only
+// if they point to the same node, so comparing them is O(1).
+class bdd {
+    bdd_manager* manager = nullptr;
+    std::uint32_t node = 0;
+
+    friend class bdd_manager;
+
+    bdd(bdd_manager* manager, std::uint32_t node);
+
+public:
+    bdd() = default;
+    bdd(const bdd& other);
+    bdd(bdd&& other) noexcept;
+    bdd& operator=(const bdd& other);
+    bdd& operator=(bdd&& other) noexcept;
+    ~bdd();
+
+    [[nodiscard]] bool is_true() const;
+    [[nodiscard]] bool is_false() const;
+    [[nodiscard]] std::uint32_t id() const;
+
+    bool operator==(const bdd& other) const;
+};
+
+struct bdd_statistics {
+    std::size_t live_nodes = 0;
+    std::size_t peak_nodes = 0;
+    std::size_t garbage_collections = 0;
+    std::size_t cache_hits = 0;
+    std::size_t cache_misses = 0;
+};
+
+// Reduced ordered binary decision diagrams over propositional statements. All BDDs of a manager share one unique
+// table, so structurally equal sub-diagrams are stored once, and operations go through a computed-table cache.
+//
+// Variables (var_stmt) are the BDD variables. Relationships are opaque atoms (equal relationships are the same
+// variable). A forall over a variable used only as a statement is computed by universal quantification, any other
+// forall is an opaque atom.
+//
+// The number of nodes is bounded by a budget. Unreferenced nodes are garbage collected between operations when the
+// manager gets close to the budget, and an operation that needs more nodes than the budget allows throws
+// bdd_node_limit_exceeded.
+class bdd_manager {
+    struct node {
+        std::uint32_t level;
+        std::uint32_t low;
+        std::uint32_t high;
+        std::uint32_t next;  // Next node in the same bucket of the unique table, or in the free list.
+        std::uint32_t refs;  // Number of handles pointing to this node.
+    };
+
+    struct cache_entry {
+        std::uint32_t f;
+        std::uint32_t g;
+        std::uint32_t h;
+        std::uint32_t result;
+    };
+
+    std::size_t node_budget;
+    std::vector<node> nodes;
+    std::vector<std::uint32_t> buckets;
+    std::uint32_t free_list;
+    std::size_t num_live = 2;
+    std::vector<cache_entry> cache;
+    bdd_statistics statistics;
+
+    std::unordered_map<const variable*, std::pair<variable_ptr, std::uint32_t>> var_levels;
+    std::unordered_map<statement_ptr, std::uint32_t, structural_hash, structural_equal> atom_levels;
+    std::uint32_t num_levels = 0;
+    std::unordered_map<const statement*, std::pair<statement_ptr, std::uint32_t>> built;
+
+    friend class bdd;
+
+    void ref(std::uint32_t id);
+    void unref(std::uint32_t id);
+    bdd handle(std::uint32_t id);
+
+    [[nodiscard]] std::uint32_t make_node(std::uint32_t level, std::uint32_t low, std::uint32_t high);
+    [[nodiscard]] std::uint32_t ite_rec(std::uint32_t f, std::uint32_t g, std::uint32_t h);
+    [[nodiscard]] std::uint32_t restrict_rec(std::uint32_t f, std::uint32_t level, bool value, std::unordered_map<std::uint32_t, std::uint32_t>& memo);
+    [[nodiscard]] std::uint32_t build_rec(const statement_ptr& stmt);
+    [[nodiscard]] std::uint32_t level_of(const variable_ptr& var);
+    [[nodiscard]] std::uint32_t level_of_atom(const statement_ptr& atom);
+    void rehash();
+    void order_rec(const statement_ptr& stmt);
+
+    template<class F>
+    std::uint32_t run_operation(F&& operation);
+
+public:
+    static constexpr std::uint32_t false_id = 0;
+    static constexpr std::uint32_t true_id = 1;
+
+    explicit bdd_manager(std::size_t node_budget = std::size_t{1} << 22U, std::size_t cache_size = std::size_t{1} << 16U);
+
+    bdd_manager(const bdd_manager&) = delete;
+    bdd_manager& operator=(const bdd_manager&) = delete;
+    bdd_manager(bdd_manager&&) = delete;
+    bdd_manager& operator=(bdd_manager&&) = delete;
+    ~bdd_manager() = default;
+
+    // Variable ordering heuristic: assigns levels to the not-yet-ordered atoms of the statements, in depth-first
+    // order of their first occurrence. Atoms that appear together in a statement end up close to each other, which
+    // usually keeps BDDs small. Atoms seen for the first time by build are placed after all the others.
+    void order_variables(const std::vector<statement_ptr>& stmts);
+
+    [[nodiscard]] bdd make_true();
+    [[nodiscard]] bdd make_false();
+    [[nodiscard]] bdd make_var(const variable_ptr& var);
+    [[nodiscard]] bdd ite(const bdd& f, const bdd& g, const bdd& h);
+    [[nodiscard]] bdd negate(const bdd& f);
+    [[nodiscard]] bdd conj(const bdd& f, const bdd& g);
+    [[nodiscard]] bdd disj(const bdd& f, const bdd& g);
+    [[nodiscard]] bdd equiv(const bdd& f, const bdd& g);
+    [[nodiscard]] bdd forall(const variable_ptr& var, const bdd& f);
+
+    [[nodiscard]] bdd build(const statement_ptr& stmt);
+
+    // Whether the two statements are equivalent, i.e. a⟷b is valid.
+    [[nodiscard]] bool equivalent(const statement_ptr& a, const statement_ptr& b);
+
+    void collect_garbage();
+
+    [[nodiscard]] const bdd_statistics& stats() const;
+};
+
+}  // namespace tema
@@ -0,0 +1,169 @@
+#include "algorithms/bdd.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+void expect_equivalent(bdd_manager& manager,
+                       const statement_ptr& a,
+                       const statement_ptr& b,
+                       Context context = Context()) {
+    expectMsg(manager.equivalent(a, b), print_utf8(*a) + " is not equivalent to " + print_utf8(*b), std::move(context));
+}
+
+void expect_not_equivalent(bdd_manager& manager,
+                           const statement_ptr& a,
+                           const statement_ptr& b,
+                           Context context = Context()) {
+    expectMsg(!manager.equivalent(a, b), print_utf8(*a) + " is equivalent to " + print_utf8(*b), std::move(context));
+}
+
+statement_ptr chain_of_equivalences(const std::vector<statement_ptr>& atoms) {
+    auto result = atoms[0];
+    for (std::size_t i = 1; i < atoms.size(); i++) {
+        result = equiv(result, atoms[i]);
+    }
+    return result;
+}
+
+TEST_CASE("algorithms.bdd") {
+    const auto p = var("p");
+    const auto q = var("q");
+    const auto r = var("r");
+    const auto vp = var_stmt(p);
+    const auto vq = var_stmt(q);
+    const auto vr = var_stmt(r);
+
+    test("terminals", [&] {
+        bdd_manager manager;
+        expect(manager.build(truth()).is_true(), isTrue);
+        expect(manager.build(contradiction()).is_false(), isTrue);
+        expect(manager.build(disj(vp, neg(vp))).is_true(), isTrue);
+        expect(manager.build(conj(vp, neg(vp))).is_false(), isTrue);
+        expect(manager.build(vp).is_true(), isFalse);
+    });
+
+    test("equivalent statements share the same node", [&] {
+        bdd_manager manager;
+        expect_equivalent(manager, neg(conj(vp, vq)), disj(neg(vp), neg(vq)));
+        expect_equivalent(manager, disj(vp, conj(vq, vr)), conj(disj(vp, vq), disj(vp, vr)));
+        expect_equivalent(manager, implies(vp, vq), implies(neg(vq), neg(vp)));
+        expect_equivalent(manager, implies(vp, implies(vq, vr)), implies(conj(vp, vq), vr));
+        expect_equivalent(manager, equiv(vp, vq), conj(implies(vp, vq), implies(vq, vp)));
+        expect_not_equivalent(manager, implies(vp, vq), implies(vq, vp));
+        expect_not_equivalent(manager, vp, vq);
+
+        const auto a = manager.build(neg(disj(vp, vq)));
+        const auto b = manager.build(conj(neg(vp), neg(vq)));
+        expect(a == b, isTrue);
+        expect(a.id(), b.id());
+    });
+
+    test("operations on handles", [&] {
+        bdd_manager manager;
+        const auto bp = manager.make_var(p);
+        const auto bq = manager.make_var(q);
+        expect(manager.conj(bp, bq) == manager.build(conj(vp, vq)), isTrue);
+        expect(manager.disj(bp, bq) == manager.build(disj(vp, vq)), isTrue);
+        expect(manager.equiv(bp, bq) == manager.build(equiv(vp, vq)), isTrue);
+        expect(manager.negate(manager.negate(bp)) == bp, isTrue);
+        expect(manager.ite(bp, bq, manager.make_false()) == manager.conj(bp, bq), isTrue);
+        expect(manager.conj(bp, manager.make_true()) == bp, isTrue);
+    });
+
+    test("relationships are atoms", [&] {
+        bdd_manager manager;
+        const auto x = var_expr(var("x"));
+        const auto y = var_expr(var("y"));
+        const auto rel = rel_stmt(x, rel_type::in, y);
+        // A structurally equal, but different, statement is the same atom.
+        expect_equivalent(manager, disj(rel, neg(rel_stmt(x, rel_type::in, y))), truth());
+        expect_not_equivalent(manager, rel, rel_stmt(y, rel_type::in, x));
+    });
+
+    test("universal quantification", [&] {
+        bdd_manager manager;
+        expect(manager.build(forall(p, disj(vp, neg(vp)))).is_true(), isTrue);
+        expect(manager.build(forall(p, vp)).is_false(), isTrue);
+        expect_equivalent(manager, forall(p, disj(vp, vq)), vq);
+        expect_equivalent(manager, forall(p, implies(vp, vq)), vq);
+        expect(manager.forall(p, manager.build(conj(disj(vp, vq), disj(neg(vp), vr)))) ==
+                 manager.build(conj(vq, vr)),
+               isTrue);
+
+        // x is used as an expression, so this forall is an atom.
+        const auto x = var("x");
+        const auto first_order = forall(x, rel_stmt(var_expr(x), rel_type::in, var_expr(x)));
+        const auto bdd_first_order = manager.build(first_order);
+        expect(bdd_first_order.is_true() || bdd_first_order.is_false(), isFalse);
+    });
+
+    test("exceeding the node budget throws", [&] {
+        std::vector<statement_ptr> atoms;
+        for (int i = 0; i < 64; i++) {
+            atoms.push_back(var_stmt(var("a" + std::to_string(i))));
+        }
+        // (a0∧a32)∨(a1∧a33)∨... is exponential in the ordering a0, a1, ..., a63.
+        std::vector<statement_ptr> terms;
+        for (int i = 0; i < 32; i++) {
+            terms.push_back(conj(atoms[static_cast<std::size_t>(i)], atoms[static_cast<std::size_t>(i + 32)]));
+        }
+        bdd_manager manager(4096);
+        manager.order_variables(atoms);
+        expect([&] {
+            (void)manager.build(disj(terms));
+        }, throwsA<bdd_node_limit_exceeded>);
+
+        // With a good ordering, the same function is small.
+        bdd_manager interleaved(4096);
+        std::vector<statement_ptr> order;
+        for (std::size_t i = 0; i < 32; i++) {
+            order.push_back(atoms[i]);
+            order.push_back(atoms[i + 32]);
+        }
+        interleaved.order_variables(order);
+        const auto result = interleaved.build(disj(terms));
+        interleaved.collect_garbage();
+        expect(interleaved.stats().live_nodes, isLessThan(std::size_t{200}));
+        expect(result.is_true(), isFalse);
+    });
+
+    test("garbage collection frees unreferenced nodes", [&] {
+        std::vector<statement_ptr> atoms;
+        for (int i = 0; i < 20; i++) {
+            atoms.push_back(var_stmt(var("a" + std::to_string(i))));
+        }
+        bdd_manager manager;
+        const auto kept = manager.build(conj(vp, vq));
+        manager.collect_garbage();
+        const auto kept_nodes = manager.stats().live_nodes;
+        {
+            const auto parity = manager.build(chain_of_equivalences(atoms));
+            expect(manager.stats().live_nodes, isGreaterThan(kept_nodes));
+        }
+        manager.collect_garbage();
+        expect(manager.stats().live_nodes, kept_nodes);
+        expect(manager.stats().garbage_collections, std::size_t{2});
+        expect(kept == manager.build(conj(vq, vp)), isTrue);
+    });
+
+    test("collection is triggered automatically near the budget", [&] {
+        std::vector<statement_ptr> atoms;
+        for (int i = 0; i < 16; i++) {
+            atoms.push_back(var_stmt(var("a" + std::to_string(i))));
+        }
+        bdd_manager manager(100);
+        for (std::size_t i = 0; i + 8 <= atoms.size(); i++) {
+            const auto parity = manager.build(
+              chain_of_equivalences(std::vector<statement_ptr>(atoms.begin() + static_cast<std::ptrdiff_t>(i),
+                                                               atoms.begin() + static_cast<std::ptrdiff_t>(i + 8))));
+            expect(parity.is_true() || parity.is_false(), isFalse);
+        }
+        expect(manager.stats().garbage_collections, isGreaterThan(std::size_t{0}));
+        expect(manager.stats().peak_nodes, isLessThan(std::size_t{101}));
+    });
+}
@@ -0,0 +1,293 @@
+#include "algorithms/canonical.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace tema {
+
+namespace {
+
+int statement_rank(const statement& stmt) {
+    // The order of the alternatives in statement::types.
+    if (stmt.is_truth()) {
+        return 0;
+    }
+    if (stmt.is_contradiction()) {
+        return 1;
+    }
+    if (stmt.is_implies()) {
+        return 2;
+    }
+    if (stmt.is_equiv()) {
+        return 3;
+    }
+    if (stmt.is_neg()) {
+        return 4;
+    }
+    if (stmt.is_conj()) {
+        return 5;
+    }
+    if (stmt.is_disj()) {
+        return 6;
+    }
+    if (stmt.is_forall()) {
+        return 7;
+    }
+    return stmt.is_var() ? 8 : 9;
+}
+
+int expression_rank(const expression& expr) {
+    if (expr.is_binop()) {
+        return 0;
+    }
+    return expr.is_call() ? 1 : 2;
+}
+
+class comparator {
+    // The variables bound by the forall statements enclosing the nodes being compared, outermost first.
+    std::vector<const variable*> a_bound;
+    std::vector<const variable*> b_bound;
+
+    static std::ptrdiff_t bound_level(const std::vector<const variable*>& bound, const variable* var) {
+        const auto it = std::find(bound.rbegin(), bound.rend(), var);
+        return it == bound.rend() ? -1 : std::distance(it, bound.rend()) - 1;
+    }
+
+    std::strong_ordering compare_vars(const variable* a, const variable* b) const {
+        const auto a_level = bound_level(a_bound, a);
+        const auto b_level = bound_level(b_bound, b);
+        if (a_level >= 0 || b_level >= 0) {
+            if (a_level < 0 || b_level < 0) {
+                // Bound variables are smaller than free variables.
+                return a_level < 0 ? std::strong_ordering::greater : std::strong_ordering::less;
+            }
+            return a_level <=> b_level;
+        }
+        if (a == b) {
+            return std::strong_ordering::equal;
+        }
+        if (const auto by_name = a->name <=> b->name; by_name != 0) {
+            return by_name;
+        }
+        return std::compare_three_way{}(a, b);
+    }
+
+    template<class T>
+    std::strong_ordering compare_lists(const std::vector<std::shared_ptr<const T>>& a,
+                                       const std::vector<std::shared_ptr<const T>>& b) {
+        const auto common = std::min(a.size(), b.size());
+        for (std::size_t i = 0; i < common; i++) {
+            if (const auto result = compare(*a[i], *b[i]); result != 0) {
+                return result;
+            }
+        }
+        return a.size() <=> b.size();
+    }
+
+public:
+    comparator() = default;
+
+    // Compares nodes inside the same forall statements, binding the given variables.
+    explicit comparator(const std::vector<const variable*>& bound)
+        : a_bound(bound), b_bound(bound) {}
+
+    std::strong_ordering compare(const expression& a, const expression& b) {  // NOLINT(misc-no-recursion)
+        if (&a == &b && a_bound == b_bound) {
+            return std::strong_ordering::equal;
+        }
+        if (const auto by_rank = expression_rank(a) <=> expression_rank(b); by_rank != 0) {
+            return by_rank;
+        }
+        if (a.is_binop()) {
+            const auto& [a_type, a_left, a_right] = a.as_binop();
+            const auto& [b_type, b_left, b_right] = b.as_binop();
+            if (const auto by_type = a_type <=> b_type; by_type != 0) {
+                return by_type;
+            }
+            if (const auto by_left = compare(*a_left, *b_left); by_left != 0) {
+                return by_left;
+            }
+            return compare(*a_right, *b_right);
+        }
+        if (a.is_call()) {
+            if (const auto by_callee = compare(*a.as_call().callee, *b.as_call().callee); by_callee != 0) {
+                return by_callee;
+            }
+            return compare_lists(a.as_call().params, b.as_call().params);
+        }
+        return compare_vars(a.as_var().get(), b.as_var().get());
+    }
+
+    std::strong_ordering compare(const statement& a, const statement& b) {  // NOLINT(misc-no-recursion)
+        if (&a == &b && a_bound == b_bound) {
+            return std::strong_ordering::equal;
+        }
+        if (const auto by_rank = statement_rank(a) <=> statement_rank(b); by_rank != 0) {
+            return by_rank;
+        }
+        if (a.is_implies()) {
+            if (const auto by_from = compare(*a.as_implies().from, *b.as_implies().from); by_from != 0) {
+                return by_from;
+            }
+            return compare(*a.as_implies().to, *b.as_implies().to);
+        }
+        if (a.is_equiv()) {
+            if (const auto by_left = compare(*a.as_equiv().left, *b.as_equiv().left); by_left != 0) {
+                return by_left;
+            }
+            return compare(*a.as_equiv().right, *b.as_equiv().right);
+        }
+        if (a.is_neg()) {
+            return compare(*a.as_neg().inner, *b.as_neg().inner);
+        }
+        if (a.is_conj()) {
+            return compare_lists(a.as_conj().inner, b.as_conj().inner);
+        }
+        if (a.is_disj()) {
+            return compare_lists(a.as_disj().inner, b.as_disj().inner);
+        }
+        if (a.is_forall()) {
+            a_bound.push_back(a.as_forall().var.get());
+            b_bound.push_back(b.as_forall().var.get());
+            const auto result = compare(*a.as_forall().inner, *b.as_forall().inner);
+            a_bound.pop_back();
+            b_bound.pop_back();
+            return result;
+        }
+        if (a.is_var()) {
+            return compare_vars(a.as_var().get(), b.as_var().get());
+        }
+        if (a.is_rel()) {
+            const auto& [a_type, a_left, a_right] = a.as_rel();
+            const auto& [b_type, b_left, b_right] = b.as_rel();
+            if (const auto by_type = a_type <=> b_type; by_type != 0) {
+                return by_type;
+            }
+            if (const auto by_left = compare(*a_left, *b_left); by_left != 0) {
+                return by_left;
+            }
+            return compare(*a_right, *b_right);
+        }
+        // truth and contradiction.
+        return std::strong_ordering::equal;
+    }
+};
+
+template<bool is_conj>
+statement_ptr make_canonical(std::vector<statement_ptr> stmts,
+                             const std::vector<const variable*>& bound,
+                             const statement_ptr& original = nullptr) {
+    std::vector<statement_ptr> flat;
+    flat.reserve(stmts.size());
+    for (auto& stmt: stmts) {
+        if (is_conj ? stmt->is_conj() : stmt->is_disj()) {
+            const auto& children = is_conj ? stmt->as_conj().inner : stmt->as_disj().inner;
+            flat.insert(flat.end(), children.begin(), children.end());
+        } else {
+            flat.push_back(std::move(stmt));
+        }
+    }
+    comparator cmp(bound);
+    std::stable_sort(flat.begin(), flat.end(), [&](const statement_ptr& a, const statement_ptr& b) {
+        return cmp.compare(*a, *b) < 0;
+    });
+    flat.erase(std::unique(flat.begin(),
+                           flat.end(),
+                           [&](const statement_ptr& a, const statement_ptr& b) {
+                               return cmp.compare(*a, *b) == 0;
+                           }),
+               flat.end());
+    if (flat.empty()) {
+        return is_conj ? truth() : contradiction();
+    }
+    if (flat.size() == 1) {
+        return flat[0];
+    }
+    if (original != nullptr && (is_conj ? original->as_conj().inner : original->as_disj().inner) == flat) {
+        return original;
+    }
+    return is_conj ? conj(std::move(flat)) : disj(std::move(flat));
+}
+
+class canonicalizer {
+    std::vector<const variable*> bound;
+    // Only used outside of forall statements, where the result does not depend on the enclosing bound variables.
+    std::unordered_map<const statement*, std::pair<statement_ptr, statement_ptr>> memo;
+
+    statement_ptr canonicalize_uncached(const statement_ptr& stmt) {  // NOLINT(misc-no-recursion)
+        const auto canonical_children = [&](const std::vector<statement_ptr>& children) {
+            std::vector<statement_ptr> result;
+            result.reserve(children.size());
+            for (const auto& child: children) {
+                result.push_back(canonicalize(child));
+            }
+            return result;
+        };
+        if (stmt->is_conj()) {
+            return make_canonical<true>(canonical_children(stmt->as_conj().inner), bound, stmt);
+        }
+        if (stmt->is_disj()) {
+            return make_canonical<false>(canonical_children(stmt->as_disj().inner), bound, stmt);
+        }
+        if (stmt->is_neg()) {
+            const auto inner = canonicalize(stmt->as_neg().inner);
+            return inner == stmt->as_neg().inner ? stmt : neg(inner);
+        }
+        if (stmt->is_implies()) {
+            const auto from = canonicalize(stmt->as_implies().from);
+            const auto to = canonicalize(stmt->as_implies().to);
+            return from == stmt->as_implies().from && to == stmt->as_implies().to ? stmt : implies(from, to);
+        }
+        if (stmt->is_equiv()) {
+            const auto left = canonicalize(stmt->as_equiv().left);
+            const auto right = canonicalize(stmt->as_equiv().right);
+            return left == stmt->as_equiv().left && right == stmt->as_equiv().right ? stmt : equiv(left, right);
+        }
+        if (stmt->is_forall()) {
+            const auto& [var, inner] = stmt->as_forall();
+            bound.push_back(var.get());
+            const auto canonical_inner = canonicalize(inner);
+            bound.pop_back();
+            return canonical_inner == inner ? stmt : forall(var, canonical_inner);
+        }
+        return stmt;
+    }
+
+public:
+    statement_ptr canonicalize(const statement_ptr& stmt) {  // NOLINT(misc-no-recursion)
+        if (!bound.empty()) {
+            return canonicalize_uncached(stmt);
+        }
+        const auto it = memo.find(stmt.get());
+        if (it != memo.end()) {
+            return it->second.second;
+        }
+        auto result = canonicalize_uncached(stmt);
+        memo.emplace(stmt.get(), std::pair{stmt, result});
+        return result;
+    }
+};
+
+}  // namespace
+
+std::strong_ordering compare(const expression& a, const expression& b) {
+    return comparator{}.compare(a, b);
+}
+
+std::strong_ordering compare(const statement& a, const statement& b) {
+    return comparator{}.compare(a, b);
+}
+
+statement_ptr canonical_conj(std::vector<statement_ptr> stmts) {
+    return make_canonical<true>(std::move(stmts), {});
+}
+
+statement_ptr canonical_disj(std::vector<statement_ptr> stmts) {
+    return make_canonical<false>(std::move(stmts), {});
+}
+
+statement_ptr canonicalize(const statement_ptr& stmt) {
+    return canonicalizer{}.canonicalize(stmt);
+}
+
+}  // namespace tema
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <compare>
+#include <vector>
+
+#include "core/statement.h"
+
+namespace tema {
+
+// A total structural ordering of statements and expressions, consistent with equals: statements that are equal
+// (including up to renaming of forall-bound variables) compare as equivalent.
+//
+// Nodes are ordered by kind first, then by their children from left to right. Bound variables are ordered by how far
+// out their forall is, and before all free variables. Free variables are ordered by name, and distinct variables with
+// the same name by address (so their order is not the same from one run to the next).
+[[nodiscard]] std::strong_ordering compare(const expression& a, const expression& b);
+[[nodiscard]] std::strong_ordering compare(const statement& a, const statement& b);
+
+// Canonical n-ary conjunction and disjunction: children of the same kind are flattened into the result, the children
+// are sorted by compare and duplicates are removed. A single remaining child is returned as it is, and no children
+// give truth (for conj) or contradiction (for disj).
+//
+// The children are expected to be canonical themselves. Variables bound by forall statements around the children are
+// ordered as free variables.
+[[nodiscard]] statement_ptr canonical_conj(std::vector<statement_ptr> stmts);
+[[nodiscard]] statement_ptr canonical_disj(std::vector<statement_ptr> stmts);
+
+// Rebuilds every conjunction and disjunction of the statement in canonical form, so that statements that are the same
+// up to associativity, commutativity and idempotence of conj and disj become equal. Sub-statements that are already
+// canonical are returned as they are, preserving sharing.
+[[nodiscard]] statement_ptr canonicalize(const statement_ptr& stmt);
+
+}  // namespace tema
@@ -0,0 +1,101 @@
+#include "algorithms/canonical.h"
+
+#include <algorithm>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.canonical") {
+    const auto p = var("p");
+    const auto q = var("q");
+    const auto r = var("r");
+    const auto x = var("x");
+    const auto y = var("y");
+    const auto vp = var_stmt(p);
+    const auto vq = var_stmt(q);
+    const auto vr = var_stmt(r);
+
+    test("compare is consistent with equals", [&] {
+        const std::vector<statement_ptr> stmts{
+                truth(),
+                contradiction(),
+                vp,
+                vq,
+                var_stmt(var("p")),
+                neg(vp),
+                neg(vq),
+                conj(vp, vq),
+                conj(vp, vq, vr),
+                conj(vq, vp),
+                disj(vp, vq),
+                implies(vp, vq),
+                equiv(vp, vq),
+                forall(x, var_stmt(x)),
+                forall(y, var_stmt(y)),
+                forall(x, conj(var_stmt(x), vp)),
+                forall(y, conj(vp, var_stmt(y))),
+                rel_stmt(var_expr(p), rel_type::in, var_expr(q)),
+                rel_stmt(var_expr(p), rel_type::in, binop(var_expr(q), binop_type::set_union, var_expr(r))),
+                rel_stmt(var_expr(p), rel_type::eq, call(var_expr(q), {var_expr(r)})),
+                rel_stmt(var_expr(p), rel_type::eq, call(var_expr(q), {var_expr(r), var_expr(p)})),
+        };
+        for (const auto& a: stmts) {
+            for (const auto& b: stmts) {
+                const auto ab = compare(*a, *b);
+                expectMsg((ab == 0) == equals(*a, *b), print_utf8(*a) + " vs " + print_utf8(*b));
+                expectMsg(ab == (0 <=> compare(*b, *a)), print_utf8(*a) + " vs " + print_utf8(*b));
+                for (const auto& c: stmts) {
+                    if (ab < 0 && compare(*b, *c) < 0) {
+                        expect(compare(*a, *c) < 0, isTrue);
+                    }
+                }
+            }
+        }
+    });
+
+    test("compare", [&] {
+        expect(compare(*vp, *vq) < 0, isTrue);
+        expect(compare(*truth(), *vp) < 0, isTrue);
+        expect(compare(*conj(vp, vq), *conj(vp, vq, vr)) < 0, isTrue);
+        expect(compare(*conj(vp, vr), *conj(vp, vq, vr)) > 0, isTrue);
+        // Bound variables come before free variables.
+        expect(compare(*forall(x, conj(var_stmt(x), vp)), *forall(x, conj(vp, var_stmt(x)))) < 0, isTrue);
+        expect(compare(*var_expr(p), *binop(var_expr(p), binop_type::set_union, var_expr(p))) > 0, isTrue);
+    });
+
+    test("canonical_conj and canonical_disj", [&] {
+        expect(equals(*canonical_conj({vr, vp, vq}), *conj(vp, vq, vr)), isTrue);
+        expect(equals(*canonical_conj({vq, conj(vp, vr), vq}), *conj(vp, vq, vr)), isTrue);
+        expect(equals(*canonical_disj({vq, conj(vp, vr), vq}), *disj(conj(vp, vr), vq)), isTrue);
+        expect(equals(*canonical_disj({vq, vq}), *vq), isTrue);
+        expect(canonical_conj({}), truth());
+        expect(canonical_disj({}), contradiction());
+    });
+
+    test("canonicalize", [&] {
+        const auto a = implies(conj(conj(vq, vp), disj(vr, vq)), neg(disj(vp, disj(vp, vq))));
+        const auto b = implies(conj(disj(vq, vr), conj(vp, vq)), neg(disj(vq, vp)));
+        expect(equals(*a, *b), isFalse);
+        const auto canonical = canonicalize(a);
+        expect(equals(*canonical, *canonicalize(b)), isTrue);
+        expectMsg(equals(*canonical, *implies(conj(disj(vq, vr), vp, vq), neg(disj(vp, vq)))), print_utf8(*canonical));
+
+        const auto already = implies(conj(vp, vq), disj(vp, vr));
+        expect(canonicalize(already) == already, isTrue);
+        expect(canonicalize(canonical) == canonical, isTrue);
+    });
+
+    test("canonicalize inside forall", [&] {
+        // The bound variables are ordered the same way regardless of their names.
+        const auto a = forall(x, forall(y, conj(var_stmt(y), var_stmt(x), vp)));
+        const auto b = forall(y, forall(x, conj(vp, var_stmt(y), var_stmt(x))));
+        expect(equals(*a, *b), isFalse);
+        expect(equals(*canonicalize(a), *canonicalize(b)), isTrue);
+    });
+}
@@ -0,0 +1,379 @@
+#include "algorithms/completion.h"
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+#include "algorithms/print_utf8.h"
+
+namespace tema {
+
+namespace {
+
+// Calls f(position, sub_term) for every non-variable sub-term of term, the root included.
+template<class F>
+void for_each_position(const term_bank& bank, term_id term, std::vector<std::uint32_t>& position, F&& f) {
+    if (bank.is_variable(term)) {
+        return;
+    }
+    f(position, term);
+    const auto args = bank.args(term);
+    for (std::uint32_t i = 0; i < args.size(); i++) {
+        position.push_back(i);
+        for_each_position(bank, args[i], position, f);
+        position.pop_back();
+    }
+}
+
+}  // namespace
+
+not_an_equation::not_an_equation(): std::runtime_error("Only equiv laws and = laws can be completed") {}
+
+bool rewrite_system::pending_equation::operator>(const pending_equation& other) const {
+    return std::tie(size, sequence) > std::tie(other.size, other.sequence);
+}
+
+rewrite_system::rewrite_system(const module& mod, const completion_options& options): options(options) {
+    for (const auto& decl: mod.get_decls()) {
+        if (!holds_alternative<stmt_decl>(decl)) {
+            continue;
+        }
+        const auto& law = get<stmt_decl>(decl);
+        if (law.stmt->is_equiv() || (law.stmt->is_rel() && law.stmt->as_rel().type == rel_type::eq)) {
+            add_law_equation(law.stmt, law.name);
+        }
+    }
+    run_completion();
+}
+
+rewrite_system::rewrite_system(const std::vector<statement_ptr>& laws, const completion_options& options)
+    : options(options) {
+    for (const auto& law: laws) {
+        add_law_equation(law, print_utf8(*law));
+    }
+    run_completion();
+}
+
+void rewrite_system::add_law_equation(const statement_ptr& law, std::string name) {
+    const auto name_index = static_cast<std::uint32_t>(names.size());
+    if (law->is_equiv()) {
+        const auto& [left, right] = law->as_equiv();
+        push(equation{bank.from_statement(*left, true), bank.from_statement(*right, true), name_index});
+    } else if (law->is_rel() && law->as_rel().type == rel_type::eq) {
+        const auto& rel = law->as_rel();
+        push(equation{bank.from_expression(*rel.left, true), bank.from_expression(*rel.right, true), name_index});
+    } else {
+        throw not_an_equation();
+    }
+    names.push_back(std::move(name));
+}
+
+void rewrite_system::push(equation eq) {
+    queue.push_back(pending_equation{bank.size(eq.lhs) + bank.size(eq.rhs), next_sequence++, eq});
+    std::push_heap(queue.begin(), queue.end(), std::greater<>{});
+}
+
+void rewrite_system::run_completion() {
+    std::size_t steps = 0;
+    while (!queue.empty()) {
+        if (steps == options.max_steps || num_alive > options.max_rules) {
+            return;
+        }
+        steps++;
+        std::pop_heap(queue.begin(), queue.end(), std::greater<>{});
+        auto eq = queue.back().eq;
+        queue.pop_back();
+
+        term_id sides[] = {normalize_term(eq.lhs), normalize_term(eq.rhs)};
+        if (sides[0] == sides[1]) {
+            continue;
+        }
+        const auto num_vars = bank.rename_to_pool(sides);
+        if (eq.name == derived_name) {
+            eq.name = static_cast<std::uint32_t>(names.size());
+            names.push_back("Critical pair " + std::to_string(names.size()));
+        }
+
+        std::vector<std::uint32_t> added;
+        if (term_greater(bank, options.order, sides[0], sides[1])) {
+            added.push_back(add_rule(sides[0], sides[1], false, eq.name, num_vars));
+        } else if (term_greater(bank, options.order, sides[1], sides[0])) {
+            added.push_back(add_rule(sides[1], sides[0], false, eq.name, num_vars));
+        } else if (!is_subsumed(sides[0], sides[1])) {
+            added.push_back(add_rule(sides[0], sides[1], true, eq.name, num_vars));
+            added.push_back(add_rule(sides[1], sides[0], true, eq.name, num_vars));
+            rule_list[added[0]].partner = added[1];
+            rule_list[added[1]].partner = added[0];
+        }
+        normal_forms.clear();
+        for (const auto index: added) {
+            index_rule(index);
+            add_critical_pairs(index);
+        }
+        for (const auto index: added) {
+            if (rule_list[index].alive) {
+                interreduce(index);
+            }
+        }
+        normal_forms.clear();
+    }
+    is_complete = true;
+}
+
+std::uint32_t rewrite_system::add_rule(term_id lhs,
+                                       term_id rhs,
+                                       bool ordered,
+                                       std::uint32_t name,
+                                       std::pair<std::size_t, std::size_t> num_vars) {
+    const auto index = static_cast<std::uint32_t>(rule_list.size());
+    rule_list.push_back(rule{lhs, rhs, name, ordered, true, index, num_vars.first, num_vars.second});
+    num_alive++;
+    return index;
+}
+
+void rewrite_system::remove_rule(std::uint32_t index) {
+    auto& r = rule_list[index];
+    if (!r.alive) {
+        return;
+    }
+    r.alive = false;
+    num_alive--;
+    if (r.ordered) {
+        remove_rule(r.partner);
+    }
+}
+
+void rewrite_system::index_rule(std::uint32_t index) {
+    const auto lhs = rule_list[index].lhs;
+    root_index[bank.symbol(lhs)].push_back(index);
+    std::vector<std::uint32_t> position;
+    for_each_position(bank, lhs, position, [&](const std::vector<std::uint32_t>& pos, term_id sub) {
+        if (!pos.empty()) {
+            subterm_index[bank.symbol(sub)].emplace_back(index, pos);
+        }
+    });
+}
+
+// Removes the rules whose left side the new rule can rewrite (turning them back into equations to process), and
+// normalizes the right sides of the others.
+void rewrite_system::interreduce(std::uint32_t index) {
+    const auto& new_rule = rule_list[index];
+    for (std::uint32_t i = 0; i < rule_list.size(); i++) {
+        if (i == index || !rule_list[i].alive || (new_rule.ordered && i == new_rule.partner)) {
+            continue;
+        }
+        if (is_reducible_by(rule_list[i].lhs, new_rule)) {
+            const auto& r = rule_list[i];
+            push(equation{r.lhs, r.rhs, r.name});
+            remove_rule(i);
+            normal_forms.clear();
+        } else if (!rule_list[i].ordered) {
+            const auto rhs = normalize_term(rule_list[i].rhs);
+            rule_list[i].rhs = rhs;
+        }
+    }
+}
+
+void rewrite_system::add_critical_pairs(std::uint32_t index) {
+    const auto lhs = rule_list[index].lhs;
+    // Other rules (or this one) applying to a sub-term of this rule's left side.
+    std::vector<std::uint32_t> position;
+    std::vector<std::pair<std::vector<std::uint32_t>, term_id>> sub_terms;
+    for_each_position(bank, lhs, position, [&](const std::vector<std::uint32_t>& pos, term_id sub) {
+        sub_terms.emplace_back(pos, sub);
+    });
+    for (const auto& [pos, sub]: sub_terms) {
+        const auto it = root_index.find(bank.symbol(sub));
+        if (it == root_index.end()) {
+            continue;
+        }
+        for (const auto other: it->second) {
+            if (rule_list[other].alive) {
+                add_critical_pair(index, pos, other);
+            }
+        }
+    }
+    // This rule applying to a sub-term of other rules' left sides.
+    const auto it = subterm_index.find(bank.symbol(lhs));
+    if (it != subterm_index.end()) {
+        for (const auto& [other, pos]: it->second) {
+            if (other != index && rule_list[other].alive) {
+                add_critical_pair(other, pos, index);
+            }
+        }
+    }
+}
+
+// The critical pair of the inner rule applied at the position of the outer rule's left side.
+void rewrite_system::add_critical_pair(std::uint32_t outer,
+                                       const std::vector<std::uint32_t>& position,
+                                       std::uint32_t inner) {
+    const auto& o = rule_list[outer];
+    const auto& i = rule_list[inner];
+    if (position.empty() && (outer == inner || (o.ordered && o.partner == inner))) {
+        return;
+    }
+    term_id renamed[] = {i.lhs, i.rhs};
+    bank.rename_to_pool(renamed, o.num_stmt_vars, o.num_expr_vars);
+    const auto unifier = bank.unify(bank.at(o.lhs, position), renamed[0]);
+    if (!unifier.has_value()) {
+        return;
+    }
+    critical_pairs++;
+    const auto overlap = bank.substitute(o.lhs, *unifier);
+    const auto outer_rhs = bank.substitute(o.rhs, *unifier);
+    const auto inner_lhs = bank.substitute(renamed[0], *unifier);
+    const auto inner_rhs = bank.substitute(renamed[1], *unifier);
+    if ((o.ordered && term_greater(bank, options.order, outer_rhs, overlap)) ||
+        (i.ordered && term_greater(bank, options.order, inner_rhs, inner_lhs))) {
+        return;
+    }
+    push(equation{outer_rhs, bank.replace_at(overlap, position, inner_rhs), derived_name});
+}
+
+// Whether s = t is an instance of an unorientable equation, possibly in a context (inside a term in which s and t are
+// the only difference). Such equations add nothing new, but they would also never be joined, because the ordered rules
+// cannot rewrite them.
+bool rewrite_system::is_subsumed(term_id s, term_id t) {
+    while (!bank.is_variable(s)) {
+        const auto it = root_index.find(bank.symbol(s));
+        if (it != root_index.end()) {
+            for (const auto index: it->second) {
+                const auto& r = rule_list[index];
+                if (!r.alive || !r.ordered) {
+                    continue;
+                }
+                const auto replacements = bank.match(r.lhs, s);
+                if (replacements.has_value() && bank.substitute(r.rhs, *replacements) == t) {
+                    return true;
+                }
+            }
+        }
+        if (bank.symbol(s) != bank.symbol(t)) {
+            return false;
+        }
+        const auto s_args = bank.args(s);
+        const auto t_args = bank.args(t);
+        // s != t, so they differ in at least one argument.
+        std::size_t difference = s_args.size();
+        for (std::size_t i = 0; i < s_args.size(); i++) {
+            if (s_args[i] != t_args[i]) {
+                if (difference != s_args.size()) {
+                    return false;
+                }
+                difference = i;
+            }
+        }
+        s = s_args[difference];
+        t = t_args[difference];
+    }
+    return false;
+}
+
+bool rewrite_system::rewrites(const rule& r, term_id term, term_id& result) {
+    const auto replacements = bank.match(r.lhs, term);
+    if (!replacements.has_value()) {
+        return false;
+    }
+    result = bank.substitute(r.rhs, *replacements);
+    return !r.ordered || term_greater(bank, options.order, term, result);
+}
+
+bool rewrite_system::is_reducible_by(term_id term, const rule& r) {
+    term_id result = 0;
+    if (bank.is_variable(term)) {
+        return false;
+    }
+    if (rewrites(r, term, result)) {
+        return true;
+    }
+    const std::vector<term_id> args(bank.args(term).begin(), bank.args(term).end());
+    return std::any_of(args.begin(), args.end(), [&](term_id arg) {
+        return is_reducible_by(arg, r);
+    });
+}
+
+term_id rewrite_system::normalize_term(term_id term) {
+    const auto cached = normal_forms.find(term);
+    if (cached != normal_forms.end()) {
+        return cached->second;
+    }
+    auto current = term;
+    if (!bank.is_variable(term) && bank.symbol(term).arity > 0) {
+        std::vector<term_id> args(bank.args(term).begin(), bank.args(term).end());
+        bool changed = false;
+        for (auto& arg: args) {
+            const auto normalized = normalize_term(arg);
+            changed = changed || normalized != arg;
+            arg = normalized;
+        }
+        if (changed) {
+            current = bank.make(bank.symbol(term), args);
+        }
+    }
+    auto result = current;
+    const auto it = root_index.find(bank.symbol(current));
+    if (it != root_index.end()) {
+        for (const auto index: it->second) {
+            term_id rewritten = 0;
+            if (rule_list[index].alive && rewrites(rule_list[index], current, rewritten)) {
+                result = normalize_term(rewritten);
+                break;
+            }
+        }
+    }
+    normal_forms.emplace(term, result);
+    normal_forms.emplace(current, result);
+    return result;
+}
+
+std::vector<oriented_law> rewrite_system::export_rules(bool ordered) const {
+    std::vector<oriented_law> laws;
+    for (const auto& r: rule_list) {
+        if (!r.alive || r.ordered != ordered) {
+            continue;
+        }
+        if (bank.is_statement(r.lhs)) {
+            laws.push_back(
+                    oriented_law{names[r.name], bank.to_statement(r.lhs), bank.to_statement(r.rhs), nullptr, nullptr});
+        } else {
+            laws.push_back(
+                    oriented_law{names[r.name], nullptr, nullptr, bank.to_expression(r.lhs), bank.to_expression(r.rhs)});
+        }
+    }
+    return laws;
+}
+
+bool rewrite_system::complete() const {
+    return is_complete;
+}
+
+std::vector<oriented_law> rewrite_system::rules() const {
+    return export_rules(false);
+}
+
+std::vector<oriented_law> rewrite_system::unorientable_equations() const {
+    return export_rules(true);
+}
+
+std::size_t rewrite_system::num_critical_pairs() const {
+    return critical_pairs;
+}
+
+statement_ptr rewrite_system::normalize(const statement_ptr& stmt) {
+    return bank.to_statement(normalize_term(bank.from_statement(*stmt, false)));
+}
+
+expr_ptr rewrite_system::normalize(const expr_ptr& expr) {
+    return bank.to_expression(normalize_term(bank.from_expression(*expr, false)));
+}
+
+bool rewrite_system::are_equivalent(const statement_ptr& a, const statement_ptr& b) {
+    return normalize_term(bank.from_statement(*a, false)) == normalize_term(bank.from_statement(*b, false));
+}
+
+bool rewrite_system::are_equivalent(const expr_ptr& a, const expr_ptr& b) {
+    return normalize_term(bank.from_expression(*a, false)) == normalize_term(bank.from_expression(*b, false));
+}
+
+}  // namespace tema
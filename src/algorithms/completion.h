@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "algorithms/rewrite.h"
+#include "algorithms/term.h"
+#include "algorithms/term_order.h"
+#include "core/module.h"
+
+namespace tema {
+
+struct completion_options {
+    term_order_kind order = term_order_kind::lpo;
+    // Completion stops (and the system is not complete) when it has more rules than this.
+    std::size_t max_rules = 500;
+    // Completion stops (and the system is not complete) after processing this many equations.
+    std::size_t max_steps = 20'000;
+};
+
+struct not_an_equation : std::runtime_error {
+    not_an_equation();
+};
+
+// A convergent rewrite system, obtained by ordered (unfailing) Knuth-Bendix completion of equational laws: equiv laws
+// between statements and = laws between expressions.
+//
+// Completion orients every equation with the term ordering. The equations that cannot be oriented (like p∧q ⟷ q∧p)
+// are kept, but are only used on the instances that they make smaller. The critical pairs of the rules (the two ways
+// of rewriting a term to which two rules apply) are added as new equations, until they all have the same normal form.
+// Overlapping rules are found through indexes of the rules' left sides and of their sub-terms by top symbol.
+//
+// Once complete, two statements are equivalent under the laws if and only if their normal forms are identical. The
+// variables of the statements being normalized are constants: they are not instantiated, even when they also appear
+// in the laws. Variables bound by forall statements are compared by identity, not up to renaming.
+class rewrite_system {
+    struct equation {
+        term_id lhs;
+        term_id rhs;
+        std::uint32_t name;  // Index in names, or derived_name for critical pairs.
+    };
+
+    static constexpr std::uint32_t derived_name = UINT32_MAX;
+
+    struct pending_equation {
+        std::uint32_t size;
+        std::uint64_t sequence;
+        equation eq;
+
+        bool operator>(const pending_equation& other) const;
+    };
+
+    struct rule {
+        term_id lhs;
+        term_id rhs;
+        std::uint32_t name;
+        // Unorientable equations are two rules (one for each direction), that can only rewrite the instances they make
+        // smaller.
+        bool ordered;
+        bool alive = true;
+        std::uint32_t partner = 0;
+        std::size_t num_stmt_vars = 0;
+        std::size_t num_expr_vars = 0;
+    };
+
+    completion_options options;
+    term_bank bank;
+    std::vector<std::string> names;
+    std::vector<rule> rule_list;
+    std::size_t num_alive = 0;
+    bool is_complete = false;
+    std::size_t critical_pairs = 0;
+
+    // The rules by the top symbol of their left side, and the non-variable sub-terms of the rules' left sides (rule
+    // index, position) by their top symbol. Entries of removed rules are skipped.
+    std::unordered_map<term_symbol, std::vector<std::uint32_t>, term_symbol_hash> root_index;
+    std::unordered_map<term_symbol, std::vector<std::pair<std::uint32_t, std::vector<std::uint32_t>>>, term_symbol_hash>
+            subterm_index;
+
+    // A min-heap of the equations left to process, smallest first.
+    std::vector<pending_equation> queue;
+    std::uint64_t next_sequence = 0;
+
+    std::unordered_map<term_id, term_id> normal_forms;
+
+    void run_completion();
+    void push(equation eq);
+    void add_law_equation(const statement_ptr& law, std::string name);
+    std::uint32_t add_rule(term_id lhs,
+                           term_id rhs,
+                           bool ordered,
+                           std::uint32_t name,
+                           std::pair<std::size_t, std::size_t> num_vars);
+    void remove_rule(std::uint32_t index);
+    void index_rule(std::uint32_t index);
+    void interreduce(std::uint32_t index);
+    void add_critical_pairs(std::uint32_t index);
+    void add_critical_pair(std::uint32_t outer, const std::vector<std::uint32_t>& position, std::uint32_t inner);
+    [[nodiscard]] bool is_subsumed(term_id s, term_id t);
+    [[nodiscard]] bool is_reducible_by(term_id term, const rule& r);
+    [[nodiscard]] bool rewrites(const rule& r, term_id term, term_id& result);
+    [[nodiscard]] term_id normalize_term(term_id term);
+    [[nodiscard]] std::vector<oriented_law> export_rules(bool ordered) const;
+
+public:
+    // Completes the equiv and = laws of the module.
+    explicit rewrite_system(const module& mod, const completion_options& options = {});
+
+    // Completes the given laws, which must all be equiv statements or = relationships (otherwise, throws
+    // not_an_equation).
+    explicit rewrite_system(const std::vector<statement_ptr>& laws, const completion_options& options = {});
+
+    // Whether completion finished without reaching a limit. If it did not, normal forms are still equivalent to the
+    // normalized statements, but equivalent statements might have different normal forms.
+    [[nodiscard]] bool complete() const;
+
+    // The oriented rules of the completed system.
+    [[nodiscard]] std::vector<oriented_law> rules() const;
+
+    // The equations of the completed system that could not be oriented, once in each direction.
+    [[nodiscard]] std::vector<oriented_law> unorientable_equations() const;
+
+    [[nodiscard]] std::size_t num_critical_pairs() const;
+
+    [[nodiscard]] statement_ptr normalize(const statement_ptr& stmt);
+    [[nodiscard]] expr_ptr normalize(const expr_ptr& expr);
+
+    [[nodiscard]] bool are_equivalent(const statement_ptr& a, const statement_ptr& b);
+    [[nodiscard]] bool are_equivalent(const expr_ptr& a, const expr_ptr& b);
+};
+
+}  // namespace tema
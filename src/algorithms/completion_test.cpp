@@ -0,0 +1,111 @@
+#include "algorithms/completion.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.completion") {
+    const auto vp = var_stmt(var("p"));
+    const auto vq = var_stmt(var("q"));
+    const auto vr = var_stmt(var("r"));
+    const auto va = var_stmt(var("a"));
+    const auto vb = var_stmt(var("b"));
+    const auto vc = var_stmt(var("c"));
+
+    test("DeMorgan's laws", [&] {
+        rewrite_system system({
+                equiv(neg(neg(vp)), vp),
+                equiv(neg(conj(vp, vq)), disj(neg(vp), neg(vq))),
+                equiv(neg(disj(vp, vq)), conj(neg(vp), neg(vq))),
+        });
+        expect(system.complete(), isTrue);
+        expect(system.rules(), hasSize(3));
+        expect(system.unorientable_equations(), isEmpty);
+        expect(system.num_critical_pairs(), isGreaterThan(0U));
+
+        const auto normal_form = system.normalize(neg(neg(neg(disj(va, neg(vb))))));
+        expectMsg(equals(*normal_form, *conj(neg(va), vb)), print_utf8(*normal_form));
+        expect(system.are_equivalent(neg(conj(va, neg(vb))), disj(neg(va), vb)), isTrue);
+        expect(system.are_equivalent(neg(conj(va, neg(vb))), disj(va, vb)), isFalse);
+    });
+
+    test("laws are oriented by the ordering", [&] {
+        // The Knuth-Bendix ordering compares sizes first, so it orients the law the other way around.
+        const std::vector<statement_ptr> laws{equiv(neg(conj(vp, vq)), disj(neg(vp), neg(vq)))};
+        const auto lpo_rules = rewrite_system(laws, {term_order_kind::lpo}).rules();
+        const auto kbo_rules = rewrite_system(laws, {term_order_kind::kbo}).rules();
+        expect(lpo_rules, hasSize(1));
+        expect(kbo_rules, hasSize(1));
+        expect(lpo_rules[0].stmt_lhs->is_neg(), isTrue);
+        expect(kbo_rules[0].stmt_lhs->is_disj(), isTrue);
+    });
+
+    test("unorientable equations rewrite ground terms to a normal form", [&] {
+        const auto x = var_expr(var("x"));
+        const auto y = var_expr(var("y"));
+        const auto ea = var_expr(var("A"));
+        const auto eb = var_expr(var("B"));
+        rewrite_system system({
+                rel_stmt(binop(ea, binop_type::set_sym_difference, eb),
+                         rel_type::eq,
+                         binop(binop(ea, binop_type::set_difference, eb),
+                               binop_type::set_union,
+                               binop(eb, binop_type::set_difference, ea))),
+                rel_stmt(binop(ea, binop_type::set_union, eb), rel_type::eq, binop(eb, binop_type::set_union, ea)),
+        });
+        expect(system.complete(), isTrue);
+        expect(system.rules(), hasSize(1));
+        expect(system.unorientable_equations(), hasSize(2));
+        expect(system.rules()[0].expr_lhs == nullptr, isFalse);
+        expect(system.are_equivalent(binop(x, binop_type::set_sym_difference, y),
+                                     binop(y, binop_type::set_sym_difference, x)),
+               isTrue);
+        expect(system.are_equivalent(rel_stmt(x, rel_type::in, binop(x, binop_type::set_union, y)),
+                                     rel_stmt(x, rel_type::in, binop(y, binop_type::set_union, x))),
+               isTrue);
+        expect(system.are_equivalent(binop(x, binop_type::set_difference, y), binop(y, binop_type::set_difference, x)),
+               isFalse);
+    });
+
+    test("limits", [&] {
+        // Associativity and commutativity do not have a finite completion without ground joinability tests.
+        rewrite_system system({equiv(conj(vp, vq), conj(vq, vp)), equiv(conj(conj(vp, vq), vr), conj(vp, conj(vq, vr)))},
+                              {term_order_kind::lpo, 500, 200});
+        expect(system.complete(), isFalse);
+        expect(system.rules(), hasSize(1));
+        expect(system.are_equivalent(conj(conj(va, vb), vc), conj(vc, conj(vb, va))), isTrue);
+        expect(system.are_equivalent(conj(va, vb), conj(va, vc)), isFalse);
+
+        rewrite_system few_rules({equiv(neg(neg(vp)), vp),
+                                  equiv(neg(conj(vp, vq)), disj(neg(vp), neg(vq))),
+                                  equiv(neg(disj(vp, vq)), conj(neg(vp), neg(vq)))},
+                                 {term_order_kind::lpo, 1, 1000});
+        expect(few_rules.complete(), isFalse);
+    });
+
+    test("laws of a module", [&] {
+        module mod("laws", "laws.tema");
+        const auto add_law = [&](std::string name, statement_ptr law) {
+            mod.add_statement_decl(stmt_decl{{0, 0}, true, stmt_decl_type::theorem, std::move(name), std::move(law), std::nullopt});
+        };
+        add_law("Double negation", equiv(neg(neg(vp)), vp));
+        add_law("Modus Ponens", implies(conj(vp, implies(vp, vq)), vq));
+        add_law("Idempotence of conjunction", equiv(vp, conj(vp, vp)));
+        rewrite_system system(mod);
+        expect(system.complete(), isTrue);
+        const auto rules = system.rules();
+        expect(rules, hasSize(2));
+        expect(rules[0].name, "Double negation");
+        expect(rules[1].name, "Idempotence of conjunction");
+        expect(system.are_equivalent(conj(neg(neg(va)), va), va), isTrue);
+    });
+
+    test("only equations can be completed", [&] {
+        expect([&] { rewrite_system system({implies(vp, vp)}); }, throwsA<not_an_equation>);
+    });
+}
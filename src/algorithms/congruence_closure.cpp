@@ -0,0 +1,209 @@
+#include "algorithms/congruence_closure.h"
+
+#include <utility>
+
+namespace tema {
+
+std::size_t congruence_closure::signature_hash::operator()(const signature& sig) const {
+    auto h = std::hash<const variable*>{}(sig.var) ^ (static_cast<std::size_t>(sig.kind) << 1U) ^
+             (static_cast<std::size_t>(sig.extra) << 3U);
+    for (const auto child: sig.children) {
+        h = h * 1000003U ^ child;
+    }
+    return h;
+}
+
+std::uint32_t congruence_closure::find(std::uint32_t node) const {
+    // Union by size keeps the trees logarithmic, so queries need no path compression and stay const.
+    while (parents[node] != node) {
+        node = parents[node];
+    }
+    return node;
+}
+
+congruence_closure::signature congruence_closure::canonical(const signature& sig) const {
+    auto result = sig;
+    for (auto& child: result.children) {
+        child = find(child);
+    }
+    return result;
+}
+
+std::optional<congruence_closure::signature> congruence_closure::head_signature(const expression& expr) const {
+    if (expr.is_var()) {
+        return signature{node_kind::var, 0, expr.as_var().get(), {}};
+    }
+    if (expr.is_binop()) {
+        const auto left = find_class(*expr.as_binop().left);
+        const auto right = find_class(*expr.as_binop().right);
+        if (!left.has_value() || !right.has_value()) {
+            return std::nullopt;
+        }
+        return signature{node_kind::binop, static_cast<std::uint32_t>(expr.as_binop().type), nullptr, {*left, *right}};
+    }
+    const auto& call = expr.as_call();
+    signature sig{node_kind::call, static_cast<std::uint32_t>(call.params.size()), nullptr, {}};
+    const auto callee = find_class(*call.callee);
+    if (!callee.has_value()) {
+        return std::nullopt;
+    }
+    sig.children.push_back(*callee);
+    for (const auto& param: call.params) {
+        const auto param_class = find_class(*param);
+        if (!param_class.has_value()) {
+            return std::nullopt;
+        }
+        sig.children.push_back(*param_class);
+    }
+    return sig;
+}
+
+std::optional<std::uint32_t> congruence_closure::find_class(const expression& expr) const {
+    const auto sig = head_signature(expr);
+    if (!sig.has_value()) {
+        return std::nullopt;
+    }
+    const auto it = signature_table.find(*sig);
+    if (it == signature_table.end()) {
+        return std::nullopt;
+    }
+    return find(it->second);
+}
+
+std::uint32_t congruence_closure::add(const expr_ptr& expr) {
+    signature sig;
+    if (expr->is_var()) {
+        vars.emplace(expr->as_var().get(), expr->as_var());
+        sig = signature{node_kind::var, 0, expr->as_var().get(), {}};
+    } else if (expr->is_binop()) {
+        const auto left = add(expr->as_binop().left);
+        const auto right = add(expr->as_binop().right);
+        sig = signature{node_kind::binop, static_cast<std::uint32_t>(expr->as_binop().type), nullptr, {find(left), find(right)}};
+    } else {
+        const auto& call = expr->as_call();
+        sig = signature{node_kind::call, static_cast<std::uint32_t>(call.params.size()), nullptr, {find(add(call.callee))}};
+        for (const auto& param: call.params) {
+            sig.children.push_back(find(add(param)));
+        }
+    }
+    const auto it = signature_table.find(sig);
+    if (it != signature_table.end()) {
+        return it->second;
+    }
+    const auto node = static_cast<std::uint32_t>(parents.size());
+    parents.push_back(node);
+    class_sizes.push_back(1);
+    uses.emplace_back();
+    num_classes++;
+    for (const auto child: sig.children) {
+        uses[child].push_back(node);
+    }
+    signature_table.emplace(sig, node);
+    node_signatures.push_back(std::move(sig));
+    return node;
+}
+
+void congruence_closure::merge(std::uint32_t a, std::uint32_t b) {
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pending{{a, b}};
+    while (!pending.empty()) {
+        auto [x, y] = pending.back();
+        pending.pop_back();
+        auto root = find(x);
+        auto other = find(y);
+        if (root == other) {
+            continue;
+        }
+        if (class_sizes[root] < class_sizes[other]) {
+            std::swap(root, other);
+        }
+        // The signatures of the nodes using the absorbed class change: take them out of the table under their old
+        // key, then put them back, merging with any node that already has the new signature.
+        auto moved_uses = std::move(uses[other]);
+        uses[other].clear();
+        for (const auto user: moved_uses) {
+            const auto it = signature_table.find(canonical(node_signatures[user]));
+            if (it != signature_table.end() && it->second == user) {
+                signature_table.erase(it);
+            }
+        }
+        parents[other] = root;
+        class_sizes[root] += class_sizes[other];
+        num_classes--;
+        for (const auto user: moved_uses) {
+            const auto [it, inserted] = signature_table.emplace(canonical(node_signatures[user]), user);
+            if (!inserted && find(it->second) != find(user)) {
+                pending.emplace_back(it->second, user);
+            }
+            uses[root].push_back(user);
+        }
+    }
+}
+
+void congruence_closure::add_equality(const expr_ptr& left, const expr_ptr& right) {
+    const auto left_node = add(left);
+    merge(left_node, add(right));
+}
+
+bool congruence_closure::add_fact(const statement_ptr& stmt) {
+    if (stmt->is_rel() && stmt->as_rel().type == rel_type::eq) {
+        add_equality(stmt->as_rel().left, stmt->as_rel().right);
+        return true;
+    }
+    if (stmt->is_conj()) {
+        bool found = false;
+        for (const auto& child: stmt->as_conj().inner) {
+            found = add_fact(child) || found;
+        }
+        return found;
+    }
+    return false;
+}
+
+void congruence_closure::add_facts(const scope& sc) {
+    for (const auto* current = &sc; current != nullptr; current = current->parent()) {
+        for (const auto& stmt: current->own_statements()) {
+            (void)add_fact(stmt);
+        }
+    }
+}
+
+bool congruence_closure::are_equal(const expression& a, const expression& b) const {
+    if (&a == &b) {
+        return true;
+    }
+    const auto class_a = find_class(a);
+    const auto class_b = find_class(b);
+    if (class_a.has_value() || class_b.has_value()) {
+        return class_a == class_b;
+    }
+    // Neither expression is congruent to an interned one, so they can only be equal with the same head and equal
+    // children.
+    if (a.is_var() || b.is_var()) {
+        return a.is_var() && b.is_var() && a.as_var() == b.as_var();
+    }
+    if (a.is_binop() || b.is_binop()) {
+        return a.is_binop() && b.is_binop() && a.as_binop().type == b.as_binop().type &&
+               are_equal(*a.as_binop().left, *b.as_binop().left) && are_equal(*a.as_binop().right, *b.as_binop().right);
+    }
+    const auto& call_a = a.as_call();
+    const auto& call_b = b.as_call();
+    if (call_a.params.size() != call_b.params.size() || !are_equal(*call_a.callee, *call_b.callee)) {
+        return false;
+    }
+    for (std::size_t i = 0; i < call_a.params.size(); i++) {
+        if (!are_equal(*call_a.params[i], *call_b.params[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t congruence_closure::num_nodes() const {
+    return parents.size();
+}
+
+std::size_t congruence_closure::num_equivalence_classes() const {
+    return num_classes;
+}
+
+}  // namespace tema
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "core/scope.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// Decides equality of expressions modulo a set of ground equalities, i.e. the smallest congruence containing them:
+// after absorbing a=b and b=c, the expressions a and c are equal, and so are f(a) and f(c), or a∪x and c∪x.
+//
+// Expressions are interned as nodes of a union-find structure, one node per distinct expression (variables are
+// constants). A signature table maps each node's head and the classes of its children to a node, so that when two
+// classes are merged, the nodes using them that became congruent are found and merged too. Queries are a find per
+// node of the queried expressions.
+class congruence_closure {
+    enum class node_kind : std::uint8_t { var, binop, call };
+
+    struct signature {
+        node_kind kind;
+        std::uint32_t extra;  // The binop type, or the number of params of a call.
+        const variable* var;
+        std::vector<std::uint32_t> children;  // Classes. For a call, the callee and then the params.
+
+        bool operator==(const signature&) const = default;
+    };
+
+    struct signature_hash {
+        std::size_t operator()(const signature& sig) const;
+    };
+
+    std::vector<std::uint32_t> parents;
+    std::vector<std::uint32_t> class_sizes;
+    std::vector<signature> node_signatures;  // As interned, with the classes of the children at that time.
+    std::vector<std::vector<std::uint32_t>> uses;  // For each class, the nodes with a child in it.
+    std::unordered_map<signature, std::uint32_t, signature_hash> signature_table;
+    std::unordered_map<const variable*, variable_ptr> vars;
+    std::size_t num_classes = 0;
+
+    [[nodiscard]] std::uint32_t find(std::uint32_t node) const;
+    [[nodiscard]] signature canonical(const signature& sig) const;
+    [[nodiscard]] std::optional<signature> head_signature(const expression& expr) const;
+    [[nodiscard]] std::optional<std::uint32_t> find_class(const expression& expr) const;
+    void merge(std::uint32_t a, std::uint32_t b);
+
+public:
+    // Interns the expression and all its sub-expressions, and returns its node.
+    std::uint32_t add(const expr_ptr& expr);
+
+    // Absorbs the equality left=right.
+    void add_equality(const expr_ptr& left, const expr_ptr& right);
+
+    // Absorbs the equalities of a statement: an = relationship, or a conjunction of statements containing some.
+    // Returns whether any equality was found. Non-ground statements (e.g. forall) are ignored.
+    bool add_fact(const statement_ptr& stmt);
+
+    // Absorbs the equalities among the statements of a scope and of all its parents.
+    void add_facts(const scope& sc);
+
+    // Whether the two expressions are equal modulo the absorbed equalities. Expressions are not interned by the
+    // query, so it does not change the structure and is safe to call concurrently.
+    [[nodiscard]] bool are_equal(const expression& a, const expression& b) const;
+
+    [[nodiscard]] std::size_t num_nodes() const;
+    [[nodiscard]] std::size_t num_equivalence_classes() const;
+};
+
+}  // namespace tema
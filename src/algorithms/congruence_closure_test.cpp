@@ -0,0 +1,103 @@
+#include "algorithms/congruence_closure.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+using namespace tema;
+using namespace mcga::matchers;
+
+TEST_CASE("algorithms.congruence_closure") {
+    const auto a = var_expr(var("a"));
+    const auto b = var_expr(var("b"));
+    const auto c = var_expr(var("c"));
+    const auto d = var_expr(var("d"));
+    const auto f = var_expr(var("f"));
+    const auto g = var_expr(var("g"));
+    const auto app = [](const expr_ptr& callee, std::vector<expr_ptr> params) {
+        return call(callee, std::move(params));
+    };
+    const auto set_union = [](expr_ptr l, expr_ptr r) {
+        return binop(std::move(l), binop_type::set_union, std::move(r));
+    };
+
+    test("without equalities, only identical expressions are equal", [&] {
+        const congruence_closure cc;
+        expect(cc.are_equal(*a, *a), isTrue);
+        expect(cc.are_equal(*app(f, {a}), *app(f, {var_expr(a->as_var())})), isTrue);
+        expect(cc.are_equal(*a, *b), isFalse);
+        expect(cc.are_equal(*app(f, {a}), *app(g, {a})), isFalse);
+    });
+
+    test("symmetry and transitivity", [&] {
+        congruence_closure cc;
+        cc.add_equality(a, b);
+        cc.add_equality(c, b);
+        expect(cc.are_equal(*a, *c), isTrue);
+        expect(cc.are_equal(*c, *a), isTrue);
+        expect(cc.are_equal(*a, *d), isFalse);
+        expect(cc.num_equivalence_classes(), std::size_t{1});
+    });
+
+    test("congruence", [&] {
+        congruence_closure cc;
+        cc.add_equality(a, b);
+        expect(cc.are_equal(*app(f, {a, c}), *app(f, {b, c})), isTrue);
+        expect(cc.are_equal(*set_union(a, app(g, {a})), *set_union(b, app(g, {b}))), isTrue);
+        expect(cc.are_equal(*app(f, {a, c}), *app(f, {c, b})), isFalse);
+        expect(cc.are_equal(*set_union(a, c), *binop(b, binop_type::set_intersection, c)), isFalse);
+    });
+
+    test("congruence of interned expressions after a merge", [&] {
+        // f(f(f(a)))=a and f(f(f(f(f(a)))))=a imply f(a)=a.
+        congruence_closure cc;
+        const auto f1 = app(f, {a});
+        const auto f2 = app(f, {f1});
+        const auto f3 = app(f, {f2});
+        const auto f4 = app(f, {f3});
+        const auto f5 = app(f, {f4});
+        cc.add_equality(f3, a);
+        expect(cc.are_equal(*f1, *a), isFalse);
+        cc.add_equality(f5, a);
+        expect(cc.are_equal(*f1, *a), isTrue);
+        expect(cc.are_equal(*f4, *f2), isTrue);
+    });
+
+    test("equalities of callees", [&] {
+        congruence_closure cc;
+        cc.add_equality(f, g);
+        expect(cc.are_equal(*app(f, {a}), *app(g, {a})), isTrue);
+        expect(cc.are_equal(*app(f, {a}), *app(g, {a, a})), isFalse);
+    });
+
+    test("facts", [&] {
+        congruence_closure cc;
+        expect(cc.add_fact(conj(rel_stmt(a, rel_type::eq, b), rel_stmt(c, rel_type::in, d))), isTrue);
+        expect(cc.add_fact(rel_stmt(c, rel_type::in, d)), isFalse);
+        expect(cc.add_fact(forall(var("x"), rel_stmt(var_expr(var("x")), rel_type::eq, c))), isFalse);
+        expect(cc.are_equal(*a, *b), isTrue);
+        expect(cc.are_equal(*c, *d), isFalse);
+
+        scope parent;
+        parent.add_statement(rel_stmt(a, rel_type::eq, c));
+        scope child(&parent);
+        child.add_statement(rel_stmt(c, rel_type::eq, d));
+        congruence_closure from_scope;
+        from_scope.add_facts(child);
+        expect(from_scope.are_equal(*a, *d), isTrue);
+    });
+
+    test("long chains", [&] {
+        congruence_closure cc;
+        std::vector<expr_ptr> vars;
+        for (int i = 0; i < 1000; i++) {
+            vars.push_back(var_expr(var("v" + std::to_string(i))));
+        }
+        for (std::size_t i = 0; i + 1 < vars.size(); i++) {
+            cc.add_equality(app(f, {vars[i]}), app(f, {vars[i + 1]}));
+            cc.add_equality(vars[i], vars[i + 1]);
+        }
+        // The variables, their images through f, and f itself.
+        expect(cc.num_equivalence_classes(), std::size_t{3});
+        expect(cc.are_equal(*app(g, {vars[0]}), *app(g, {vars[999]})), isTrue);
+        expect(cc.are_equal(*app(f, {vars[0]}), *vars[999]), isFalse);
+    });
+}
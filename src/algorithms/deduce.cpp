@@ -1,6 +1,9 @@
 #include "algorithms/deduce.h"
 
+#include <algorithm>
+
 #include "algorithms/match.h"
+#include "algorithms/match_program.h"
 
 namespace tema {
 
@@ -27,4 +30,39 @@ std::optional<statement_ptr> mp_deduce(const statement& law, const statement_ptr
     return std::nullopt;
 }
 
+std::vector<std::pair<std::size_t, statement_ptr>> mp_deduce_all(const statement& law,
+                                                                 std::span<const statement_ptr> applications,
+                                                                 std::span<const fingerprint> fingerprints) {
+    std::vector<std::uint32_t> candidates;
+    if (law.is_implies()) {
+        filter_may_match(law_fingerprint(*law.as_implies().from), fingerprints, candidates);
+    } else if (law.is_equiv()) {
+        filter_may_match(law_fingerprint(*law.as_equiv().left), fingerprints, candidates);
+        const auto num_left = candidates.size();
+        filter_may_match(law_fingerprint(*law.as_equiv().right), fingerprints, candidates);
+        std::inplace_merge(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(num_left), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    }
+    // The premises are compiled once for all the candidates. As in mp_deduce, the right side of an equivalence is
+    // only tried when the left side doesn't match.
+    std::vector<std::pair<match_program, const statement_ptr*>> programs;
+    if (law.is_implies()) {
+        programs.emplace_back(match_program(*law.as_implies().from), &law.as_implies().to);
+    } else if (law.is_equiv()) {
+        programs.emplace_back(match_program(*law.as_equiv().left), &law.as_equiv().right);
+        programs.emplace_back(match_program(*law.as_equiv().right), &law.as_equiv().left);
+    }
+    std::vector<std::pair<std::size_t, statement_ptr>> deduced;
+    for (const auto index: candidates) {
+        for (const auto& [program, conclusion]: programs) {
+            const auto match_result = program.run(applications[index]);
+            if (match_result.has_value()) {
+                deduced.emplace_back(index, apply_vars(*conclusion, match_result.value()).stmt);
+                break;
+            }
+        }
+    }
+    return deduced;
+}
+
 }  // namespace tema
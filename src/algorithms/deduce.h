@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
+#include <span>
+#include <utility>
+#include <vector>
 
 #include "algorithms/apply_vars.h"
+#include "algorithms/fingerprint.h"
 #include "core/statement.h"
 
 namespace tema {
@@ -12,4 +17,11 @@ namespace tema {
 // that B is true with the replacements from the *match* of "application" to A.
 [[nodiscard]] std::optional<statement_ptr> mp_deduce(const statement& law, const statement_ptr& application);
 
+// mp_deduce of the law with each of the applications, given with their fingerprints (see statement_fingerprint). Only
+// the applications whose fingerprints the law's premise may match are matched. Returns the index of every application
+// from which something was deduced, with the deduced statement, in increasing order of index.
+[[nodiscard]] std::vector<std::pair<std::size_t, statement_ptr>> mp_deduce_all(const statement& law,
+                                                                               std::span<const statement_ptr> applications,
+                                                                               std::span<const fingerprint> fingerprints);
+
 }  // namespace tema
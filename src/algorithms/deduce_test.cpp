@@ -73,4 +73,40 @@ TEST_CASE("algorithms.mp_deduce") {
         const auto law = neg(conj(var_stmt(p), neg(var_stmt(p))));
         expect_not_mp_deduce(law, truth());
     });
+
+    test("batch with fingerprints", [&] {
+        const std::vector<statement_ptr> applications = {
+                truth(),
+                neg(neg(var_stmt(q))),
+                conj(var_stmt(q), var_stmt(r)),
+                neg(neg(neg(neg(var_stmt(r))))),
+                neg(var_stmt(s)),
+        };
+        std::vector<fingerprint> fingerprints;
+        for (const auto& application: applications) {
+            fingerprints.push_back(statement_fingerprint(*application));
+        }
+        const auto laws = {
+                equiv(neg(neg(var_stmt(p))), var_stmt(p)),
+                implies(conj(var_stmt(p), var_stmt(q)), var_stmt(p)),
+                implies(neg(neg(neg(var_stmt(p)))), var_stmt(p)),
+                neg(var_stmt(p)),
+        };
+        for (const auto& law: laws) {
+            std::vector<std::pair<std::size_t, statement_ptr>> expected;
+            for (std::size_t i = 0; i < applications.size(); i++) {
+                if (auto deduced = mp_deduce(*law, applications[i]); deduced.has_value()) {
+                    expected.emplace_back(i, std::move(*deduced));
+                }
+            }
+            const auto deduced = mp_deduce_all(*law, applications, fingerprints);
+            expectMsg(deduced.size() == expected.size(), print_utf8(*law));
+            for (std::size_t i = 0; i < deduced.size() && i < expected.size(); i++) {
+                expect(deduced[i].first, expected[i].first);
+                expect(equals(*deduced[i].second, *expected[i].second), isTrue);
+            }
+        }
+        // Every application matches the equivalence one way or the other.
+        expect(mp_deduce_all(*equiv(neg(neg(var_stmt(p))), var_stmt(p)), applications, fingerprints), hasSize(5));
+    });
 }
@@ -0,0 +1,431 @@
+#include "algorithms/egraph.h"
+
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <tuple>
+
+namespace tema {
+
+namespace {
+
+bool is_rule_pattern(const statement& stmt) {
+    if (stmt.is_rel() || stmt.is_forall()) {
+        return false;
+    }
+    if (stmt.is_neg()) {
+        return is_rule_pattern(*stmt.as_neg().inner);
+    }
+    if (stmt.is_implies()) {
+        return is_rule_pattern(*stmt.as_implies().from) && is_rule_pattern(*stmt.as_implies().to);
+    }
+    if (stmt.is_equiv()) {
+        return is_rule_pattern(*stmt.as_equiv().left) && is_rule_pattern(*stmt.as_equiv().right);
+    }
+    if (stmt.is_conj() || stmt.is_disj()) {
+        const auto& children = stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner;
+        return std::all_of(children.begin(), children.end(), [](const statement_ptr& child) {
+            return is_rule_pattern(*child);
+        });
+    }
+    return true;
+}
+
+void collect_pattern_vars(const statement& stmt, std::set<const variable*>& vars) {
+    if (stmt.is_var()) {
+        vars.insert(stmt.as_var().get());
+    } else if (stmt.is_neg()) {
+        collect_pattern_vars(*stmt.as_neg().inner, vars);
+    } else if (stmt.is_implies()) {
+        collect_pattern_vars(*stmt.as_implies().from, vars);
+        collect_pattern_vars(*stmt.as_implies().to, vars);
+    } else if (stmt.is_equiv()) {
+        collect_pattern_vars(*stmt.as_equiv().left, vars);
+        collect_pattern_vars(*stmt.as_equiv().right, vars);
+    } else if (stmt.is_conj() || stmt.is_disj()) {
+        for (const auto& child: stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner) {
+            collect_pattern_vars(*child, vars);
+        }
+    }
+}
+
+bool is_valid_direction(const statement& lhs, const statement& rhs) {
+    if (lhs.is_var()) {
+        return false;
+    }
+    std::set<const variable*> lhs_vars;
+    std::set<const variable*> rhs_vars;
+    collect_pattern_vars(lhs, lhs_vars);
+    collect_pattern_vars(rhs, rhs_vars);
+    return std::includes(lhs_vars.begin(), lhs_vars.end(), rhs_vars.begin(), rhs_vars.end());
+}
+
+}  // namespace
+
+std::vector<rewrite_rule> equivalence_rules(const module& mod) {
+    std::vector<rewrite_rule> rules;
+    for (const auto& decl: mod.get_decls()) {
+        if (!holds_alternative<stmt_decl>(decl)) {
+            continue;
+        }
+        const auto& law = get<stmt_decl>(decl);
+        if (!law.stmt->is_equiv() || !is_rule_pattern(*law.stmt)) {
+            continue;
+        }
+        const auto& [left, right] = law.stmt->as_equiv();
+        if (is_valid_direction(*left, *right)) {
+            rules.push_back(rewrite_rule{law.name, left, right});
+        }
+        if (is_valid_direction(*right, *left)) {
+            rules.push_back(rewrite_rule{law.name + " (reversed)", right, left});
+        }
+    }
+    return rules;
+}
+
+std::size_t egraph::enode_hash::operator()(const enode& node) const {
+    auto h = (static_cast<std::size_t>(node.op) << 32U) ^ node.payload;
+    for (const auto child: node.children) {
+        h = h * 1000003U ^ child;
+    }
+    return h;
+}
+
+egraph::class_id egraph::find(class_id id) const {
+    while (parents[id] != id) {
+        id = parents[id];
+    }
+    return id;
+}
+
+egraph::enode egraph::canonical(enode node) const {
+    for (auto& child: node.children) {
+        child = find(child);
+    }
+    return node;
+}
+
+egraph::class_id egraph::add_node(enode node) {
+    node = canonical(std::move(node));
+    const auto it = memo.find(node);
+    if (it != memo.end()) {
+        return find(it->second);
+    }
+    const auto id = static_cast<class_id>(parents.size());
+    parents.push_back(id);
+    classes.emplace_back();
+    for (const auto child: node.children) {
+        classes[child].uses.emplace_back(node, id);
+    }
+    classes[id].nodes.push_back(node);
+    memo.emplace(std::move(node), id);
+    node_count++;
+    class_count++;
+    return id;
+}
+
+egraph::class_id egraph::add(const statement_ptr& stmt) {
+    if (stmt->is_truth()) {
+        return add_node({node_op::truth, 0, {}});
+    }
+    if (stmt->is_contradiction()) {
+        return add_node({node_op::contradiction, 0, {}});
+    }
+    if (stmt->is_var()) {
+        const auto [it, inserted] = var_ids.emplace(stmt->as_var().get(), static_cast<std::uint32_t>(vars.size()));
+        if (inserted) {
+            vars.push_back(stmt->as_var());
+        }
+        return add_node({node_op::var, it->second, {}});
+    }
+    if (stmt->is_neg()) {
+        return add_node({node_op::neg, 0, {add(stmt->as_neg().inner)}});
+    }
+    if (stmt->is_conj() || stmt->is_disj()) {
+        enode node{stmt->is_conj() ? node_op::conj : node_op::disj, 0, {}};
+        for (const auto& child: stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner) {
+            node.children.push_back(add(child));
+        }
+        return add_node(std::move(node));
+    }
+    if (stmt->is_implies()) {
+        const auto from = add(stmt->as_implies().from);
+        return add_node({node_op::implies, 0, {from, add(stmt->as_implies().to)}});
+    }
+    if (stmt->is_equiv()) {
+        const auto left = add(stmt->as_equiv().left);
+        return add_node({node_op::equiv, 0, {left, add(stmt->as_equiv().right)}});
+    }
+    const auto [it, inserted] = leaf_ids.emplace(stmt, static_cast<std::uint32_t>(leaves.size()));
+    if (inserted) {
+        leaves.push_back(stmt);
+    }
+    return add_node({node_op::leaf, it->second, {}});
+}
+
+bool egraph::merge(class_id a, class_id b) {
+    auto root = find(a);
+    auto other = find(b);
+    if (root == other) {
+        return false;
+    }
+    if (classes[root].nodes.size() + classes[root].uses.size() < classes[other].nodes.size() + classes[other].uses.size()) {
+        std::swap(root, other);
+    }
+    parents[other] = root;
+    auto& absorbed = classes[other];
+    auto& target = classes[root];
+    target.nodes.insert(target.nodes.end(), absorbed.nodes.begin(), absorbed.nodes.end());
+    target.uses.insert(target.uses.end(), absorbed.uses.begin(), absorbed.uses.end());
+    absorbed = eclass{};
+    class_count--;
+    pending.push_back(root);
+    return true;
+}
+
+void egraph::repair(class_id id) {
+    // The nodes using this class may have changed their canonical form, and some of them may now be equal, in which
+    // case their classes are congruent.
+    auto uses = std::move(classes[id].uses);
+    classes[id].uses.clear();
+    for (auto& [node, user]: uses) {
+        memo.erase(node);
+        node = canonical(std::move(node));
+        memo[node] = find(user);
+    }
+    std::unordered_map<enode, class_id, enode_hash> unique_uses;
+    for (auto& [node, user]: uses) {
+        const auto [it, inserted] = unique_uses.emplace(node, user);
+        if (!inserted) {
+            merge(it->second, user);
+            it->second = find(user);
+        }
+    }
+    auto& repaired = classes[find(id)].uses;
+    for (auto& [node, user]: unique_uses) {
+        repaired.emplace_back(node, find(user));
+    }
+
+    // Deduplicate the class's own nodes, which may also have become equal.
+    auto& nodes = classes[find(id)].nodes;
+    for (auto& node: nodes) {
+        node = canonical(std::move(node));
+    }
+    std::sort(nodes.begin(), nodes.end(), [](const enode& a, const enode& b) {
+        return std::tie(a.op, a.payload, a.children) < std::tie(b.op, b.payload, b.children);
+    });
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+}
+
+void egraph::rebuild() {
+    while (!pending.empty()) {
+        auto todo = std::move(pending);
+        pending.clear();
+        for (auto& id: todo) {
+            id = find(id);
+        }
+        std::sort(todo.begin(), todo.end());
+        todo.erase(std::unique(todo.begin(), todo.end()), todo.end());
+        for (const auto id: todo) {
+            repair(id);
+        }
+    }
+    node_count = memo.size();
+}
+
+std::vector<egraph::substitution> egraph::ematch(const statement& pattern,
+                                                 class_id id,
+                                                 const substitution& subst) const {
+    id = find(id);
+    if (pattern.is_var()) {
+        const auto* var = pattern.as_var().get();
+        for (const auto& [bound_var, bound_class]: subst) {
+            if (bound_var == var) {
+                return find(bound_class) == id ? std::vector<substitution>{subst} : std::vector<substitution>{};
+            }
+        }
+        auto extended = subst;
+        extended.emplace_back(var, id);
+        return {std::move(extended)};
+    }
+
+    node_op op;
+    std::vector<const statement*> child_patterns;
+    if (pattern.is_truth()) {
+        op = node_op::truth;
+    } else if (pattern.is_contradiction()) {
+        op = node_op::contradiction;
+    } else if (pattern.is_neg()) {
+        op = node_op::neg;
+        child_patterns = {pattern.as_neg().inner.get()};
+    } else if (pattern.is_implies()) {
+        op = node_op::implies;
+        child_patterns = {pattern.as_implies().from.get(), pattern.as_implies().to.get()};
+    } else if (pattern.is_equiv()) {
+        op = node_op::equiv;
+        child_patterns = {pattern.as_equiv().left.get(), pattern.as_equiv().right.get()};
+    } else {
+        op = pattern.is_conj() ? node_op::conj : node_op::disj;
+        for (const auto& child: pattern.is_conj() ? pattern.as_conj().inner : pattern.as_disj().inner) {
+            child_patterns.push_back(child.get());
+        }
+    }
+
+    std::vector<substitution> results;
+    for (const auto& node: classes[id].nodes) {
+        if (node.op != op || node.children.size() != child_patterns.size()) {
+            continue;
+        }
+        std::vector<substitution> partial{subst};
+        for (std::size_t i = 0; i < child_patterns.size() && !partial.empty(); i++) {
+            std::vector<substitution> next;
+            for (const auto& candidate: partial) {
+                auto matches = ematch(*child_patterns[i], node.children[i], candidate);
+                next.insert(next.end(), std::make_move_iterator(matches.begin()), std::make_move_iterator(matches.end()));
+            }
+            partial = std::move(next);
+        }
+        results.insert(results.end(), std::make_move_iterator(partial.begin()), std::make_move_iterator(partial.end()));
+    }
+    return results;
+}
+
+egraph::class_id egraph::instantiate(const statement& pattern, const substitution& subst) {
+    if (pattern.is_var()) {
+        for (const auto& [var, id]: subst) {
+            if (var == pattern.as_var().get()) {
+                return find(id);
+            }
+        }
+        // Not a pattern variable of the rule, so it stands for itself.
+        return add(var_stmt(pattern.as_var()));
+    }
+    if (pattern.is_truth()) {
+        return add_node({node_op::truth, 0, {}});
+    }
+    if (pattern.is_contradiction()) {
+        return add_node({node_op::contradiction, 0, {}});
+    }
+    if (pattern.is_neg()) {
+        return add_node({node_op::neg, 0, {instantiate(*pattern.as_neg().inner, subst)}});
+    }
+    if (pattern.is_implies()) {
+        const auto from = instantiate(*pattern.as_implies().from, subst);
+        return add_node({node_op::implies, 0, {from, instantiate(*pattern.as_implies().to, subst)}});
+    }
+    if (pattern.is_equiv()) {
+        const auto left = instantiate(*pattern.as_equiv().left, subst);
+        return add_node({node_op::equiv, 0, {left, instantiate(*pattern.as_equiv().right, subst)}});
+    }
+    enode node{pattern.is_conj() ? node_op::conj : node_op::disj, 0, {}};
+    for (const auto& child: pattern.is_conj() ? pattern.as_conj().inner : pattern.as_disj().inner) {
+        node.children.push_back(instantiate(*child, subst));
+    }
+    return add_node(std::move(node));
+}
+
+saturation_report egraph::saturate(const std::vector<rewrite_rule>& rules, const egraph_limits& limits) {
+    saturation_report report;
+    rebuild();
+    while (report.iterations < limits.max_iterations && num_nodes() <= limits.max_nodes) {
+        report.iterations++;
+        // Find all the matches first, then apply them, so that every rule sees the same graph.
+        std::vector<std::pair<std::size_t, std::pair<class_id, substitution>>> matches;
+        for (std::size_t rule = 0; rule < rules.size(); rule++) {
+            for (class_id id = 0; id < parents.size(); id++) {
+                if (find(id) != id) {
+                    continue;
+                }
+                for (auto& subst: ematch(*rules[rule].lhs, id, {})) {
+                    matches.emplace_back(rule, std::pair{id, std::move(subst)});
+                }
+            }
+        }
+        const auto nodes_before = num_nodes();
+        const auto classes_before = num_classes();
+        for (const auto& [rule, match]: matches) {
+            if (num_nodes() > limits.max_nodes) {
+                break;
+            }
+            const auto rhs = instantiate(*rules[rule].rhs, match.second);
+            merge(match.first, rhs);
+            report.applied_matches++;
+        }
+        rebuild();
+        if (num_nodes() == nodes_before && num_classes() == classes_before) {
+            report.saturated = true;
+            break;
+        }
+    }
+    return report;
+}
+
+statement_ptr egraph::extract(class_id id) const {
+    // Bellman-Ford style fixpoint of the cost of the cheapest node of every class.
+    constexpr auto infinite = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> costs(parents.size(), infinite);
+    std::vector<const enode*> best(parents.size(), nullptr);
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (class_id c = 0; c < parents.size(); c++) {
+            if (find(c) != c) {
+                continue;
+            }
+            for (const auto& node: classes[c].nodes) {
+                std::size_t cost = 1;
+                for (const auto child: node.children) {
+                    const auto child_cost = costs[find(child)];
+                    cost = child_cost == infinite ? infinite : cost + child_cost;
+                    if (cost == infinite) {
+                        break;
+                    }
+                }
+                if (cost < costs[c]) {
+                    costs[c] = cost;
+                    best[c] = &node;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    const auto build = [&](const auto& self, class_id c) -> statement_ptr {
+        const auto& node = *best[find(c)];
+        std::vector<statement_ptr> children;
+        for (const auto child: node.children) {
+            children.push_back(self(self, child));
+        }
+        switch (node.op) {
+            case node_op::truth: return truth();
+            case node_op::contradiction: return contradiction();
+            case node_op::neg: return neg(children[0]);
+            case node_op::conj: return conj(std::move(children));
+            case node_op::disj: return disj(std::move(children));
+            case node_op::implies: return implies(children[0], children[1]);
+            case node_op::equiv: return equiv(children[0], children[1]);
+            case node_op::var: return var_stmt(vars[node.payload]);
+            case node_op::leaf: return leaves[node.payload];
+        }
+        return nullptr;
+    };
+    return build(build, id);
+}
+
+std::size_t egraph::num_nodes() const {
+    return node_count;
+}
+
+std::size_t egraph::num_classes() const {
+    return class_count;
+}
+
+statement_ptr simplify_with_rules(const statement_ptr& stmt,
+                                  const std::vector<rewrite_rule>& rules,
+                                  const egraph_limits& limits) {
+    egraph graph;
+    const auto id = graph.add(stmt);
+    (void)graph.saturate(rules, limits);
+    return graph.extract(id);
+}
+
+}  // namespace tema
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "algorithms/hash.h"
+#include "core/module.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// Rewrites instances of lhs into the corresponding instances of rhs. The variables used as statements (var_stmt) in
+// lhs are the pattern variables, and rhs can only use variables that appear in lhs.
+struct rewrite_rule {
+    std::string name;
+    statement_ptr lhs;
+    statement_ptr rhs;
+};
+
+// The rewrite rules given by the equiv statements of a module, one in each direction. Laws containing relationships
+// or forall statements are skipped, and so are directions whose lhs is a bare variable (which would match every
+// statement) or whose rhs uses variables not in lhs. The reversed direction of a law is named "<name> (reversed)".
+[[nodiscard]] std::vector<rewrite_rule> equivalence_rules(const module& mod);
+
+struct egraph_limits {
+    std::size_t max_nodes = 10'000;
+    std::size_t max_iterations = 16;
+};
+
+struct saturation_report {
+    std::size_t iterations = 0;
+    // Whether no rule application could add anything new. Otherwise, a limit stopped the saturation.
+    bool saturated = false;
+    std::size_t applied_matches = 0;
+};
+
+// An e-graph over statements: a set of equivalence classes of statements, in which every node is an operator applied
+// to classes, so that exponentially many equivalent statements are stored in shared, compact form. Relationships and
+// forall statements are opaque leaves (structurally equal ones are the same leaf).
+//
+// Equality saturation repeatedly finds all the instances of the rules' left sides in the graph (e-matching) and merges
+// them with the corresponding right sides, restoring congruence after each round.
+class egraph {
+public:
+    using class_id = std::uint32_t;
+
+private:
+    enum class node_op : std::uint8_t { truth, contradiction, neg, conj, disj, implies, equiv, var, leaf };
+
+    struct enode {
+        node_op op;
+        std::uint32_t payload;  // Index of the variable or of the leaf.
+        std::vector<class_id> children;
+
+        bool operator==(const enode&) const = default;
+    };
+
+    struct enode_hash {
+        std::size_t operator()(const enode& node) const;
+    };
+
+    struct eclass {
+        std::vector<enode> nodes;
+        std::vector<std::pair<enode, class_id>> uses;  // The nodes with a child in this class, and their classes.
+    };
+
+    using substitution = std::vector<std::pair<const variable*, class_id>>;
+
+    std::vector<class_id> parents;
+    std::vector<eclass> classes;
+    std::unordered_map<enode, class_id, enode_hash> memo;
+    std::vector<class_id> pending;
+    std::size_t node_count = 0;
+    std::size_t class_count = 0;
+
+    std::vector<variable_ptr> vars;
+    std::unordered_map<const variable*, std::uint32_t> var_ids;
+    std::vector<statement_ptr> leaves;
+    std::unordered_map<statement_ptr, std::uint32_t, structural_hash, structural_equal> leaf_ids;
+
+    [[nodiscard]] enode canonical(enode node) const;
+    class_id add_node(enode node);
+    void repair(class_id id);
+    [[nodiscard]] std::vector<substitution> ematch(const statement& pattern, class_id id, const substitution& subst) const;
+    class_id instantiate(const statement& pattern, const substitution& subst);
+
+public:
+    // Adds the statement and all its sub-statements, and returns the class of the statement.
+    class_id add(const statement_ptr& stmt);
+
+    // Merges two classes. Congruence is only restored by rebuild.
+    bool merge(class_id a, class_id b);
+    void rebuild();
+
+    [[nodiscard]] class_id find(class_id id) const;
+
+    saturation_report saturate(const std::vector<rewrite_rule>& rules, const egraph_limits& limits = {});
+
+    // The smallest statement (by number of nodes) of the class.
+    [[nodiscard]] statement_ptr extract(class_id id) const;
+
+    [[nodiscard]] std::size_t num_nodes() const;
+    [[nodiscard]] std::size_t num_classes() const;
+};
+
+// Saturates an e-graph containing the statement with the rules, and returns the smallest equivalent statement.
+[[nodiscard]] statement_ptr simplify_with_rules(const statement_ptr& stmt,
+                                                const std::vector<rewrite_rule>& rules,
+                                                const egraph_limits& limits = {});
+
+}  // namespace tema
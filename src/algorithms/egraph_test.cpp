@@ -0,0 +1,104 @@
+#include "algorithms/egraph.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+void expect_simplifies_to(const statement_ptr& stmt,
+                          const statement_ptr& expected,
+                          const std::vector<rewrite_rule>& rules,
+                          Context context = Context()) {
+    const auto result = simplify_with_rules(stmt, rules);
+    expectMsg(equals(*result, *expected),
+              print_utf8(*stmt) + " simplified to " + print_utf8(*result) + " instead of " + print_utf8(*expected),
+              std::move(context));
+}
+
+TEST_CASE("algorithms.egraph") {
+    const auto p = var("p");
+    const auto q = var("q");
+    const auto r = var("r");
+    const auto vp = var_stmt(p);
+    const auto vq = var_stmt(q);
+    const auto vr = var_stmt(r);
+
+    module mod("propositional_logic", "propositional_logic.tema");
+    const auto add_law = [&](std::string name, statement_ptr law) {
+        mod.add_statement_decl(stmt_decl{{0, 0}, true, stmt_decl_type::theorem, std::move(name), std::move(law), std::nullopt});
+    };
+    add_law("Double negation", equiv(neg(neg(vp)), vp));
+    add_law("DeMorgan law I", equiv(disj(vp, vq), neg(conj(neg(vp), neg(vq)))));
+    add_law("Idempotence of conjunction", equiv(vp, conj(vp, vp)));
+    add_law("Commutativity of conjunction", equiv(conj(vp, vq), conj(vq, vp)));
+    add_law("Commutativity of disjunction", equiv(disj(vp, vq), disj(vq, vp)));
+    add_law("Associativity of conjunction", equiv(conj(conj(vp, vq), vr), conj(vp, conj(vq, vr))));
+    add_law("Absorption of conjunction", equiv(disj(vp, conj(vp, vq)), vp));
+    add_law("Modus Ponens", implies(conj(vp, implies(vp, vq)), vq));
+    add_law("Set law", equiv(rel_stmt(var_expr(p), rel_type::eq, var_expr(q)), rel_stmt(var_expr(q), rel_type::eq, var_expr(p))));
+    const auto rules = equivalence_rules(mod);
+
+    test("rules from a module's equivalences", [&] {
+        // Double negation, idempotence and absorption only in the direction whose left side is not a bare variable, no
+        // rules for the implication and for the law with relationships.
+        expect(rules, hasSize(11));
+        expect(rules[0].name, "Double negation");
+        expect(rules[1].name, "DeMorgan law I");
+        expect(rules[2].name, "DeMorgan law I (reversed)");
+        expect(rules[3].name, "Idempotence of conjunction (reversed)");
+        expect(equals(*rules[3].lhs, *conj(vp, vp)), isTrue);
+        expect(rules[10].name, "Absorption of conjunction");
+    });
+
+    test("congruence of the initial statements", [&] {
+        egraph graph;
+        const auto a = graph.add(conj(vp, vq));
+        const auto b = graph.add(conj(vp, vq));
+        expect(a, b);
+        const auto c = graph.add(neg(vp));
+        const auto d = graph.add(neg(vq));
+        expect(graph.find(c) == graph.find(d), isFalse);
+        graph.merge(graph.add(vp), graph.add(vq));
+        graph.rebuild();
+        expect(graph.find(c), graph.find(d));
+    });
+
+    test("saturation proves equivalences", [&] {
+        egraph graph;
+        const auto a = graph.add(conj(conj(vp, vq), vr));
+        const auto b = graph.add(conj(vr, conj(vq, vp)));
+        const auto c = graph.add(neg(neg(disj(vq, vp))));
+        const auto d = graph.add(neg(conj(neg(vp), neg(vq))));
+        const auto report = graph.saturate(rules);
+        expect(report.saturated, isTrue);
+        expect(graph.find(a), graph.find(b));
+        expect(graph.find(c), graph.find(d));
+        expect(graph.find(a) == graph.find(c), isFalse);
+    });
+
+    test("extraction of the smallest equivalent statement", [&] {
+        expect_simplifies_to(neg(neg(conj(vp, vp))), vp, rules);
+        expect_simplifies_to(disj(vq, conj(vq, vr)), vq, rules);
+        expect_simplifies_to(neg(conj(neg(vp), neg(vq))), disj(vp, vq), rules);
+        expect_simplifies_to(implies(neg(neg(vp)), vq), implies(vp, vq), rules);
+        const auto rel = rel_stmt(var_expr(p), rel_type::in, var_expr(q));
+        expect_simplifies_to(neg(neg(rel)), rel, rules);
+    });
+
+    test("limits", [&] {
+        egraph graph;
+        (void)graph.add(conj(conj(conj(vp, vq), vr), conj(vq, vp)));
+        const auto report = graph.saturate(rules, egraph_limits{20, 16});
+        expect(report.saturated, isFalse);
+
+        egraph iterations;
+        (void)iterations.add(conj(conj(conj(vp, vq), vr), conj(vq, vp)));
+        const auto one_iteration = iterations.saturate(rules, egraph_limits{10'000, 1});
+        expect(one_iteration.iterations, std::size_t{1});
+        expect(one_iteration.saturated, isFalse);
+    });
+}
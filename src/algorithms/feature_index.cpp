@@ -0,0 +1,270 @@
+#include "algorithms/feature_index.h"
+
+#include <algorithm>
+
+#include "algorithms/match.h"
+
+namespace tema {
+
+namespace {
+
+enum symbol_slot : std::uint32_t {
+    truth_slot = 0,
+    contradiction_slot,
+    neg_slot,
+    implies_slot,
+    equiv_slot,
+    conj_slot,
+    disj_slot,
+    forall_slot,
+    call_slot,
+    bound_var_slot,
+    first_rel_slot,
+    first_binop_slot = first_rel_slot + 20,
+    num_symbols = first_binop_slot + 4,
+};
+
+void add_occurrence(feature_vector& features, std::uint32_t slot, std::uint32_t depth) {
+    features[slot] += 1;
+    features[num_symbols + slot] = std::max(features[num_symbols + slot], depth);
+}
+
+void collect_features(const expression& expr,  // NOLINT(misc-no-recursion)
+                      std::uint32_t depth,
+                      const std::vector<const variable*>& bound,
+                      feature_vector& features) {
+    if (expr.is_var()) {
+        if (std::find(bound.begin(), bound.end(), expr.as_var().get()) != bound.end()) {
+            add_occurrence(features, bound_var_slot, depth);
+        }
+    } else if (expr.is_binop()) {
+        const auto& [type, left, right] = expr.as_binop();
+        add_occurrence(features, first_binop_slot + static_cast<std::uint32_t>(type), depth);
+        collect_features(*left, depth + 1, bound, features);
+        collect_features(*right, depth + 1, bound, features);
+    } else {
+        add_occurrence(features, call_slot, depth);
+        collect_features(*expr.as_call().callee, depth + 1, bound, features);
+        for (const auto& param: expr.as_call().params) {
+            collect_features(*param, depth + 1, bound, features);
+        }
+    }
+}
+
+void collect_features(const statement& stmt,  // NOLINT(misc-no-recursion)
+                      std::uint32_t depth,
+                      std::vector<const variable*>& bound,
+                      feature_vector& features) {
+    if (stmt.is_truth()) {
+        add_occurrence(features, truth_slot, depth);
+    } else if (stmt.is_contradiction()) {
+        add_occurrence(features, contradiction_slot, depth);
+    } else if (stmt.is_var()) {
+        if (std::find(bound.begin(), bound.end(), stmt.as_var().get()) != bound.end()) {
+            add_occurrence(features, bound_var_slot, depth);
+        }
+    } else if (stmt.is_rel()) {
+        const auto& [type, left, right] = stmt.as_rel();
+        add_occurrence(features, first_rel_slot + static_cast<std::uint32_t>(type), depth);
+        collect_features(*left, depth + 1, bound, features);
+        collect_features(*right, depth + 1, bound, features);
+    } else if (stmt.is_neg()) {
+        add_occurrence(features, neg_slot, depth);
+        collect_features(*stmt.as_neg().inner, depth + 1, bound, features);
+    } else if (stmt.is_implies()) {
+        add_occurrence(features, implies_slot, depth);
+        collect_features(*stmt.as_implies().from, depth + 1, bound, features);
+        collect_features(*stmt.as_implies().to, depth + 1, bound, features);
+    } else if (stmt.is_equiv()) {
+        add_occurrence(features, equiv_slot, depth);
+        collect_features(*stmt.as_equiv().left, depth + 1, bound, features);
+        collect_features(*stmt.as_equiv().right, depth + 1, bound, features);
+    } else if (stmt.is_conj() || stmt.is_disj()) {
+        add_occurrence(features, stmt.is_conj() ? conj_slot : disj_slot, depth);
+        for (const auto& child: stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner) {
+            collect_features(*child, depth + 1, bound, features);
+        }
+    } else {
+        add_occurrence(features, forall_slot, depth);
+        bound.push_back(stmt.as_forall().var.get());
+        collect_features(*stmt.as_forall().inner, depth + 1, bound, features);
+        bound.pop_back();
+    }
+}
+
+void collect_features(const term_bank& bank,  // NOLINT(misc-no-recursion)
+                      term_id term,
+                      std::uint32_t depth,
+                      feature_vector& features) {
+    const auto& symbol = bank.symbol(term);
+    switch (symbol.kind) {
+        case term_kind::expr_var:
+        case term_kind::stmt_var: return;
+        case term_kind::expr_const:
+        case term_kind::stmt_const: add_occurrence(features, bound_var_slot, depth); break;
+        case term_kind::truth: add_occurrence(features, truth_slot, depth); break;
+        case term_kind::contradiction: add_occurrence(features, contradiction_slot, depth); break;
+        case term_kind::call: add_occurrence(features, call_slot, depth); break;
+        case term_kind::binop: add_occurrence(features, first_binop_slot + symbol.payload, depth); break;
+        case term_kind::disj: add_occurrence(features, disj_slot, depth); break;
+        case term_kind::conj: add_occurrence(features, conj_slot, depth); break;
+        case term_kind::neg: add_occurrence(features, neg_slot, depth); break;
+        case term_kind::implies: add_occurrence(features, implies_slot, depth); break;
+        case term_kind::equiv: add_occurrence(features, equiv_slot, depth); break;
+        case term_kind::forall: add_occurrence(features, forall_slot, depth); break;
+        case term_kind::rel: add_occurrence(features, first_rel_slot + symbol.payload, depth); break;
+    }
+    for (const auto arg: bank.args(term)) {
+        collect_features(bank, arg, depth + 1, features);
+    }
+}
+
+}  // namespace
+
+std::size_t num_features() {
+    return 2 * num_symbols;
+}
+
+feature_vector statement_features(const statement& stmt) {
+    feature_vector features(num_features(), 0);
+    std::vector<const variable*> bound;
+    collect_features(stmt, 1, bound, features);
+    return features;
+}
+
+feature_vector term_features(const term_bank& bank, term_id term) {
+    feature_vector features(num_features(), 0);
+    collect_features(bank, term, 1, features);
+    return features;
+}
+
+std::uint32_t feature_index::insert(const feature_vector& features) {
+    std::uint32_t current = 0;
+    for (const auto value: features) {
+        auto& children = nodes[current].children;
+        auto it = std::lower_bound(children.begin(), children.end(), value, [](const auto& child, std::uint32_t v) {
+            return child.first < v;
+        });
+        if (it == children.end() || it->first != value) {
+            const auto child = static_cast<std::uint32_t>(nodes.size());
+            children.insert(it, {value, child});
+            // children is invalidated by adding the node.
+            nodes.emplace_back();
+            current = child;
+        } else {
+            current = it->second;
+        }
+    }
+    const auto id = static_cast<std::uint32_t>(leaves.size());
+    nodes[current].entries.push_back(id);
+    leaves.push_back(current);
+    num_entries += 1;
+    return id;
+}
+
+void feature_index::remove(std::uint32_t id) {
+    if (leaves[id] == removed) {
+        return;
+    }
+    auto& entries = nodes[leaves[id]].entries;
+    entries.erase(std::find(entries.begin(), entries.end(), id));
+    leaves[id] = removed;
+    num_entries -= 1;
+}
+
+template<bool at_most>
+std::vector<std::uint32_t> feature_index::find(const feature_vector& features) const {
+    std::vector<std::uint32_t> result;
+    std::vector<std::pair<std::uint32_t, std::size_t>> stack{{0, 0}};  // (node, level)
+    while (!stack.empty()) {
+        const auto [current, level] = stack.back();
+        stack.pop_back();
+        const auto& n = nodes[current];
+        if (level == features.size()) {
+            result.insert(result.end(), n.entries.begin(), n.entries.end());
+            continue;
+        }
+        for (const auto& [value, child]: n.children) {
+            if (at_most ? value > features[level] : value < features[level]) {
+                if (at_most) {
+                    break;
+                }
+                continue;
+            }
+            stack.emplace_back(child, level + 1);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<std::uint32_t> feature_index::at_most(const feature_vector& features) const {
+    return find<true>(features);
+}
+
+std::vector<std::uint32_t> feature_index::at_least(const feature_vector& features) const {
+    return find<false>(features);
+}
+
+std::size_t feature_index::size() const {
+    return num_entries;
+}
+
+std::uint32_t subsumption_index::add(statement_ptr stmt) {
+    const auto id = index.insert(statement_features(*stmt));
+    stmts.push_back(std::move(stmt));
+    return id;
+}
+
+void subsumption_index::add_scope(const scope& s) {
+    for (const scope* current = &s; current != nullptr; current = current->parent()) {
+        for (const auto& stmt: current->own_statements()) {
+            (void)add(stmt);
+        }
+    }
+}
+
+void subsumption_index::remove(std::uint32_t id) {
+    index.remove(id);
+}
+
+const statement_ptr& subsumption_index::get(std::uint32_t id) const {
+    return stmts[id];
+}
+
+std::size_t subsumption_index::size() const {
+    return index.size();
+}
+
+std::vector<std::uint32_t> subsumption_index::generalization_candidates(const statement& stmt) const {
+    return index.at_most(statement_features(stmt));
+}
+
+std::vector<std::uint32_t> subsumption_index::instance_candidates(const statement& stmt) const {
+    return index.at_least(statement_features(stmt));
+}
+
+std::vector<std::uint32_t> subsumption_index::generalizations(const statement_ptr& stmt) const {
+    auto candidates = generalization_candidates(*stmt);
+    std::erase_if(candidates, [&](std::uint32_t id) {
+        return !match(*stmts[id], stmt).has_value();
+    });
+    return candidates;
+}
+
+std::vector<std::uint32_t> subsumption_index::instances(const statement& stmt) const {
+    auto candidates = instance_candidates(stmt);
+    std::erase_if(candidates, [&](std::uint32_t id) {
+        return !match(stmt, stmts[id]).has_value();
+    });
+    return candidates;
+}
+
+bool subsumption_index::is_subsumed(const statement_ptr& stmt) const {
+    const auto candidates = generalization_candidates(*stmt);
+    return std::any_of(candidates.begin(), candidates.end(), [&](std::uint32_t id) {
+        return match(*stmts[id], stmt).has_value();
+    });
+}
+
+}  // namespace tema
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "algorithms/term.h"
+#include "core/scope.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// Feature vectors for subsumption indexing. For every symbol (connective, relationship type, binary operation, call,
+// and variable bound by a forall), the number of its occurrences and the depth of its deepest occurrence (1 for the
+// root, 0 when it does not occur). Free variables have no features, because match replaces them: every feature of a
+// law is at most the same feature of any statement that it matches.
+using feature_vector = std::vector<std::uint32_t>;
+
+[[nodiscard]] std::size_t num_features();
+
+[[nodiscard]] feature_vector statement_features(const statement& stmt);
+
+// The same features for a term, with term variables as the free variables and constants as the bound variables.
+[[nodiscard]] feature_vector term_features(const term_bank& bank, term_id term);
+
+// A trie of feature vectors, with one level per feature. Finds the entries whose features are all at most (or at
+// least) the features of a query, visiting only the branches that can still lead to one of them.
+class feature_index {
+    struct trie_node {
+        // (feature value, node index), sorted by feature value.
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> children;
+        // Only for leaves.
+        std::vector<std::uint32_t> entries;
+    };
+
+    std::vector<trie_node> nodes{1};
+    // The leaf of every entry, or removed.
+    std::vector<std::uint32_t> leaves;
+    std::size_t num_entries = 0;
+
+    static constexpr std::uint32_t removed = UINT32_MAX;
+
+    template<bool at_most>
+    [[nodiscard]] std::vector<std::uint32_t> find(const feature_vector& features) const;
+
+public:
+    // All the feature vectors of an index must have the same size. Returns the id of the new entry.
+    std::uint32_t insert(const feature_vector& features);
+
+    void remove(std::uint32_t id);
+
+    // The entries whose features are all at most the given features: the only ones that can subsume an entry with
+    // these features.
+    [[nodiscard]] std::vector<std::uint32_t> at_most(const feature_vector& features) const;
+
+    // The entries whose features are all at least the given features: the only ones that an entry with these features
+    // can subsume.
+    [[nodiscard]] std::vector<std::uint32_t> at_least(const feature_vector& features) const;
+
+    [[nodiscard]] std::size_t size() const;
+};
+
+// Statements indexed for subsumption: a stored statement subsumes a statement when, as a law, it matches it (see
+// match). A forward engine can drop the facts it deduces that are subsumed by the ones it has.
+class subsumption_index {
+    feature_index index;
+    std::vector<statement_ptr> stmts;
+
+public:
+    // Returns the id of the statement in the index.
+    std::uint32_t add(statement_ptr stmt);
+
+    // Adds the statements of the scope and of its parents.
+    void add_scope(const scope& s);
+
+    void remove(std::uint32_t id);
+
+    [[nodiscard]] const statement_ptr& get(std::uint32_t id) const;
+
+    [[nodiscard]] std::size_t size() const;
+
+    // The stored statements that may subsume stmt (or be subsumed by it), before checking with match.
+    [[nodiscard]] std::vector<std::uint32_t> generalization_candidates(const statement& stmt) const;
+    [[nodiscard]] std::vector<std::uint32_t> instance_candidates(const statement& stmt) const;
+
+    // The stored statements that subsume stmt.
+    [[nodiscard]] std::vector<std::uint32_t> generalizations(const statement_ptr& stmt) const;
+
+    // The stored statements that stmt subsumes.
+    [[nodiscard]] std::vector<std::uint32_t> instances(const statement& stmt) const;
+
+    [[nodiscard]] bool is_subsumed(const statement_ptr& stmt) const;
+};
+
+}  // namespace tema
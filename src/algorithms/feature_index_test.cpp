@@ -0,0 +1,139 @@
+#include "algorithms/feature_index.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/match.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.feature_index") {
+    const auto p = var_stmt(var("p"));
+    const auto q = var_stmt(var("q"));
+    const auto r = var_stmt(var("r"));
+    const auto x = var("x");
+    const auto ex = var_expr(x);
+    const auto a = var_expr(var("A"));
+    const auto b = var_expr(var("B"));
+    const auto in = [](const expr_ptr& l, const expr_ptr& r) {
+        return rel_stmt(l, rel_type::in, r);
+    };
+    const auto unite = [](const expr_ptr& l, const expr_ptr& r) {
+        return binop(l, binop_type::set_union, r);
+    };
+
+    group("features", [&] {
+        test("laws have at most the features of the statements they match", [&] {
+            const std::vector<std::pair<statement_ptr, statement_ptr>> pairs = {
+                    {implies(p, q), implies(conj(p, r), neg(q))},
+                    {neg(neg(p)), neg(neg(neg(implies(q, r))))},
+                    {in(ex, a), in(unite(a, b), unite(b, a))},
+                    {forall(x, in(ex, a)), forall(x, in(ex, unite(a, b)))},
+                    {disj(p, in(a, b)), disj(in(ex, b), in(a, b))},
+            };
+            for (const auto& [law, application]: pairs) {
+                expect(match(*law, application).has_value(), isTrue);
+                const auto law_features = statement_features(*law);
+                const auto application_features = statement_features(*application);
+                expect(law_features, hasSize(num_features()));
+                for (std::size_t i = 0; i < num_features(); i++) {
+                    expectMsg(law_features[i] <= application_features[i],
+                              print_utf8(*law) + " vs " + print_utf8(*application) + ", feature " + std::to_string(i));
+                }
+            }
+        });
+
+        test("statement and term features agree", [&] {
+            term_bank bank;
+            const auto stmt = forall(x, implies(in(ex, unite(a, b)), disj(p, neg(truth()))));
+            expect(term_features(bank, bank.from_statement(*stmt, true)), statement_features(*stmt));
+        });
+
+        test("free variables have no features", [&] {
+            expect(statement_features(*p), statement_features(*q));
+            expect(statement_features(*in(a, b)), statement_features(*in(ex, a)));
+            expect(statement_features(*forall(x, in(ex, a))) == statement_features(*forall(x, in(a, b))), isFalse);
+        });
+    });
+
+    group("feature_index", [&] {
+        test("at most and at least", [&] {
+            feature_index index;
+            const auto e1 = index.insert({1, 2, 3});
+            const auto e2 = index.insert({1, 3, 3});
+            const auto e3 = index.insert({0, 2, 4});
+            const auto e4 = index.insert({1, 2, 3});
+            expect(index.size(), 4U);
+            expect(index.at_most({1, 2, 3}), std::vector{e1, e4});
+            expect(index.at_most({1, 3, 4}), std::vector{e1, e2, e3, e4});
+            expect(index.at_most({0, 9, 9}), std::vector{e3});
+            expect(index.at_least({1, 2, 3}), std::vector{e1, e2, e4});
+            expect(index.at_least({0, 0, 4}), std::vector{e3});
+            expect(index.at_least({2, 0, 0}), isEmpty);
+
+            index.remove(e1);
+            index.remove(e1);
+            expect(index.size(), 3U);
+            expect(index.at_most({1, 2, 3}), std::vector{e4});
+        });
+    });
+
+    group("subsumption_index", [&] {
+        test("generalizations and instances", [&] {
+            subsumption_index index;
+            const auto modus_ponens = index.add(implies(conj(p, implies(p, q)), q));
+            const auto membership = index.add(in(ex, unite(a, b)));
+            const auto double_negation = index.add(neg(neg(p)));
+
+            const auto instance = implies(conj(in(ex, a), implies(in(ex, a), r)), r);
+            expect(index.generalizations(instance), std::vector{modus_ponens});
+            expect(index.is_subsumed(instance), isTrue);
+            expect(index.is_subsumed(implies(conj(p, implies(q, q)), q)), isFalse);
+            expect(index.generalizations(in(a, unite(b, unite(a, b)))), std::vector{membership});
+            expect(index.instances(*neg(p)), std::vector{double_negation});
+            expect(index.instances(*in(ex, a)), std::vector{membership});
+        });
+
+        test("few candidates", [&] {
+            subsumption_index index;
+            std::vector<statement_ptr> stmts;
+            for (int type = 0; type < 20; type++) {
+                auto stmt = rel_stmt(a, static_cast<rel_type>(type), b);
+                for (int depth = 0; depth < 5; depth++) {
+                    stmts.push_back(stmt);
+                    stmt = neg(stmt);
+                }
+            }
+            for (const auto& stmt: stmts) {
+                (void)index.add(stmt);
+            }
+            expect(index.size(), stmts.size());
+            std::size_t num_candidates = 0;
+            for (const auto& stmt: stmts) {
+                num_candidates += index.generalization_candidates(*stmt).size();
+                expect(index.generalizations(stmt), hasSize(1));
+            }
+            // Only the statements with the same relationship, and at most as many negations. A full scan would check
+            // all of them for every statement.
+            expect(num_candidates, 20U * (1 + 2 + 3 + 4 + 5));
+        });
+
+        test("scopes", [&] {
+            scope parent;
+            parent.add_statement(implies(p, q));
+            scope child(&parent);
+            child.add_statement(in(ex, a));
+            subsumption_index index;
+            index.add_scope(child);
+            expect(index.size(), 2U);
+            expect(index.is_subsumed(implies(in(a, b), in(b, a))), isTrue);
+            expect(index.is_subsumed(in(unite(a, b), b)), isTrue);
+
+            index.remove(0);
+            expect(index.is_subsumed(in(unite(a, b), b)), isFalse);
+            expect(index.size(), 1U);
+        });
+    });
+}
@@ -0,0 +1,249 @@
+#include "algorithms/fingerprint.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tema {
+
+namespace {
+
+using u64x1 = std::uint64_t __attribute__((vector_size(8)));
+using u64x4 = std::uint64_t __attribute__((vector_size(32)));
+using u64x8 = std::uint64_t __attribute__((vector_size(64)));
+
+constexpr std::uint8_t wildcard = 0xFF;
+
+constexpr std::uint8_t truth_code = 1;
+constexpr std::uint8_t contradiction_code = 2;
+constexpr std::uint8_t neg_code = 3;
+constexpr std::uint8_t implies_code = 4;
+constexpr std::uint8_t equiv_code = 5;
+constexpr std::uint8_t conj_code = 6;
+constexpr std::uint8_t disj_code = 7;
+constexpr std::uint8_t forall_code = 8;
+constexpr std::uint8_t stmt_var_code = 9;
+constexpr std::uint8_t first_rel_code = 16;
+constexpr std::uint8_t expr_var_code = 40;
+constexpr std::uint8_t call_code = 41;
+constexpr std::uint8_t first_binop_code = 48;
+
+constexpr std::size_t num_positions = 7;
+constexpr std::size_t arity_byte = 7;
+
+// The position of the child of a position: the root is 0, its children 1 and 2, their children 3, 4 and 5, 6.
+std::optional<std::size_t> child_position(std::size_t position, std::size_t child) {
+    if (child >= 2) {
+        return std::nullopt;
+    }
+    if (position == 0) {
+        return 1 + child;
+    }
+    if (position <= 2) {
+        return 3 + 2 * (position - 1) + child;
+    }
+    return std::nullopt;
+}
+
+struct fingerprint_builder {
+    bool is_law;
+    std::uint8_t bytes[8] = {};
+    std::vector<const variable*> bound{};
+
+    void set_wildcard(std::size_t position) {  // NOLINT(misc-no-recursion)
+        bytes[position] = wildcard;
+        for (std::size_t child = 0; child < 2; child++) {
+            if (const auto child_pos = child_position(position, child); child_pos.has_value()) {
+                set_wildcard(*child_pos);
+            }
+        }
+    }
+
+    [[nodiscard]] bool is_free(const variable_ptr& var) const {
+        return std::find(bound.begin(), bound.end(), var.get()) == bound.end();
+    }
+
+    void set_arity(std::size_t position, std::size_t arity) {
+        if (position == 0) {
+            bytes[arity_byte] = static_cast<std::uint8_t>(std::min<std::size_t>(arity, wildcard - 1));
+        }
+    }
+
+    void add(const expression& expr, std::size_t position) {  // NOLINT(misc-no-recursion)
+        if (expr.is_var()) {
+            if (is_law && is_free(expr.as_var())) {
+                set_wildcard(position);
+                if (position == 0) {
+                    bytes[arity_byte] = wildcard;
+                }
+            } else {
+                bytes[position] = expr_var_code;
+            }
+        } else if (expr.is_binop()) {
+            const auto& [type, left, right] = expr.as_binop();
+            bytes[position] = static_cast<std::uint8_t>(first_binop_code + static_cast<std::uint8_t>(type));
+            set_arity(position, 2);
+            add_child(*left, position, 0);
+            add_child(*right, position, 1);
+        } else {
+            const auto& [callee, params] = expr.as_call();
+            bytes[position] = call_code;
+            set_arity(position, 1 + params.size());
+            add_child(*callee, position, 0);
+            if (!params.empty()) {
+                add_child(*params[0], position, 1);
+            }
+        }
+    }
+
+    void add(const statement& stmt, std::size_t position) {  // NOLINT(misc-no-recursion)
+        if (stmt.is_truth()) {
+            bytes[position] = truth_code;
+        } else if (stmt.is_contradiction()) {
+            bytes[position] = contradiction_code;
+        } else if (stmt.is_var()) {
+            if (is_law && is_free(stmt.as_var())) {
+                set_wildcard(position);
+                if (position == 0) {
+                    bytes[arity_byte] = wildcard;
+                }
+            } else {
+                bytes[position] = stmt_var_code;
+            }
+        } else if (stmt.is_neg()) {
+            bytes[position] = neg_code;
+            set_arity(position, 1);
+            add_child(*stmt.as_neg().inner, position, 0);
+        } else if (stmt.is_implies()) {
+            bytes[position] = implies_code;
+            set_arity(position, 2);
+            add_child(*stmt.as_implies().from, position, 0);
+            add_child(*stmt.as_implies().to, position, 1);
+        } else if (stmt.is_equiv()) {
+            bytes[position] = equiv_code;
+            set_arity(position, 2);
+            add_child(*stmt.as_equiv().left, position, 0);
+            add_child(*stmt.as_equiv().right, position, 1);
+        } else if (stmt.is_conj() || stmt.is_disj()) {
+            const auto& children = stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner;
+            bytes[position] = stmt.is_conj() ? conj_code : disj_code;
+            set_arity(position, children.size());
+            for (std::size_t i = 0; i < children.size() && i < 2; i++) {
+                add_child(*children[i], position, i);
+            }
+        } else if (stmt.is_forall()) {
+            bytes[position] = forall_code;
+            set_arity(position, 1);
+            bound.push_back(stmt.as_forall().var.get());
+            add_child(*stmt.as_forall().inner, position, 0);
+            bound.pop_back();
+        } else {
+            const auto& [type, left, right] = stmt.as_rel();
+            bytes[position] = static_cast<std::uint8_t>(first_rel_code + static_cast<std::uint8_t>(type));
+            set_arity(position, 2);
+            add_child(*left, position, 0);
+            add_child(*right, position, 1);
+        }
+    }
+
+    void add_child(const mcga::meta::one_of<statement, expression> auto& child,  // NOLINT(misc-no-recursion)
+                   std::size_t position,
+                   std::size_t index) {
+        if (const auto child_pos = child_position(position, index); child_pos.has_value()) {
+            add(child, *child_pos);
+        }
+    }
+
+    [[nodiscard]] fingerprint value() const {
+        fingerprint result = 0;
+        for (std::size_t i = 0; i <= num_positions; i++) {
+            result |= fingerprint{bytes[i]} << (8 * i);
+        }
+        return result;
+    }
+};
+
+template<class V>
+void filter(const pattern_fingerprint& law,
+            std::span<const fingerprint> fingerprints,
+            std::vector<std::uint32_t>& out) {
+    constexpr std::size_t lanes = sizeof(V) / sizeof(std::uint64_t);
+    V value;
+    V mask;
+    for (std::size_t lane = 0; lane < lanes; lane++) {
+        value[lane] = law.value;
+        mask[lane] = law.mask;
+    }
+    std::size_t i = 0;
+    for (; i + lanes <= fingerprints.size(); i += lanes) {
+        V block;
+        std::memcpy(&block, fingerprints.data() + i, sizeof(V));
+        const V mismatch = (block ^ value) & mask;
+        for (std::size_t lane = 0; lane < lanes; lane++) {
+            if (mismatch[lane] == 0) {
+                out.push_back(static_cast<std::uint32_t>(i + lane));
+            }
+        }
+    }
+    for (; i < fingerprints.size(); i++) {
+        if (may_match(law, fingerprints[i])) {
+            out.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+void filter_scalar(const pattern_fingerprint& law, std::span<const fingerprint> fingerprints, std::vector<std::uint32_t>& out) {
+    filter<u64x1>(law, fingerprints, out);
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) void filter_avx2(const pattern_fingerprint& law,
+                                                 std::span<const fingerprint> fingerprints,
+                                                 std::vector<std::uint32_t>& out) {
+    filter<u64x4>(law, fingerprints, out);
+}
+
+__attribute__((target("avx512f"))) void filter_avx512(const pattern_fingerprint& law,
+                                                      std::span<const fingerprint> fingerprints,
+                                                      std::vector<std::uint32_t>& out) {
+    filter<u64x8>(law, fingerprints, out);
+}
+#endif
+
+}  // namespace
+
+fingerprint statement_fingerprint(const statement& stmt) {
+    fingerprint_builder builder{.is_law = false};
+    builder.add(stmt, 0);
+    return builder.value();
+}
+
+pattern_fingerprint law_fingerprint(const statement& law) {
+    fingerprint_builder builder{.is_law = true};
+    builder.add(law, 0);
+    fingerprint value = 0;
+    fingerprint mask = 0;
+    for (std::size_t i = 0; i <= num_positions; i++) {
+        if (builder.bytes[i] != wildcard) {
+            value |= fingerprint{builder.bytes[i]} << (8 * i);
+            mask |= fingerprint{0xFF} << (8 * i);
+        }
+    }
+    return {value, mask};
+}
+
+void filter_may_match(const pattern_fingerprint& law,
+                      std::span<const fingerprint> fingerprints,
+                      std::vector<std::uint32_t>& out,
+                      std::optional<simd_level> simd) {
+#if defined(__x86_64__)
+    switch (std::min(simd.value_or(detected_simd_level()), detected_simd_level())) {
+        case simd_level::avx512: filter_avx512(law, fingerprints, out); return;
+        case simd_level::avx2: filter_avx2(law, fingerprints, out); return;
+        case simd_level::scalar: break;
+    }
+#endif
+    (void)simd;
+    filter_scalar(law, fingerprints, out);
+}
+
+}  // namespace tema
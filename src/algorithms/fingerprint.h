@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "algorithms/truth_table.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// A compact summary of the symbols at fixed positions of a statement, to rule out most failing matches without
+// calling match. Each byte holds the symbol at one position: the root, its first two children, and their first two
+// children (the tag of the connective, the rel_type of relationships, the binop_type of binary operations, or just
+// "variable"), with 0 for positions that do not exist. The last byte is the number of children of the root.
+using fingerprint = std::uint64_t;
+
+[[nodiscard]] fingerprint statement_fingerprint(const statement& stmt);
+
+// The fingerprint of a law, used as the pattern of match. The positions at or below a free variable of the law can
+// hold anything in the statements it matches, so they are not compared.
+struct pattern_fingerprint {
+    fingerprint value;
+    // All ones in the bytes that are compared.
+    fingerprint mask;
+};
+
+[[nodiscard]] pattern_fingerprint law_fingerprint(const statement& law);
+
+// False when match(law, stmt) certainly fails. True does not mean that it succeeds.
+[[nodiscard]] inline bool may_match(const pattern_fingerprint& law, fingerprint stmt) {
+    return ((stmt ^ law.value) & law.mask) == 0;
+}
+
+// Appends to out the indices of the fingerprints that may be matched by the law, in increasing order. The
+// fingerprints are compared several at a time with the given SIMD level (defaults to detected_simd_level()).
+void filter_may_match(const pattern_fingerprint& law,
+                      std::span<const fingerprint> fingerprints,
+                      std::vector<std::uint32_t>& out,
+                      std::optional<simd_level> simd = std::nullopt);
+
+}  // namespace tema
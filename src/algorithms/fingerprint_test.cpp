@@ -0,0 +1,121 @@
+#include "algorithms/fingerprint.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/match.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.fingerprint") {
+    const auto p = var_stmt(var("p"));
+    const auto q = var_stmt(var("q"));
+    const auto x = var("x");
+    const auto ex = var_expr(x);
+    const auto a = var_expr(var("A"));
+    const auto b = var_expr(var("B"));
+    const auto f = var_expr(var("f"));
+    const auto in = [](const expr_ptr& l, const expr_ptr& r) {
+        return rel_stmt(l, rel_type::in, r);
+    };
+    const auto unite = [](const expr_ptr& l, const expr_ptr& r) {
+        return binop(l, binop_type::set_union, r);
+    };
+    const auto intersect = [](const expr_ptr& l, const expr_ptr& r) {
+        return binop(l, binop_type::set_intersection, r);
+    };
+
+    const std::vector<statement_ptr> stmts = {
+            p,
+            neg(p),
+            neg(neg(p)),
+            neg(neg(neg(q))),
+            implies(p, q),
+            implies(neg(p), q),
+            implies(conj(p, q), p),
+            equiv(p, neg(q)),
+            conj(p, q),
+            conj(p, q, neg(p)),
+            disj(p, q),
+            in(ex, a),
+            in(a, b),
+            in(ex, unite(a, b)),
+            in(ex, intersect(a, b)),
+            in(unite(a, b), intersect(a, b)),
+            rel_stmt(ex, rel_type::n_in, a),
+            rel_stmt(a, rel_type::eq, call(f, {a, b})),
+            rel_stmt(a, rel_type::eq, call(f, {b})),
+            forall(x, in(ex, a)),
+            forall(x, implies(in(ex, a), in(ex, b))),
+            truth(),
+            contradiction(),
+            neg(truth()),
+    };
+
+    test("every successful match passes the filter", [&] {
+        std::size_t num_matches = 0;
+        std::size_t num_filtered = 0;
+        for (const auto& law: stmts) {
+            const auto law_fp = law_fingerprint(*law);
+            for (const auto& stmt: stmts) {
+                const auto matched = match(*law, stmt).has_value();
+                const auto passed = may_match(law_fp, statement_fingerprint(*stmt));
+                expectMsg(!matched || passed, print_utf8(*law) + " matches " + print_utf8(*stmt));
+                num_matches += matched ? 1 : 0;
+                num_filtered += passed ? 0 : 1;
+            }
+        }
+        // Most of the failing matches are filtered out.
+        expect(num_filtered * 10, isGreaterThan((stmts.size() * stmts.size() - num_matches) * 9));
+    });
+
+    test("positions under free variables are not compared", [&] {
+        expect(law_fingerprint(*p).mask, 0U);
+        const auto law = law_fingerprint(*neg(p));
+        // The root, the root's arity, and the positions that do not exist below it.
+        expect(law.mask, 0xFFFFFF0000FF00FFU);
+        expect(may_match(law, statement_fingerprint(*neg(conj(p, q)))), isTrue);
+        expect(may_match(law, statement_fingerprint(*neg(in(a, b)))), isTrue);
+        expect(may_match(law, statement_fingerprint(*conj(p, q))), isFalse);
+    });
+
+    test("relationship and binop types", [&] {
+        const auto law = law_fingerprint(*in(ex, unite(a, b)));
+        expect(may_match(law, statement_fingerprint(*in(a, unite(b, a)))), isTrue);
+        expect(may_match(law, statement_fingerprint(*in(a, intersect(b, a)))), isFalse);
+        expect(may_match(law, statement_fingerprint(*rel_stmt(a, rel_type::n_in, unite(b, a)))), isFalse);
+        expect(may_match(law, statement_fingerprint(*in(a, b))), isFalse);
+    });
+
+    test("bound variables only match variables", [&] {
+        const auto y = var("y");
+        const auto law = law_fingerprint(*forall(x, in(ex, a)));
+        expect(may_match(law, statement_fingerprint(*forall(y, in(var_expr(y), b)))), isTrue);
+        expect(may_match(law, statement_fingerprint(*forall(y, in(unite(a, b), b)))), isFalse);
+    });
+
+    test("filtering with every SIMD level", [&] {
+        std::vector<fingerprint> fingerprints;
+        for (int i = 0; i < 3; i++) {
+            for (const auto& stmt: stmts) {
+                fingerprints.push_back(statement_fingerprint(*stmt));
+            }
+        }
+        for (const auto& law: stmts) {
+            const auto law_fp = law_fingerprint(*law);
+            std::vector<std::uint32_t> expected;
+            for (std::size_t i = 0; i < fingerprints.size(); i++) {
+                if (may_match(law_fp, fingerprints[i])) {
+                    expected.push_back(static_cast<std::uint32_t>(i));
+                }
+            }
+            for (const auto level: {simd_level::scalar, simd_level::avx2, simd_level::avx512}) {
+                std::vector<std::uint32_t> filtered;
+                filter_may_match(law_fp, fingerprints, filtered, level);
+                expect(filtered, expected);
+            }
+        }
+    });
+}
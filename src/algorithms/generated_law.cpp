@@ -0,0 +1,17 @@
+#include "algorithms/generated_law.h"
+
+#include <algorithm>
+
+namespace tema {
+
+const generated_law* find_generated_law(std::span<const generated_law> laws, std::string_view name) {
+    const auto it = std::lower_bound(laws.begin(), laws.end(), name, [](const generated_law& law, std::string_view n) {
+        return law.name < n;
+    });
+    if (it == laws.end() || it->name != name) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+}  // namespace tema
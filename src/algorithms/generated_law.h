@@ -0,0 +1,25 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "core/statement.h"
+
+namespace tema {
+
+// A law of a module compiled ahead of time into C++ (see AddTemaGeneratedMatchers in cmake/Tema.cmake).
+struct generated_law {
+    std::string_view name;
+    // Equivalent to mp_deduce(law, application), specialized for the law, with one difference: the variables of the
+    // conclusion that are not bound by matching the premise (e.g. q in ¬p→(p→q)) are not the variables of the parsed
+    // module, but variables of the generated code with the same names. They are created once per generated source, so
+    // every result of the laws of a module shares them. The result is therefore equal to the one of mp_deduce only up
+    // to renaming these variables.
+    std::optional<statement_ptr> (*deduce)(const statement_ptr& application);
+};
+
+// The law with the given name, or nullptr. The laws must be sorted by name, as the generated registries are.
+[[nodiscard]] const generated_law* find_generated_law(std::span<const generated_law> laws, std::string_view name);
+
+}  // namespace tema
@@ -0,0 +1,43 @@
+#include "algorithms/generated_law.h"
+
+#include <vector>
+
+#include <mcga/test_ext/matchers.hpp>
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+namespace {
+
+std::optional<statement_ptr> deduce_truth(const statement_ptr&) {
+    return truth();
+}
+
+std::optional<statement_ptr> deduce_nothing(const statement_ptr&) {
+    return std::nullopt;
+}
+
+}  // namespace
+
+TEST_CASE("algorithms.generated_law") {
+    const std::vector<generated_law> laws = {
+            {"a", deduce_nothing},
+            {"b", deduce_truth},
+            {"d", deduce_nothing},
+    };
+
+    test("finds laws by name", [&] {
+        const auto* law = find_generated_law(laws, "b");
+        expect(law != nullptr, isTrue);
+        expect(law->deduce(contradiction()).has_value(), isTrue);
+        expect(find_generated_law(laws, "a") == &laws[0], isTrue);
+        expect(find_generated_law(laws, "d") == &laws[2], isTrue);
+    });
+
+    test("unknown names give nullptr", [&] {
+        expect(find_generated_law(laws, "c") == nullptr, isTrue);
+        expect(find_generated_law(laws, "e") == nullptr, isTrue);
+        expect(find_generated_law({}, "a") == nullptr, isTrue);
+    });
+}
@@ -0,0 +1,117 @@
+#include "algorithms/hash.h"
+
+#include <functional>
+#include <vector>
+
+#include "algorithms/equals.h"
+
+namespace tema {
+
+namespace {
+
+constexpr std::size_t hash_seed = 0x9e3779b97f4a7c15ULL;
+
+std::size_t combine(std::size_t seed, std::size_t value) {
+    return seed ^ (value + hash_seed + (seed << 6U) + (seed >> 2U));
+}
+
+struct hash_visitor {
+    // Variables bound by the enclosing forall statements, innermost last. Bound variables are hashed by their
+    // position in this stack rather than by identity, so the hash does not depend on their names.
+    std::vector<const variable*> bound_vars;
+
+    std::size_t hash_var(const variable* var, std::size_t tag) const {
+        for (auto it = bound_vars.rbegin(); it != bound_vars.rend(); it++) {
+            if (*it == var) {
+                return combine(tag, static_cast<std::size_t>(it - bound_vars.rbegin()));
+            }
+        }
+        return combine(tag + 1, std::hash<const variable*>{}(var));
+    }
+
+    std::size_t hash_children(std::size_t seed, const std::vector<statement_ptr>& children) {
+        for (const auto& child: children) {
+            seed = combine(seed, child->accept_r<std::size_t>(*this));
+        }
+        return seed;
+    }
+
+    std::size_t operator()(const statement::truth&) const {
+        return 1;
+    }
+    std::size_t operator()(const statement::contradiction&) const {
+        return 2;
+    }
+    std::size_t operator()(const statement::implies& stmt) {
+        return combine(combine(3, stmt.from->accept_r<std::size_t>(*this)), stmt.to->accept_r<std::size_t>(*this));
+    }
+    std::size_t operator()(const statement::equiv& stmt) {
+        return combine(combine(4, stmt.left->accept_r<std::size_t>(*this)), stmt.right->accept_r<std::size_t>(*this));
+    }
+    std::size_t operator()(const statement::neg& stmt) {
+        return combine(5, stmt.inner->accept_r<std::size_t>(*this));
+    }
+    std::size_t operator()(const statement::conj& stmt) {
+        return hash_children(6, stmt.inner);
+    }
+    std::size_t operator()(const statement::disj& stmt) {
+        return hash_children(7, stmt.inner);
+    }
+    std::size_t operator()(const statement::forall& stmt) {
+        bound_vars.push_back(stmt.var.get());
+        const auto inner = stmt.inner->accept_r<std::size_t>(*this);
+        bound_vars.pop_back();
+        return combine(8, inner);
+    }
+    std::size_t operator()(const statement::var_stmt& stmt) const {
+        return hash_var(stmt.var.get(), 9);
+    }
+    std::size_t operator()(const relationship& rel) {
+        const auto seed = combine(11, static_cast<std::size_t>(rel.type));
+        return combine(combine(seed, rel.left->accept_r<std::size_t>(*this)), rel.right->accept_r<std::size_t>(*this));
+    }
+    std::size_t operator()(const variable_ptr& var) const {
+        return hash_var(var.get(), 12);
+    }
+    std::size_t operator()(const expression::binop& expr) {
+        const auto seed = combine(14, static_cast<std::size_t>(expr.type));
+        return combine(combine(seed, expr.left->accept_r<std::size_t>(*this)), expr.right->accept_r<std::size_t>(*this));
+    }
+    std::size_t operator()(const expression::call& expr) {
+        auto seed = combine(15, expr.callee->accept_r<std::size_t>(*this));
+        for (const auto& param: expr.params) {
+            seed = combine(seed, param->accept_r<std::size_t>(*this));
+        }
+        return seed;
+    }
+};
+
+}  // namespace
+
+std::size_t hash(const expression& expr) {
+    hash_visitor visitor;
+    return expr.accept_r<std::size_t>(visitor);
+}
+
+std::size_t hash(const statement& stmt) {
+    hash_visitor visitor;
+    return stmt.accept_r<std::size_t>(visitor);
+}
+
+std::size_t structural_hash::operator()(const statement_ptr& stmt) const {
+    return hash(*stmt);
+}
+
+std::size_t structural_hash::operator()(const expr_ptr& expr) const {
+    return hash(*expr);
+}
+
+bool structural_equal::operator()(const statement_ptr& a, const statement_ptr& b) const {
+    return equals(*a, *b);
+}
+
+bool structural_equal::operator()(const expr_ptr& a, const expr_ptr& b) const {
+    return equals(*a, *b);
+}
+
+}  // namespace tema
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+#include "core/statement.h"
+
+namespace tema {
+
+// Structural hash, consistent with equals: statements that are equal (including up to renaming of forall-bound
+// variables) have the same hash.
+[[nodiscard]] std::size_t hash(const expression& expr);
+[[nodiscard]] std::size_t hash(const statement& stmt);
+
+// Hash and equality functors for using statements and expressions as keys of unordered containers, by structure
+// instead of by pointer.
+struct structural_hash {
+    [[nodiscard]] std::size_t operator()(const statement_ptr& stmt) const;
+    [[nodiscard]] std::size_t operator()(const expr_ptr& expr) const;
+};
+
+struct structural_equal {
+    [[nodiscard]] bool operator()(const statement_ptr& a, const statement_ptr& b) const;
+    [[nodiscard]] bool operator()(const expr_ptr& a, const expr_ptr& b) const;
+};
+
+}  // namespace tema
@@ -0,0 +1,75 @@
+#include "algorithms/hash.h"
+
+#include <unordered_set>
+
+#include <mcga/test_ext/matchers.hpp>
+
+using namespace tema;
+using namespace mcga::matchers;
+
+TEST_CASE("algorithms.hash") {
+    const auto x = var("X");
+    const auto y = var("Y");
+    const auto z = var("Z");
+
+    test("equal statements have equal hashes", [&] {
+        const auto make = [&] {
+            return implies(conj(var_stmt(x), neg(var_stmt(y))),
+                           rel_stmt(binop(var_expr(x), binop_type::set_union, var_expr(y)), rel_type::in, call(var_expr(z), {var_expr(x)})));
+        };
+        expect(hash(*make()), hash(*make()));
+        expect(hash(*truth()), hash(*truth()));
+    });
+
+    test("renamed forall-bound variables", [&] {
+        expect(hash(*forall(x, implies(var_stmt(x), var_stmt(z)))), hash(*forall(y, implies(var_stmt(y), var_stmt(z)))));
+        expect(hash(*forall(x, forall(y, rel_stmt(var_expr(x), rel_type::eq, var_expr(y))))),
+               hash(*forall(y, forall(x, rel_stmt(var_expr(y), rel_type::eq, var_expr(x))))));
+    });
+
+    test("different statements have (usually) different hashes", [&] {
+        const std::vector<statement_ptr> stmts{
+                truth(),
+                contradiction(),
+                var_stmt(x),
+                var_stmt(y),
+                neg(var_stmt(x)),
+                conj(var_stmt(x), var_stmt(y)),
+                conj(var_stmt(y), var_stmt(x)),
+                disj(var_stmt(x), var_stmt(y)),
+                implies(var_stmt(x), var_stmt(y)),
+                equiv(var_stmt(x), var_stmt(y)),
+                forall(x, var_stmt(x)),
+                forall(x, var_stmt(y)),
+                rel_stmt(var_expr(x), rel_type::eq, var_expr(y)),
+                rel_stmt(var_expr(x), rel_type::n_eq, var_expr(y)),
+                rel_stmt(var_expr(y), rel_type::eq, var_expr(x)),
+        };
+        std::unordered_set<std::size_t> hashes;
+        for (const auto& stmt: stmts) {
+            hashes.insert(hash(*stmt));
+        }
+        expect(hashes, hasSize(stmts.size()));
+    });
+
+    test("expressions", [&] {
+        expect(hash(*binop(var_expr(x), binop_type::set_union, var_expr(y))), hash(*binop(var_expr(x), binop_type::set_union, var_expr(y))));
+        expect(hash(*binop(var_expr(x), binop_type::set_union, var_expr(y))) != hash(*binop(var_expr(x), binop_type::set_intersection, var_expr(y))), isTrue);
+        expect(hash(*call(var_expr(z), {var_expr(x)})) != hash(*call(var_expr(z), {var_expr(y)})), isTrue);
+    });
+
+    test("unordered containers", [&] {
+        std::unordered_set<statement_ptr, structural_hash, structural_equal> stmts;
+        stmts.insert(conj(var_stmt(x), var_stmt(y)));
+        stmts.insert(conj(var_stmt(x), var_stmt(y)));
+        stmts.insert(forall(x, var_stmt(x)));
+        stmts.insert(forall(y, var_stmt(y)));
+        expect(stmts, hasSize(2));
+
+        std::unordered_set<expr_ptr, structural_hash, structural_equal> exprs;
+        exprs.insert(var_expr(x));
+        exprs.insert(var_expr(x));
+        exprs.insert(var_expr(y));
+        expect(exprs, hasSize(2));
+    });
+}
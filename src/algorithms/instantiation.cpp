@@ -0,0 +1,384 @@
+#include "algorithms/instantiation.h"
+
+#include <algorithm>
+
+#include "algorithms/apply_vars.h"
+
+namespace tema {
+
+namespace {
+
+void collect_vars(const expression& expr, std::set<variable_ptr>& vars) {  // NOLINT(misc-no-recursion)
+    if (expr.is_var()) {
+        vars.insert(expr.as_var());
+    } else if (expr.is_binop()) {
+        collect_vars(*expr.as_binop().left, vars);
+        collect_vars(*expr.as_binop().right, vars);
+    } else {
+        collect_vars(*expr.as_call().callee, vars);
+        for (const auto& param: expr.as_call().params) {
+            collect_vars(*param, vars);
+        }
+    }
+}
+
+std::set<variable_ptr> pattern_vars(const trigger_pattern& pattern) {
+    std::set<variable_ptr> vars;
+    if (pattern.rel != nullptr) {
+        collect_vars(*pattern.rel->as_rel().left, vars);
+        collect_vars(*pattern.rel->as_rel().right, vars);
+    } else {
+        collect_vars(*pattern.expr, vars);
+    }
+    return vars;
+}
+
+std::size_t expr_size(const expression& expr) {  // NOLINT(misc-no-recursion)
+    if (expr.is_var()) {
+        return 1;
+    }
+    if (expr.is_binop()) {
+        return 1 + expr_size(*expr.as_binop().left) + expr_size(*expr.as_binop().right);
+    }
+    std::size_t size = 1 + expr_size(*expr.as_call().callee);
+    for (const auto& param: expr.as_call().params) {
+        size += expr_size(*param);
+    }
+    return size;
+}
+
+bool intersects(const std::set<variable_ptr>& vars, const std::set<variable_ptr>& other) {
+    return std::any_of(vars.begin(), vars.end(), [&](const variable_ptr& var) {
+        return other.contains(var);
+    });
+}
+
+struct trigger_candidate {
+    trigger_pattern pattern;
+    std::set<variable_ptr> covered;
+    std::size_t size;
+};
+
+class trigger_collector {
+    const std::set<variable_ptr>& vars;
+    // Variables bound by foralls nested in the body.
+    std::set<variable_ptr> nested;
+
+    void consider(trigger_pattern pattern, std::size_t size) {
+        const auto used = pattern_vars(pattern);
+        if (intersects(used, nested)) {
+            return;
+        }
+        std::set<variable_ptr> covered;
+        std::set_intersection(used.begin(), used.end(), vars.begin(), vars.end(), std::inserter(covered, covered.end()));
+        if (!covered.empty()) {
+            candidates.push_back(trigger_candidate{std::move(pattern), std::move(covered), size});
+        }
+    }
+
+public:
+    std::vector<trigger_candidate> candidates;
+
+    explicit trigger_collector(const std::set<variable_ptr>& vars)
+        : vars(vars) {}
+
+    void collect(const expr_ptr& expr) {  // NOLINT(misc-no-recursion)
+        if (expr->is_var()) {
+            return;
+        }
+        consider(trigger_pattern{nullptr, expr}, expr_size(*expr));
+        if (expr->is_binop()) {
+            collect(expr->as_binop().left);
+            collect(expr->as_binop().right);
+        } else {
+            collect(expr->as_call().callee);
+            for (const auto& param: expr->as_call().params) {
+                collect(param);
+            }
+        }
+    }
+
+    void collect(const statement_ptr& stmt) {  // NOLINT(misc-no-recursion)
+        if (stmt->is_rel()) {
+            const auto& [type, left, right] = stmt->as_rel();
+            consider(trigger_pattern{stmt, nullptr}, 1 + expr_size(*left) + expr_size(*right));
+            collect(left);
+            collect(right);
+        } else if (stmt->is_neg()) {
+            collect(stmt->as_neg().inner);
+        } else if (stmt->is_implies()) {
+            collect(stmt->as_implies().from);
+            collect(stmt->as_implies().to);
+        } else if (stmt->is_equiv()) {
+            collect(stmt->as_equiv().left);
+            collect(stmt->as_equiv().right);
+        } else if (stmt->is_conj() || stmt->is_disj()) {
+            for (const auto& child: stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner) {
+                collect(child);
+            }
+        } else if (stmt->is_forall()) {
+            const auto inserted = nested.insert(stmt->as_forall().var).second;
+            collect(stmt->as_forall().inner);
+            if (inserted) {
+                nested.erase(stmt->as_forall().var);
+            }
+        }
+    }
+};
+
+std::pair<std::vector<variable_ptr>, statement_ptr> strip_foralls(const statement_ptr& quantified) {
+    std::vector<variable_ptr> vars;
+    statement_ptr body = quantified;
+    while (body->is_forall()) {
+        vars.push_back(body->as_forall().var);
+        body = body->as_forall().inner;
+    }
+    return {std::move(vars), std::move(body)};
+}
+
+}  // namespace
+
+std::vector<trigger_pattern> select_triggers(const statement_ptr& quantified) {
+    const auto [var_list, body] = strip_foralls(quantified);
+    const std::set<variable_ptr> vars(var_list.begin(), var_list.end());
+    trigger_collector collector(vars);
+    collector.collect(body);
+    auto& candidates = collector.candidates;
+
+    // The smallest single pattern with all the variables.
+    const trigger_candidate* best = nullptr;
+    for (const auto& candidate: candidates) {
+        if (candidate.covered.size() == vars.size() && (best == nullptr || candidate.size < best->size)) {
+            best = &candidate;
+        }
+    }
+    if (best != nullptr) {
+        return {best->pattern};
+    }
+
+    // Otherwise, greedily pick the patterns with the most uncovered variables.
+    std::vector<trigger_pattern> triggers;
+    std::set<variable_ptr> uncovered = vars;
+    while (!uncovered.empty()) {
+        best = nullptr;
+        std::size_t best_count = 0;
+        for (const auto& candidate: candidates) {
+            const auto count = static_cast<std::size_t>(std::count_if(candidate.covered.begin(), candidate.covered.end(), [&](const variable_ptr& var) {
+                return uncovered.contains(var);
+            }));
+            if (count > best_count || (count == best_count && count > 0 && candidate.size < best->size)) {
+                best = &candidate;
+                best_count = count;
+            }
+        }
+        if (best == nullptr) {
+            return {};
+        }
+        for (const auto& var: best->covered) {
+            uncovered.erase(var);
+        }
+        triggers.push_back(best->pattern);
+    }
+    return triggers;
+}
+
+quantifier_instantiator::quantifier_instantiator(instantiation_options options)
+    : options(options) {}
+
+void quantifier_instantiator::add_fact(const statement_ptr& fact) {
+    add_fact(fact, 0);
+}
+
+void quantifier_instantiator::add_scope(const scope& s) {
+    for (const scope* current = &s; current != nullptr; current = current->parent()) {
+        for (const auto& stmt: current->own_statements()) {
+            add_fact(stmt);
+        }
+    }
+}
+
+void quantifier_instantiator::add_fact(const statement_ptr& fact, std::size_t generation) {
+    std::set<variable_ptr> bound;
+    add_terms(fact, generation, bound);
+    add_quantifiers(fact, generation);
+}
+
+void quantifier_instantiator::add_quantifiers(const statement_ptr& fact, std::size_t generation) {  // NOLINT(misc-no-recursion)
+    if (fact->is_conj()) {
+        for (const auto& child: fact->as_conj().inner) {
+            add_quantifiers(child, generation);
+        }
+        return;
+    }
+    if (!fact->is_forall()) {
+        return;
+    }
+    auto [vars, body] = strip_foralls(fact);
+    auto triggers = select_triggers(fact);
+    match_result fixed_vars;
+    for (const auto& trigger: triggers) {
+        for (const auto& var: pattern_vars(trigger)) {
+            if (std::find(vars.begin(), vars.end(), var) == vars.end()) {
+                fixed_vars.expr_replacements.emplace(var, var_expr(var));
+            }
+        }
+    }
+    quantifiers.push_back(quantifier{
+            .stmt = fact,
+            .vars = std::move(vars),
+            .body = std::move(body),
+            .triggers = std::move(triggers),
+            .fixed_vars = std::move(fixed_vars),
+            .generation = generation,
+    });
+}
+
+void quantifier_instantiator::add_terms(const statement_ptr& stmt,  // NOLINT(misc-no-recursion)
+                                        std::size_t generation,
+                                        std::set<variable_ptr>& bound) {
+    if (stmt->is_rel()) {
+        const auto& [type, left, right] = stmt->as_rel();
+        if (!intersects(pattern_vars(trigger_pattern{stmt, nullptr}), bound)) {
+            add_term(ground_term{stmt, nullptr, generation}, {0, static_cast<int>(type)});
+        }
+        add_terms(left, generation, bound);
+        add_terms(right, generation, bound);
+    } else if (stmt->is_neg()) {
+        add_terms(stmt->as_neg().inner, generation, bound);
+    } else if (stmt->is_implies()) {
+        add_terms(stmt->as_implies().from, generation, bound);
+        add_terms(stmt->as_implies().to, generation, bound);
+    } else if (stmt->is_equiv()) {
+        add_terms(stmt->as_equiv().left, generation, bound);
+        add_terms(stmt->as_equiv().right, generation, bound);
+    } else if (stmt->is_conj() || stmt->is_disj()) {
+        for (const auto& child: stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner) {
+            add_terms(child, generation, bound);
+        }
+    } else if (stmt->is_forall()) {
+        const auto inserted = bound.insert(stmt->as_forall().var).second;
+        add_terms(stmt->as_forall().inner, generation, bound);
+        if (inserted) {
+            bound.erase(stmt->as_forall().var);
+        }
+    }
+}
+
+void quantifier_instantiator::add_terms(const expr_ptr& expr,  // NOLINT(misc-no-recursion)
+                                        std::size_t generation,
+                                        const std::set<variable_ptr>& bound) {
+    if (expr->is_var()) {
+        return;
+    }
+    if (!intersects(pattern_vars(trigger_pattern{nullptr, expr}), bound)) {
+        const auto key = expr->is_binop() ? term_key{1, static_cast<int>(expr->as_binop().type)}
+                                          : term_key{2, static_cast<int>(expr->as_call().params.size())};
+        add_term(ground_term{nullptr, expr, generation}, key);
+    }
+    if (expr->is_binop()) {
+        add_terms(expr->as_binop().left, generation, bound);
+        add_terms(expr->as_binop().right, generation, bound);
+    } else {
+        add_terms(expr->as_call().callee, generation, bound);
+        for (const auto& param: expr->as_call().params) {
+            add_terms(param, generation, bound);
+        }
+    }
+}
+
+void quantifier_instantiator::add_term(ground_term term, const term_key& key) {
+    const bool is_new = term.rel != nullptr ? seen_rels.insert(term.rel).second : seen_exprs.insert(term.expr).second;
+    if (is_new) {
+        index[key].push_back(terms.size());
+        terms.push_back(std::move(term));
+    }
+}
+
+bool quantifier_instantiator::match_triggers(std::size_t quantifier_index,  // NOLINT(misc-no-recursion)
+                                             std::size_t trigger_index,
+                                             const match_result& replacements,
+                                             std::size_t generation,
+                                             bool uses_new_term,
+                                             std::size_t num_terms) {
+    // New instances can add quantifiers, so quantifiers[quantifier_index] is not kept as a reference.
+    const auto trigger = [&]() -> std::optional<trigger_pattern> {
+        const auto& triggers = quantifiers[quantifier_index].triggers;
+        return trigger_index < triggers.size() ? std::optional{triggers[trigger_index]} : std::nullopt;
+    }();
+    if (!trigger.has_value()) {
+        if (!uses_new_term) {
+            // Found in an earlier round.
+            return true;
+        }
+        const auto body = quantifiers[quantifier_index].body;
+        auto instance = apply_vars(body, replacements).stmt;
+        if (seen_instances.insert(instance).second) {
+            instance_list.push_back(quantifier_instance{quantifiers[quantifier_index].stmt, instance, generation});
+            add_fact(instance, generation);
+        }
+        return instance_list.size() < options.max_instances;
+    }
+
+    const auto key = trigger->rel != nullptr
+                             ? term_key{0, static_cast<int>(trigger->rel->as_rel().type)}
+                     : trigger->expr->is_binop() ? term_key{1, static_cast<int>(trigger->expr->as_binop().type)}
+                                                 : term_key{2, static_cast<int>(trigger->expr->as_call().params.size())};
+    const auto it = index.find(key);
+    if (it == index.end()) {
+        return true;
+    }
+    // The vector can grow while instances are added, so it is indexed again at every step. The ids are increasing.
+    const auto& ids = it->second;
+    for (std::size_t i = 0; i < ids.size() && ids[i] < num_terms; i++) {
+        const auto id = ids[i];
+        const auto term_generation = std::max(generation, terms[id].generation + 1);
+        if (term_generation > options.max_generation) {
+            continue;
+        }
+        const auto matched = trigger->rel != nullptr ? match(*trigger->rel, terms[id].rel, replacements)
+                                                     : match(*trigger->expr, terms[id].expr, replacements);
+        if (!matched.has_value()) {
+            continue;
+        }
+        const bool is_new = uses_new_term || id >= quantifiers[quantifier_index].num_matched_terms;
+        if (!match_triggers(quantifier_index, trigger_index + 1, *matched, term_generation, is_new, num_terms)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<quantifier_instance> quantifier_instantiator::instantiate() {
+    const auto first_new = instance_list.size();
+    bool within_limits = instance_list.size() < options.max_instances;
+    while (within_limits) {
+        const auto num_instances = instance_list.size();
+        const auto num_terms = terms.size();
+        for (std::size_t i = 0; i < quantifiers.size() && within_limits; i++) {
+            if (quantifiers[i].triggers.empty() || quantifiers[i].num_matched_terms >= num_terms) {
+                continue;
+            }
+            // Instances from a quantifier are at least one generation after it.
+            const auto generation = quantifiers[i].generation + 1;
+            if (generation <= options.max_generation) {
+                const auto fixed_vars = quantifiers[i].fixed_vars;
+                within_limits = match_triggers(i, 0, fixed_vars, generation, false, num_terms);
+            }
+            quantifiers[i].num_matched_terms = num_terms;
+        }
+        if (instance_list.size() == num_instances) {
+            break;
+        }
+    }
+    return {instance_list.begin() + static_cast<std::ptrdiff_t>(first_new), instance_list.end()};
+}
+
+const std::vector<quantifier_instance>& quantifier_instantiator::instances() const {
+    return instance_list;
+}
+
+std::size_t quantifier_instantiator::num_ground_terms() const {
+    return terms.size();
+}
+
+}  // namespace tema
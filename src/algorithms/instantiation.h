@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "algorithms/hash.h"
+#include "algorithms/match.h"
+#include "core/scope.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// A pattern that selects the instances of a forall statement: a relationship or a compound expression (a call or a
+// binary operation) from its body, containing some of its bound variables.
+struct trigger_pattern {
+    statement_ptr rel;
+    expr_ptr expr;
+};
+
+// The triggers of a statement made of one or more nested foralls: a single pattern containing all the bound variables
+// when there is one (the smallest such pattern), otherwise a set of patterns that together contain all of them.
+// Patterns inside nested foralls that use the nested variables are not considered. Returns no triggers when some
+// bound variable does not appear in any pattern (e.g. when it is only used as a statement).
+[[nodiscard]] std::vector<trigger_pattern> select_triggers(const statement_ptr& quantified);
+
+struct instantiation_options {
+    // Instances built only from the terms of the facts are of generation 1. Instances that use the terms of (or are
+    // obtained from a quantifier introduced by) a generation n instance are of generation n+1.
+    std::size_t max_generation = 2;
+    std::size_t max_instances = 10'000;
+};
+
+struct quantifier_instance {
+    // The forall statement that was instantiated.
+    statement_ptr quantified;
+    statement_ptr instance;
+    std::size_t generation;
+};
+
+// Instantiates the universally quantified facts with the ground terms of the facts (E-matching): the bound variables
+// of a forall fact are only replaced with the terms that make its triggers match a relationship or expression already
+// present in the facts. Free variables of the triggers only match themselves. The instances are added as facts, so
+// their own terms can trigger more instances, up to max_generation.
+class quantifier_instantiator {
+    struct quantifier {
+        statement_ptr stmt;
+        std::vector<variable_ptr> vars;
+        statement_ptr body;
+        std::vector<trigger_pattern> triggers;
+        // The free variables of the triggers, each replaced by itself.
+        match_result fixed_vars;
+        std::size_t generation;
+        // The terms before this index were already tried against the triggers.
+        std::size_t num_matched_terms = 0;
+    };
+
+    struct ground_term {
+        statement_ptr rel;
+        expr_ptr expr;
+        std::size_t generation;
+    };
+
+    // Relationships are indexed by (0, rel_type), binary operations by (1, binop_type) and calls by (2, number of
+    // parameters).
+    using term_key = std::pair<int, int>;
+
+    instantiation_options options;
+    std::vector<quantifier> quantifiers;
+    std::vector<ground_term> terms;
+    std::map<term_key, std::vector<std::size_t>> index;
+    std::unordered_set<statement_ptr, structural_hash, structural_equal> seen_rels;
+    std::unordered_set<expr_ptr, structural_hash, structural_equal> seen_exprs;
+    std::unordered_set<statement_ptr, structural_hash, structural_equal> seen_instances;
+    std::vector<quantifier_instance> instance_list;
+
+    void add_fact(const statement_ptr& fact, std::size_t generation);
+    void add_quantifiers(const statement_ptr& fact, std::size_t generation);
+    void add_terms(const statement_ptr& stmt, std::size_t generation, std::set<variable_ptr>& bound);
+    void add_terms(const expr_ptr& expr, std::size_t generation, const std::set<variable_ptr>& bound);
+    void add_term(ground_term term, const term_key& key);
+    bool match_triggers(std::size_t quantifier_index,
+                        std::size_t trigger_index,
+                        const match_result& replacements,
+                        std::size_t generation,
+                        bool uses_new_term,
+                        std::size_t num_terms);
+
+public:
+    explicit quantifier_instantiator(instantiation_options options = {});
+
+    void add_fact(const statement_ptr& fact);
+
+    // Adds the facts of the scope and of its parents.
+    void add_scope(const scope& s);
+
+    // Instantiates the quantifiers until no new instance can be found within the limits, and returns the new
+    // instances (which are also added as facts).
+    std::vector<quantifier_instance> instantiate();
+
+    // All the instances found so far.
+    [[nodiscard]] const std::vector<quantifier_instance>& instances() const;
+
+    [[nodiscard]] std::size_t num_ground_terms() const;
+};
+
+}  // namespace tema
@@ -0,0 +1,147 @@
+#include "algorithms/instantiation.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.instantiation") {
+    const auto x = var("x");
+    const auto y = var("y");
+    const auto t = var("t");
+    const auto ex = var_expr(x);
+    const auto ey = var_expr(y);
+    const auto et = var_expr(t);
+    const auto a = var_expr(var("A"));
+    const auto b = var_expr(var("B"));
+    const auto c = var_expr(var("C"));
+    const auto d = var_expr(var("d"));
+    const auto e = var_expr(var("e"));
+    const auto in = [](const expr_ptr& l, const expr_ptr& r) {
+        return rel_stmt(l, rel_type::in, r);
+    };
+    const auto is_included = forall(t, implies(in(et, a), in(et, b)));
+
+    group("select_triggers", [&] {
+        test("single pattern", [&] {
+            const auto triggers = select_triggers(is_included);
+            expect(triggers, hasSize(1));
+            expect(triggers[0].rel == is_included->as_forall().inner->as_implies().from, isTrue);
+        });
+
+        test("smallest pattern with all the variables", [&] {
+            const auto body = implies(conj(in(ex, a), in(ey, b)), rel_stmt(binop(ex, binop_type::set_union, ey), rel_type::eq_is_included, c));
+            const auto triggers = select_triggers(forall(x, forall(y, body)));
+            expect(triggers, hasSize(1));
+            expect(triggers[0].expr != nullptr, isTrue);
+            expect(equals(*triggers[0].expr, *binop(ex, binop_type::set_union, ey)), isTrue);
+        });
+
+        test("multiple patterns", [&] {
+            const auto triggers = select_triggers(forall(x, forall(y, implies(conj(in(ex, a), in(ey, b)), neg(in(ex, b))))));
+            expect(triggers, hasSize(2));
+            expect(equals(*triggers[0].rel, *in(ex, a)), isTrue);
+            expect(equals(*triggers[1].rel, *in(ey, b)), isTrue);
+        });
+
+        test("no pattern", [&] {
+            const auto p = var("p");
+            expect(select_triggers(forall(p, disj(var_stmt(p), neg(var_stmt(p))))), isEmpty);
+            // Patterns that use the variables of nested foralls are not considered.
+            expect(select_triggers(forall(x, neg(forall(y, in(ey, ex))))), isEmpty);
+            const auto triggers = select_triggers(forall(x, implies(in(ex, a), forall(y, in(ey, ex)))));
+            expect(triggers, hasSize(1));
+            expect(equals(*triggers[0].rel, *in(ex, a)), isTrue);
+        });
+    });
+
+    group("quantifier_instantiator", [&] {
+        test("instances from the ground terms of the facts", [&] {
+            quantifier_instantiator instantiator;
+            instantiator.add_fact(is_included);
+            instantiator.add_fact(in(d, a));
+            // A only matches itself.
+            instantiator.add_fact(in(e, c));
+            const auto instances = instantiator.instantiate();
+            expect(instances, hasSize(1));
+            expectMsg(equals(*instances[0].instance, *implies(in(d, a), in(d, b))), print_utf8(*instances[0].instance));
+            expect(instances[0].quantified == is_included, isTrue);
+            expect(instances[0].generation, 1U);
+            expect(instantiator.instantiate(), isEmpty);
+
+            instantiator.add_fact(in(e, a));
+            const auto more = instantiator.instantiate();
+            expect(more, hasSize(1));
+            expect(equals(*more[0].instance, *implies(in(e, a), in(e, b))), isTrue);
+            expect(instantiator.instances(), hasSize(2));
+        });
+
+        test("ground terms nested in the facts", [&] {
+            quantifier_instantiator instantiator;
+            instantiator.add_fact(is_included);
+            instantiator.add_fact(implies(var_stmt(var("p")), conj(in(binop(d, binop_type::set_union, e), a), in(d, c))));
+            const auto instances = instantiator.instantiate();
+            expect(instances, hasSize(1));
+            expect(equals(*instances[0].instance,
+                          *implies(in(binop(d, binop_type::set_union, e), a), in(binop(d, binop_type::set_union, e), b))),
+                   isTrue);
+        });
+
+        test("generations", [&] {
+            const auto chain = std::vector<statement_ptr>{
+                    is_included,
+                    forall(t, implies(in(et, b), in(et, c))),
+                    in(d, a),
+            };
+            quantifier_instantiator limited({.max_generation = 1});
+            for (const auto& fact: chain) {
+                limited.add_fact(fact);
+            }
+            expect(limited.instantiate(), hasSize(1));
+
+            quantifier_instantiator instantiator({.max_generation = 2});
+            for (const auto& fact: chain) {
+                instantiator.add_fact(fact);
+            }
+            const auto instances = instantiator.instantiate();
+            expect(instances, hasSize(2));
+            expect(instances[1].generation, 2U);
+            expect(equals(*instances[1].instance, *implies(in(d, b), in(d, c))), isTrue);
+        });
+
+        test("multiple triggers", [&] {
+            quantifier_instantiator instantiator;
+            instantiator.add_fact(conj(forall(x, forall(y, implies(conj(in(ex, a), in(ey, b)), neg(in(ex, b))))), in(d, a)));
+            instantiator.add_fact(in(d, b));
+            instantiator.add_fact(in(e, b));
+            const auto instances = instantiator.instantiate();
+            expect(instances, hasSize(2));
+        });
+
+        test("instance limit", [&] {
+            quantifier_instantiator instantiator({.max_generation = 2, .max_instances = 3});
+            instantiator.add_fact(is_included);
+            for (int i = 0; i < 10; i++) {
+                instantiator.add_fact(in(var_expr(var("x" + std::to_string(i))), a));
+            }
+            expect(instantiator.instantiate(), hasSize(3));
+            expect(instantiator.instantiate(), isEmpty);
+        });
+
+        test("facts of a scope", [&] {
+            scope outer;
+            outer.add_statement(is_included);
+            scope inner(&outer);
+            inner.add_statement(in(d, a));
+            quantifier_instantiator instantiator;
+            instantiator.add_scope(inner);
+            expect(instantiator.instantiate(), hasSize(1));
+            // d∈A, and d∈B from the instance.
+            expect(instantiator.num_ground_terms(), 2U);
+        });
+    });
+}
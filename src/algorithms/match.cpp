@@ -1,5 +1,6 @@
 #include "algorithms/match.h"
 
+#include "algorithms/congruence_closure.h"
 #include "algorithms/equals.h"
 
 #include <set>
@@ -19,15 +20,16 @@ struct match_visitor {
     statement_ptr app_stmt;
     expr_ptr app_expr;
     match_result result;
+    const congruence_closure* equalities;
 
     // TODO: This will contain like 1-2 variables at most, do a flat map / vector for it.
     var_mapping bound_vars;  // For forall
 
-    match_visitor(statement_ptr app_stmt, match_result result)
-        : app_stmt(std::move(app_stmt)), result(std::move(result)) {}
+    match_visitor(statement_ptr app_stmt, match_result result, const congruence_closure* equalities)
+        : app_stmt(std::move(app_stmt)), result(std::move(result)), equalities(equalities) {}
 
-    match_visitor(expr_ptr app_expr, match_result result)
-        : app_expr(std::move(app_expr)), result(std::move(result)) {}
+    match_visitor(expr_ptr app_expr, match_result result, const congruence_closure* equalities)
+        : app_expr(std::move(app_expr)), result(std::move(result)), equalities(equalities) {}
 
     bool operator()(const statement::truth&) const {
         return app_stmt->is_truth();
@@ -122,7 +124,7 @@ struct match_visitor {
             result.expr_replacements.emplace(var, app_expr);
             return true;
         }
-        return equals(*it->second, *app_expr);
+        return equals(*it->second, *app_expr) || (equalities != nullptr && equalities->are_equal(*it->second, *app_expr));
     }
     bool operator()(const expression::binop& expr) {
         return app_expr->is_binop() &&
@@ -165,16 +167,22 @@ struct match_visitor {
     }
 };
 
-std::optional<match_result> match(const expression& law, expr_ptr application, match_result existing_replacements) {
-    match_visitor visitor(std::move(application), std::move(existing_replacements));
+std::optional<match_result> match(const expression& law,
+                                  expr_ptr application,
+                                  match_result existing_replacements,
+                                  const congruence_closure* equalities) {
+    match_visitor visitor(std::move(application), std::move(existing_replacements), equalities);
     if (!law.accept_r<bool>(visitor)) {
         return std::nullopt;
     }
     return std::move(visitor.result);
 }
 
-std::optional<match_result> match(const statement& law, statement_ptr application, match_result existing_replacements) {
-    match_visitor visitor(std::move(application), std::move(existing_replacements));
+std::optional<match_result> match(const statement& law,
+                                  statement_ptr application,
+                                  match_result existing_replacements,
+                                  const congruence_closure* equalities) {
+    match_visitor visitor(std::move(application), std::move(existing_replacements), equalities);
     if (!law.accept_r<bool>(visitor)) {
         return std::nullopt;
     }
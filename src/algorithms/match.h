@@ -7,12 +7,22 @@
 
 namespace tema {
 
+class congruence_closure;
+
 struct match_result {
     std::map<variable_ptr, statement_ptr> stmt_replacements;
     std::map<variable_ptr, expr_ptr> expr_replacements;
 };
 
-[[nodiscard]] std::optional<match_result> match(const expression& law, expr_ptr application, match_result existing_replacements = {});
-[[nodiscard]] std::optional<match_result> match(const statement& law, statement_ptr application, match_result existing_replacements = {});
+// When given, equalities is used to check the repeated occurrences of a law's expression variables: x+x matches a+b
+// if a=b modulo the equalities.
+[[nodiscard]] std::optional<match_result> match(const expression& law,
+                                                expr_ptr application,
+                                                match_result existing_replacements = {},
+                                                const congruence_closure* equalities = nullptr);
+[[nodiscard]] std::optional<match_result> match(const statement& law,
+                                                statement_ptr application,
+                                                match_result existing_replacements = {},
+                                                const congruence_closure* equalities = nullptr);
 
 }  // namespace tema
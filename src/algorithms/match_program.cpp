@@ -0,0 +1,378 @@
+#include "algorithms/match_program.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <stdexcept>
+
+#include "algorithms/equals.h"
+
+namespace tema {
+
+namespace {
+
+// A node of the application. Exactly one of the pointers is set; they point inside the application (or to the
+// application itself), which outlives the run.
+struct node_ref {
+    const statement_ptr* stmt;
+    const expr_ptr* expr;
+};
+
+struct law_compiler {
+    std::vector<match_instruction>& code;
+    std::vector<variable_ptr>& slot_vars;
+    std::size_t num_bound_vars = 0;
+    // The number of application nodes on the stack of the machine after the instructions so far, and its maximum.
+    std::size_t depth = 1;
+    std::size_t max_depth = 1;
+
+    std::map<std::pair<const variable*, bool>, std::uint32_t> slots{};
+    // The variables bound by the enclosing foralls of the law, with their indices.
+    std::vector<std::pair<const variable*, std::uint32_t>> bound{};
+
+    void emit(match_opcode opcode, std::size_t operand = 0, std::size_t num_children = 0) {
+        code.push_back(match_instruction{opcode, static_cast<std::uint32_t>(operand)});
+        depth = depth - 1 + num_children;
+        max_depth = std::max(max_depth, depth);
+    }
+
+    void emit_var(const variable_ptr& var, bool is_stmt) {
+        const auto bound_it = std::find_if(bound.begin(), bound.end(), [&](const auto& entry) {
+            return entry.first == var.get();
+        });
+        if (bound_it != bound.end()) {
+            emit(is_stmt ? match_opcode::check_bound_stmt : match_opcode::check_bound_expr, bound_it->second);
+            return;
+        }
+        const auto [it, inserted] = slots.emplace(std::make_pair(var.get(), is_stmt), slot_vars.size());
+        if (inserted) {
+            slot_vars.push_back(var);
+            emit(is_stmt ? match_opcode::bind_stmt : match_opcode::bind_expr, it->second);
+        } else {
+            emit(is_stmt ? match_opcode::compare_stmt : match_opcode::compare_expr, it->second);
+        }
+    }
+
+    void compile(const expression& expr) {  // NOLINT(misc-no-recursion)
+        if (expr.is_var()) {
+            emit_var(expr.as_var(), false);
+        } else if (expr.is_binop()) {
+            const auto& [type, left, right] = expr.as_binop();
+            emit(match_opcode::check_binop, static_cast<std::size_t>(type), 2);
+            compile(*left);
+            compile(*right);
+        } else {
+            const auto& [callee, params] = expr.as_call();
+            emit(match_opcode::check_call, params.size(), 1 + params.size());
+            compile(*callee);
+            for (const auto& param: params) {
+                compile(*param);
+            }
+        }
+    }
+
+    void compile(const statement& stmt) {  // NOLINT(misc-no-recursion)
+        if (stmt.is_truth()) {
+            emit(match_opcode::check_truth);
+        } else if (stmt.is_contradiction()) {
+            emit(match_opcode::check_contradiction);
+        } else if (stmt.is_var()) {
+            emit_var(stmt.as_var(), true);
+        } else if (stmt.is_neg()) {
+            emit(match_opcode::check_neg, 0, 1);
+            compile(*stmt.as_neg().inner);
+        } else if (stmt.is_implies()) {
+            emit(match_opcode::check_implies, 0, 2);
+            compile(*stmt.as_implies().from);
+            compile(*stmt.as_implies().to);
+        } else if (stmt.is_equiv()) {
+            emit(match_opcode::check_equiv, 0, 2);
+            compile(*stmt.as_equiv().left);
+            compile(*stmt.as_equiv().right);
+        } else if (stmt.is_conj() || stmt.is_disj()) {
+            const auto& inner = stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner;
+            emit(stmt.is_conj() ? match_opcode::check_conj : match_opcode::check_disj, inner.size(), inner.size());
+            for (const auto& term: inner) {
+                compile(*term);
+            }
+        } else if (stmt.is_forall()) {
+            const auto& [var, inner] = stmt.as_forall();
+            if (std::any_of(bound.begin(), bound.end(), [&](const auto& entry) {
+                    return entry.first == var.get();
+                })) {
+                throw std::runtime_error("Invalid statement, forall twice with the same variable");
+            }
+            const auto index = num_bound_vars++;
+            emit(match_opcode::check_forall, index, 1);
+            bound.emplace_back(var.get(), index);
+            compile(*inner);
+            bound.pop_back();
+        } else {
+            const auto& [type, left, right] = stmt.as_rel();
+            emit(match_opcode::check_rel, static_cast<std::size_t>(type), 2);
+            compile(*left);
+            compile(*right);
+        }
+    }
+};
+
+// The state of a run: the application nodes left to match (the next one on top), the nodes bound to the slots and
+// the variables bound by the foralls of the application. The storage is given by the caller, sized for the law.
+struct match_machine {
+    node_ref* stack;
+    std::size_t top = 0;
+    node_ref* slots;
+    const variable** bound;
+
+    void push(const statement_ptr& stmt) {
+        stack[top++] = node_ref{&stmt, nullptr};
+    }
+
+    void push(const expr_ptr& expr) {
+        stack[top++] = node_ref{nullptr, &expr};
+    }
+
+    void push_children(const std::vector<statement_ptr>& children) {
+        for (auto it = children.rbegin(); it != children.rend(); it++) {
+            push(*it);
+        }
+    }
+
+    [[nodiscard]] bool step(const match_instruction& instruction) {
+        const auto node = stack[--top];
+        switch (instruction.opcode) {
+            case match_opcode::check_truth: return (*node.stmt)->is_truth();
+            case match_opcode::check_contradiction: return (*node.stmt)->is_contradiction();
+            case match_opcode::check_neg: {
+                if (!(*node.stmt)->is_neg()) {
+                    return false;
+                }
+                push((*node.stmt)->as_neg().inner);
+                return true;
+            }
+            case match_opcode::check_implies: {
+                if (!(*node.stmt)->is_implies()) {
+                    return false;
+                }
+                const auto& [from, to] = (*node.stmt)->as_implies();
+                push(to);
+                push(from);
+                return true;
+            }
+            case match_opcode::check_equiv: {
+                if (!(*node.stmt)->is_equiv()) {
+                    return false;
+                }
+                const auto& [left, right] = (*node.stmt)->as_equiv();
+                push(right);
+                push(left);
+                return true;
+            }
+            case match_opcode::check_conj: {
+                if (!(*node.stmt)->is_conj() || (*node.stmt)->as_conj().inner.size() != instruction.operand) {
+                    return false;
+                }
+                push_children((*node.stmt)->as_conj().inner);
+                return true;
+            }
+            case match_opcode::check_disj: {
+                if (!(*node.stmt)->is_disj() || (*node.stmt)->as_disj().inner.size() != instruction.operand) {
+                    return false;
+                }
+                push_children((*node.stmt)->as_disj().inner);
+                return true;
+            }
+            case match_opcode::check_forall: {
+                if (!(*node.stmt)->is_forall()) {
+                    return false;
+                }
+                const auto& [var, inner] = (*node.stmt)->as_forall();
+                bound[instruction.operand] = var.get();
+                push(inner);
+                return true;
+            }
+            case match_opcode::check_rel: {
+                if (!(*node.stmt)->is_rel() || static_cast<std::uint32_t>((*node.stmt)->as_rel().type) != instruction.operand) {
+                    return false;
+                }
+                const auto& rel = (*node.stmt)->as_rel();
+                push(rel.right);
+                push(rel.left);
+                return true;
+            }
+            case match_opcode::check_binop: {
+                if (!(*node.expr)->is_binop() || static_cast<std::uint32_t>((*node.expr)->as_binop().type) != instruction.operand) {
+                    return false;
+                }
+                const auto& binop = (*node.expr)->as_binop();
+                push(binop.right);
+                push(binop.left);
+                return true;
+            }
+            case match_opcode::check_call: {
+                if (!(*node.expr)->is_call() || (*node.expr)->as_call().params.size() != instruction.operand) {
+                    return false;
+                }
+                const auto& [callee, params] = (*node.expr)->as_call();
+                for (auto it = params.rbegin(); it != params.rend(); it++) {
+                    push(*it);
+                }
+                push(callee);
+                return true;
+            }
+            case match_opcode::check_bound_stmt:
+                return (*node.stmt)->is_var() && (*node.stmt)->as_var().get() == bound[instruction.operand];
+            case match_opcode::check_bound_expr:
+                return (*node.expr)->is_var() && (*node.expr)->as_var().get() == bound[instruction.operand];
+            case match_opcode::bind_stmt:
+            case match_opcode::bind_expr: slots[instruction.operand] = node; return true;
+            case match_opcode::compare_stmt: return equals(**slots[instruction.operand].stmt, **node.stmt);
+            case match_opcode::compare_expr: return equals(**slots[instruction.operand].expr, **node.expr);
+        }
+        return false;
+    }
+
+    [[nodiscard]] match_result result(const std::vector<variable_ptr>& slot_vars) const {
+        match_result result;
+        for (std::size_t i = 0; i < slot_vars.size(); i++) {
+            if (slots[i].stmt != nullptr) {
+                result.stmt_replacements.emplace(slot_vars[i], *slots[i].stmt);
+            } else {
+                result.expr_replacements.emplace(slot_vars[i], *slots[i].expr);
+            }
+        }
+        return result;
+    }
+};
+
+// The storage of a machine: inline for small laws, so that running them doesn't allocate.
+class machine_storage {
+    std::array<node_ref, 32> inline_nodes;
+    std::array<const variable*, 4> inline_bound;
+    std::vector<node_ref> spilled_nodes;
+    std::vector<const variable*> spilled_bound;
+
+public:
+    [[nodiscard]] match_machine machine(std::size_t max_depth, std::size_t num_slots, std::size_t num_bound_vars) {
+        auto* nodes = inline_nodes.data();
+        if (max_depth + num_slots > inline_nodes.size()) {
+            spilled_nodes.resize(max_depth + num_slots);
+            nodes = spilled_nodes.data();
+        }
+        auto* bound = inline_bound.data();
+        if (num_bound_vars > inline_bound.size()) {
+            spilled_bound.resize(num_bound_vars);
+            bound = spilled_bound.data();
+        }
+        return match_machine{nodes, 0, nodes + max_depth, bound};
+    }
+};
+
+}  // namespace
+
+match_program::match_program(const statement& law) {
+    law_compiler compiler{code, slot_vars};
+    compiler.compile(law);
+    num_bound_vars = compiler.num_bound_vars;
+    max_depth = compiler.max_depth;
+}
+
+std::optional<match_result> match_program::run(const statement_ptr& application) const {
+    machine_storage storage;
+    auto machine = storage.machine(max_depth, slot_vars.size(), num_bound_vars);
+    machine.push(application);
+    for (const auto& instruction: code) {
+        if (!machine.step(instruction)) {
+            return std::nullopt;
+        }
+    }
+    return machine.result(slot_vars);
+}
+
+const std::vector<match_instruction>& match_program::instructions() const {
+    return code;
+}
+
+std::size_t match_code_tree::add(const statement& law) {
+    std::vector<match_instruction> code;
+    compiled_law compiled;
+    law_compiler compiler{code, compiled.slot_vars};
+    compiler.compile(law);
+    num_slots = std::max(num_slots, compiled.slot_vars.size());
+    num_bound_vars = std::max(num_bound_vars, compiler.num_bound_vars);
+    max_depth = std::max(max_depth, compiler.max_depth);
+
+    // Laws with the same instructions so far bound the same slots (slots are numbered in order of first occurrence),
+    // so they can share the nodes.
+    std::uint32_t node = 0;
+    for (const auto& instruction: code) {
+        const auto& children = nodes[node].children;
+        const auto it = std::find_if(children.begin(), children.end(), [&](std::uint32_t child) {
+            return nodes[child].instruction == instruction;
+        });
+        if (it != children.end()) {
+            node = *it;
+        } else {
+            const auto child = static_cast<std::uint32_t>(nodes.size());
+            nodes.push_back(tree_node{instruction, {}, {}});
+            nodes[node].children.push_back(child);
+            node = child;
+        }
+    }
+    const auto index = law_list.size();
+    nodes[node].laws.push_back(static_cast<std::uint32_t>(index));
+    law_list.push_back(std::move(compiled));
+    return index;
+}
+
+std::size_t match_code_tree::size() const {
+    return law_list.size();
+}
+
+std::size_t match_code_tree::num_nodes() const {
+    return nodes.size();
+}
+
+std::vector<std::pair<std::size_t, match_result>> match_code_tree::match_all(const statement_ptr& application) const {
+    std::vector<std::pair<std::size_t, match_result>> matches;
+    machine_storage storage;
+    auto machine = storage.machine(max_depth, num_slots, num_bound_vars);
+    machine.push(application);
+    // Depth-first, restoring the stack of the machine when backtracking. The slots and bound variables don't need to
+    // be restored: a node only reads the ones written on its path from the root.
+    std::vector<std::pair<std::uint32_t, std::vector<node_ref>>> pending;
+    pending.emplace_back(0, std::vector<node_ref>(machine.stack, machine.stack + machine.top));
+    while (!pending.empty()) {
+        auto [node, stack] = std::move(pending.back());
+        pending.pop_back();
+        std::copy(stack.begin(), stack.end(), machine.stack);
+        machine.top = stack.size();
+        if (node != 0 && !machine.step(nodes[node].instruction)) {
+            continue;
+        }
+        while (true) {
+            const auto& current = nodes[node];
+            for (const auto law: current.laws) {
+                matches.emplace_back(law, machine.result(law_list[law].slot_vars));
+            }
+            if (current.children.empty()) {
+                break;
+            }
+            // The other children are tried later, from the current stack.
+            for (std::size_t i = current.children.size() - 1; i > 0; i--) {
+                pending.emplace_back(current.children[i],
+                                     std::vector<node_ref>(machine.stack, machine.stack + machine.top));
+            }
+            node = current.children[0];
+            if (!machine.step(nodes[node].instruction)) {
+                break;
+            }
+        }
+    }
+    std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+    return matches;
+}
+
+}  // namespace tema
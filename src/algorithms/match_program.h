@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "algorithms/match.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// Laws compiled into matching instructions, executed against applications by a small virtual machine instead of
+// walking the law with match_visitor.
+//
+// The instructions follow the law in pre-order. The machine keeps a stack of the application nodes left to match:
+// check instructions pop a node, check its tag (and relationship or binop type, or number of children) and push its
+// children; bind instructions pop a node and store it in a slot (the first occurrence of a free variable of the law);
+// compare instructions pop a node and compare it with a slot (the next occurrences). Variables bound by a forall of the
+// law are compared with the variable bound by the corresponding forall of the application.
+enum class match_opcode : std::uint8_t {
+    check_truth,
+    check_contradiction,
+    check_neg,
+    check_implies,
+    check_equiv,
+    check_conj,    // operand: number of children.
+    check_disj,    // operand: number of children.
+    check_forall,  // operand: index of the bound variable.
+    check_rel,     // operand: rel_type.
+    check_binop,   // operand: binop_type.
+    check_call,    // operand: number of parameters.
+    check_bound_stmt,  // operand: index of the bound variable.
+    check_bound_expr,  // operand: index of the bound variable.
+    bind_stmt,     // operand: slot.
+    bind_expr,     // operand: slot.
+    compare_stmt,  // operand: slot.
+    compare_expr,  // operand: slot.
+};
+
+struct match_instruction {
+    match_opcode opcode;
+    std::uint32_t operand;
+
+    bool operator==(const match_instruction&) const = default;
+};
+
+// A single compiled law. run gives the same result as match(law, application).
+class match_program {
+    std::vector<match_instruction> code;
+    // The free variable of the law stored in each slot.
+    std::vector<variable_ptr> slot_vars;
+    std::size_t num_bound_vars = 0;
+    // The maximum number of application nodes waiting to be matched.
+    std::size_t max_depth = 0;
+
+public:
+    // Throws std::runtime_error for laws with two nested foralls over the same variable, like match.
+    explicit match_program(const statement& law);
+
+    [[nodiscard]] std::optional<match_result> run(const statement_ptr& application) const;
+
+    [[nodiscard]] const std::vector<match_instruction>& instructions() const;
+};
+
+// Many compiled laws merged into a tree, in which laws whose instructions start the same way share the nodes of their
+// common prefix. Matching an application against all the laws runs the shared instructions once, and backtracks to
+// try the other branches.
+class match_code_tree {
+    struct tree_node {
+        match_instruction instruction;
+        std::vector<std::uint32_t> children;
+        // The laws whose instructions end at this node.
+        std::vector<std::uint32_t> laws;
+    };
+
+    struct compiled_law {
+        std::vector<variable_ptr> slot_vars;
+    };
+
+    // Node 0 is the root, and has no instruction.
+    std::vector<tree_node> nodes{1};
+    std::vector<compiled_law> law_list;
+    std::size_t num_slots = 0;
+    std::size_t num_bound_vars = 0;
+    std::size_t max_depth = 0;
+
+public:
+    // Returns the index of the law in the tree.
+    std::size_t add(const statement& law);
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::size_t num_nodes() const;
+
+    // The laws that match the application, with their replacements, in increasing order of index.
+    [[nodiscard]] std::vector<std::pair<std::size_t, match_result>> match_all(const statement_ptr& application) const;
+};
+
+}  // namespace tema
@@ -0,0 +1,161 @@
+#include "algorithms/match_program.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+namespace {
+
+bool same_result(const match_result& a, const match_result& b) {
+    if (a.stmt_replacements.size() != b.stmt_replacements.size() ||
+        a.expr_replacements.size() != b.expr_replacements.size()) {
+        return false;
+    }
+    for (const auto& [var, stmt]: a.stmt_replacements) {
+        const auto it = b.stmt_replacements.find(var);
+        if (it == b.stmt_replacements.end() || !equals(*stmt, *it->second)) {
+            return false;
+        }
+    }
+    for (const auto& [var, expr]: a.expr_replacements) {
+        const auto it = b.expr_replacements.find(var);
+        if (it == b.expr_replacements.end() || !equals(*expr, *it->second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE("algorithms.match_program") {
+    const auto p = var_stmt(var("p"));
+    const auto q = var_stmt(var("q"));
+    const auto x = var("x");
+    const auto y = var("y");
+    const auto ex = var_expr(x);
+    const auto ey = var_expr(y);
+    const auto a = var_expr(var("A"));
+    const auto b = var_expr(var("B"));
+    const auto f = var_expr(var("f"));
+    const auto in = [](const expr_ptr& l, const expr_ptr& r) {
+        return rel_stmt(l, rel_type::in, r);
+    };
+    const auto unite = [](const expr_ptr& l, const expr_ptr& r) {
+        return binop(l, binop_type::set_union, r);
+    };
+
+    const std::vector<statement_ptr> stmts = {
+            p,
+            neg(p),
+            neg(neg(p)),
+            neg(neg(q)),
+            implies(p, q),
+            implies(p, p),
+            implies(q, q),
+            implies(conj(p, q), p),
+            equiv(p, neg(q)),
+            conj(p, q),
+            conj(p, q, neg(p)),
+            disj(p, q),
+            in(ex, a),
+            in(a, a),
+            in(ex, unite(a, b)),
+            in(ex, unite(a, a)),
+            in(ex, unite(b, b)),
+            rel_stmt(ex, rel_type::n_in, a),
+            rel_stmt(a, rel_type::eq, call(f, {a, b})),
+            rel_stmt(a, rel_type::eq, call(f, {b})),
+            forall(x, in(ex, a)),
+            forall(y, in(ey, a)),
+            forall(x, in(a, a)),
+            forall(x, implies(in(ex, a), in(ex, b))),
+            forall(x, forall(y, in(ex, ey))),
+            forall(x, forall(y, in(ey, ex))),
+            conj(forall(x, in(ex, a)), in(ex, a)),
+            forall(x, p),
+            truth(),
+            contradiction(),
+    };
+
+    test("run gives the same result as match", [&] {
+        std::size_t num_matches = 0;
+        for (const auto& law: stmts) {
+            const match_program program(*law);
+            for (const auto& app: stmts) {
+                const auto expected = match(*law, app);
+                const auto actual = program.run(app);
+                expectMsg(actual.has_value() == expected.has_value(), print_utf8(*law) + " on " + print_utf8(*app));
+                if (actual.has_value() && expected.has_value()) {
+                    num_matches += 1;
+                    expectMsg(same_result(*actual, *expected), print_utf8(*law) + " on " + print_utf8(*app));
+                }
+            }
+        }
+        expect(num_matches, isGreaterThan(stmts.size()));
+    });
+
+    test("instructions follow the law in pre-order", [&] {
+        const match_program program(*forall(x, implies(in(ex, a), in(ex, a))));
+        const std::vector<match_instruction> expected = {
+                {match_opcode::check_forall, 0},
+                {match_opcode::check_implies, 0},
+                {match_opcode::check_rel, static_cast<std::uint32_t>(rel_type::in)},
+                {match_opcode::check_bound_expr, 0},
+                {match_opcode::bind_expr, 0},
+                {match_opcode::check_rel, static_cast<std::uint32_t>(rel_type::in)},
+                {match_opcode::check_bound_expr, 0},
+                {match_opcode::compare_expr, 0},
+        };
+        expect(program.instructions() == expected, isTrue);
+    });
+
+    test("forall twice with the same variable is rejected", [&] {
+        expect(
+                [&] {
+                    (void)match_program(*forall(x, forall(x, in(ex, a))));
+                },
+                throwsA<std::runtime_error>);
+    });
+
+    test("code tree finds the same laws as match", [&] {
+        match_code_tree tree;
+        for (const auto& law: stmts) {
+            (void)tree.add(*law);
+        }
+        expect(tree.size(), isEqualTo(stmts.size()));
+        for (const auto& app: stmts) {
+            const auto matches = tree.match_all(app);
+            std::size_t k = 0;
+            for (std::size_t i = 0; i < stmts.size(); i++) {
+                const auto expected = match(*stmts[i], app);
+                if (!expected.has_value()) {
+                    continue;
+                }
+                expectMsg(k < matches.size() && matches[k].first == i, print_utf8(*stmts[i]) + " on " + print_utf8(*app));
+                if (k < matches.size() && matches[k].first == i) {
+                    expect(same_result(matches[k].second, *expected), isTrue);
+                }
+                k += 1;
+            }
+            expectMsg(matches.size() == k, print_utf8(*app));
+        }
+    });
+
+    test("code tree shares common prefixes", [&] {
+        match_code_tree tree;
+        for (const auto& law: {implies(in(ex, a), p), implies(in(ex, a), q), implies(in(ex, b), neg(p))}) {
+            (void)tree.add(*law);
+        }
+        // The first two laws have the same 5 instructions (q is bound to the same slot as p), and the third one shares
+        // their first 4 instructions, then checks a negation and binds p.
+        expect(tree.num_nodes(), isEqualTo(1U + 5U + 2U));
+        const auto matches = tree.match_all(implies(in(a, b), neg(q)));
+        expect(matches, hasSize(3));
+    });
+}
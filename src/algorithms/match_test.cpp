@@ -2,6 +2,7 @@
 
 #include <mcga/test_ext/matchers.hpp>
 
+#include "algorithms/congruence_closure.h"
 #include "algorithms/equals.h"
 #include "algorithms/print_utf8.h"
 
@@ -342,4 +343,34 @@ TEST_CASE("algorithms.match") {
             });
         });
     });
+
+    group("modulo equalities", [&] {
+        const auto x = var("x");
+        const auto y = var("y");
+        const auto s = var("s");
+        const auto t = var("t");
+        congruence_closure equalities;
+        equalities.add_equality(var_expr(s), var_expr(t));
+
+        test("repeated variable mapped to equal expressions", [&] {
+            const auto law = binop(var_expr(x), binop_type::set_union, var_expr(x));
+            const auto app = binop(var_expr(s), binop_type::set_union, var_expr(t));
+            expect(match(*law, app).has_value(), isFalse);
+            const auto result = match(*law, app, {}, &equalities);
+            expect(result.has_value(), isTrue);
+            expect(result->expr_replacements.at(x) == app->as_binop().left, isTrue);
+        });
+
+        test("repeated variable mapped to congruent expressions", [&] {
+            const auto law = rel_stmt(call(var_expr(y), {var_expr(x)}), rel_type::in, var_expr(x));
+            const auto app = rel_stmt(call(var_expr(y), {var_expr(s)}), rel_type::in, var_expr(t));
+            expect(match(*law, app, {}, &equalities).has_value(), isTrue);
+        });
+
+        test("repeated variable mapped to different expressions", [&] {
+            const auto law = binop(var_expr(x), binop_type::set_union, var_expr(x));
+            const auto app = binop(var_expr(s), binop_type::set_union, var_expr(y));
+            expect(match(*law, app, {}, &equalities).has_value(), isFalse);
+        });
+    });
 }
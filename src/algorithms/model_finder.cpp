@@ -0,0 +1,658 @@
+#include "algorithms/model_finder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
+#include "algorithms/threads.h"
+
+namespace tema {
+
+namespace {
+
+constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+constexpr std::int32_t unassigned = -1;
+
+struct var_usage {
+    bool element = false;
+    bool callee = false;
+    bool proposition = false;
+};
+
+using usage_map = std::map<const variable*, std::pair<variable_ptr, var_usage>>;
+
+void collect_free_usage(const expression& expr, std::vector<const variable*>& bound, usage_map& usage) {
+    const auto record = [&](const variable_ptr& var, bool is_callee) {
+        if (std::find(bound.begin(), bound.end(), var.get()) != bound.end()) {
+            return;
+        }
+        auto& entry = usage[var.get()];
+        entry.first = var;
+        (is_callee ? entry.second.callee : entry.second.element) = true;
+    };
+    if (expr.is_var()) {
+        record(expr.as_var(), false);
+    } else if (expr.is_binop()) {
+        collect_free_usage(*expr.as_binop().left, bound, usage);
+        collect_free_usage(*expr.as_binop().right, bound, usage);
+    } else {
+        const auto& callee = *expr.as_call().callee;
+        if (callee.is_var()) {
+            record(callee.as_var(), true);
+        } else {
+            collect_free_usage(callee, bound, usage);
+        }
+        for (const auto& param: expr.as_call().params) {
+            collect_free_usage(*param, bound, usage);
+        }
+    }
+}
+
+void collect_free_usage(const statement& stmt, std::vector<const variable*>& bound, usage_map& usage) {
+    if (stmt.is_var()) {
+        if (std::find(bound.begin(), bound.end(), stmt.as_var().get()) == bound.end()) {
+            auto& entry = usage[stmt.as_var().get()];
+            entry.first = stmt.as_var();
+            entry.second.proposition = true;
+        }
+    } else if (stmt.is_rel()) {
+        collect_free_usage(*stmt.as_rel().left, bound, usage);
+        collect_free_usage(*stmt.as_rel().right, bound, usage);
+    } else if (stmt.is_neg()) {
+        collect_free_usage(*stmt.as_neg().inner, bound, usage);
+    } else if (stmt.is_implies()) {
+        collect_free_usage(*stmt.as_implies().from, bound, usage);
+        collect_free_usage(*stmt.as_implies().to, bound, usage);
+    } else if (stmt.is_equiv()) {
+        collect_free_usage(*stmt.as_equiv().left, bound, usage);
+        collect_free_usage(*stmt.as_equiv().right, bound, usage);
+    } else if (stmt.is_conj() || stmt.is_disj()) {
+        for (const auto& child: stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner) {
+            collect_free_usage(*child, bound, usage);
+        }
+    } else if (stmt.is_forall()) {
+        bound.push_back(stmt.as_forall().var.get());
+        collect_free_usage(*stmt.as_forall().inner, bound, usage);
+        bound.pop_back();
+    }
+}
+
+// How a relationship type is evaluated: through equality or one of the base relations, possibly with the sides
+// swapped, and possibly negated.
+struct rel_meaning {
+    std::optional<rel_type> base;  // std::nullopt for equality.
+    bool swapped;
+    bool negated;
+};
+
+rel_meaning meaning_of(rel_type type) {
+    switch (type) {
+        case rel_type::eq: return {std::nullopt, false, false};
+        case rel_type::n_eq: return {std::nullopt, false, true};
+        case rel_type::less: return {rel_type::less, false, false};
+        case rel_type::n_less: return {rel_type::less, false, true};
+        case rel_type::greater: return {rel_type::less, true, false};
+        case rel_type::n_greater: return {rel_type::less, true, true};
+        case rel_type::eq_less: return {rel_type::eq_less, false, false};
+        case rel_type::n_eq_less: return {rel_type::eq_less, false, true};
+        case rel_type::eq_greater: return {rel_type::eq_less, true, false};
+        case rel_type::n_eq_greater: return {rel_type::eq_less, true, true};
+        case rel_type::in: return {rel_type::in, false, false};
+        case rel_type::n_in: return {rel_type::in, false, true};
+        case rel_type::is_included: return {rel_type::is_included, false, false};
+        case rel_type::n_is_included: return {rel_type::is_included, false, true};
+        case rel_type::includes: return {rel_type::is_included, true, false};
+        case rel_type::n_includes: return {rel_type::is_included, true, true};
+        case rel_type::eq_is_included: return {rel_type::eq_is_included, false, false};
+        case rel_type::n_eq_is_included: return {rel_type::eq_is_included, false, true};
+        case rel_type::eq_includes: return {rel_type::eq_is_included, true, false};
+        case rel_type::n_eq_includes: return {rel_type::eq_is_included, true, true};
+    }
+    return {std::nullopt, false, false};
+}
+
+struct symbol_info {
+    enum class origin_type { constant, proposition, function, binop, relation };
+
+    origin_type origin;
+    std::size_t arity;
+    variable_ptr var;
+    binop_type op = binop_type::set_union;
+    rel_type rel = rel_type::eq;
+
+    [[nodiscard]] bool is_boolean() const {
+        return origin == origin_type::proposition || origin == origin_type::relation;
+    }
+};
+
+struct term_node {
+    bool is_bound;
+    std::size_t index;  // The slot of a bound variable, or the applied symbol.
+    std::vector<std::size_t> args;
+};
+
+enum class formula_kind {
+    truth,
+    contradiction,
+    proposition,
+    bound_proposition,
+    neg,
+    conj,
+    disj,
+    implies,
+    equiv,
+    forall_element,
+    forall_boolean,
+    equal,
+    relation,
+};
+
+struct formula_node {
+    formula_kind kind;
+    std::size_t a = 0;  // Symbol, slot, child or left term.
+    std::size_t b = 0;  // Child or right term.
+    std::size_t symbol = 0;
+    std::vector<std::size_t> children{};
+};
+
+// The statements compiled to a tree of nodes, with all the variables resolved to symbols or quantifier slots.
+class problem {
+    std::vector<std::pair<const variable*, std::size_t>> scope;
+    std::vector<bool> slot_is_boolean;
+    std::map<std::pair<const variable*, std::size_t>, std::size_t> var_symbols;
+    std::map<binop_type, std::size_t> binop_symbols;
+    std::map<rel_type, std::size_t> relation_symbols;
+
+    std::size_t add_symbol(symbol_info info) {
+        symbols.push_back(std::move(info));
+        return symbols.size() - 1;
+    }
+
+    std::size_t add_formula(formula_node node) {
+        formulas.push_back(std::move(node));
+        return formulas.size() - 1;
+    }
+
+    std::size_t new_slot(const variable* var, bool is_boolean) {
+        slot_is_boolean.push_back(is_boolean);
+        scope.emplace_back(var, slot_is_boolean.size() - 1);
+        return slot_is_boolean.size() - 1;
+    }
+
+    std::size_t lookup(const variable* var) const {
+        for (auto it = scope.rbegin(); it != scope.rend(); ++it) {
+            if (it->first == var) {
+                return it->second;
+            }
+        }
+        return none;
+    }
+
+    std::size_t var_symbol(const variable_ptr& var, std::size_t arity, symbol_info::origin_type origin) {
+        const auto [it, inserted] = var_symbols.emplace(std::pair{var.get(), arity}, symbols.size());
+        if (inserted) {
+            add_symbol(symbol_info{origin, arity, var});
+        } else if (symbols[it->second].origin != origin) {
+            // The same variable used both as a proposition and as an element.
+            supported = false;
+        }
+        return it->second;
+    }
+
+    std::size_t compile_term(const expression& expr) {
+        if (expr.is_var()) {
+            const auto slot = lookup(expr.as_var().get());
+            if (slot != none) {
+                supported = supported && !slot_is_boolean[slot];
+                terms.push_back(term_node{true, slot, {}});
+            } else {
+                terms.push_back(term_node{false, var_symbol(expr.as_var(), 0, symbol_info::origin_type::constant), {}});
+            }
+            return terms.size() - 1;
+        }
+        if (expr.is_binop()) {
+            const auto type = expr.as_binop().type;
+            const auto [it, inserted] = binop_symbols.emplace(type, symbols.size());
+            if (inserted) {
+                add_symbol(symbol_info{symbol_info::origin_type::binop, 2, nullptr, type});
+            }
+            const auto left = compile_term(*expr.as_binop().left);
+            const auto right = compile_term(*expr.as_binop().right);
+            terms.push_back(term_node{false, it->second, {left, right}});
+            return terms.size() - 1;
+        }
+        const auto& callee = *expr.as_call().callee;
+        if (!callee.is_var() || lookup(callee.as_var().get()) != none) {
+            supported = false;
+            terms.push_back(term_node{false, 0, {}});
+            return terms.size() - 1;
+        }
+        std::vector<std::size_t> args;
+        for (const auto& param: expr.as_call().params) {
+            args.push_back(compile_term(*param));
+        }
+        const auto symbol = var_symbol(callee.as_var(), args.size(), symbol_info::origin_type::function);
+        terms.push_back(term_node{false, symbol, std::move(args)});
+        return terms.size() - 1;
+    }
+
+    std::size_t compile_forall(const variable_ptr& var, const statement& inner) {
+        std::vector<const variable*> bound;
+        usage_map usage;
+        collect_free_usage(inner, bound, usage);
+        const auto it = usage.find(var.get());
+        const auto flags = it != usage.end() ? it->second.second : var_usage{};
+        if (flags.callee || (flags.element && flags.proposition)) {
+            supported = false;
+        }
+        const auto slot = new_slot(var.get(), !flags.element);
+        const auto body = compile(inner);
+        scope.pop_back();
+        return add_formula({flags.element ? formula_kind::forall_element : formula_kind::forall_boolean, slot, body});
+    }
+
+    std::size_t compile(const statement& stmt) {
+        if (stmt.is_truth()) {
+            return add_formula({formula_kind::truth});
+        }
+        if (stmt.is_contradiction()) {
+            return add_formula({formula_kind::contradiction});
+        }
+        if (stmt.is_var()) {
+            const auto slot = lookup(stmt.as_var().get());
+            if (slot != none) {
+                supported = supported && slot_is_boolean[slot];
+                return add_formula({formula_kind::bound_proposition, slot});
+            }
+            return add_formula(
+              {formula_kind::proposition, var_symbol(stmt.as_var(), 0, symbol_info::origin_type::proposition)});
+        }
+        if (stmt.is_neg()) {
+            return add_formula({formula_kind::neg, compile(*stmt.as_neg().inner)});
+        }
+        if (stmt.is_conj() || stmt.is_disj()) {
+            formula_node node{stmt.is_conj() ? formula_kind::conj : formula_kind::disj};
+            for (const auto& child: stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner) {
+                node.children.push_back(compile(*child));
+            }
+            return add_formula(std::move(node));
+        }
+        if (stmt.is_implies()) {
+            const auto from = compile(*stmt.as_implies().from);
+            return add_formula({formula_kind::implies, from, compile(*stmt.as_implies().to)});
+        }
+        if (stmt.is_equiv()) {
+            const auto left = compile(*stmt.as_equiv().left);
+            return add_formula({formula_kind::equiv, left, compile(*stmt.as_equiv().right)});
+        }
+        if (stmt.is_forall()) {
+            return compile_forall(stmt.as_forall().var, *stmt.as_forall().inner);
+        }
+        const auto& rel = stmt.as_rel();
+        const auto meaning = meaning_of(rel.type);
+        auto left = compile_term(*rel.left);
+        auto right = compile_term(*rel.right);
+        if (meaning.swapped) {
+            std::swap(left, right);
+        }
+        std::size_t result;
+        if (meaning.base.has_value()) {
+            const auto [it, inserted] = relation_symbols.emplace(*meaning.base, symbols.size());
+            if (inserted) {
+                add_symbol(symbol_info{symbol_info::origin_type::relation, 2, nullptr, binop_type::set_union, *meaning.base});
+            }
+            result = add_formula({formula_kind::relation, left, right, it->second});
+        } else {
+            result = add_formula({formula_kind::equal, left, right});
+        }
+        return meaning.negated ? add_formula({formula_kind::neg, result}) : result;
+    }
+
+    // Hypotheses hold for all the values of their free variables, except for the function symbols.
+    std::size_t compile_closed(const statement& stmt) {
+        std::vector<const variable*> bound;
+        usage_map usage;
+        collect_free_usage(stmt, bound, usage);
+        std::vector<std::pair<std::size_t, bool>> quantifiers;
+        for (const auto& [var, entry]: usage) {
+            const auto& flags = entry.second;
+            if (flags.element || flags.proposition) {
+                if (flags.element && flags.proposition) {
+                    supported = false;
+                }
+                quantifiers.emplace_back(new_slot(var, !flags.element), flags.element);
+            }
+        }
+        auto result = compile(stmt);
+        for (auto it = quantifiers.rbegin(); it != quantifiers.rend(); ++it) {
+            scope.pop_back();
+            result = add_formula(
+              {it->second ? formula_kind::forall_element : formula_kind::forall_boolean, it->first, result});
+        }
+        return result;
+    }
+
+public:
+    std::vector<symbol_info> symbols;
+    std::vector<term_node> terms;
+    std::vector<formula_node> formulas;
+    std::size_t root = 0;
+    std::size_t num_slots = 0;
+    bool supported = true;
+
+    problem(const std::vector<statement_ptr>& hypotheses, const statement& stmt) {
+        formula_node goal{formula_kind::conj};
+        for (const auto& hypothesis: hypotheses) {
+            goal.children.push_back(compile_closed(*hypothesis));
+        }
+        goal.children.push_back(add_formula({formula_kind::neg, compile(stmt)}));
+        root = add_formula(std::move(goal));
+        num_slots = slot_is_boolean.size();
+    }
+};
+
+enum class truth_value : std::uint8_t { false_value, true_value, unknown };
+
+enum class search_outcome { found, exhausted, aborted };
+
+// Backtracking search for a model of a problem's goal, over one domain size.
+class model_search {
+    const problem& prob;
+    std::int32_t domain_size;
+    std::vector<std::vector<std::int32_t>> cells;
+    std::vector<std::int32_t> env;
+    std::size_t blocking_symbol = none;
+    std::size_t blocking_cell = 0;
+    std::int32_t max_used = -1;
+    std::uint64_t budget;
+    const std::atomic<std::size_t>& best_size;
+
+    std::int32_t eval_term(std::size_t index) {
+        const auto& term = prob.terms[index];
+        if (term.is_bound) {
+            return env[term.index];
+        }
+        std::size_t cell = 0;
+        for (auto it = term.args.rbegin(); it != term.args.rend(); ++it) {
+            const auto value = eval_term(*it);
+            if (value == unassigned) {
+                return unassigned;
+            }
+            cell = cell * static_cast<std::size_t>(domain_size) + static_cast<std::size_t>(value);
+        }
+        return lookup(term.index, cell);
+    }
+
+    std::int32_t lookup(std::size_t symbol, std::size_t cell) {
+        const auto value = cells[symbol][cell];
+        if (value == unassigned && blocking_symbol == none) {
+            blocking_symbol = symbol;
+            blocking_cell = cell;
+        }
+        return value;
+    }
+
+    static truth_value from_value(std::int32_t value) {
+        if (value == unassigned) {
+            return truth_value::unknown;
+        }
+        return value != 0 ? truth_value::true_value : truth_value::false_value;
+    }
+
+    static truth_value negate(truth_value value) {
+        switch (value) {
+            case truth_value::false_value: return truth_value::true_value;
+            case truth_value::true_value: return truth_value::false_value;
+            case truth_value::unknown: break;
+        }
+        return truth_value::unknown;
+    }
+
+    // Kleene's three-valued logic: unknown when the value depends on unassigned cells.
+    truth_value eval(std::size_t index) {
+        const auto& node = prob.formulas[index];
+        switch (node.kind) {
+            case formula_kind::truth: return truth_value::true_value;
+            case formula_kind::contradiction: return truth_value::false_value;
+            case formula_kind::proposition: return from_value(lookup(node.a, 0));
+            case formula_kind::bound_proposition: return from_value(env[node.a]);
+            case formula_kind::neg: return negate(eval(node.a));
+            case formula_kind::conj:
+            case formula_kind::disj: {
+                // A conjunction is decided by a false child, a disjunction by a true one.
+                const auto decisive = node.kind == formula_kind::conj ? truth_value::false_value : truth_value::true_value;
+                auto result = negate(decisive);
+                for (const auto child: node.children) {
+                    const auto value = eval(child);
+                    if (value == decisive) {
+                        return decisive;
+                    }
+                    if (value == truth_value::unknown) {
+                        result = truth_value::unknown;
+                    }
+                }
+                return result;
+            }
+            case formula_kind::implies: {
+                const auto from = eval(node.a);
+                if (from == truth_value::false_value) {
+                    return truth_value::true_value;
+                }
+                const auto to = eval(node.b);
+                if (to == truth_value::true_value) {
+                    return truth_value::true_value;
+                }
+                return from == truth_value::true_value && to == truth_value::false_value ? truth_value::false_value
+                                                                                         : truth_value::unknown;
+            }
+            case formula_kind::equiv: {
+                const auto left = eval(node.a);
+                if (left == truth_value::unknown) {
+                    return truth_value::unknown;
+                }
+                const auto right = eval(node.b);
+                if (right == truth_value::unknown) {
+                    return truth_value::unknown;
+                }
+                return left == right ? truth_value::true_value : truth_value::false_value;
+            }
+            case formula_kind::forall_element:
+            case formula_kind::forall_boolean: {
+                const auto num_values = node.kind == formula_kind::forall_element ? domain_size : 2;
+                auto result = truth_value::true_value;
+                for (std::int32_t value = 0; value < num_values; value++) {
+                    env[node.a] = value;
+                    const auto inner = eval(node.b);
+                    if (inner == truth_value::false_value) {
+                        return truth_value::false_value;
+                    }
+                    if (inner == truth_value::unknown) {
+                        result = truth_value::unknown;
+                    }
+                }
+                return result;
+            }
+            case formula_kind::equal: {
+                const auto left = eval_term(node.a);
+                const auto right = eval_term(node.b);
+                if (left == unassigned || right == unassigned) {
+                    return truth_value::unknown;
+                }
+                return left == right ? truth_value::true_value : truth_value::false_value;
+            }
+            case formula_kind::relation: {
+                const auto left = eval_term(node.a);
+                const auto right = eval_term(node.b);
+                if (left == unassigned || right == unassigned) {
+                    return truth_value::unknown;
+                }
+                const auto cell = static_cast<std::size_t>(right) * static_cast<std::size_t>(domain_size) +
+                                  static_cast<std::size_t>(left);
+                return from_value(lookup(node.symbol, cell));
+            }
+        }
+        return truth_value::unknown;
+    }
+
+    search_outcome search() {
+        if (budget == 0 || best_size.load(std::memory_order_relaxed) < static_cast<std::size_t>(domain_size)) {
+            return search_outcome::aborted;
+        }
+        budget--;
+        blocking_symbol = none;
+        const auto value = eval(prob.root);
+        if (value != truth_value::unknown) {
+            return value == truth_value::true_value ? search_outcome::found : search_outcome::exhausted;
+        }
+
+        const auto symbol = blocking_symbol;
+        const auto cell = blocking_cell;
+        const auto& info = prob.symbols[symbol];
+        // Least number heuristic: elements above max_used (and not arguments of this cell) are interchangeable, so
+        // only the first of them needs to be tried.
+        auto used = max_used;
+        for (auto rest = cell, i = std::size_t{0}; i < info.arity; i++) {
+            used = std::max(used, static_cast<std::int32_t>(rest % static_cast<std::size_t>(domain_size)));
+            rest /= static_cast<std::size_t>(domain_size);
+        }
+        const auto num_values = info.is_boolean() ? 2 : std::min(domain_size, used + 2);
+        const auto previous_max_used = max_used;
+        for (std::int32_t candidate = 0; candidate < num_values; candidate++) {
+            cells[symbol][cell] = candidate;
+            max_used = info.is_boolean() ? used : std::max(used, candidate);
+            const auto outcome = search();
+            if (outcome != search_outcome::exhausted) {
+                return outcome;
+            }
+        }
+        cells[symbol][cell] = unassigned;
+        max_used = previous_max_used;
+        return search_outcome::exhausted;
+    }
+
+public:
+    model_search(const problem& prob,
+                 std::size_t domain_size,
+                 std::uint64_t budget,
+                 const std::atomic<std::size_t>& best_size)
+        : prob(prob), domain_size(static_cast<std::int32_t>(domain_size)), env(prob.num_slots, 0), budget(budget),
+          best_size(best_size) {
+        for (const auto& symbol: prob.symbols) {
+            std::size_t size = 1;
+            for (std::size_t i = 0; i < symbol.arity; i++) {
+                size *= domain_size;
+            }
+            cells.emplace_back(size, unassigned);
+        }
+    }
+
+    std::optional<finite_model> run() {
+        if (search() != search_outcome::found) {
+            return std::nullopt;
+        }
+        finite_model model;
+        model.domain_size = static_cast<std::size_t>(domain_size);
+        for (std::size_t i = 0; i < prob.symbols.size(); i++) {
+            const auto& symbol = prob.symbols[i];
+            std::vector<std::size_t> values;
+            for (const auto value: cells[i]) {
+                values.push_back(value == unassigned ? 0 : static_cast<std::size_t>(value));
+            }
+            switch (symbol.origin) {
+                case symbol_info::origin_type::constant: model.elements.emplace(symbol.var, values[0]); break;
+                case symbol_info::origin_type::proposition: model.propositions.emplace(symbol.var, values[0] != 0); break;
+                case symbol_info::origin_type::function:
+                    model.functions.push_back(finite_model::function_table{symbol.var, symbol.arity, std::move(values)});
+                    break;
+                case symbol_info::origin_type::binop: model.binops.emplace(symbol.op, std::move(values)); break;
+                case symbol_info::origin_type::relation: {
+                    std::vector<bool> relation;
+                    for (const auto value: values) {
+                        relation.push_back(value != 0);
+                    }
+                    model.relations.emplace(symbol.rel, std::move(relation));
+                    break;
+                }
+            }
+        }
+        return model;
+    }
+};
+
+bool table_sizes_fit(const problem& prob, std::size_t domain_size) {
+    constexpr std::size_t max_cells = std::size_t{1} << 24U;
+    for (const auto& symbol: prob.symbols) {
+        std::size_t size = 1;
+        for (std::size_t i = 0; i < symbol.arity; i++) {
+            size *= domain_size;
+            if (size > max_cells) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+std::optional<finite_model> find_counterexample(const std::vector<statement_ptr>& hypotheses,
+                                                const statement_ptr& stmt,
+                                                const model_finder_options& options) {
+    const problem prob(hypotheses, *stmt);
+    if (!prob.supported || options.max_domain_size == 0) {
+        return std::nullopt;
+    }
+
+    std::atomic<std::size_t> best_size{none};
+    std::atomic<std::size_t> next_size{1};
+    std::vector<std::optional<finite_model>> models(options.max_domain_size + 1);
+    const auto worker = [&] {
+        while (true) {
+            const auto size = next_size.fetch_add(1, std::memory_order_relaxed);
+            if (size > options.max_domain_size || size > best_size.load(std::memory_order_relaxed)) {
+                break;
+            }
+            if (!table_sizes_fit(prob, size)) {
+                break;
+            }
+            models[size] = model_search(prob, size, options.max_assignments, best_size).run();
+            if (models[size].has_value()) {
+                auto current = best_size.load(std::memory_order_relaxed);
+                while (size < current && !best_size.compare_exchange_weak(current, size, std::memory_order_relaxed)) {
+                }
+            }
+        }
+    };
+
+    const std::size_t num_threads = std::min<std::size_t>(
+      options.num_threads != 0 ? options.num_threads : std::thread::hardware_concurrency(), options.max_domain_size);
+    run_on_threads(num_threads, [&](std::size_t) {
+        worker();
+    });
+
+    const auto best = best_size.load();
+    if (best == none) {
+        return std::nullopt;
+    }
+    return std::move(models[best]);
+}
+
+std::vector<theorem_counterexample> find_counterexamples(const module& mod, const model_finder_options& options) {
+    std::vector<theorem_counterexample> results;
+    std::vector<statement_ptr> definitions;
+    for (const auto& decl: mod.get_decls()) {
+        if (!holds_alternative<stmt_decl>(decl)) {
+            continue;
+        }
+        const auto& stmt = get<stmt_decl>(decl);
+        if (stmt.type == stmt_decl_type::definition) {
+            definitions.push_back(stmt.stmt);
+        } else {
+            results.push_back(theorem_counterexample{stmt.name, find_counterexample(definitions, stmt.stmt, options)});
+        }
+    }
+    return results;
+}
+
+}  // namespace tema
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/module.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// An interpretation over the domain {0, ..., domain_size - 1}. Tables are indexed by their arguments, the first
+// argument being the least significant digit in base domain_size. Cells the search never needed are 0 (or false).
+struct finite_model {
+    struct function_table {
+        variable_ptr symbol;
+        std::size_t arity;
+        std::vector<std::size_t> values;
+    };
+
+    std::size_t domain_size = 0;
+    // The free variables of the falsified statement.
+    std::map<variable_ptr, std::size_t> elements;
+    std::map<variable_ptr, bool> propositions;
+    // Variables used as callees.
+    std::vector<function_table> functions;
+    std::map<binop_type, std::vector<std::size_t>> binops;
+    // Equality is the identity of the domain. The other relationships are derived from these base relations: the
+    // negated types are their complements, and >, ≥, ⊃ and ⊇ are <, ≤, ⊂ and ⊆ with the sides swapped.
+    std::map<rel_type, std::vector<bool>> relations;
+};
+
+struct model_finder_options {
+    // Domains of sizes 1, ..., max_domain_size are searched, and the smallest counterexample is returned.
+    std::size_t max_domain_size = 4;
+    // Defaults to the number of hardware threads. Each thread searches a different domain size.
+    std::size_t num_threads = 0;
+    // Search budget for each domain size, in number of cell assignments.
+    std::uint64_t max_assignments = 1'000'000;
+};
+
+struct theorem_counterexample {
+    std::string name;
+    std::optional<finite_model> counterexample;
+};
+
+// Searches for a finite model of the hypotheses in which stmt is false.
+//
+// Expressions are interpreted as elements of the domain: variables used as callees are function symbols, binops are
+// binary function symbols, and relationships are binary relations (see finite_model). Variables used as statements
+// are propositions. Like in laws, the free variables of the hypotheses are universally quantified, while the free
+// variables of stmt are constants of the model. Function symbols are shared by all the statements.
+//
+// The search assigns the cells of the tables lazily, only when evaluating the statements needs them, and prunes
+// assignments that already falsify a hypothesis or satisfy stmt. Domain elements not used by any assigned cell are
+// interchangeable, so only the smallest of them is tried for a new cell (least number heuristic).
+//
+// Returns std::nullopt when no counterexample exists up to the maximum domain size, when the budget runs out, or
+// when a forall binds a variable used as a callee (quantifying over functions is not supported).
+[[nodiscard]] std::optional<finite_model> find_counterexample(const std::vector<statement_ptr>& hypotheses,
+                                                              const statement_ptr& stmt,
+                                                              const model_finder_options& options = {});
+
+// Searches a counterexample for every theorem and exercise of a module, in declaration order, with the definitions
+// declared before it as hypotheses.
+[[nodiscard]] std::vector<theorem_counterexample> find_counterexamples(const module& mod,
+                                                                       const model_finder_options& options = {});
+
+}  // namespace tema
@@ -0,0 +1,114 @@
+#include "algorithms/model_finder.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+using namespace tema;
+using namespace mcga::matchers;
+
+TEST_CASE("algorithms.model_finder") {
+    const auto p = var("p");
+    const auto q = var("q");
+    const auto vp = var_stmt(p);
+    const auto vq = var_stmt(q);
+    const auto a = var("A");
+    const auto b = var("B");
+    const auto x = var("x");
+    const auto t = var("t");
+    const auto f = var("f");
+    const auto ea = var_expr(a);
+    const auto eb = var_expr(b);
+    const auto ex = var_expr(x);
+    const auto et = var_expr(t);
+    const auto set_union = [](expr_ptr l, expr_ptr r) {
+        return binop(std::move(l), binop_type::set_union, std::move(r));
+    };
+    const auto set_intersection = [](expr_ptr l, expr_ptr r) {
+        return binop(std::move(l), binop_type::set_intersection, std::move(r));
+    };
+    const auto in = [](expr_ptr l, expr_ptr r) {
+        return rel_stmt(std::move(l), rel_type::in, std::move(r));
+    };
+    // Extensionality and the definitions of ∪ and ∩ through ∈, like in set_theory.tema.
+    const std::vector<statement_ptr> set_theory{
+      equiv(rel_stmt(ea, rel_type::eq, eb), forall(t, equiv(in(et, ea), in(et, eb)))),
+      equiv(in(ex, set_union(ea, eb)), disj(in(ex, ea), in(ex, eb))),
+      equiv(in(ex, set_intersection(ea, eb)), conj(in(ex, ea), in(ex, eb))),
+    };
+
+    test("propositional counterexample", [&] {
+        const auto model = find_counterexample({}, implies(vp, vq));
+        expect(model.has_value(), isTrue);
+        expect(model->domain_size, std::size_t{1});
+        expect(model->propositions.at(p), true);
+        expect(model->propositions.at(q), false);
+    });
+
+    test("valid statements have no counterexample", [&] {
+        expect(find_counterexample({}, disj(vp, neg(vp))).has_value(), isFalse);
+        expect(find_counterexample({}, rel_stmt(ex, rel_type::eq, ex)).has_value(), isFalse);
+        expect(find_counterexample({}, forall(x, rel_stmt(ex, rel_type::eq, ex))).has_value(), isFalse);
+        expect(find_counterexample({vp}, vp).has_value(), isFalse);
+    });
+
+    test("hypotheses constrain the model", [&] {
+        expect(find_counterexample({implies(vp, vq), vp}, vq).has_value(), isFalse);
+        // Free variables of hypotheses are universally quantified.
+        const auto commutative = rel_stmt(set_union(ea, eb), rel_type::eq, set_union(eb, ea));
+        expect(find_counterexample({commutative}, rel_stmt(set_union(eb, ea), rel_type::eq, set_union(ea, eb))).has_value(), isFalse);
+        expect(find_counterexample({}, commutative).has_value(), isTrue);
+    });
+
+    test("function symbols", [&] {
+        const auto model = find_counterexample({}, rel_stmt(call(var_expr(f), {ex}), rel_type::eq, ex));
+        expect(model.has_value(), isTrue);
+        expect(model->domain_size, std::size_t{2});
+        expect(model->functions, hasSize(1));
+        const auto& table = model->functions[0];
+        expect(table.arity, std::size_t{1});
+        expect(table.values[model->elements.at(x)] != model->elements.at(x), isTrue);
+
+        // ∀x f(x)=x forces f to be the identity.
+        const auto identity = forall(x, rel_stmt(call(var_expr(f), {ex}), rel_type::eq, ex));
+        expect(find_counterexample({identity}, rel_stmt(call(var_expr(f), {call(var_expr(f), {ea})}), rel_type::eq, ea)).has_value(), isFalse);
+    });
+
+    test("set theory", [&] {
+        const auto options = model_finder_options{3, 1, 1'000'000};
+        expect(find_counterexample(set_theory, rel_stmt(set_union(ea, eb), rel_type::eq, set_union(eb, ea)), options).has_value(), isFalse);
+        expect(find_counterexample(set_theory, rel_stmt(set_intersection(ea, ea), rel_type::eq, ea), options).has_value(), isFalse);
+
+        const auto model = find_counterexample(set_theory, rel_stmt(set_union(ea, eb), rel_type::eq, set_intersection(ea, eb)), options);
+        expect(model.has_value(), isTrue);
+        expect(model->elements.at(a) != model->elements.at(b), isTrue);
+        expect(model->relations.count(rel_type::in), std::size_t{1});
+    });
+
+    test("threads find the smallest counterexample", [&] {
+        // Needs three distinct elements.
+        const auto c = var_expr(var("C"));
+        const auto stmt = disj(rel_stmt(ea, rel_type::eq, eb), rel_stmt(eb, rel_type::eq, c), rel_stmt(ea, rel_type::eq, c));
+        for (const auto num_threads: {std::size_t{1}, std::size_t{2}, std::size_t{4}}) {
+            const auto model = find_counterexample({}, stmt, model_finder_options{5, num_threads, 1'000'000});
+            expect(model.has_value(), isTrue);
+            expect(model->domain_size, std::size_t{3});
+        }
+        expect(find_counterexample({}, stmt, model_finder_options{2, 2, 1'000'000}).has_value(), isFalse);
+    });
+
+    test("quantifying over functions is not supported", [&] {
+        expect(find_counterexample({}, forall(f, rel_stmt(call(var_expr(f), {ex}), rel_type::eq, ex))).has_value(), isFalse);
+    });
+
+    test("module theorems", [&] {
+        module mod("test", "test.tema");
+        mod.add_statement_decl(stmt_decl{{1, 1}, false, stmt_decl_type::definition, "def", implies(conj(vp, vq), vp), std::nullopt});
+        mod.add_statement_decl(stmt_decl{{2, 1}, false, stmt_decl_type::theorem, "right", implies(conj(vq, vp), vq), std::nullopt});
+        mod.add_statement_decl(stmt_decl{{3, 1}, false, stmt_decl_type::exercise, "wrong", implies(vq, vp), std::nullopt});
+        const auto results = find_counterexamples(mod);
+        expect(results, hasSize(2));
+        expect(results[0].name, "right");
+        expect(results[0].counterexample.has_value(), isFalse);
+        expect(results[1].name, "wrong");
+        expect(results[1].counterexample.has_value(), isTrue);
+    });
+}
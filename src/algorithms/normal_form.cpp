@@ -0,0 +1,235 @@
+#include "algorithms/normal_form.h"
+
+#include <set>
+#include <string>
+
+namespace tema {
+
+namespace {
+
+bool is_atom(const statement& stmt) {
+    return stmt.is_var() || stmt.is_rel() || stmt.is_forall();
+}
+
+// Build a flattened conjunction (or disjunction), folding truth and contradiction. If the result has exactly the
+// children of "original", the original statement is returned to preserve sharing.
+template<bool is_conj>
+statement_ptr make_flat(const std::vector<statement_ptr>& children, const statement_ptr& original = nullptr) {
+    // Neutral element: truth for conjunction, contradiction for disjunction. The absorbing element is the other one.
+    std::vector<statement_ptr> flat;
+    flat.reserve(children.size());
+    for (const auto& child: children) {
+        if (is_conj ? child->is_truth() : child->is_contradiction()) {
+            continue;
+        }
+        if (is_conj ? child->is_contradiction() : child->is_truth()) {
+            return child;
+        }
+        if (is_conj ? child->is_conj() : child->is_disj()) {
+            const auto& grandchildren = is_conj ? child->as_conj().inner : child->as_disj().inner;
+            flat.insert(flat.end(), grandchildren.begin(), grandchildren.end());
+        } else {
+            flat.push_back(child);
+        }
+    }
+    if (flat.empty()) {
+        return is_conj ? truth() : contradiction();
+    }
+    if (flat.size() == 1) {
+        return flat[0];
+    }
+    if (original != nullptr && (is_conj ? original->is_conj() : original->is_disj())) {
+        const auto& original_children = is_conj ? original->as_conj().inner : original->as_disj().inner;
+        if (original_children == flat) {
+            return original;
+        }
+    }
+    return is_conj ? conj(std::move(flat)) : disj(std::move(flat));
+}
+
+}  // namespace
+
+bool is_literal(const statement& stmt) {
+    return is_atom(stmt) || (stmt.is_neg() && is_atom(*stmt.as_neg().inner));
+}
+
+statement_ptr normal_form_converter::nnf(const statement_ptr& stmt) {
+    return nnf_with_polarity(stmt, true);
+}
+
+statement_ptr normal_form_converter::nnf_with_polarity(const statement_ptr& stmt, bool positive) {
+    auto& memo = nnf_memo[positive ? 1 : 0];
+    const auto it = memo.find(stmt.get());
+    if (it != memo.end()) {
+        return it->second.result;
+    }
+    const auto nnf_children = [&](const std::vector<statement_ptr>& children, bool child_positive) {
+        std::vector<statement_ptr> result;
+        result.reserve(children.size());
+        for (const auto& child: children) {
+            result.push_back(nnf_with_polarity(child, child_positive));
+        }
+        return result;
+    };
+    statement_ptr result;
+    if (stmt->is_truth() || stmt->is_contradiction()) {
+        result = positive ? stmt : (stmt->is_truth() ? contradiction() : truth());
+    } else if (is_atom(*stmt)) {
+        result = positive ? stmt : neg(stmt);
+    } else if (stmt->is_neg() && positive && is_atom(*stmt->as_neg().inner)) {
+        result = stmt;
+    } else if (stmt->is_neg()) {
+        result = nnf_with_polarity(stmt->as_neg().inner, !positive);
+    } else if (stmt->is_conj()) {
+        const auto children = nnf_children(stmt->as_conj().inner, positive);
+        result = positive ? make_flat<true>(children, stmt) : make_flat<false>(children);
+    } else if (stmt->is_disj()) {
+        const auto children = nnf_children(stmt->as_disj().inner, positive);
+        result = positive ? make_flat<false>(children, stmt) : make_flat<true>(children);
+    } else if (stmt->is_implies()) {
+        // A→B is ¬A∨B, and ¬(A→B) is A∧¬B.
+        const auto& [from, to] = stmt->as_implies();
+        result = positive ? make_flat<false>({nnf_with_polarity(from, false), nnf_with_polarity(to, true)})
+                          : make_flat<true>({nnf_with_polarity(from, true), nnf_with_polarity(to, false)});
+    } else {
+        // A⟷B is (¬A∨B)∧(A∨¬B), and ¬(A⟷B) is (A∨B)∧(¬A∨¬B).
+        const auto& [left, right] = stmt->as_equiv();
+        const auto pos_left = nnf_with_polarity(left, true);
+        const auto neg_left = nnf_with_polarity(left, false);
+        const auto pos_right = nnf_with_polarity(right, true);
+        const auto neg_right = nnf_with_polarity(right, false);
+        if (positive) {
+            result = make_flat<true>({make_flat<false>({neg_left, pos_right}), make_flat<false>({pos_left, neg_right})});
+        } else {
+            result = make_flat<true>({make_flat<false>({pos_left, pos_right}), make_flat<false>({neg_left, neg_right})});
+        }
+    }
+    memo.emplace(stmt.get(), memo_entry<statement_ptr>{stmt, result});
+    return result;
+}
+
+statement_ptr normal_form_converter::dnf(const statement_ptr& stmt) {
+    const auto& cubes = dnf_cubes(nnf(stmt));
+    std::vector<statement_ptr> disjuncts;
+    disjuncts.reserve(cubes.size());
+    for (const auto& cube: cubes) {
+        disjuncts.push_back(make_flat<true>(cube));
+    }
+    return make_flat<false>(disjuncts);
+}
+
+auto normal_form_converter::dnf_cubes(const statement_ptr& nnf_stmt) -> const cube_list& {
+    const auto it = dnf_memo.find(nnf_stmt.get());
+    if (it != dnf_memo.end()) {
+        return it->second.result;
+    }
+    cube_list cubes;
+    if (nnf_stmt->is_truth()) {
+        cubes.emplace_back();
+    } else if (nnf_stmt->is_disj()) {
+        for (const auto& child: nnf_stmt->as_disj().inner) {
+            const auto& child_cubes = dnf_cubes(child);
+            cubes.insert(cubes.end(), child_cubes.begin(), child_cubes.end());
+        }
+    } else if (nnf_stmt->is_conj()) {
+        // Distribute: every combination of one cube from each child.
+        cubes.emplace_back();
+        for (const auto& child: nnf_stmt->as_conj().inner) {
+            const auto& child_cubes = dnf_cubes(child);
+            cube_list product;
+            product.reserve(cubes.size() * child_cubes.size());
+            for (const auto& cube: cubes) {
+                for (const auto& child_cube: child_cubes) {
+                    auto& new_cube = product.emplace_back(cube);
+                    new_cube.insert(new_cube.end(), child_cube.begin(), child_cube.end());
+                }
+            }
+            cubes = std::move(product);
+        }
+    } else if (!nnf_stmt->is_contradiction()) {
+        cubes.push_back({nnf_stmt});
+    }
+    return dnf_memo.emplace(nnf_stmt.get(), memo_entry<cube_list>{nnf_stmt, std::move(cubes)}).first->second.result;
+}
+
+tseitin_cnf_result normal_form_converter::cnf(const statement_ptr& stmt) {
+    const auto nnf_stmt = nnf(stmt);
+    if (nnf_stmt->is_truth() || nnf_stmt->is_contradiction()) {
+        return {nnf_stmt, {}};
+    }
+    std::vector<statement_ptr> clauses;
+    std::vector<const tseitin_definition*> dependencies;
+    if (nnf_stmt->is_conj()) {
+        for (const auto& child: nnf_stmt->as_conj().inner) {
+            clauses.push_back(tseitin_clause(child, dependencies));
+        }
+    } else {
+        clauses.push_back(tseitin_clause(nnf_stmt, dependencies));
+    }
+
+    // Add the defining clauses of all the definitions reachable from the top-level clauses, once each.
+    tseitin_cnf_result result;
+    std::set<const tseitin_definition*> visited(dependencies.begin(), dependencies.end());
+    while (!dependencies.empty()) {
+        const auto* definition = dependencies.back();
+        dependencies.pop_back();
+        result.definitions.emplace_back(definition->var, definition->named);
+        clauses.insert(clauses.end(), definition->clauses.begin(), definition->clauses.end());
+        for (const auto* dependency: definition->dependencies) {
+            if (visited.insert(dependency).second) {
+                dependencies.push_back(dependency);
+            }
+        }
+    }
+    result.stmt = conj(std::move(clauses));
+    return result;
+}
+
+statement_ptr normal_form_converter::tseitin_clause(const statement_ptr& nnf_stmt, std::vector<const tseitin_definition*>& dependencies) {
+    const auto literal_for = [&](const statement_ptr& child) {
+        if (is_literal(*child)) {
+            return child;
+        }
+        const auto& definition = tseitin_define(child);
+        dependencies.push_back(&definition);
+        return var_stmt(definition.var);
+    };
+    std::vector<statement_ptr> literals;
+    if (nnf_stmt->is_disj()) {
+        for (const auto& child: nnf_stmt->as_disj().inner) {
+            literals.push_back(literal_for(child));
+        }
+    } else {
+        literals.push_back(literal_for(nnf_stmt));
+    }
+    return disj(std::move(literals));
+}
+
+auto normal_form_converter::tseitin_define(const statement_ptr& nnf_stmt) -> const tseitin_definition& {
+    const auto it = tseitin_memo.find(nnf_stmt.get());
+    if (it != tseitin_memo.end()) {
+        return it->second.result;
+    }
+    // As the statement is in NNF, it only occurs with positive polarity, so it is enough to define x→stmt
+    // (Plaisted-Greenbaum) instead of the full x⟷stmt.
+    tseitin_definition definition{var("τ" + std::to_string(++num_fresh_vars)), nnf_stmt, {}, {}};
+    const auto not_x = neg(var_stmt(definition.var));
+    if (nnf_stmt->is_conj()) {
+        // x→(A∧B) is (¬x∨A)∧(¬x∨B)
+        for (const auto& child: nnf_stmt->as_conj().inner) {
+            const auto clause = tseitin_clause(child, definition.dependencies);
+            std::vector<statement_ptr> literals{not_x};
+            literals.insert(literals.end(), clause->as_disj().inner.begin(), clause->as_disj().inner.end());
+            definition.clauses.push_back(disj(std::move(literals)));
+        }
+    } else {
+        // x→(A∨B) is ¬x∨A∨B
+        const auto clause = tseitin_clause(nnf_stmt, definition.dependencies);
+        std::vector<statement_ptr> literals{not_x};
+        literals.insert(literals.end(), clause->as_disj().inner.begin(), clause->as_disj().inner.end());
+        definition.clauses.push_back(disj(std::move(literals)));
+    }
+    return tseitin_memo.emplace(nnf_stmt.get(), memo_entry<tseitin_definition>{nnf_stmt, std::move(definition)}).first->second.result;
+}
+
+}  // namespace tema
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/statement.h"
+
+namespace tema {
+
+struct tseitin_cnf_result {
+    // A conjunction of disjunctions of literals, satisfiable if and only if the original statement is.
+    statement_ptr stmt;
+    // The fresh variables introduced to name sub-statements, each with the sub-statement (in NNF) it names.
+    std::vector<std::pair<variable_ptr, statement_ptr>> definitions;
+};
+
+// Converts statements to negation, disjunctive and conjunctive normal forms. Variables, relationships and forall
+// statements are the atoms of the conversions. Nested conjunctions and disjunctions are flattened, and truth and
+// contradiction are folded away.
+//
+// Results are memoized per sub-statement, so a converter should be reused when normalizing many statements that
+// share sub-statements (e.g. all the laws of a module).
+class normal_form_converter {
+    template<class T>
+    struct memo_entry {
+        statement_ptr source;  // Keeps the key alive, so its address is not reused.
+        T result;
+    };
+    template<class T>
+    using memo_table = std::unordered_map<const statement*, memo_entry<T>>;
+
+    using cube_list = std::vector<std::vector<statement_ptr>>;
+
+    // A fresh variable naming a sub-statement, with the clauses defining it. Definitions are shared between the
+    // results of all the conversions that need them.
+    struct tseitin_definition {
+        variable_ptr var;
+        statement_ptr named;
+        std::vector<statement_ptr> clauses;
+        std::vector<const tseitin_definition*> dependencies;
+    };
+
+    memo_table<statement_ptr> nnf_memo[2];
+    memo_table<cube_list> dnf_memo;
+    memo_table<tseitin_definition> tseitin_memo;
+    std::size_t num_fresh_vars = 0;
+
+    statement_ptr nnf_with_polarity(const statement_ptr& stmt, bool positive);
+    const cube_list& dnf_cubes(const statement_ptr& nnf_stmt);
+    const tseitin_definition& tseitin_define(const statement_ptr& nnf_stmt);
+    statement_ptr tseitin_clause(const statement_ptr& nnf_stmt, std::vector<const tseitin_definition*>& dependencies);
+
+public:
+    // Negation normal form: only conj, disj, and neg applied directly to atoms.
+    [[nodiscard]] statement_ptr nnf(const statement_ptr& stmt);
+
+    // Disjunctive normal form: a disjunction of conjunctions of literals. This can be exponentially larger than the
+    // original statement.
+    [[nodiscard]] statement_ptr dnf(const statement_ptr& stmt);
+
+    // Conjunctive normal form, using a definitional (Tseitin) encoding. The size of the result is linear in the size
+    // of the original statement.
+    [[nodiscard]] tseitin_cnf_result cnf(const statement_ptr& stmt);
+};
+
+// A literal is an atom or a negated atom.
+[[nodiscard]] bool is_literal(const statement& stmt);
+
+}  // namespace tema
@@ -0,0 +1,271 @@
+#include "algorithms/normal_form.h"
+
+#include <map>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+using assignment = std::map<const variable*, bool>;
+
+bool evaluate(const statement& stmt, const assignment& values) {
+    if (stmt.is_truth()) {
+        return true;
+    }
+    if (stmt.is_contradiction()) {
+        return false;
+    }
+    if (stmt.is_var()) {
+        return values.at(stmt.as_var().get());
+    }
+    if (stmt.is_neg()) {
+        return !evaluate(*stmt.as_neg().inner, values);
+    }
+    if (stmt.is_implies()) {
+        return !evaluate(*stmt.as_implies().from, values) || evaluate(*stmt.as_implies().to, values);
+    }
+    if (stmt.is_equiv()) {
+        return evaluate(*stmt.as_equiv().left, values) == evaluate(*stmt.as_equiv().right, values);
+    }
+    if (stmt.is_conj()) {
+        return std::all_of(stmt.as_conj().inner.begin(), stmt.as_conj().inner.end(), [&](const statement_ptr& s) {
+            return evaluate(*s, values);
+        });
+    }
+    return std::any_of(stmt.as_disj().inner.begin(), stmt.as_disj().inner.end(), [&](const statement_ptr& s) {
+        return evaluate(*s, values);
+    });
+}
+
+template<class F>
+void for_each_assignment(const std::vector<variable_ptr>& vars, assignment& values, std::size_t index, F&& callback) {
+    if (index == vars.size()) {
+        callback();
+        return;
+    }
+    for (const bool value: {false, true}) {
+        values[vars[index].get()] = value;
+        for_each_assignment(vars, values, index + 1, callback);
+    }
+}
+
+void expect_equivalent(const statement_ptr& a, const statement_ptr& b, const std::vector<variable_ptr>& vars, Context context = Context()) {
+    assignment values;
+    for_each_assignment(vars, values, 0, [&] {
+        expectMsg(evaluate(*a, values) == evaluate(*b, values), print_utf8(*a) + " is not equivalent to " + print_utf8(*b), context);
+    });
+}
+
+void expect_equals_stmt(const statement_ptr& actual, const statement_ptr& expected, Context context = Context()) {
+    expectMsg(equals(*actual, *expected), "Expected " + print_utf8(*expected) + ", got " + print_utf8(*actual), std::move(context));
+}
+
+bool is_nnf(const statement& stmt) {
+    if (is_literal(stmt) || stmt.is_truth() || stmt.is_contradiction()) {
+        return true;
+    }
+    if (stmt.is_conj() || stmt.is_disj()) {
+        const auto& children = stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner;
+        return std::all_of(children.begin(), children.end(), [&](const statement_ptr& child) {
+            return is_nnf(*child) && (stmt.is_conj() ? !child->is_conj() : !child->is_disj());
+        });
+    }
+    return false;
+}
+
+bool is_clause(const statement& stmt) {
+    return stmt.is_disj() && std::all_of(stmt.as_disj().inner.begin(), stmt.as_disj().inner.end(), [](const statement_ptr& lit) {
+               return is_literal(*lit);
+           });
+}
+
+bool is_cube(const statement& stmt) {
+    return is_literal(stmt) ||
+           (stmt.is_conj() && std::all_of(stmt.as_conj().inner.begin(), stmt.as_conj().inner.end(), [](const statement_ptr& lit) {
+                return is_literal(*lit);
+            }));
+}
+
+TEST_CASE("algorithms.normal_form") {
+    const auto p = var("P");
+    const auto q = var("Q");
+    const auto r = var("R");
+    const auto s = var("S");
+    const std::vector<variable_ptr> vars{p, q, r, s};
+
+    const std::vector<statement_ptr> samples{
+            var_stmt(p),
+            neg(conj(var_stmt(p), var_stmt(q))),
+            implies(conj(var_stmt(p), implies(var_stmt(p), var_stmt(q))), var_stmt(q)),
+            equiv(disj(var_stmt(p), var_stmt(q)), neg(conj(neg(var_stmt(p)), neg(var_stmt(q))))),
+            neg(equiv(var_stmt(p), implies(var_stmt(q), var_stmt(r)))),
+            equiv(conj(var_stmt(p), disj(var_stmt(q), var_stmt(r))), disj(conj(var_stmt(p), var_stmt(q)), conj(var_stmt(p), var_stmt(r)))),
+            conj(disj(var_stmt(p), var_stmt(q)), disj(var_stmt(r), neg(var_stmt(s))), implies(var_stmt(s), truth())),
+            disj(conj(var_stmt(p), contradiction()), neg(neg(var_stmt(r)))),
+            neg(truth()),
+    };
+
+    group("nnf", [&] {
+        test("DeMorgan", [&] {
+            normal_form_converter converter;
+            expect_equals_stmt(converter.nnf(neg(conj(var_stmt(p), var_stmt(q)))),
+                               disj(neg(var_stmt(p)), neg(var_stmt(q))));
+            expect_equals_stmt(converter.nnf(neg(disj(var_stmt(p), var_stmt(q)))),
+                               conj(neg(var_stmt(p)), neg(var_stmt(q))));
+        });
+
+        test("implication and double negation", [&] {
+            normal_form_converter converter;
+            expect_equals_stmt(converter.nnf(implies(var_stmt(p), neg(neg(var_stmt(q))))),
+                               disj(neg(var_stmt(p)), var_stmt(q)));
+            expect_equals_stmt(converter.nnf(neg(implies(var_stmt(p), var_stmt(q)))),
+                               conj(var_stmt(p), neg(var_stmt(q))));
+        });
+
+        test("flattens nested conjunctions and disjunctions", [&] {
+            normal_form_converter converter;
+            expect_equals_stmt(converter.nnf(conj(conj(var_stmt(p), var_stmt(q)), conj(var_stmt(r), var_stmt(s)))),
+                               conj(var_stmt(p), var_stmt(q), var_stmt(r), var_stmt(s)));
+            expect_equals_stmt(converter.nnf(neg(conj(conj(var_stmt(p), var_stmt(q)), var_stmt(r)))),
+                               disj(neg(var_stmt(p)), neg(var_stmt(q)), neg(var_stmt(r))));
+        });
+
+        test("folds truth and contradiction", [&] {
+            normal_form_converter converter;
+            expect(converter.nnf(neg(truth())), contradiction());
+            expect(converter.nnf(conj(var_stmt(p), contradiction())), contradiction());
+            expect(converter.nnf(disj(var_stmt(p), neg(contradiction()))), truth());
+            expect_equals_stmt(converter.nnf(conj(var_stmt(p), truth())), var_stmt(p));
+        });
+
+        test("atoms are kept", [&] {
+            normal_form_converter converter;
+            const auto rel = rel_stmt(var_expr(p), rel_type::in, var_expr(q));
+            const auto quantified = forall(r, implies(var_stmt(r), var_stmt(r)));
+            expect(converter.nnf(rel), rel);
+            expect(converter.nnf(quantified), quantified);
+            expect_equals_stmt(converter.nnf(neg(neg(neg(rel)))), neg(rel));
+        });
+
+        test("preserves sharing", [&] {
+            normal_form_converter converter;
+            const auto already_nnf = conj(var_stmt(p), disj(neg(var_stmt(q)), var_stmt(r)));
+            expect(converter.nnf(already_nnf), already_nnf);
+            const auto shared = neg(disj(var_stmt(p), var_stmt(q)));
+            const auto stmt = disj(implies(var_stmt(r), shared), conj(shared, var_stmt(s)));
+            const auto first = converter.nnf(shared);
+            (void) converter.nnf(stmt);
+            expect(converter.nnf(shared), first);
+        });
+
+        test("equivalent and well-formed", [&] {
+            normal_form_converter converter;
+            for (const auto& sample: samples) {
+                const auto result = converter.nnf(sample);
+                expectMsg(is_nnf(*result), print_utf8(*result) + " is not in NNF");
+                expect_equivalent(sample, result, vars);
+            }
+        });
+    });
+
+    group("dnf", [&] {
+        test("distributes conjunction over disjunction", [&] {
+            normal_form_converter converter;
+            expect_equals_stmt(converter.dnf(conj(disj(var_stmt(p), var_stmt(q)), var_stmt(r))),
+                               disj(conj(var_stmt(p), var_stmt(r)), conj(var_stmt(q), var_stmt(r))));
+        });
+
+        test("constants", [&] {
+            normal_form_converter converter;
+            expect(converter.dnf(truth()), truth());
+            expect(converter.dnf(contradiction()), contradiction());
+            expect(converter.dnf(conj(var_stmt(p), neg(truth()))), contradiction());
+        });
+
+        test("equivalent and well-formed", [&] {
+            normal_form_converter converter;
+            for (const auto& sample: samples) {
+                const auto result = converter.dnf(sample);
+                const auto disjuncts = result->is_disj() ? result->as_disj().inner : std::vector<statement_ptr>{result};
+                for (const auto& disjunct: disjuncts) {
+                    expectMsg(is_cube(*disjunct) || disjunct->is_truth() || disjunct->is_contradiction(),
+                              print_utf8(*result) + " is not in DNF");
+                }
+                expect_equivalent(sample, result, vars);
+            }
+        });
+    });
+
+    group("cnf", [&] {
+        test("constants", [&] {
+            normal_form_converter converter;
+            expect(converter.cnf(implies(var_stmt(p), var_stmt(p))).stmt->is_conj(), isTrue);
+            expect(converter.cnf(truth()).stmt, truth());
+            expect(converter.cnf(neg(truth())).stmt, contradiction());
+        });
+
+        test("no definitions needed for clauses", [&] {
+            normal_form_converter converter;
+            const auto result = converter.cnf(conj(disj(var_stmt(p), neg(var_stmt(q))), implies(var_stmt(q), var_stmt(r))));
+            expect(result.definitions, isEmpty);
+            expect_equals_stmt(result.stmt, conj(disj(var_stmt(p), neg(var_stmt(q))), disj(neg(var_stmt(q)), var_stmt(r))));
+        });
+
+        test("linear size for distributivity-heavy statements", [&] {
+            normal_form_converter converter;
+            std::vector<statement_ptr> cubes;
+            std::vector<variable_ptr> many_vars;
+            for (int i = 0; i < 16; i++) {
+                many_vars.push_back(var("X" + std::to_string(i)));
+            }
+            for (int i = 0; i < 16; i += 2) {
+                cubes.push_back(conj(var_stmt(many_vars[static_cast<std::size_t>(i)]), var_stmt(many_vars[static_cast<std::size_t>(i + 1)])));
+            }
+            // Distributing this would produce 2^8 clauses.
+            const auto result = converter.cnf(disj(std::move(cubes)));
+            expect(result.definitions, hasSize(8));
+            expect(result.stmt->as_conj().inner, hasSize(1 + 16));
+        });
+
+        test("equisatisfiable and well-formed", [&] {
+            normal_form_converter converter;
+            for (const auto& sample: samples) {
+                const auto result = converter.cnf(sample);
+                if (result.stmt->is_truth() || result.stmt->is_contradiction()) {
+                    expect_equivalent(sample, result.stmt, vars);
+                    continue;
+                }
+                for (const auto& clause: result.stmt->as_conj().inner) {
+                    expectMsg(is_clause(*clause), print_utf8(*result.stmt) + " is not in CNF");
+                }
+                std::vector<variable_ptr> definition_vars;
+                for (const auto& [definition_var, named]: result.definitions) {
+                    definition_vars.push_back(definition_var);
+                }
+                assignment values;
+                for_each_assignment(vars, values, 0, [&] {
+                    bool satisfiable = false;
+                    for_each_assignment(definition_vars, values, 0, [&] {
+                        satisfiable = satisfiable || evaluate(*result.stmt, values);
+                    });
+                    expectMsg(satisfiable == evaluate(*sample, values), print_utf8(*result.stmt) + " is not equisatisfiable with " + print_utf8(*sample));
+                });
+            }
+        });
+
+        test("definitions are shared between conversions", [&] {
+            normal_form_converter converter;
+            const auto shared = conj(var_stmt(p), var_stmt(q));
+            const auto first = converter.cnf(disj(shared, var_stmt(r)));
+            const auto second = converter.cnf(disj(shared, var_stmt(s)));
+            expect(first.definitions, hasSize(1));
+            expect(second.definitions, hasSize(1));
+            expect(first.definitions[0].first, second.definitions[0].first);
+        });
+    });
+}
@@ -0,0 +1,46 @@
+#include "algorithms/occurs.h"
+
+#include <algorithm>
+
+namespace tema {
+
+bool occurs_as_expression(const expression& expr, const variable* var) {
+    if (expr.is_var()) {
+        return expr.as_var().get() == var;
+    }
+    if (expr.is_binop()) {
+        return occurs_as_expression(*expr.as_binop().left, var) || occurs_as_expression(*expr.as_binop().right, var);
+    }
+    const auto& params = expr.as_call().params;
+    return occurs_as_expression(*expr.as_call().callee, var) ||
+           std::any_of(params.begin(), params.end(), [&](const expr_ptr& param) {
+               return occurs_as_expression(*param, var);
+           });
+}
+
+bool occurs_as_expression(const statement& stmt, const variable* var) {
+    if (stmt.is_rel()) {
+        return occurs_as_expression(*stmt.as_rel().left, var) || occurs_as_expression(*stmt.as_rel().right, var);
+    }
+    if (stmt.is_neg()) {
+        return occurs_as_expression(*stmt.as_neg().inner, var);
+    }
+    if (stmt.is_implies()) {
+        return occurs_as_expression(*stmt.as_implies().from, var) || occurs_as_expression(*stmt.as_implies().to, var);
+    }
+    if (stmt.is_equiv()) {
+        return occurs_as_expression(*stmt.as_equiv().left, var) || occurs_as_expression(*stmt.as_equiv().right, var);
+    }
+    if (stmt.is_forall()) {
+        return occurs_as_expression(*stmt.as_forall().inner, var);
+    }
+    if (stmt.is_conj() || stmt.is_disj()) {
+        const auto& children = stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner;
+        return std::any_of(children.begin(), children.end(), [&](const statement_ptr& child) {
+            return occurs_as_expression(*child, var);
+        });
+    }
+    return false;
+}
+
+}  // namespace tema
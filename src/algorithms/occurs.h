@@ -0,0 +1,13 @@
+#pragma once
+
+#include "core/statement.h"
+
+namespace tema {
+
+// Whether the variable occurs in the expression.
+[[nodiscard]] bool occurs_as_expression(const expression& expr, const variable* var);
+
+// Whether the variable occurs in any expression inside the statement (as opposed to only being used as a statement).
+[[nodiscard]] bool occurs_as_expression(const statement& stmt, const variable* var);
+
+}  // namespace tema
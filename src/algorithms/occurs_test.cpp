@@ -0,0 +1,29 @@
+#include "algorithms/occurs.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+using namespace tema;
+using namespace mcga::matchers;
+
+TEST_CASE("algorithms.occurs") {
+    const auto x = var("X");
+    const auto y = var("Y");
+    const auto f = var("f");
+
+    test("expressions", [&] {
+        expect(occurs_as_expression(*var_expr(x), x.get()), isTrue);
+        expect(occurs_as_expression(*var_expr(y), x.get()), isFalse);
+        expect(occurs_as_expression(*binop(var_expr(y), binop_type::set_union, var_expr(x)), x.get()), isTrue);
+        expect(occurs_as_expression(*call(var_expr(f), {var_expr(y), var_expr(x)}), x.get()), isTrue);
+        expect(occurs_as_expression(*call(var_expr(f), {var_expr(y)}), f.get()), isTrue);
+        expect(occurs_as_expression(*call(var_expr(f), {var_expr(y)}), x.get()), isFalse);
+    });
+
+    test("statements", [&] {
+        expect(occurs_as_expression(*var_stmt(x), x.get()), isFalse);
+        expect(occurs_as_expression(*conj(var_stmt(x), neg(var_stmt(y))), x.get()), isFalse);
+        expect(occurs_as_expression(*rel_stmt(var_expr(x), rel_type::in, var_expr(y)), x.get()), isTrue);
+        expect(occurs_as_expression(*implies(var_stmt(x), forall(y, rel_stmt(var_expr(y), rel_type::in, var_expr(x)))), x.get()), isTrue);
+        expect(occurs_as_expression(*equiv(var_stmt(y), disj(truth(), neg(rel_stmt(var_expr(y), rel_type::eq, var_expr(x))))), x.get()), isTrue);
+    });
+}
@@ -0,0 +1,215 @@
+#include "algorithms/order_closure.h"
+
+#include <algorithm>
+
+#include "algorithms/equals.h"
+#include "algorithms/rel_duality.h"
+
+namespace tema {
+
+namespace {
+
+constexpr std::size_t ordering = 0;
+constexpr std::size_t inclusion = 1;
+
+bool test_bit(const std::vector<std::uint64_t>& bits, std::uint32_t index) {
+    const auto word = index / 64;
+    return word < bits.size() && ((bits[word] >> (index % 64)) & 1U) != 0;
+}
+
+void set_bit(std::vector<std::uint64_t>& bits, std::uint32_t index) {
+    const auto word = index / 64;
+    if (word >= bits.size()) {
+        bits.resize(word + 1, 0);
+    }
+    bits[word] |= std::uint64_t{1} << (index % 64);
+}
+
+bool is_order_fact(const statement& stmt) {
+    if (!stmt.is_rel()) {
+        return false;
+    }
+    const auto [rel, negated] = canonical_form(stmt.as_rel());
+    return !negated && rel.type != rel_type::in;
+}
+
+void or_into(std::vector<std::uint64_t>& bits, const std::vector<std::uint64_t>& other) {
+    if (bits.size() < other.size()) {
+        bits.resize(other.size(), 0);
+    }
+    for (std::size_t i = 0; i < other.size(); i++) {
+        bits[i] |= other[i];
+    }
+}
+
+}  // namespace
+
+bool order_closure::partial_order::reaches(std::uint32_t from, std::uint32_t to) const {
+    return test_bit(reach[from], to);
+}
+
+bool order_closure::partial_order::strictly_reaches(std::uint32_t from, std::uint32_t to) const {
+    return test_bit(strict_reach[from], to);
+}
+
+bool order_closure::partial_order::add_edge(std::uint32_t from, std::uint32_t to, bool strict) {
+    // Every x that reaches "from" (including "from" itself) now reaches "to" and everything "to" reaches. The paths
+    // through the new fact are strict if the fact is, if x reaches "from" strictly, or if they continue strictly from
+    // "to". Copies are needed because "to" might itself be one of the updated expressions.
+    const auto to_reach = reach[to];
+    const auto to_strict_reach = strict_reach[to];
+    std::vector<std::pair<std::uint32_t, bool>> sources;
+    for (std::uint32_t x = 0; x < reach.size(); x++) {
+        if (x == from || reaches(x, from)) {
+            sources.emplace_back(x, strict || strictly_reaches(x, from));
+        }
+    }
+    bool ok = true;
+    for (const auto& [x, strict_to_edge]: sources) {
+        set_bit(reach[x], to);
+        or_into(reach[x], to_reach);
+        if (strict_to_edge) {
+            set_bit(strict_reach[x], to);
+            or_into(strict_reach[x], to_reach);
+        } else {
+            or_into(strict_reach[x], to_strict_reach);
+        }
+        ok = ok && !strictly_reaches(x, x);
+    }
+    return ok;
+}
+
+std::uint32_t order_closure::id_of(const expr_ptr& expr) {
+    const auto [it, inserted] = ids.emplace(expr, static_cast<std::uint32_t>(ids.size()));
+    if (inserted) {
+        for (auto& order: orders) {
+            order.reach.emplace_back();
+            order.strict_reach.emplace_back();
+        }
+    }
+    return it->second;
+}
+
+std::optional<std::uint32_t> order_closure::find(const expr_ptr& expr) const {
+    const auto it = ids.find(expr);
+    if (it == ids.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool order_closure::add(const statement& fact) {
+    if (fact.is_conj()) {
+        const auto& children = fact.as_conj().inner;
+        if (!std::all_of(children.begin(), children.end(), [](const statement_ptr& child) {
+                return is_order_fact(*child);
+            })) {
+            return false;
+        }
+        for (const auto& child: children) {
+            (void)add(*child);
+        }
+        return true;
+    }
+    if (!is_order_fact(fact)) {
+        return false;
+    }
+    const auto rel = canonical_form(fact.as_rel()).rel;
+    const auto left = id_of(rel.left);
+    const auto right = id_of(rel.right);
+    num_facts += 1;
+    switch (rel.type) {
+        case rel_type::eq:
+            for (auto& order: orders) {
+                consistent = order.add_edge(left, right, false) && consistent;
+                consistent = order.add_edge(right, left, false) && consistent;
+            }
+            break;
+        case rel_type::less: consistent = orders[ordering].add_edge(left, right, true) && consistent; break;
+        case rel_type::eq_less: consistent = orders[ordering].add_edge(left, right, false) && consistent; break;
+        case rel_type::is_included: consistent = orders[inclusion].add_edge(left, right, true) && consistent; break;
+        default: consistent = orders[inclusion].add_edge(left, right, false) && consistent; break;
+    }
+    return true;
+}
+
+void order_closure::add_scope(const scope& s) {
+    for (const scope* current = &s; current != nullptr; current = current->parent()) {
+        for (const auto& stmt: current->own_statements()) {
+            (void)add(*stmt);
+        }
+    }
+}
+
+bool order_closure::at_most(const partial_order& order, const expr_ptr& a, const expr_ptr& b) const {
+    if (equals(*a, *b)) {
+        return true;
+    }
+    const auto a_id = find(a);
+    const auto b_id = find(b);
+    return a_id.has_value() && b_id.has_value() && order.reaches(*a_id, *b_id);
+}
+
+bool order_closure::less(const partial_order& order, const expr_ptr& a, const expr_ptr& b) const {
+    const auto a_id = find(a);
+    const auto b_id = find(b);
+    return a_id.has_value() && b_id.has_value() && order.strictly_reaches(*a_id, *b_id);
+}
+
+bool order_closure::are_equal(const expr_ptr& a, const expr_ptr& b) const {
+    return std::any_of(std::begin(orders), std::end(orders), [&](const partial_order& order) {
+        return at_most(order, a, b) && at_most(order, b, a);
+    });
+}
+
+bool order_closure::follows(const relationship& rel) const {
+    const auto [canonical, negated] = canonical_form(rel);
+    const auto& [type, a, b] = canonical;
+    if (type == rel_type::eq) {
+        if (!negated) {
+            return are_equal(a, b);
+        }
+        return std::any_of(std::begin(orders), std::end(orders), [&](const partial_order& order) {
+            return less(order, a, b) || less(order, b, a);
+        });
+    }
+    if (type == rel_type::in) {
+        return false;
+    }
+    const auto& order = orders[type == rel_type::less || type == rel_type::eq_less ? ordering : inclusion];
+    const bool strict = type == rel_type::less || type == rel_type::is_included;
+    if (!negated) {
+        return strict ? less(order, a, b) : at_most(order, a, b);
+    }
+    // a≮b when b≤a, and a≰b when b<a.
+    return strict ? at_most(order, b, a) : less(order, b, a);
+}
+
+bool order_closure::follows(const statement& stmt) const {
+    if (!consistent) {
+        return true;
+    }
+    if (stmt.is_truth()) {
+        return true;
+    }
+    if (stmt.is_conj()) {
+        return std::all_of(stmt.as_conj().inner.begin(), stmt.as_conj().inner.end(), [&](const statement_ptr& child) {
+            return follows(*child);
+        });
+    }
+    return stmt.is_rel() && follows(stmt.as_rel());
+}
+
+bool order_closure::is_consistent() const {
+    return consistent;
+}
+
+std::size_t order_closure::num_expressions() const {
+    return ids.size();
+}
+
+std::size_t order_closure::num_added_facts() const {
+    return num_facts;
+}
+
+}  // namespace tema
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "algorithms/hash.h"
+#include "core/scope.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// Incremental transitive closure of ordering (<, ≤, >, ≥) and inclusion (⊂, ⊆, ⊃, ⊇) facts, which answers whether a
+// relationship follows from the facts by transitivity without materializing the intermediate facts.
+//
+// Orderings and inclusions are two separate partial orders over expressions (compared by structure). Equalities are
+// added to both, as a non-strict relationship in each direction. A path of facts from a to b gives a≤b (or a⊆b), and
+// a<b (or a⊂b) when at least one of the facts on the path is strict. A cycle of non-strict facts forces all the
+// expressions on it to be equal, and a cycle with a strict fact makes the facts inconsistent.
+//
+// Reachability is kept as a bitset per expression, so queries are a bit test and adding a fact costs O(n²/64) for n
+// expressions.
+class order_closure {
+    struct partial_order {
+        // reach[x] has the expressions reachable from x by a non-empty path, strict_reach[x] those reachable by a path
+        // with at least one strict fact.
+        std::vector<std::vector<std::uint64_t>> reach;
+        std::vector<std::vector<std::uint64_t>> strict_reach;
+
+        [[nodiscard]] bool reaches(std::uint32_t from, std::uint32_t to) const;
+        [[nodiscard]] bool strictly_reaches(std::uint32_t from, std::uint32_t to) const;
+        // Returns false when the new fact makes the order inconsistent.
+        bool add_edge(std::uint32_t from, std::uint32_t to, bool strict);
+    };
+
+    std::unordered_map<expr_ptr, std::uint32_t, structural_hash, structural_equal> ids;
+    partial_order orders[2];
+    bool consistent = true;
+    std::size_t num_facts = 0;
+
+    std::uint32_t id_of(const expr_ptr& expr);
+    [[nodiscard]] std::optional<std::uint32_t> find(const expr_ptr& expr) const;
+    [[nodiscard]] bool at_most(const partial_order& order, const expr_ptr& a, const expr_ptr& b) const;
+    [[nodiscard]] bool less(const partial_order& order, const expr_ptr& a, const expr_ptr& b) const;
+    [[nodiscard]] bool follows(const relationship& rel) const;
+
+public:
+    // Adds an ordering, inclusion or equality relationship (or a conjunction of them) as a fact. Returns false, without
+    // adding anything, for other statements.
+    bool add(const statement& fact);
+
+    // Adds the facts of the scope and of its parents.
+    void add_scope(const scope& s);
+
+    // Whether the statement (a relationship, or a conjunction of relationships) follows from the facts by
+    // transitivity. Besides positive relationships, this covers the negations implied by strictness: a≮b when b≤a,
+    // a≰b when b<a, and a≠b when a<b or b<a. Every statement follows from inconsistent facts.
+    [[nodiscard]] bool follows(const statement& stmt) const;
+
+    // Whether the facts force a and b to be equal: a=b was added, or a≤b and b≤a follow (or a⊆b and b⊆a).
+    [[nodiscard]] bool are_equal(const expr_ptr& a, const expr_ptr& b) const;
+
+    // Whether there is no cycle with a strict fact (like a<b, b≤a).
+    [[nodiscard]] bool is_consistent() const;
+
+    [[nodiscard]] std::size_t num_expressions() const;
+    [[nodiscard]] std::size_t num_added_facts() const;
+};
+
+}  // namespace tema
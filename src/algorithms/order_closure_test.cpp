@@ -0,0 +1,130 @@
+#include "algorithms/order_closure.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.order_closure") {
+    const auto a = var_expr(var("a"));
+    const auto b = var_expr(var("b"));
+    const auto c = var_expr(var("c"));
+    const auto d = var_expr(var("d"));
+    const auto rel = [](const expr_ptr& x, rel_type type, const expr_ptr& y) {
+        return rel_stmt(x, type, y);
+    };
+
+    test("chains of non-strict facts", [&] {
+        order_closure closure;
+        expect(closure.add(*rel(a, rel_type::eq_less, b)), isTrue);
+        expect(closure.add(*rel(c, rel_type::eq_greater, b)), isTrue);
+        expect(closure.add(*rel(c, rel_type::eq_less, d)), isTrue);
+        expect(closure.follows(*rel(a, rel_type::eq_less, d)), isTrue);
+        expect(closure.follows(*rel(d, rel_type::eq_greater, a)), isTrue);
+        expect(closure.follows(*rel(a, rel_type::eq_less, a)), isTrue);
+        expect(closure.follows(*rel(a, rel_type::less, d)), isFalse);
+        expect(closure.follows(*rel(d, rel_type::eq_less, a)), isFalse);
+        // Inclusions are a separate order.
+        expect(closure.follows(*rel(a, rel_type::eq_is_included, d)), isFalse);
+        expect(closure.num_expressions(), 4U);
+        expect(closure.num_added_facts(), 3U);
+    });
+
+    test("strict and non-strict facts", [&] {
+        order_closure closure;
+        expect(closure.add(*conj(rel(a, rel_type::is_included, b),
+                                 rel(b, rel_type::eq_is_included, c),
+                                 rel(d, rel_type::includes, c))),
+               isTrue);
+        expect(closure.follows(*rel(a, rel_type::is_included, c)), isTrue);
+        expect(closure.follows(*rel(b, rel_type::is_included, c)), isFalse);
+        expect(closure.follows(*rel(b, rel_type::is_included, d)), isTrue);
+        expect(closure.follows(*rel(d, rel_type::includes, a)), isTrue);
+        expect(closure.follows(*conj(rel(a, rel_type::is_included, d), rel(b, rel_type::eq_is_included, d))), isTrue);
+        // Negations implied by strictness.
+        expect(closure.follows(*rel(c, rel_type::n_is_included, a)), isTrue);
+        expect(closure.follows(*rel(d, rel_type::n_eq_is_included, a)), isTrue);
+        expect(closure.follows(*rel(a, rel_type::n_eq, d)), isTrue);
+        expect(closure.follows(*rel(a, rel_type::n_eq, b)), isTrue);
+        expect(closure.follows(*rel(b, rel_type::n_eq, c)), isFalse);
+        expect(closure.is_consistent(), isTrue);
+    });
+
+    test("cycles", [&] {
+        order_closure closure;
+        (void)closure.add(*rel(a, rel_type::eq_less, b));
+        (void)closure.add(*rel(b, rel_type::eq_less, c));
+        expect(closure.are_equal(a, c), isFalse);
+        (void)closure.add(*rel(c, rel_type::eq_less, a));
+        expect(closure.are_equal(a, c), isTrue);
+        expect(closure.follows(*rel(b, rel_type::eq, a)), isTrue);
+        expect(closure.is_consistent(), isTrue);
+        expect(closure.follows(*rel(a, rel_type::less, b)), isFalse);
+
+        (void)closure.add(*rel(c, rel_type::less, d));
+        expect(closure.is_consistent(), isTrue);
+        (void)closure.add(*rel(d, rel_type::eq_less, b));
+        expect(closure.is_consistent(), isFalse);
+        expect(closure.follows(*rel(a, rel_type::less, a)), isTrue);
+    });
+
+    test("equalities", [&] {
+        order_closure closure;
+        (void)closure.add(*rel(a, rel_type::eq, b));
+        (void)closure.add(*rel(b, rel_type::less, c));
+        (void)closure.add(*rel(b, rel_type::is_included, d));
+        expect(closure.follows(*rel(a, rel_type::less, c)), isTrue);
+        expect(closure.follows(*rel(a, rel_type::is_included, d)), isTrue);
+        expect(closure.follows(*rel(b, rel_type::eq, a)), isTrue);
+        expect(closure.follows(*rel(c, rel_type::n_less, a)), isTrue);
+        // Expressions are compared by structure.
+        const auto ab = binop(a, binop_type::set_union, b);
+        (void)closure.add(*rel(ab, rel_type::eq_is_included, c));
+        expect(closure.follows(*rel(binop(a, binop_type::set_union, b), rel_type::eq_is_included, c)), isTrue);
+    });
+
+    test("unsupported facts", [&] {
+        order_closure closure;
+        expect(closure.add(*rel(a, rel_type::in, b)), isFalse);
+        expect(closure.add(*rel(a, rel_type::n_less, b)), isFalse);
+        expect(closure.add(*var_stmt(var("p"))), isFalse);
+        expect(closure.add(*conj(rel(a, rel_type::less, b), rel(a, rel_type::in, b))), isFalse);
+        expect(closure.num_added_facts(), 0U);
+        expect(closure.follows(*rel(a, rel_type::less, b)), isFalse);
+        expect(closure.follows(*rel(a, rel_type::in, b)), isFalse);
+        expect(closure.follows(*rel(a, rel_type::eq, a)), isTrue);
+    });
+
+    test("facts of a scope", [&] {
+        scope outer;
+        outer.add_statement(rel(a, rel_type::less, b));
+        outer.add_statement(var_stmt(var("p")));
+        scope inner(&outer);
+        inner.add_statement(rel(b, rel_type::less, c));
+        order_closure closure;
+        closure.add_scope(inner);
+        expect(closure.follows(*rel(a, rel_type::less, c)), isTrue);
+        expect(closure.num_added_facts(), 2U);
+    });
+
+    test("long chains", [&] {
+        order_closure closure;
+        std::vector<expr_ptr> exprs;
+        for (int i = 0; i < 300; i++) {
+            exprs.push_back(var_expr(var("x" + std::to_string(i))));
+        }
+        // Added out of order, so that the closure is updated for existing paths on both sides of each fact.
+        for (std::size_t i = 0; i + 1 < exprs.size(); i += 2) {
+            (void)closure.add(*rel(exprs[i], rel_type::eq_less, exprs[i + 1]));
+        }
+        for (std::size_t i = 1; i + 1 < exprs.size(); i += 2) {
+            (void)closure.add(*rel(exprs[i], i == 151 ? rel_type::less : rel_type::eq_less, exprs[i + 1]));
+        }
+        expect(closure.follows(*rel(exprs[0], rel_type::eq_less, exprs[299])), isTrue);
+        expect(closure.follows(*rel(exprs[0], rel_type::less, exprs[299])), isTrue);
+        expect(closure.follows(*rel(exprs[0], rel_type::less, exprs[151])), isFalse);
+        expect(closure.follows(*rel(exprs[152], rel_type::less, exprs[299])), isFalse);
+        expect(closure.follows(*rel(exprs[299], rel_type::eq_less, exprs[0])), isFalse);
+    });
+}
@@ -0,0 +1,238 @@
+#include "algorithms/portfolio.h"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+#include "algorithms/apply_vars.h"
+#include "algorithms/deduce.h"
+#include "algorithms/equals.h"
+#include "algorithms/fingerprint.h"
+#include "algorithms/match_program.h"
+#include "algorithms/order_closure.h"
+#include "algorithms/threads.h"
+
+namespace tema {
+
+bool cancellation_token::is_cancelled() const noexcept {
+    const bool cancelled = flag->load(std::memory_order_relaxed);
+    if (cancelled && observed != nullptr) {
+        observed->store(true, std::memory_order_relaxed);
+    }
+    return cancelled;
+}
+
+portfolio_result run_portfolio(const module& mod, const std::vector<search_strategy>& strategies) {
+    std::atomic<bool> cancelled{false};
+    std::mutex result_mutex;
+    portfolio_result result;
+    result.reports.resize(strategies.size());
+
+    const auto run_strategy = [&](std::size_t index) {
+        const auto& strategy = strategies[index];
+        auto& report = result.reports[index];
+        report.name = strategy.name;
+        const auto start = std::chrono::steady_clock::now();
+        std::atomic<bool> stopped_early{false};
+        try {
+            auto found = strategy.run(mod, cancellation_token{&cancelled, &stopped_early});
+            if (found.has_value()) {
+                report.outcome = strategy_outcome::succeeded;
+                std::lock_guard guard(result_mutex);
+                if (!result.result.has_value()) {
+                    result.result = std::move(found);
+                    result.winner = index;
+                    cancelled.store(true, std::memory_order_relaxed);
+                }
+            } else {
+                // Only a strategy that saw the cancellation was stopped by it: the others finished their search.
+                report.outcome = stopped_early.load(std::memory_order_relaxed) ? strategy_outcome::cancelled
+                                                                                : strategy_outcome::failed;
+            }
+        } catch (...) {
+            report.outcome = strategy_outcome::threw;
+        }
+        report.duration = std::chrono::steady_clock::now() - start;
+    };
+
+    // When a thread can't be started, the strategies already running are cancelled.
+    run_on_threads(strategies.size(), run_strategy, [&] {
+        cancelled.store(true, std::memory_order_relaxed);
+    });
+    return result;
+}
+
+namespace {
+
+std::vector<statement_ptr> collect_laws(const module& mod, const std::vector<std::string>& law_order) {
+    std::vector<statement_ptr> laws;
+    if (law_order.empty()) {
+        for (const auto& decl: mod.get_decls()) {
+            if (holds_alternative<stmt_decl>(decl)) {
+                laws.push_back(get<stmt_decl>(decl).stmt);
+            }
+        }
+        return laws;
+    }
+    for (const auto& name: law_order) {
+        const auto it = std::find_if(mod.get_decls().begin(), mod.get_decls().end(), [&](const decl& d) {
+            return holds_alternative<stmt_decl>(d) && get<stmt_decl>(d).name == name;
+        });
+        if (it == mod.get_decls().end()) {
+            throw std::runtime_error("Law '" + name + "' not found in module " + std::string{mod.get_name()});
+        }
+        laws.push_back(get<stmt_decl>(*it).stmt);
+    }
+    return laws;
+}
+
+bool contains(const std::vector<statement_ptr>& stmts, const statement& stmt) {
+    return std::any_of(stmts.begin(), stmts.end(), [&](const statement_ptr& s) {
+        return equals(*s, stmt);
+    });
+}
+
+// The sides of the laws from which goals can be deduced backwards, and what is left to prove for each of them: the
+// conclusion of an implication and its premise, or either side of an equivalence and the other side.
+struct reverse_mp_laws {
+    match_code_tree conclusions;
+    std::vector<statement_ptr> premises;
+
+    explicit reverse_mp_laws(const std::vector<statement_ptr>& laws) {
+        for (const auto& law: laws) {
+            if (law->is_implies()) {
+                add(*law->as_implies().to, law->as_implies().from);
+            }
+            if (law->is_equiv()) {
+                add(*law->as_equiv().right, law->as_equiv().left);
+                add(*law->as_equiv().left, law->as_equiv().right);
+            }
+        }
+    }
+
+    void add(const statement& conclusion, const statement_ptr& premise) {
+        (void)conclusions.add(conclusion);
+        premises.push_back(premise);
+    }
+
+    // Statements from which "goal" can be deduced using the laws, in the order of the laws.
+    [[nodiscard]] std::vector<statement_ptr> sub_goals(const statement_ptr& goal) const {
+        std::vector<statement_ptr> sub_goals;
+        for (const auto& [index, match_result]: conclusions.match_all(goal)) {
+            sub_goals.push_back(apply_vars(premises[index], match_result).stmt);
+        }
+        return sub_goals;
+    }
+};
+
+std::optional<statement_ptr> forward_search(const std::vector<statement_ptr>& laws,
+                                            const std::vector<statement_ptr>& facts,
+                                            const statement_ptr& target,
+                                            std::size_t max_depth,
+                                            bool use_order_closure,
+                                            cancellation_token token) {
+    if (contains(facts, *target)) {
+        return target;
+    }
+    order_closure closure;
+    if (use_order_closure) {
+        for (const auto& fact: facts) {
+            (void)closure.add(*fact);
+        }
+        if (closure.follows(*target)) {
+            return target;
+        }
+    }
+    std::vector<statement_ptr> known = facts;
+    std::vector<statement_ptr> frontier = facts;
+    std::vector<fingerprint> frontier_fingerprints;
+    for (std::size_t depth = 0; depth < max_depth && !frontier.empty(); depth++) {
+        frontier_fingerprints.clear();
+        for (const auto& fact: frontier) {
+            frontier_fingerprints.push_back(statement_fingerprint(*fact));
+        }
+        std::vector<statement_ptr> next_frontier;
+        for (const auto& law: laws) {
+            if (token.is_cancelled()) {
+                return std::nullopt;
+            }
+            for (auto& [index, deduced]: mp_deduce_all(*law, frontier, frontier_fingerprints)) {
+                if (contains(known, *deduced)) {
+                    continue;
+                }
+                if (equals(*deduced, *target)) {
+                    return target;
+                }
+                if (use_order_closure && closure.add(*deduced) && closure.follows(*target)) {
+                    return target;
+                }
+                known.push_back(deduced);
+                next_frontier.push_back(std::move(deduced));
+            }
+        }
+        frontier = std::move(next_frontier);
+    }
+    return std::nullopt;
+}
+
+std::optional<statement_ptr> backward_search(const std::vector<statement_ptr>& laws,
+                                             const std::vector<statement_ptr>& facts,
+                                             const statement_ptr& target,
+                                             std::size_t max_depth,
+                                             bool use_order_closure,
+                                             cancellation_token token) {
+    order_closure closure;
+    if (use_order_closure) {
+        for (const auto& fact: facts) {
+            (void)closure.add(*fact);
+        }
+    }
+    const auto is_reached = [&](const statement& goal) {
+        return goal.is_truth() || contains(facts, goal) || (use_order_closure && closure.follows(goal));
+    };
+    if (is_reached(*target)) {
+        return target;
+    }
+    const reverse_mp_laws reverse_laws(laws);
+    std::vector<statement_ptr> seen{target};
+    std::vector<statement_ptr> frontier{target};
+    for (std::size_t depth = 0; depth < max_depth && !frontier.empty(); depth++) {
+        std::vector<statement_ptr> next_frontier;
+        for (const auto& goal: frontier) {
+            if (token.is_cancelled()) {
+                return std::nullopt;
+            }
+            for (auto& sub_goal: reverse_laws.sub_goals(goal)) {
+                if (is_reached(*sub_goal)) {
+                    return target;
+                }
+                if (!contains(seen, *sub_goal)) {
+                    seen.push_back(sub_goal);
+                    next_frontier.push_back(std::move(sub_goal));
+                }
+            }
+        }
+        frontier = std::move(next_frontier);
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+search_strategy mp_search_strategy(std::string name,
+                                   std::vector<statement_ptr> facts,
+                                   statement_ptr target,
+                                   mp_search_options options) {
+    return search_strategy{
+            .name = std::move(name),
+            .run = [facts = std::move(facts), target = std::move(target), options = std::move(options)](const module& mod, cancellation_token token) {
+                const auto laws = collect_laws(mod, options.law_order);
+                if (options.direction == search_direction::forward) {
+                    return forward_search(laws, facts, target, options.max_depth, options.use_order_closure, token);
+                }
+                return backward_search(laws, facts, target, options.max_depth, options.use_order_closure, token);
+            },
+    };
+}
+
+}  // namespace tema
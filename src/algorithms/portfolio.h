@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/module.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// Cooperative cancellation flag handed to the strategies of a portfolio. Strategies should poll it regularly and
+// give up (returning std::nullopt) once it is set, as the runner waits for all of them before returning.
+struct cancellation_token {
+    const std::atomic<bool>* flag;
+    // When set, is_cancelled records here that it returned true, so that the runner can tell a strategy that gave up
+    // because it was cancelled from one that finished its search without a result.
+    std::atomic<bool>* observed = nullptr;
+
+    [[nodiscard]] bool is_cancelled() const noexcept;
+};
+
+struct search_strategy {
+    std::string name;
+    std::function<std::optional<statement_ptr>(const module&, cancellation_token)> run;
+};
+
+enum class strategy_outcome {
+    succeeded = 0,
+    failed = 1,
+    cancelled = 2,
+    threw = 3,
+};
+
+struct strategy_report {
+    std::string name;
+    strategy_outcome outcome;
+    std::chrono::nanoseconds duration;
+};
+
+struct portfolio_result {
+    std::optional<statement_ptr> result;
+    // Index of the strategy that produced the result, if any.
+    std::optional<std::size_t> winner;
+    // One report per strategy, in the same order as the strategies given to run_portfolio.
+    std::vector<strategy_report> reports;
+};
+
+// Run all the strategies over the same module, each on its own thread. The first strategy to produce a result wins,
+// and all the others are asked to stop through their cancellation token.
+[[nodiscard]] portfolio_result run_portfolio(const module& mod, const std::vector<search_strategy>& strategies);
+
+enum class search_direction {
+    // Start from the facts and apply laws until the target is deduced.
+    forward = 0,
+    // Start from the target and apply laws in reverse until reaching a fact.
+    backward = 1,
+};
+
+struct mp_search_options {
+    search_direction direction = search_direction::forward;
+    std::size_t max_depth = 3;
+    // Names of the module's statement declarations to use as laws, in the order in which they are tried. When empty,
+    // all the statement declarations of the module are used, in declaration order.
+    std::vector<std::string> law_order{};
+    // Treat ordering and inclusion relationships as transitive: the search also succeeds when the target follows from
+    // the facts (and, searching forward, the deduced statements) through an order_closure.
+    bool use_order_closure = false;
+};
+
+// A strategy that searches for a derivation of target from the given facts, using the laws of the module through
+// mp_deduce. On success, it produces the target statement.
+[[nodiscard]] search_strategy mp_search_strategy(std::string name,
+                                                 std::vector<statement_ptr> facts,
+                                                 statement_ptr target,
+                                                 mp_search_options options = {});
+
+}  // namespace tema
@@ -0,0 +1,205 @@
+#include "algorithms/portfolio.h"
+
+#include <thread>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+
+module make_laws_module(const variable_ptr& p, const variable_ptr& q) {
+    module mod("laws", "/laws.tema");
+    mod.add_statement_decl(stmt_decl{
+            .loc = {1, 1},
+            .exported = true,
+            .type = stmt_decl_type::theorem,
+            .name = "Modus Ponens",
+            .stmt = implies(conj(var_stmt(p), implies(var_stmt(p), var_stmt(q))), var_stmt(q)),
+            .proof_description = std::nullopt,
+    });
+    mod.add_statement_decl(stmt_decl{
+            .loc = {2, 1},
+            .exported = true,
+            .type = stmt_decl_type::theorem,
+            .name = "Double negation",
+            .stmt = equiv(neg(neg(var_stmt(p))), var_stmt(p)),
+            .proof_description = std::nullopt,
+    });
+    return mod;
+}
+
+search_strategy const_strategy(std::string name, std::optional<statement_ptr> result) {
+    return search_strategy{
+            .name = std::move(name),
+            .run = [result = std::move(result)](const module&, cancellation_token) {
+                return result;
+            },
+    };
+}
+
+search_strategy spin_until_cancelled_strategy(std::string name) {
+    return search_strategy{
+            .name = std::move(name),
+            .run = [](const module&, cancellation_token token) -> std::optional<statement_ptr> {
+                while (!token.is_cancelled()) {
+                    std::this_thread::yield();
+                }
+                return std::nullopt;
+            },
+    };
+}
+
+search_strategy throwing_strategy(std::string name) {
+    return search_strategy{
+            .name = std::move(name),
+            .run = [](const module&, cancellation_token) -> std::optional<statement_ptr> {
+                throw std::runtime_error("strategy failed");
+            },
+    };
+}
+
+std::optional<statement_ptr> run_single(const module& mod, const search_strategy& strategy) {
+    const std::atomic<bool> never_cancelled{false};
+    return strategy.run(mod, cancellation_token{&never_cancelled});
+}
+
+TEST_CASE("algorithms.portfolio") {
+    const auto p = var("P");
+    const auto q = var("Q");
+    const auto a = var("A");
+    const auto b = var("B");
+    const auto mod = make_laws_module(p, q);
+
+    group("run_portfolio", [&] {
+        test("first result wins and cancels the others", [&] {
+            const auto result = run_portfolio(mod, {
+                                                           spin_until_cancelled_strategy("spin"),
+                                                           const_strategy("found", truth()),
+                                                   });
+            expect(result.result.has_value(), isTrue);
+            expect(result.result.value(), truth());
+            expect(result.winner.has_value(), isTrue);
+            expect(result.winner.value(), std::size_t{1});
+            expect(result.reports, hasSize(2));
+            expect(result.reports[0].name, std::string{"spin"});
+            expect(result.reports[0].outcome, strategy_outcome::cancelled);
+            expect(result.reports[1].name, std::string{"found"});
+            expect(result.reports[1].outcome, strategy_outcome::succeeded);
+            expect(result.reports[0].duration >= std::chrono::nanoseconds::zero(), isTrue);
+            expect(result.reports[1].duration >= std::chrono::nanoseconds::zero(), isTrue);
+        });
+
+        test("strategies finishing after the winner without seeing the cancellation failed", [&] {
+            std::atomic<bool> won{false};
+            const auto result = run_portfolio(mod, {
+                                                           search_strategy{
+                                                                   .name = "exhausted",
+                                                                   .run = [&](const module&, cancellation_token)
+                                                                           -> std::optional<statement_ptr> {
+                                                                       while (!won.load()) {
+                                                                           std::this_thread::yield();
+                                                                       }
+                                                                       return std::nullopt;
+                                                                   },
+                                                           },
+                                                           search_strategy{
+                                                                   .name = "found",
+                                                                   .run = [&](const module&, cancellation_token)
+                                                                           -> std::optional<statement_ptr> {
+                                                                       won.store(true);
+                                                                       return truth();
+                                                                   },
+                                                           },
+                                                   });
+            expect(result.winner.has_value(), isTrue);
+            expect(result.reports[0].outcome, strategy_outcome::failed);
+            expect(result.reports[1].outcome, strategy_outcome::succeeded);
+        });
+
+        test("no strategy succeeds", [&] {
+            const auto result = run_portfolio(mod, {
+                                                           const_strategy("fails", std::nullopt),
+                                                           throwing_strategy("throws"),
+                                                   });
+            expect(result.result.has_value(), isFalse);
+            expect(result.winner.has_value(), isFalse);
+            expect(result.reports, hasSize(2));
+            expect(result.reports[0].outcome, strategy_outcome::failed);
+            expect(result.reports[1].outcome, strategy_outcome::threw);
+        });
+
+        test("empty portfolio", [&] {
+            const auto result = run_portfolio(mod, {});
+            expect(result.result.has_value(), isFalse);
+            expect(result.reports, isEmpty);
+        });
+    });
+
+    group("mp_search_strategy", [&] {
+        const auto fact = conj(var_stmt(a), implies(var_stmt(a), var_stmt(b)));
+
+        test("forward, single step", [&] {
+            const auto result = run_single(mod, mp_search_strategy("fwd", {fact}, var_stmt(b)));
+            expect(result.has_value(), isTrue);
+            expect(equals(*result.value(), *var_stmt(b)), isTrue);
+        });
+
+        test("forward, respects depth limit", [&] {
+            const auto negated_fact = neg(neg(fact));
+            const auto shallow = run_single(mod, mp_search_strategy("fwd", {negated_fact}, var_stmt(b), {.max_depth = 1}));
+            expect(shallow.has_value(), isFalse);
+            const auto deep = run_single(mod, mp_search_strategy("fwd", {negated_fact}, var_stmt(b), {.max_depth = 2}));
+            expect(deep.has_value(), isTrue);
+        });
+
+        test("forward, restricted law order", [&] {
+            const auto result = run_single(mod, mp_search_strategy("fwd", {fact}, var_stmt(b), {.law_order = {"Double negation"}}));
+            expect(result.has_value(), isFalse);
+        });
+
+        test("forward, unknown law", [&] {
+            expect([&] {
+                (void) run_single(mod, mp_search_strategy("fwd", {fact}, var_stmt(b), {.law_order = {"Missing law"}}));
+            },
+                   throwsA<std::runtime_error>);
+        });
+
+        test("backward", [&] {
+            const auto result = run_single(mod, mp_search_strategy("bwd", {var_stmt(b)}, neg(neg(var_stmt(b))), {.direction = search_direction::backward}));
+            expect(result.has_value(), isTrue);
+            expect(equals(*result.value(), *neg(neg(var_stmt(b)))), isTrue);
+        });
+
+        test("backward, no derivation", [&] {
+            const auto result = run_single(mod, mp_search_strategy("bwd", {var_stmt(a)}, var_stmt(b), {.direction = search_direction::backward}));
+            expect(result.has_value(), isFalse);
+        });
+
+        test("order closure", [&] {
+            const auto x = var_expr(var("x"));
+            const auto y = var_expr(var("y"));
+            const auto z = var_expr(var("z"));
+            const std::vector<statement_ptr> facts{rel_stmt(x, rel_type::less, y), rel_stmt(z, rel_type::eq_greater, y)};
+            const auto target = rel_stmt(x, rel_type::less, z);
+            expect(run_single(mod, mp_search_strategy("fwd", facts, target)).has_value(), isFalse);
+            expect(run_single(mod, mp_search_strategy("fwd", facts, target, {.use_order_closure = true})).has_value(), isTrue);
+            expect(run_single(mod, mp_search_strategy("bwd", facts, neg(neg(target)), {.direction = search_direction::backward, .use_order_closure = true}))
+                           .has_value(),
+                   isTrue);
+            expect(run_single(mod, mp_search_strategy("fwd", facts, rel_stmt(z, rel_type::less, x), {.use_order_closure = true}))
+                           .has_value(),
+                   isFalse);
+        });
+
+        test("portfolio of forward and backward searches", [&] {
+            const auto result = run_portfolio(mod, {
+                                                           mp_search_strategy("fwd", {fact}, var_stmt(b)),
+                                                           mp_search_strategy("bwd", {fact}, var_stmt(b), {.direction = search_direction::backward}),
+                                                   });
+            expect(result.result.has_value(), isTrue);
+            expect(equals(*result.result.value(), *var_stmt(b)), isTrue);
+        });
+    });
+}
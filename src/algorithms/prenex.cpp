@@ -0,0 +1,303 @@
+#include "algorithms/prenex.h"
+
+#include <algorithm>
+#include <string>
+
+#include "algorithms/apply_vars.h"
+#include "algorithms/occurs.h"
+
+namespace tema {
+
+namespace {
+
+void collect_free_vars(const expression& expr,  // NOLINT(misc-no-recursion)
+                       std::vector<const variable*>& bound,
+                       std::vector<variable_ptr>& vars) {
+    if (expr.is_var()) {
+        const auto& var = expr.as_var();
+        if (std::find(bound.begin(), bound.end(), var.get()) == bound.end() &&
+            std::find(vars.begin(), vars.end(), var) == vars.end()) {
+            vars.push_back(var);
+        }
+    } else if (expr.is_binop()) {
+        collect_free_vars(*expr.as_binop().left, bound, vars);
+        collect_free_vars(*expr.as_binop().right, bound, vars);
+    } else {
+        collect_free_vars(*expr.as_call().callee, bound, vars);
+        for (const auto& param: expr.as_call().params) {
+            collect_free_vars(*param, bound, vars);
+        }
+    }
+}
+
+void collect_free_vars(const statement& stmt,  // NOLINT(misc-no-recursion)
+                       std::vector<const variable*>& bound,
+                       std::vector<variable_ptr>& vars) {
+    if (stmt.is_var()) {
+        const auto& var = stmt.as_var();
+        if (std::find(bound.begin(), bound.end(), var.get()) == bound.end() &&
+            std::find(vars.begin(), vars.end(), var) == vars.end()) {
+            vars.push_back(var);
+        }
+    } else if (stmt.is_rel()) {
+        collect_free_vars(*stmt.as_rel().left, bound, vars);
+        collect_free_vars(*stmt.as_rel().right, bound, vars);
+    } else if (stmt.is_neg()) {
+        collect_free_vars(*stmt.as_neg().inner, bound, vars);
+    } else if (stmt.is_implies()) {
+        collect_free_vars(*stmt.as_implies().from, bound, vars);
+        collect_free_vars(*stmt.as_implies().to, bound, vars);
+    } else if (stmt.is_equiv()) {
+        collect_free_vars(*stmt.as_equiv().left, bound, vars);
+        collect_free_vars(*stmt.as_equiv().right, bound, vars);
+    } else if (stmt.is_conj() || stmt.is_disj()) {
+        for (const auto& child: stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner) {
+            collect_free_vars(*child, bound, vars);
+        }
+    } else if (stmt.is_forall()) {
+        bound.push_back(stmt.as_forall().var.get());
+        collect_free_vars(*stmt.as_forall().inner, bound, vars);
+        bound.pop_back();
+    }
+}
+
+void append_flipped(std::vector<prenex_quantifier>& prefix, const std::vector<prenex_quantifier>& other) {
+    for (const auto& quantifier: other) {
+        prefix.push_back(prenex_quantifier{quantifier.var, !quantifier.universal});
+    }
+}
+
+}  // namespace
+
+std::vector<variable_ptr> free_variables(const statement& stmt) {
+    std::vector<const variable*> bound;
+    std::vector<variable_ptr> vars;
+    collect_free_vars(stmt, bound, vars);
+    return vars;
+}
+
+statement_ptr to_statement(const prenex_form& form) {
+    auto stmt = form.matrix;
+    for (auto it = form.prefix.rbegin(); it != form.prefix.rend(); it++) {
+        stmt = it->universal ? forall(it->var, std::move(stmt)) : neg(forall(it->var, neg(std::move(stmt))));
+    }
+    return stmt;
+}
+
+statement_ptr to_statement(const skolem_form& form) {
+    auto stmt = form.matrix;
+    for (auto it = form.universals.rbegin(); it != form.universals.rend(); it++) {
+        stmt = forall(*it, std::move(stmt));
+    }
+    return stmt;
+}
+
+skolemization_error::skolemization_error(const variable_ptr& var)
+    : std::runtime_error("Cannot Skolemize existential statement variable " + var->name + " that depends on universal variables") {}
+
+bool prenex_converter::has_forall(const statement_ptr& stmt) {  // NOLINT(misc-no-recursion)
+    const auto it = has_forall_memo.find(stmt.get());
+    if (it != has_forall_memo.end()) {
+        return it->second.second;
+    }
+    bool result = false;
+    if (stmt->is_forall()) {
+        result = true;
+    } else if (stmt->is_neg()) {
+        result = has_forall(stmt->as_neg().inner);
+    } else if (stmt->is_implies()) {
+        result = has_forall(stmt->as_implies().from) || has_forall(stmt->as_implies().to);
+    } else if (stmt->is_equiv()) {
+        result = has_forall(stmt->as_equiv().left) || has_forall(stmt->as_equiv().right);
+    } else if (stmt->is_conj() || stmt->is_disj()) {
+        for (const auto& child: stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner) {
+            result = has_forall(child) || result;
+        }
+    }
+    has_forall_memo.emplace(stmt.get(), std::pair{stmt, result});
+    return result;
+}
+
+variable_ptr prenex_converter::fresh_var(const variable_ptr& original) {
+    num_fresh_vars += 1;
+    return var(original->name + "_" + std::to_string(num_fresh_vars));
+}
+
+expr_ptr prenex_converter::rename(const expr_ptr& expr, const rename_map& renames) {  // NOLINT(misc-no-recursion)
+    if (expr->is_var()) {
+        const auto it = renames.find(expr->as_var().get());
+        return it == renames.end() ? expr : var_expr(it->second);
+    }
+    if (expr->is_binop()) {
+        const auto& [type, left, right] = expr->as_binop();
+        const auto new_left = rename(left, renames);
+        const auto new_right = rename(right, renames);
+        return new_left == left && new_right == right ? expr : binop(new_left, type, new_right);
+    }
+    const auto callee = rename(expr->as_call().callee, renames);
+    bool changed = callee != expr->as_call().callee;
+    std::vector<expr_ptr> params;
+    params.reserve(expr->as_call().params.size());
+    for (const auto& param: expr->as_call().params) {
+        params.push_back(rename(param, renames));
+        changed = changed || params.back() != param;
+    }
+    return changed ? call(callee, std::move(params)) : expr;
+}
+
+statement_ptr prenex_converter::rename(const statement_ptr& stmt, const rename_map& renames) {  // NOLINT(misc-no-recursion)
+    if (renames.empty()) {
+        return stmt;
+    }
+    if (stmt->is_var()) {
+        const auto it = renames.find(stmt->as_var().get());
+        return it == renames.end() ? stmt : var_stmt(it->second);
+    }
+    if (stmt->is_rel()) {
+        const auto& [type, left, right] = stmt->as_rel();
+        const auto new_left = rename(left, renames);
+        const auto new_right = rename(right, renames);
+        return new_left == left && new_right == right ? stmt : rel_stmt(new_left, type, new_right);
+    }
+    if (stmt->is_neg()) {
+        const auto inner = rename(stmt->as_neg().inner, renames);
+        return inner == stmt->as_neg().inner ? stmt : neg(inner);
+    }
+    if (stmt->is_implies()) {
+        const auto from = rename(stmt->as_implies().from, renames);
+        const auto to = rename(stmt->as_implies().to, renames);
+        return from == stmt->as_implies().from && to == stmt->as_implies().to ? stmt : implies(from, to);
+    }
+    if (stmt->is_equiv()) {
+        const auto left = rename(stmt->as_equiv().left, renames);
+        const auto right = rename(stmt->as_equiv().right, renames);
+        return left == stmt->as_equiv().left && right == stmt->as_equiv().right ? stmt : equiv(left, right);
+    }
+    if (stmt->is_conj() || stmt->is_disj()) {
+        const auto& children = stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner;
+        std::vector<statement_ptr> renamed;
+        renamed.reserve(children.size());
+        for (const auto& child: children) {
+            renamed.push_back(rename(child, renames));
+        }
+        if (renamed == children) {
+            return stmt;
+        }
+        return stmt->is_conj() ? conj(std::move(renamed)) : disj(std::move(renamed));
+    }
+    // truth and contradiction. Statements with a forall are not renamed, but pulled.
+    return stmt;
+}
+
+prenex_form prenex_converter::pull(const statement_ptr& stmt, rename_map& renames) {  // NOLINT(misc-no-recursion)
+    if (!has_forall(stmt)) {
+        return {{}, rename(stmt, renames)};
+    }
+    if (stmt->is_forall()) {
+        const auto& [var, inner] = stmt->as_forall();
+        const auto new_var = used_vars.contains(var) ? fresh_var(var) : var;
+        used_vars.insert(new_var);
+        // A nested forall over the same variable shadows the outer one.
+        const auto old_it = renames.find(var.get());
+        const auto old = old_it == renames.end() ? nullptr : old_it->second;
+        if (new_var != var) {
+            renames[var.get()] = new_var;
+        } else {
+            renames.erase(var.get());
+        }
+        auto inner_form = pull(inner, renames);
+        if (old != nullptr) {
+            renames[var.get()] = old;
+        } else {
+            renames.erase(var.get());
+        }
+        prenex_form result;
+        result.prefix.reserve(inner_form.prefix.size() + 1);
+        result.prefix.push_back(prenex_quantifier{new_var, true});
+        result.prefix.insert(result.prefix.end(), inner_form.prefix.begin(), inner_form.prefix.end());
+        result.matrix = std::move(inner_form.matrix);
+        return result;
+    }
+    if (stmt->is_neg()) {
+        auto inner_form = pull(stmt->as_neg().inner, renames);
+        prenex_form result;
+        append_flipped(result.prefix, inner_form.prefix);
+        result.matrix = neg(std::move(inner_form.matrix));
+        return result;
+    }
+    if (stmt->is_implies()) {
+        // A→B is ¬A∨B: the quantifiers of A are flipped.
+        auto from_form = pull(stmt->as_implies().from, renames);
+        auto to_form = pull(stmt->as_implies().to, renames);
+        prenex_form result;
+        append_flipped(result.prefix, from_form.prefix);
+        result.prefix.insert(result.prefix.end(), to_form.prefix.begin(), to_form.prefix.end());
+        result.matrix = implies(std::move(from_form.matrix), std::move(to_form.matrix));
+        return result;
+    }
+    if (stmt->is_equiv()) {
+        const auto& [left, right] = stmt->as_equiv();
+        return pull(conj(implies(left, right), implies(right, left)), renames);
+    }
+    // conj and disj.
+    const auto& children = stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner;
+    prenex_form result;
+    std::vector<statement_ptr> matrices;
+    matrices.reserve(children.size());
+    for (const auto& child: children) {
+        auto child_form = pull(child, renames);
+        result.prefix.insert(result.prefix.end(), child_form.prefix.begin(), child_form.prefix.end());
+        matrices.push_back(std::move(child_form.matrix));
+    }
+    result.matrix = stmt->is_conj() ? conj(std::move(matrices)) : disj(std::move(matrices));
+    return result;
+}
+
+prenex_form prenex_converter::prenex(const statement_ptr& stmt) {
+    const auto free_vars = free_variables(*stmt);
+    used_vars.insert(free_vars.begin(), free_vars.end());
+    rename_map renames;
+    return pull(stmt, renames);
+}
+
+skolem_form prenex_converter::skolemize(const statement_ptr& stmt) {
+    const auto form = prenex(stmt);
+    skolem_form result;
+    match_result replacements;
+    // The matrix has no forall, so its free variables are all the variables it uses.
+    const auto matrix_vars = free_variables(*form.matrix);
+    for (const auto& [var, universal]: form.prefix) {
+        if (universal) {
+            result.universals.push_back(var);
+            continue;
+        }
+        if (std::find(matrix_vars.begin(), matrix_vars.end(), var) == matrix_vars.end()) {
+            // A vacuous existential quantifier is dropped.
+            continue;
+        }
+        num_skolem_functions += 1;
+        auto symbol = tema::var("sk" + std::to_string(num_skolem_functions));
+        if (occurs_as_expression(*form.matrix, var.get())) {
+            if (result.universals.empty()) {
+                replacements.expr_replacements.emplace(var, var_expr(symbol));
+            } else {
+                std::vector<expr_ptr> params;
+                params.reserve(result.universals.size());
+                for (const auto& universal_var: result.universals) {
+                    params.push_back(var_expr(universal_var));
+                }
+                replacements.expr_replacements.emplace(var, call(var_expr(symbol), std::move(params)));
+            }
+        } else {
+            if (!result.universals.empty()) {
+                throw skolemization_error(var);
+            }
+            replacements.stmt_replacements.emplace(var, var_stmt(symbol));
+        }
+        result.functions.push_back(skolem_function{std::move(symbol), result.universals.size()});
+    }
+    result.matrix = apply_vars(form.matrix, replacements).stmt;
+    return result;
+}
+
+}  // namespace tema
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "core/statement.h"
+
+namespace tema {
+
+// The free variables of the statement, in order of first occurrence.
+[[nodiscard]] std::vector<variable_ptr> free_variables(const statement& stmt);
+
+// A quantifier of a prenex form. Statements only have forall, so an existential quantifier ∃x A stands for ¬∀x ¬A.
+struct prenex_quantifier {
+    variable_ptr var;
+    bool universal;
+};
+
+struct prenex_form {
+    // Outermost quantifier first.
+    std::vector<prenex_quantifier> prefix;
+    // Has no forall.
+    statement_ptr matrix;
+};
+
+// The prenex form as a statement, with existential quantifiers written as ¬∀¬.
+[[nodiscard]] statement_ptr to_statement(const prenex_form& form);
+
+// A fresh function symbol introduced by Skolemization, used as the callee of call expressions (or as a constant when
+// its arity is 0).
+struct skolem_function {
+    variable_ptr symbol;
+    std::size_t arity;
+};
+
+struct skolem_form {
+    // Outermost quantifier first.
+    std::vector<variable_ptr> universals;
+    // Has no forall.
+    statement_ptr matrix;
+    std::vector<skolem_function> functions;
+};
+
+// The Skolem form as a statement, with the universal quantifiers around the matrix.
+[[nodiscard]] statement_ptr to_statement(const skolem_form& form);
+
+struct skolemization_error : std::runtime_error {
+    explicit skolemization_error(const variable_ptr& var);
+};
+
+// Moves the quantifiers of statements to prenex position, and Skolemizes them.
+//
+// Bound variables are renamed apart: a forall whose variable was already bound by another forall (in this statement or
+// in a statement converted before by the same converter), or that is free in the statement, gets a fresh variable.
+// Equivalences with a forall in either side are expanded into two implications first; the other equivalences are kept
+// as they are. Sub-statements without forall are kept as they are (unless they use a renamed variable), so they are
+// shared with the original statement.
+class prenex_converter {
+    std::unordered_map<const statement*, std::pair<statement_ptr, bool>> has_forall_memo;
+    std::set<variable_ptr> used_vars;
+    std::size_t num_fresh_vars = 0;
+    std::size_t num_skolem_functions = 0;
+
+    using rename_map = std::map<const variable*, variable_ptr>;
+
+    [[nodiscard]] bool has_forall(const statement_ptr& stmt);
+    variable_ptr fresh_var(const variable_ptr& original);
+    prenex_form pull(const statement_ptr& stmt, rename_map& renames);
+    statement_ptr rename(const statement_ptr& stmt, const rename_map& renames);
+    expr_ptr rename(const expr_ptr& expr, const rename_map& renames);
+
+public:
+    [[nodiscard]] prenex_form prenex(const statement_ptr& stmt);
+
+    // Replaces every existential variable of the prenex form by a call to a fresh function of the universal variables
+    // before it. Existential variables used as statements can only be replaced by a fresh statement variable, when
+    // there is no universal variable before them; otherwise, throws skolemization_error. Existential variables that
+    // don't occur in the matrix are dropped.
+    [[nodiscard]] skolem_form skolemize(const statement_ptr& stmt);
+};
+
+}  // namespace tema
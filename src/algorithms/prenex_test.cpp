@@ -0,0 +1,206 @@
+#include "algorithms/prenex.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.prenex") {
+    const auto x = var("x");
+    const auto y = var("y");
+    const auto t = var("t");
+    const auto p = var("p");
+    const auto ex = var_expr(x);
+    const auto ey = var_expr(y);
+    const auto et = var_expr(t);
+    const auto a = var_expr(var("A"));
+    const auto b = var_expr(var("B"));
+    const auto q = var_stmt(var("q"));
+    const auto in = [](const expr_ptr& l, const expr_ptr& r) {
+        return rel_stmt(l, rel_type::in, r);
+    };
+    const auto expect_equals = [](const statement_ptr& got, const statement_ptr& expected) {
+        expectMsg(equals(*got, *expected), "Expected " + print_utf8(*expected) + ", got " + print_utf8(*got));
+    };
+
+    test("free_variables", [&] {
+        const auto vars = free_variables(*conj(in(ex, a), forall(x, in(ex, b)), forall(t, in(et, ey))));
+        expect(vars, hasSize(4));
+        expect(vars[0] == x, isTrue);
+        expect(vars[1] == a->as_var(), isTrue);
+        expect(vars[2] == b->as_var(), isTrue);
+        expect(vars[3] == y, isTrue);
+    });
+
+    group("prenex", [&] {
+        test("statement without forall is kept", [&] {
+            prenex_converter converter;
+            const auto stmt = implies(in(ex, a), equiv(q, in(ex, b)));
+            const auto form = converter.prenex(stmt);
+            expect(form.prefix, isEmpty);
+            expect(form.matrix == stmt, isTrue);
+        });
+
+        test("forall in positive position stays universal", [&] {
+            prenex_converter converter;
+            const auto inner = implies(in(et, a), in(et, b));
+            const auto form = converter.prenex(conj(q, forall(t, inner)));
+            expect(form.prefix, hasSize(1));
+            expect(form.prefix[0].var == t, isTrue);
+            expect(form.prefix[0].universal, isTrue);
+            expect_equals(form.matrix, conj(q, inner));
+            // The sub-statements without forall are shared.
+            expect(form.matrix->as_conj().inner[1] == inner, isTrue);
+        });
+
+        test("forall under negation or on the left of an implication becomes existential", [&] {
+            prenex_converter converter;
+            const auto form = converter.prenex(neg(forall(x, in(ex, a))));
+            expect(form.prefix, hasSize(1));
+            expect(form.prefix[0].universal, isFalse);
+            expect_equals(form.matrix, neg(in(ex, a)));
+
+            const auto form2 = converter.prenex(implies(forall(y, in(ey, a)), forall(t, in(et, b))));
+            expect(form2.prefix, hasSize(2));
+            expect(form2.prefix[0].var == y && !form2.prefix[0].universal, isTrue);
+            expect(form2.prefix[1].var == t && form2.prefix[1].universal, isTrue);
+            expect_equals(form2.matrix, implies(in(ey, a), in(et, b)));
+        });
+
+        test("double negation flips twice", [&] {
+            prenex_converter converter;
+            const auto form = converter.prenex(neg(forall(x, neg(forall(y, in(ex, ey))))));
+            expect(form.prefix, hasSize(2));
+            expect(form.prefix[0].universal, isFalse);
+            expect(form.prefix[1].universal, isTrue);
+            expect_equals(form.matrix, neg(neg(in(ex, ey))));
+        });
+
+        test("shared quantified sub-statements are renamed apart", [&] {
+            prenex_converter converter;
+            const auto shared = forall(t, in(et, a));
+            const auto form = converter.prenex(disj(shared, shared));
+            expect(form.prefix, hasSize(2));
+            expect(form.prefix[0].var == t, isTrue);
+            expect(form.prefix[1].var != t, isTrue);
+            expect(form.prefix[1].var->name, isEqualTo("t_1"));
+            expect_equals(form.matrix, disj(in(et, a), in(var_expr(form.prefix[1].var), a)));
+        });
+
+        test("bound variables that are also free are renamed", [&] {
+            prenex_converter converter;
+            const auto form = converter.prenex(conj(in(et, a), forall(t, in(et, b))));
+            expect(form.prefix, hasSize(1));
+            expect(form.prefix[0].var != t, isTrue);
+            expect_equals(form.matrix, conj(in(et, a), in(var_expr(form.prefix[0].var), b)));
+        });
+
+        test("nested forall over the same variable shadows the outer one", [&] {
+            prenex_converter converter;
+            const auto form = converter.prenex(forall(t, conj(in(et, a), forall(t, in(et, b)))));
+            expect(form.prefix, hasSize(2));
+            expect(form.prefix[0].var == t, isTrue);
+            const auto inner_t = form.prefix[1].var;
+            expect(inner_t != t, isTrue);
+            expect_equals(form.matrix, conj(in(et, a), in(var_expr(inner_t), b)));
+        });
+
+        test("variables are renamed apart across statements of the same converter", [&] {
+            prenex_converter converter;
+            const auto stmt = forall(x, in(ex, a));
+            const auto first = converter.prenex(stmt);
+            const auto second = converter.prenex(stmt);
+            expect(first.prefix[0].var == x, isTrue);
+            expect(second.prefix[0].var != x, isTrue);
+        });
+
+        test("equivalences with a forall are expanded", [&] {
+            prenex_converter converter;
+            const auto form = converter.prenex(equiv(q, forall(t, in(et, a))));
+            expect(form.prefix, hasSize(2));
+            expect(form.prefix[0].universal, isTrue);
+            expect(form.prefix[1].universal, isFalse);
+            const auto t1 = var_expr(form.prefix[0].var);
+            const auto t2 = var_expr(form.prefix[1].var);
+            expect(form.prefix[0].var != form.prefix[1].var, isTrue);
+            expect_equals(form.matrix, conj(implies(q, in(t1, a)), implies(in(t2, a), q)));
+        });
+
+        test("equivalences without forall are kept", [&] {
+            prenex_converter converter;
+            const auto definition = equiv(in(et, a), in(et, b));
+            const auto form = converter.prenex(forall(t, definition));
+            expect(form.prefix, hasSize(1));
+            expect(form.matrix == definition, isTrue);
+        });
+
+        test("to_statement", [&] {
+            prenex_converter converter;
+            const auto form = converter.prenex(implies(forall(y, in(ey, a)), forall(t, in(et, b))));
+            expect_equals(to_statement(form), neg(forall(y, neg(forall(t, implies(in(ey, a), in(et, b)))))));
+        });
+    });
+
+    group("skolemize", [&] {
+        test("universal statements are kept", [&] {
+            prenex_converter converter;
+            const auto form = converter.skolemize(forall(x, forall(y, in(ex, ey))));
+            expect(form.universals, hasSize(2));
+            expect(form.functions, isEmpty);
+            expect_equals(form.matrix, in(ex, ey));
+            expect_equals(to_statement(form), forall(x, forall(y, in(ex, ey))));
+        });
+
+        test("existential after universals becomes a function call", [&] {
+            prenex_converter converter;
+            // ∀x ∃y y∈x
+            const auto form = converter.skolemize(forall(x, neg(forall(y, neg(in(ey, ex))))));
+            expect(form.universals, hasSize(1));
+            expect(form.functions, hasSize(1));
+            expect(form.functions[0].arity, isEqualTo(1u));
+            const auto sk = var_expr(form.functions[0].symbol);
+            expect_equals(form.matrix, neg(neg(in(call(sk, {ex}), ex))));
+        });
+
+        test("existential before universals becomes a constant", [&] {
+            prenex_converter converter;
+            // ∃x ∀y y∈x
+            const auto form = converter.skolemize(neg(forall(x, neg(forall(y, in(ey, ex))))));
+            expect(form.universals, hasSize(1));
+            expect(form.functions, hasSize(1));
+            expect(form.functions[0].arity, isEqualTo(0u));
+            expect_equals(form.matrix, neg(neg(in(ey, var_expr(form.functions[0].symbol)))));
+        });
+
+        test("fresh symbols for every existential", [&] {
+            prenex_converter converter;
+            const auto first = converter.skolemize(neg(forall(x, in(ex, a))));
+            const auto second = converter.skolemize(neg(forall(x, in(ex, a))));
+            expect(first.functions[0].symbol != second.functions[0].symbol, isTrue);
+            expect(first.functions[0].symbol->name != second.functions[0].symbol->name, isTrue);
+        });
+
+        test("existential statement variables", [&] {
+            prenex_converter converter;
+            const auto form = converter.skolemize(neg(forall(p, var_stmt(p))));
+            expect(form.functions, hasSize(1));
+            expect_equals(form.matrix, neg(var_stmt(form.functions[0].symbol)));
+
+            expect([&] { (void)converter.skolemize(forall(x, neg(forall(p, conj(var_stmt(p), in(ex, a)))))); },
+                   throwsA<skolemization_error>);
+        });
+
+        test("vacuous existential after a universal is dropped", [&] {
+            prenex_converter converter;
+            // ∀x ∃y x∈A
+            const auto form = converter.skolemize(forall(x, neg(forall(y, neg(in(ex, a))))));
+            expect(form.universals, hasSize(1));
+            expect(form.functions, isEmpty);
+            expect_equals(form.matrix, neg(neg(in(ex, a))));
+        });
+    });
+}
@@ -0,0 +1,186 @@
+#include "algorithms/propositional_checker.h"
+
+#include <stdexcept>
+
+#include "algorithms/apply_vars.h"
+#include "algorithms/occurs.h"
+
+namespace tema {
+
+propositional_checker::propositional_checker()
+    : true_literal(sat_literal::make(solver.new_var())) {
+    solver.add_clause({true_literal});
+}
+
+sat_literal propositional_checker::new_literal() {
+    return sat_literal::make(solver.new_var());
+}
+
+sat_literal propositional_checker::encode(const statement_ptr& stmt) {
+    const auto it = encoded.find(stmt.get());
+    if (it != encoded.end()) {
+        return it->second.second;
+    }
+    const auto lit = encode_uncached(stmt);
+    encoded.emplace(stmt.get(), std::make_pair(stmt, lit));
+    return lit;
+}
+
+sat_literal propositional_checker::encode_uncached(const statement_ptr& stmt) {
+    if (stmt->is_truth()) {
+        return true_literal;
+    }
+    if (stmt->is_contradiction()) {
+        return ~true_literal;
+    }
+    if (stmt->is_neg()) {
+        return ~encode(stmt->as_neg().inner);
+    }
+    if (stmt->is_var()) {
+        const auto var = stmt->as_var();
+        auto it = vars.find(var.get());
+        if (it == vars.end()) {
+            it = vars.emplace(var.get(), std::make_pair(var, new_literal())).first;
+        }
+        return it->second.second;
+    }
+    if (stmt->is_conj()) {
+        return encode_nary(stmt->as_conj().inner, true);
+    }
+    if (stmt->is_disj()) {
+        return encode_nary(stmt->as_disj().inner, false);
+    }
+    if (stmt->is_implies()) {
+        // A→B is ¬A∨B
+        const auto from = encode(stmt->as_implies().from);
+        const auto to = encode(stmt->as_implies().to);
+        const auto result = new_literal();
+        solver.add_clause({~result, ~from, to});
+        solver.add_clause({result, from});
+        solver.add_clause({result, ~to});
+        return result;
+    }
+    if (stmt->is_equiv()) {
+        const auto left = encode(stmt->as_equiv().left);
+        const auto right = encode(stmt->as_equiv().right);
+        const auto result = new_literal();
+        solver.add_clause({~result, ~left, right});
+        solver.add_clause({~result, left, ~right});
+        solver.add_clause({result, left, right});
+        solver.add_clause({result, ~left, ~right});
+        return result;
+    }
+    if (stmt->is_forall() && !occurs_as_expression(*stmt->as_forall().inner, stmt->as_forall().var.get())) {
+        // ∀p φ(p) is φ(⊤)∧φ(⊥) when p is propositional.
+        const auto& [var, inner] = stmt->as_forall();
+        const auto when_true = apply_vars(inner, match_result{{{var, truth()}}, {}}).stmt;
+        const auto when_false = apply_vars(inner, match_result{{{var, contradiction()}}, {}}).stmt;
+        return encode(conj(when_true, when_false));
+    }
+    // Relationships and other forall statements are opaque.
+    auto it = atoms.find(stmt);
+    if (it == atoms.end()) {
+        it = atoms.emplace(stmt, new_literal()).first;
+    }
+    return it->second;
+}
+
+sat_literal propositional_checker::encode_nary(const std::vector<statement_ptr>& children, bool is_conj) {
+    // For a conjunction x = A∧B: (¬x∨A), (¬x∨B), (x∨¬A∨¬B). Disjunctions are the dual.
+    const auto result = new_literal();
+    std::vector<sat_literal> long_clause{is_conj ? result : ~result};
+    for (const auto& child: children) {
+        const auto child_lit = encode(child);
+        if (is_conj) {
+            solver.add_clause({~result, child_lit});
+            long_clause.push_back(~child_lit);
+        } else {
+            solver.add_clause({result, ~child_lit});
+            long_clause.push_back(child_lit);
+        }
+    }
+    solver.add_clause(std::move(long_clause));
+    return result;
+}
+
+std::map<variable_ptr, bool> propositional_checker::current_assignment(const statement& stmt) const {
+    std::map<variable_ptr, bool> assignment;
+    std::vector<const statement*> stack{&stmt};
+    while (!stack.empty()) {
+        const auto* current = stack.back();
+        stack.pop_back();
+        if (current->is_var()) {
+            const auto it = vars.find(current->as_var().get());
+            if (it != vars.end()) {
+                assignment.emplace(it->second.first, solver.model_value(it->second.second));
+            }
+        } else if (current->is_neg()) {
+            stack.push_back(current->as_neg().inner.get());
+        } else if (current->is_implies()) {
+            stack.push_back(current->as_implies().from.get());
+            stack.push_back(current->as_implies().to.get());
+        } else if (current->is_equiv()) {
+            stack.push_back(current->as_equiv().left.get());
+            stack.push_back(current->as_equiv().right.get());
+        } else if (current->is_conj() || current->is_disj()) {
+            for (const auto& child: current->is_conj() ? current->as_conj().inner : current->as_disj().inner) {
+                stack.push_back(child.get());
+            }
+        }
+    }
+    return assignment;
+}
+
+propositional_check_result propositional_checker::check_validity(const statement_ptr& stmt) {
+    // The statement is valid if its negation is unsatisfiable. The negation is only asserted under a fresh
+    // activation literal, which is then disabled for good, so the solver can be reused for the next checks.
+    const auto lit = encode(stmt);
+    const auto activation = new_literal();
+    solver.add_clause({~activation, ~lit});
+    const auto result = solver.solve({activation});
+    if (result == sat_result::unknown) {
+        throw std::runtime_error("SAT solver gave up");
+    }
+    propositional_check_result check{result == sat_result::unsatisfiable, {}};
+    if (!check.holds) {
+        check.assignment = current_assignment(*stmt);
+    }
+    solver.add_clause({~activation});
+    return check;
+}
+
+propositional_check_result propositional_checker::check_satisfiability(const statement_ptr& stmt) {
+    const auto result = solver.solve({encode(stmt)});
+    if (result == sat_result::unknown) {
+        throw std::runtime_error("SAT solver gave up");
+    }
+    propositional_check_result check{result == sat_result::satisfiable, {}};
+    if (check.holds) {
+        check.assignment = current_assignment(*stmt);
+    }
+    return check;
+}
+
+bool propositional_checker::is_valid(const statement_ptr& stmt) {
+    return check_validity(stmt).holds;
+}
+
+std::vector<theorem_check> propositional_checker::check_module(const module& mod) {
+    std::vector<theorem_check> checks;
+    for (const auto& decl: mod.get_decls()) {
+        if (!holds_alternative<stmt_decl>(decl)) {
+            continue;
+        }
+        const auto& stmt = get<stmt_decl>(decl);
+        if (stmt.type == stmt_decl_type::theorem || stmt.type == stmt_decl_type::exercise) {
+            checks.push_back(theorem_check{stmt.name, is_valid(stmt.stmt)});
+        }
+    }
+    return checks;
+}
+
+const sat_statistics& propositional_checker::stats() const {
+    return solver.stats();
+}
+
+}  // namespace tema
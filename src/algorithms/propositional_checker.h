@@ -0,0 +1,61 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "algorithms/hash.h"
+#include "algorithms/sat_solver.h"
+#include "core/module.h"
+#include "core/statement.h"
+
+namespace tema {
+
+struct propositional_check_result {
+    bool holds;
+    // When checking validity, an assignment falsifying the statement if it is not valid. When checking
+    // satisfiability, an assignment satisfying the statement if it is satisfiable. Only covers the variables used as
+    // statements (var_stmt).
+    std::map<variable_ptr, bool> assignment;
+};
+
+struct theorem_check {
+    std::string name;
+    bool valid;
+};
+
+// Decides validity and satisfiability of propositional statements, built from var_stmt, neg, conj, disj, implies,
+// equiv, truth and contradiction. Relationships are opaque atoms (equal relationships are the same atom). A forall
+// over a variable used only as a statement is expanded into the conjunction of its two instances, any other forall
+// is an opaque atom as well.
+//
+// A single SAT solver is reused for all the checks, together with the encoding of every statement already seen, so
+// checking many statements that share variables and sub-statements (e.g. all the theorems of a module) is cheap.
+class propositional_checker {
+    sat_solver solver;
+    sat_literal true_literal;
+    std::unordered_map<const statement*, std::pair<statement_ptr, sat_literal>> encoded;
+    std::unordered_map<statement_ptr, sat_literal, structural_hash, structural_equal> atoms;
+    std::map<const variable*, std::pair<variable_ptr, sat_literal>> vars;
+
+    sat_literal encode(const statement_ptr& stmt);
+    sat_literal encode_uncached(const statement_ptr& stmt);
+    sat_literal encode_nary(const std::vector<statement_ptr>& children, bool is_conj);
+    sat_literal new_literal();
+    std::map<variable_ptr, bool> current_assignment(const statement& stmt) const;
+
+public:
+    propositional_checker();
+
+    [[nodiscard]] propositional_check_result check_validity(const statement_ptr& stmt);
+    [[nodiscard]] propositional_check_result check_satisfiability(const statement_ptr& stmt);
+    [[nodiscard]] bool is_valid(const statement_ptr& stmt);
+
+    // Check the validity of all the theorems and exercises of a module, in declaration order.
+    [[nodiscard]] std::vector<theorem_check> check_module(const module& mod);
+
+    [[nodiscard]] const sat_statistics& stats() const;
+};
+
+}  // namespace tema
@@ -0,0 +1,113 @@
+#include "algorithms/propositional_checker.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+void expect_valid(propositional_checker& checker, const statement_ptr& stmt, Context context = Context()) {
+    expectMsg(checker.is_valid(stmt), print_utf8(*stmt) + " is not valid", std::move(context));
+}
+
+void expect_not_valid(propositional_checker& checker, const statement_ptr& stmt, Context context = Context()) {
+    expectMsg(!checker.is_valid(stmt), print_utf8(*stmt) + " is valid", std::move(context));
+}
+
+TEST_CASE("algorithms.propositional_checker") {
+    const auto p = var("p");
+    const auto q = var("q");
+    const auto r = var("r");
+    const auto vp = var_stmt(p);
+    const auto vq = var_stmt(q);
+    const auto vr = var_stmt(r);
+
+    test("textbook tautologies", [&] {
+        propositional_checker checker;
+        expect_valid(checker, disj(vp, neg(vp)));
+        expect_valid(checker, implies(conj(vp, implies(vp, vq)), vq));
+        expect_valid(checker, equiv(implies(vp, vq), implies(neg(vq), neg(vp))));
+        expect_valid(checker, equiv(disj(vp, vq), neg(conj(neg(vp), neg(vq)))));
+        expect_valid(checker, equiv(implies(vp, implies(vq, vr)), implies(conj(vp, vq), vr)));
+        expect_valid(checker, equiv(disj(vp, conj(vq, vr)), conj(disj(vp, vq), disj(vp, vr))));
+        expect_valid(checker, implies(conj(implies(vp, vq), implies(vq, vr)), implies(vp, vr)));
+        expect_valid(checker, truth());
+        expect_valid(checker, neg(contradiction()));
+    });
+
+    test("non-tautologies with counterexamples", [&] {
+        propositional_checker checker;
+        expect_not_valid(checker, implies(vq, vp));
+        expect_not_valid(checker, contradiction());
+        const auto result = checker.check_validity(implies(implies(vp, vq), vp));
+        expect(result.holds, isFalse);
+        expect(result.assignment, hasSize(2));
+        expect(result.assignment.at(p), false);
+    });
+
+    test("checks do not affect each other", [&] {
+        propositional_checker checker;
+        expect_not_valid(checker, vp);
+        expect_not_valid(checker, neg(vp));
+        expect_valid(checker, disj(vp, neg(vp)));
+        expect_not_valid(checker, vp);
+    });
+
+    test("satisfiability", [&] {
+        propositional_checker checker;
+        const auto result = checker.check_satisfiability(conj(vp, neg(vq)));
+        expect(result.holds, isTrue);
+        expect(result.assignment.at(p), true);
+        expect(result.assignment.at(q), false);
+        expect(checker.check_satisfiability(conj(vp, neg(vp))).holds, isFalse);
+        expect(checker.check_satisfiability(vp).holds, isTrue);
+    });
+
+    test("propositional forall is expanded", [&] {
+        propositional_checker checker;
+        expect_valid(checker, implies(vp, forall(q, disj(vp, vq))));
+        expect_not_valid(checker, forall(q, vq));
+        expect_valid(checker, implies(forall(q, vq), vp));
+    });
+
+    test("relationships are opaque atoms", [&] {
+        propositional_checker checker;
+        const auto a_in_b = rel_stmt(var_expr(p), rel_type::in, var_expr(q));
+        expect_valid(checker, disj(a_in_b, neg(rel_stmt(var_expr(p), rel_type::in, var_expr(q)))));
+        expect_not_valid(checker, disj(a_in_b, neg(rel_stmt(var_expr(q), rel_type::in, var_expr(p)))));
+        const auto quantified = forall(r, rel_stmt(var_expr(r), rel_type::in, var_expr(p)));
+        expect_valid(checker, implies(quantified, quantified));
+        expect_not_valid(checker, quantified);
+    });
+
+    test("check module", [&] {
+        module mod("logic", "/logic.tema");
+        mod.add_statement_decl({{1, 1}, true, stmt_decl_type::definition, "Truth", truth(), std::nullopt});
+        mod.add_statement_decl({{2, 1}, true, stmt_decl_type::theorem, "Double negation", equiv(neg(neg(vp)), vp), std::nullopt});
+        mod.add_statement_decl({{3, 1}, true, stmt_decl_type::exercise, "Converse", implies(implies(vp, vq), implies(vq, vp)), std::nullopt});
+        propositional_checker checker;
+        const auto checks = checker.check_module(mod);
+        expect(checks, hasSize(2));
+        expect(checks[0].name, std::string{"Double negation"});
+        expect(checks[0].valid, isTrue);
+        expect(checks[1].name, std::string{"Converse"});
+        expect(checks[1].valid, isFalse);
+    });
+
+    test("many checks on one solver", [&] {
+        propositional_checker checker;
+        std::vector<variable_ptr> vars;
+        for (int i = 0; i < 20; i++) {
+            vars.push_back(var("x" + std::to_string(i)));
+        }
+        for (std::size_t i = 0; i + 2 < vars.size(); i++) {
+            const auto a = var_stmt(vars[i]);
+            const auto b = var_stmt(vars[i + 1]);
+            const auto c = var_stmt(vars[i + 2]);
+            expect_valid(checker, equiv(conj(a, disj(b, c)), disj(conj(a, b), conj(a, c))));
+            expect_not_valid(checker, equiv(conj(a, disj(b, c)), disj(a, conj(b, c))));
+        }
+    });
+}
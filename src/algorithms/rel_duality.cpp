@@ -0,0 +1,144 @@
+#include "algorithms/rel_duality.h"
+
+#include <unordered_map>
+
+#include "algorithms/equals.h"
+
+namespace tema {
+
+bool is_canonical(rel_type type) {
+    switch (type) {
+        case rel_type::eq:
+        case rel_type::less:
+        case rel_type::eq_less:
+        case rel_type::in:
+        case rel_type::is_included:
+        case rel_type::eq_is_included: return true;
+        default: return false;
+    }
+}
+
+rel_type negation_of(rel_type type) {
+    // Every positive type is followed by its negation.
+    const auto value = static_cast<int>(type);
+    return static_cast<rel_type>(value % 2 == 0 ? value + 1 : value - 1);
+}
+
+std::optional<rel_type> converse_of(rel_type type) {
+    switch (type) {
+        case rel_type::less: return rel_type::greater;
+        case rel_type::n_less: return rel_type::n_greater;
+        case rel_type::eq_less: return rel_type::eq_greater;
+        case rel_type::n_eq_less: return rel_type::n_eq_greater;
+        case rel_type::greater: return rel_type::less;
+        case rel_type::n_greater: return rel_type::n_less;
+        case rel_type::eq_greater: return rel_type::eq_less;
+        case rel_type::n_eq_greater: return rel_type::n_eq_less;
+        case rel_type::includes: return rel_type::is_included;
+        case rel_type::n_includes: return rel_type::n_is_included;
+        case rel_type::eq_includes: return rel_type::eq_is_included;
+        case rel_type::n_eq_includes: return rel_type::n_eq_is_included;
+        case rel_type::is_included: return rel_type::includes;
+        case rel_type::n_is_included: return rel_type::n_includes;
+        case rel_type::eq_is_included: return rel_type::eq_includes;
+        case rel_type::n_eq_is_included: return rel_type::n_eq_includes;
+        default: return std::nullopt;
+    }
+}
+
+canonical_rel canonical_form(const relationship& rel) {
+    canonical_rel result{rel, false};
+    if (static_cast<int>(result.rel.type) % 2 == 1) {
+        result.rel.type = negation_of(result.rel.type);
+        result.negated = true;
+    }
+    if (!is_canonical(result.rel.type)) {
+        result.rel.type = *converse_of(result.rel.type);
+        std::swap(result.rel.left, result.rel.right);
+    }
+    return result;
+}
+
+namespace {
+
+class relationship_normalizer {
+    std::unordered_map<const statement*, std::pair<statement_ptr, statement_ptr>> memo;
+
+    statement_ptr normalize_uncached(const statement_ptr& stmt) {  // NOLINT(misc-no-recursion)
+        if (stmt->is_rel()) {
+            const auto [rel, negated] = canonical_form(stmt->as_rel());
+            auto result = rel.type == stmt->as_rel().type ? stmt : rel_stmt(rel.left, rel.type, rel.right);
+            return negated ? neg(std::move(result)) : result;
+        }
+        if (stmt->is_neg()) {
+            const auto& inner = stmt->as_neg().inner;
+            if (inner->is_rel() && canonical_form(inner->as_rel()).negated) {
+                // ¬(a≠b) is a=b.
+                return normalize(inner)->as_neg().inner;
+            }
+            const auto normalized = normalize(inner);
+            return normalized == inner ? stmt : neg(normalized);
+        }
+        if (stmt->is_implies()) {
+            const auto from = normalize(stmt->as_implies().from);
+            const auto to = normalize(stmt->as_implies().to);
+            return from == stmt->as_implies().from && to == stmt->as_implies().to ? stmt : implies(from, to);
+        }
+        if (stmt->is_equiv()) {
+            const auto left = normalize(stmt->as_equiv().left);
+            const auto right = normalize(stmt->as_equiv().right);
+            return left == stmt->as_equiv().left && right == stmt->as_equiv().right ? stmt : equiv(left, right);
+        }
+        if (stmt->is_conj() || stmt->is_disj()) {
+            const auto& children = stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner;
+            std::vector<statement_ptr> normalized;
+            normalized.reserve(children.size());
+            for (const auto& child: children) {
+                normalized.push_back(normalize(child));
+            }
+            if (normalized == children) {
+                return stmt;
+            }
+            return stmt->is_conj() ? conj(std::move(normalized)) : disj(std::move(normalized));
+        }
+        if (stmt->is_forall()) {
+            const auto& [var, inner] = stmt->as_forall();
+            const auto normalized = normalize(inner);
+            return normalized == inner ? stmt : forall(var, normalized);
+        }
+        return stmt;
+    }
+
+public:
+    statement_ptr normalize(const statement_ptr& stmt) {  // NOLINT(misc-no-recursion)
+        const auto it = memo.find(stmt.get());
+        if (it != memo.end()) {
+            return it->second.second;
+        }
+        auto result = normalize_uncached(stmt);
+        memo.emplace(stmt.get(), std::pair{stmt, result});
+        return result;
+    }
+};
+
+}  // namespace
+
+statement_ptr normalize_relationships(const statement_ptr& stmt) {
+    return relationship_normalizer{}.normalize(stmt);
+}
+
+bool equals_modulo_duality(const statement_ptr& a, const statement_ptr& b) {
+    relationship_normalizer normalizer;
+    return equals(*normalizer.normalize(a), *normalizer.normalize(b));
+}
+
+std::optional<match_result> match_modulo_duality(const statement_ptr& law, const statement_ptr& application) {
+    relationship_normalizer normalizer;
+    return match(*normalizer.normalize(law), normalizer.normalize(application));
+}
+
+bool is_duality_law(const statement_ptr& law) {
+    return law->is_equiv() && equals_modulo_duality(law->as_equiv().left, law->as_equiv().right);
+}
+
+}  // namespace tema
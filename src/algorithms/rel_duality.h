@@ -0,0 +1,46 @@
+#pragma once
+
+#include <optional>
+
+#include "algorithms/match.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// The dualities between relationship types: every n_* type is the negation of its positive form, and the "greater"
+// and "includes" types are their "less" and "is included" counterparts with the operands swapped. Each relationship
+// is equivalent to exactly one canonical relationship (of type eq, less, eq_less, in, is_included or eq_is_included),
+// possibly negated.
+
+[[nodiscard]] bool is_canonical(rel_type type);
+
+// The type of the negation of a relationship (¬(a<b) is a≮b, and the other way around).
+[[nodiscard]] rel_type negation_of(rel_type type);
+
+// The type of the same relationship with its operands swapped (a<b is b>a), if there is one.
+[[nodiscard]] std::optional<rel_type> converse_of(rel_type type);
+
+struct canonical_rel {
+    // One of the canonical types.
+    relationship rel;
+    bool negated;
+};
+
+[[nodiscard]] canonical_rel canonical_form(const relationship& rel);
+
+// Rewrites every relationship of the statement into its canonical orientation, with n_* types becoming a neg of the
+// positive relationship (and a neg of a n_* relationship becoming the positive relationship). Statements that only
+// differ by these dualities become equal. Sub-statements without relationships to change are returned as they are.
+[[nodiscard]] statement_ptr normalize_relationships(const statement_ptr& stmt);
+
+[[nodiscard]] bool equals_modulo_duality(const statement_ptr& a, const statement_ptr& b);
+
+// Matches the law against the application after normalizing the relationships of both. The replacements are taken
+// from the normalized application.
+[[nodiscard]] std::optional<match_result> match_modulo_duality(const statement_ptr& law, const statement_ptr& application);
+
+// Whether the law only restates a duality (like B⊇A ⟷ A⊆B): it is an equiv statement whose two sides are equal
+// modulo duality. Such laws are redundant for engines that work on normalized statements.
+[[nodiscard]] bool is_duality_law(const statement_ptr& law);
+
+}  // namespace tema
@@ -0,0 +1,93 @@
+#include "algorithms/rel_duality.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.rel_duality") {
+    const auto a = var_expr(var("A"));
+    const auto b = var_expr(var("B"));
+    const auto x = var_expr(var("x"));
+
+    const auto expect_normalizes_to = [](const statement_ptr& stmt, const statement_ptr& expected) {
+        const auto result = normalize_relationships(stmt);
+        expectMsg(equals(*result, *expected), print_utf8(*stmt) + " normalized to " + print_utf8(*result));
+    };
+
+    test("types", [&] {
+        for (int i = 0; i < 20; i++) {
+            const auto type = static_cast<rel_type>(i);
+            expect(negation_of(negation_of(type)), type);
+            expect(negation_of(type) == type, isFalse);
+            const auto converse = converse_of(type);
+            if (converse.has_value()) {
+                expect(converse_of(*converse), type);
+                expect(converse_of(negation_of(type)), negation_of(*converse));
+            }
+            const auto [rel, negated] = canonical_form(relationship{type, a, b});
+            expect(is_canonical(rel.type), isTrue);
+            expect(negated, i % 2 == 1);
+            expect(rel.left == (converse.has_value() && !is_canonical(negated ? negation_of(type) : type) ? b : a),
+                   isTrue);
+        }
+        expect(converse_of(rel_type::eq).has_value(), isFalse);
+        expect(converse_of(rel_type::n_in).has_value(), isFalse);
+        expect(negation_of(rel_type::eq_includes), rel_type::n_eq_includes);
+    });
+
+    test("normalizing statements", [&] {
+        expect_normalizes_to(rel_stmt(b, rel_type::includes, a), rel_stmt(a, rel_type::is_included, b));
+        expect_normalizes_to(rel_stmt(b, rel_type::n_eq_includes, a), neg(rel_stmt(a, rel_type::eq_is_included, b)));
+        expect_normalizes_to(rel_stmt(x, rel_type::n_in, a), neg(rel_stmt(x, rel_type::in, a)));
+        expect_normalizes_to(neg(rel_stmt(x, rel_type::n_in, a)), rel_stmt(x, rel_type::in, a));
+        expect_normalizes_to(neg(rel_stmt(a, rel_type::greater, b)), neg(rel_stmt(b, rel_type::less, a)));
+        expect_normalizes_to(forall(var("t"), implies(rel_stmt(a, rel_type::n_eq, b), rel_stmt(b, rel_type::eq_greater, a))),
+                             forall(var("t"), implies(neg(rel_stmt(a, rel_type::eq, b)), rel_stmt(a, rel_type::eq_less, b))));
+
+        const auto unchanged = conj(rel_stmt(x, rel_type::in, a), neg(rel_stmt(a, rel_type::is_included, b)));
+        expect(normalize_relationships(unchanged) == unchanged, isTrue);
+    });
+
+    test("equals and match modulo duality", [&] {
+        expect(equals_modulo_duality(rel_stmt(a, rel_type::n_eq_is_included, b), neg(rel_stmt(b, rel_type::eq_includes, a))),
+               isTrue);
+        expect(equals_modulo_duality(rel_stmt(a, rel_type::includes, b), rel_stmt(a, rel_type::is_included, b)), isFalse);
+
+        // A law written with ⊂ applies to a statement written with ⊃.
+        const auto law = implies(rel_stmt(a, rel_type::is_included, b), rel_stmt(a, rel_type::eq_is_included, b));
+        const auto c = var_expr(var("C"));
+        const auto d = var_expr(var("D"));
+        const auto application = implies(rel_stmt(d, rel_type::includes, c), rel_stmt(d, rel_type::eq_includes, c));
+        expect(match(*law, application).has_value(), isFalse);
+        const auto result = match_modulo_duality(law, application);
+        expect(result.has_value(), isTrue);
+        expect(result->expr_replacements, hasSize(2));
+        expect(result->expr_replacements.at(a->as_var()) == c, isTrue);
+    });
+
+    test("laws of set theory that only restate dualities", [&] {
+        const auto t = var("t");
+        const std::vector<std::pair<statement_ptr, bool>> laws{
+                {equiv(rel_stmt(a, rel_type::eq_is_included, b),
+                       forall(t, implies(rel_stmt(var_expr(t), rel_type::in, a), rel_stmt(var_expr(t), rel_type::in, b)))),
+                 false},
+                {equiv(rel_stmt(a, rel_type::n_eq, b), neg(rel_stmt(a, rel_type::eq, b))), true},
+                {equiv(rel_stmt(a, rel_type::n_eq_is_included, b), neg(rel_stmt(a, rel_type::eq_is_included, b))), true},
+                {equiv(rel_stmt(b, rel_type::eq_includes, a), rel_stmt(a, rel_type::eq_is_included, b)), true},
+                {equiv(rel_stmt(b, rel_type::n_eq_includes, a), rel_stmt(a, rel_type::n_eq_is_included, b)), true},
+                {equiv(rel_stmt(a, rel_type::n_is_included, b), neg(rel_stmt(a, rel_type::is_included, b))), true},
+                {equiv(rel_stmt(b, rel_type::includes, a), rel_stmt(a, rel_type::is_included, b)), true},
+                {equiv(rel_stmt(b, rel_type::n_includes, a), rel_stmt(a, rel_type::n_is_included, b)), true},
+                {equiv(rel_stmt(b, rel_type::includes, a), rel_stmt(b, rel_type::is_included, a)), false},
+                {implies(rel_stmt(b, rel_type::includes, a), rel_stmt(a, rel_type::is_included, b)), false},
+        };
+        for (const auto& [law, is_duality] : laws) {
+            expectMsg(is_duality_law(law) == is_duality, print_utf8(*law));
+        }
+    });
+}
@@ -0,0 +1,328 @@
+#include "algorithms/resolution.h"
+
+#include <algorithm>
+#include <set>
+
+#include "algorithms/rel_duality.h"
+
+namespace tema {
+
+resolution_prover::resolution_prover(const resolution_options& options): options(options) {}
+
+void resolution_prover::add_hypothesis(const statement_ptr& hypothesis) {
+    add_statement(hypothesis, true);
+}
+
+resolution_result resolution_prover::prove(const statement_ptr& goal) {
+    add_statement(neg(goal), false);
+    return saturate();
+}
+
+void resolution_prover::add_statement(const statement_ptr& stmt, bool is_hypothesis) {
+    auto closed = stmt;
+    if (is_hypothesis) {
+        const auto free_vars = free_variables(*stmt);
+        for (auto it = free_vars.rbegin(); it != free_vars.rend(); it++) {
+            closed = forall(*it, std::move(closed));
+        }
+    }
+    const auto skolemized = prenex.skolemize(closed);
+    const std::set<const variable*> universals = [&] {
+        std::set<const variable*> vars;
+        for (const auto& var: skolemized.universals) {
+            vars.insert(var.get());
+        }
+        return vars;
+    }();
+
+    // The clauses of the matrix are the negations of the cubes of the DNF of its negation.
+    const auto negated = normal_forms.dnf(neg(normalize_relationships(skolemized.matrix)));
+    if (negated->is_contradiction()) {
+        return;
+    }
+    const auto& cubes = negated->is_disj() ? negated->as_disj().inner : std::vector<statement_ptr>{negated};
+    for (const auto& cube: cubes) {
+        std::vector<literal> clause_literals;
+        if (!cube->is_truth()) {
+            for (const auto& lit: cube->is_conj() ? cube->as_conj().inner : std::vector<statement_ptr>{cube}) {
+                const auto& atom = lit->is_neg() ? lit->as_neg().inner : lit;
+                clause_literals.push_back(literal{bank.from_statement(*atom,
+                                                                      [&](const variable& var) {
+                                                                          return universals.contains(&var);
+                                                                      }),
+                                                  !lit->is_neg()});
+            }
+        }
+        add_clause(std::move(clause_literals), is_hypothesis);
+    }
+}
+
+void resolution_prover::add_clause(std::vector<literal> clause_literals, bool is_hypothesis) {
+    std::vector<term_id> atoms;
+    atoms.reserve(clause_literals.size());
+    for (const auto& lit: clause_literals) {
+        atoms.push_back(lit.atom);
+    }
+    const auto [num_stmt_vars, num_expr_vars] = bank.rename_to_pool(atoms);
+    std::uint32_t weight = 0;
+    for (std::size_t i = 0; i < atoms.size(); i++) {
+        clause_literals[i].atom = atoms[i];
+        weight += bank.size(atoms[i]);
+    }
+    std::sort(clause_literals.begin(), clause_literals.end());
+    clause_literals.erase(std::unique(clause_literals.begin(), clause_literals.end()), clause_literals.end());
+    for (std::size_t i = 1; i < clause_literals.size(); i++) {
+        if (clause_literals[i].atom == clause_literals[i - 1].atom) {
+            stats.num_tautologies += 1;
+            return;
+        }
+    }
+
+    const auto index = static_cast<std::uint32_t>(clauses.size());
+    clauses.push_back(clause_header{static_cast<std::uint32_t>(literals.size()),
+                                    static_cast<std::uint32_t>(clause_literals.size()),
+                                    weight,
+                                    static_cast<std::uint16_t>(num_stmt_vars),
+                                    static_cast<std::uint16_t>(num_expr_vars),
+                                    clause_state::passive});
+    literals.insert(literals.end(), clause_literals.begin(), clause_literals.end());
+    if (is_hypothesis && options.set_of_support && !clause_literals.empty()) {
+        activate(index, clause_features(index));
+    } else {
+        lightest.emplace(weight, index);
+    }
+    stats.num_clauses += 1;
+    if (clause_literals.empty()) {
+        refuted = true;
+    }
+}
+
+feature_vector resolution_prover::clause_features(std::uint32_t index) const {
+    // The features of the positive literals, then of the negative literals, each the maximum over the literals. When
+    // a clause subsumes another, every one of its literals has an instance in the other clause, so its features are at
+    // most the other clause's features (even when several of its literals have the same instance).
+    const auto size = num_features();
+    feature_vector features(2 * size, 0);
+    const auto& header = clauses[index];
+    for (std::uint32_t i = 0; i < header.num_literals; i++) {
+        const auto& lit = literals[header.first_literal + i];
+        const auto literal_features = term_features(bank, lit.atom);
+        const auto offset = lit.negative ? size : 0;
+        for (std::size_t k = 0; k < size; k++) {
+            features[offset + k] = std::max(features[offset + k], literal_features[k]);
+        }
+    }
+    return features;
+}
+
+void resolution_prover::activate(std::uint32_t index, const feature_vector& features) {
+    clauses[index].state = clause_state::active;
+    active.push_back(index);
+    (void)active_index.insert(features);
+    indexed_clauses.push_back(index);
+}
+
+std::vector<resolution_prover::literal> resolution_prover::clause_literals(std::uint32_t index) const {
+    const auto& header = clauses[index];
+    return {literals.begin() + header.first_literal,
+            literals.begin() + header.first_literal + header.num_literals};
+}
+
+bool resolution_prover::select_given(std::uint32_t& given) {
+    if (options.age_weight_ratio != 0 && stats.num_given % options.age_weight_ratio == 0) {
+        while (oldest < clauses.size() && clauses[oldest].state != clause_state::passive) {
+            oldest += 1;
+        }
+        if (oldest < clauses.size()) {
+            given = oldest;
+            return true;
+        }
+    }
+    while (!lightest.empty()) {
+        const auto index = lightest.top().second;
+        lightest.pop();
+        if (clauses[index].state == clause_state::passive) {
+            given = index;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool resolution_prover::subsumes(std::uint32_t subsuming, std::uint32_t subsumed) const {
+    const auto& a = clauses[subsuming];
+    const auto& b = clauses[subsumed];
+    if (a.num_literals > b.num_literals) {
+        return false;
+    }
+    const auto* a_literals = literals.data() + a.first_literal;
+    const auto* b_literals = literals.data() + b.first_literal;
+    // Backtracking search of a literal of b for every literal of a, extending the same substitution.
+    term_substitution subst;
+    std::vector<std::pair<std::uint32_t, std::size_t>> choices;  // (literal of b, size of subst before matching it)
+    std::uint32_t next_candidate = 0;
+    while (choices.size() < a.num_literals) {
+        const auto& lit = a_literals[choices.size()];
+        bool matched = false;
+        for (auto j = next_candidate; j < b.num_literals; j++) {
+            const auto size = subst.size();
+            if (b_literals[j].negative == lit.negative && bank.match(lit.atom, b_literals[j].atom, subst)) {
+                choices.emplace_back(j, size);
+                next_candidate = 0;
+                matched = true;
+                break;
+            }
+        }
+        if (!matched) {
+            if (choices.empty()) {
+                return false;
+            }
+            next_candidate = choices.back().first + 1;
+            subst.resize(choices.back().second);
+            choices.pop_back();
+        }
+    }
+    return true;
+}
+
+std::vector<resolution_prover::literal> resolution_prover::apply(const std::vector<literal>& clause_literals,
+                                                                 const term_substitution& subst,
+                                                                 std::size_t skipped) {
+    std::vector<literal> result;
+    result.reserve(clause_literals.size());
+    for (std::size_t i = 0; i < clause_literals.size(); i++) {
+        if (i != skipped) {
+            result.push_back(literal{bank.substitute(clause_literals[i].atom, subst), clause_literals[i].negative});
+        }
+    }
+    return result;
+}
+
+void resolution_prover::resolve(const std::vector<literal>& given, const clause_header& given_header, std::uint32_t other) {
+    auto other_literals = clause_literals(other);
+    std::vector<term_id> atoms;
+    atoms.reserve(other_literals.size());
+    for (const auto& lit: other_literals) {
+        atoms.push_back(lit.atom);
+    }
+    (void)bank.rename_to_pool(atoms, given_header.num_stmt_vars, given_header.num_expr_vars);
+    for (std::size_t j = 0; j < other_literals.size(); j++) {
+        other_literals[j].atom = atoms[j];
+    }
+
+    for (std::size_t i = 0; i < given.size(); i++) {
+        for (std::size_t j = 0; j < other_literals.size(); j++) {
+            if (given[i].negative == other_literals[j].negative) {
+                continue;
+            }
+            const auto unifier = bank.unify(given[i].atom, other_literals[j].atom);
+            if (!unifier.has_value()) {
+                continue;
+            }
+            auto resolvent = apply(given, *unifier, i);
+            auto other_part = apply(other_literals, *unifier, j);
+            resolvent.insert(resolvent.end(), other_part.begin(), other_part.end());
+            stats.num_resolvents += 1;
+            add_clause(std::move(resolvent));
+            if (refuted) {
+                return;
+            }
+        }
+    }
+}
+
+void resolution_prover::factor(const std::vector<literal>& given) {
+    for (std::size_t i = 0; i < given.size(); i++) {
+        for (std::size_t j = i + 1; j < given.size(); j++) {
+            if (given[i].negative != given[j].negative) {
+                continue;
+            }
+            const auto unifier = bank.unify(given[i].atom, given[j].atom);
+            if (unifier.has_value()) {
+                stats.num_factors += 1;
+                add_clause(apply(given, *unifier, j));
+            }
+        }
+    }
+}
+
+resolution_result resolution_prover::saturate() {
+    const auto start = std::chrono::steady_clock::now();
+    while (!refuted) {
+        if (clauses.size() > options.max_clauses) {
+            return {resolution_status::clause_limit, stats};
+        }
+        if (std::chrono::steady_clock::now() - start > options.time_limit) {
+            return {resolution_status::time_limit, stats};
+        }
+        std::uint32_t given = 0;
+        if (!select_given(given)) {
+            return {resolution_status::saturated, stats};
+        }
+        stats.num_given += 1;
+        const auto features = clause_features(given);
+        const auto generalizations = active_index.at_most(features);
+        if (std::any_of(generalizations.begin(), generalizations.end(), [&](std::uint32_t entry) {
+                return subsumes(indexed_clauses[entry], given);
+            })) {
+            clauses[given].state = clause_state::removed;
+            stats.num_forward_subsumed += 1;
+            continue;
+        }
+        bool removed_any = false;
+        for (const auto entry: active_index.at_least(features)) {
+            const auto index = indexed_clauses[entry];
+            if (subsumes(given, index)) {
+                clauses[index].state = clause_state::removed;
+                active_index.remove(entry);
+                stats.num_backward_subsumed += 1;
+                removed_any = true;
+            }
+        }
+        if (removed_any) {
+            std::erase_if(active, [&](std::uint32_t index) {
+                return clauses[index].state == clause_state::removed;
+            });
+        }
+        activate(given, features);
+
+        // The header and literals are copied, as adding clauses can reallocate their storage.
+        const auto given_header = clauses[given];
+        const auto given_literals = clause_literals(given);
+        factor(given_literals);
+        for (std::size_t k = 0; k < active.size() && !refuted; k++) {
+            resolve(given_literals, given_header, active[k]);
+        }
+    }
+    return {resolution_status::proved, stats};
+}
+
+std::size_t resolution_prover::num_clauses() const {
+    return clauses.size();
+}
+
+statement_ptr resolution_prover::clause(std::size_t index) const {
+    const auto& header = clauses[index];
+    std::vector<statement_ptr> disjuncts;
+    for (std::uint32_t i = 0; i < header.num_literals; i++) {
+        const auto& lit = literals[header.first_literal + i];
+        auto atom = bank.to_statement(lit.atom);
+        disjuncts.push_back(lit.negative ? neg(std::move(atom)) : std::move(atom));
+    }
+    if (disjuncts.empty()) {
+        return contradiction();
+    }
+    return disjuncts.size() == 1 ? disjuncts[0] : disj(std::move(disjuncts));
+}
+
+resolution_result prove_by_resolution(const std::vector<statement_ptr>& hypotheses,
+                                      const statement_ptr& stmt,
+                                      const resolution_options& options) {
+    resolution_prover prover(options);
+    for (const auto& hypothesis: hypotheses) {
+        prover.add_hypothesis(hypothesis);
+    }
+    return prover.prove(stmt);
+}
+
+}  // namespace tema
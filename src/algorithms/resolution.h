@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "algorithms/feature_index.h"
+#include "algorithms/normal_form.h"
+#include "algorithms/prenex.h"
+#include "algorithms/term.h"
+#include "core/statement.h"
+
+namespace tema {
+
+struct resolution_options {
+    // The prover gives up when it has stored more clauses than this.
+    std::size_t max_clauses = 100'000;
+    std::chrono::milliseconds time_limit{10'000};
+    // One in every this many given clauses is the oldest passive clause, the others are the lightest ones.
+    std::size_t age_weight_ratio = 5;
+    // The clauses of the hypotheses are never resolved with each other, only with clauses derived from the goal: they
+    // start in the active set instead of the passive set. Complete when the hypotheses are consistent.
+    bool set_of_support = true;
+};
+
+enum class resolution_status {
+    // The empty clause was derived: the hypotheses imply the goal (or are inconsistent).
+    proved = 0,
+    // Every inference was done without deriving the empty clause: the goal does not follow from the hypotheses.
+    saturated = 1,
+    clause_limit = 2,
+    time_limit = 3,
+};
+
+struct resolution_stats {
+    std::size_t num_clauses = 0;
+    std::size_t num_given = 0;
+    std::size_t num_resolvents = 0;
+    std::size_t num_factors = 0;
+    std::size_t num_tautologies = 0;
+    std::size_t num_forward_subsumed = 0;
+    std::size_t num_backward_subsumed = 0;
+};
+
+struct resolution_result {
+    resolution_status status;
+    resolution_stats stats;
+};
+
+// A saturation prover for first-order statements, using binary resolution and factoring in a given-clause loop.
+//
+// Statements are Skolemized (see prenex_converter) and their matrix is converted to clauses, with relationships
+// written in their canonical orientation (see rel_duality.h). Relationships and statement variables are the atoms of
+// the clauses; equality is an ordinary relation (there are no equality inferences). Like in laws, the free variables
+// of the hypotheses are universally quantified, while the free variables of the goal are constants.
+//
+// The clauses of the passive set are selected by weight (the size of their atoms), and by age once in every
+// age_weight_ratio selections. A selected clause is dropped if a clause of the active set subsumes it, and removes the
+// active clauses it subsumes, before being resolved with the active set. The candidates for subsumption are found with
+// a feature_index of the active set.
+class resolution_prover {
+    struct literal {
+        term_id atom;
+        bool negative;
+
+        auto operator<=>(const literal&) const = default;
+    };
+
+    enum class clause_state : std::uint8_t {
+        passive,
+        active,
+        removed,
+    };
+
+    // The literals of all the clauses are stored contiguously, in the order in which the clauses were added. The
+    // variables of every clause are pool variables (see term_bank::rename_to_pool), numbered from 0.
+    struct clause_header {
+        std::uint32_t first_literal;
+        std::uint32_t num_literals;
+        std::uint32_t weight;
+        std::uint16_t num_stmt_vars;
+        std::uint16_t num_expr_vars;
+        clause_state state;
+    };
+
+    resolution_options options;
+    term_bank bank;
+    prenex_converter prenex;
+    normal_form_converter normal_forms;
+
+    std::vector<literal> literals;
+    std::vector<clause_header> clauses;
+    std::vector<std::uint32_t> active;
+    // The active clauses by their features (see clause_features), and the clause of every entry of the index.
+    feature_index active_index;
+    std::vector<std::uint32_t> indexed_clauses;
+    std::priority_queue<std::pair<std::uint32_t, std::uint32_t>,
+                        std::vector<std::pair<std::uint32_t, std::uint32_t>>,
+                        std::greater<>>
+            lightest;
+    std::uint32_t oldest = 0;
+    bool refuted = false;
+    resolution_stats stats;
+
+    void add_statement(const statement_ptr& stmt, bool is_hypothesis);
+    void add_clause(std::vector<literal> clause_literals, bool is_hypothesis = false);
+    [[nodiscard]] std::vector<literal> clause_literals(std::uint32_t index) const;
+    [[nodiscard]] feature_vector clause_features(std::uint32_t index) const;
+    void activate(std::uint32_t index, const feature_vector& features);
+    [[nodiscard]] bool select_given(std::uint32_t& given);
+    [[nodiscard]] bool subsumes(std::uint32_t subsuming, std::uint32_t subsumed) const;
+    void resolve(const std::vector<literal>& given, const clause_header& given_header, std::uint32_t other);
+    void factor(const std::vector<literal>& given);
+    [[nodiscard]] std::vector<literal> apply(const std::vector<literal>& clause_literals,
+                                             const term_substitution& subst,
+                                             std::size_t skipped);
+
+public:
+    explicit resolution_prover(const resolution_options& options = {});
+
+    void add_hypothesis(const statement_ptr& hypothesis);
+
+    // Adds the negation of the goal, and saturates the clauses.
+    [[nodiscard]] resolution_result prove(const statement_ptr& goal);
+
+    // Runs the given-clause loop until the empty clause is derived, no passive clause is left or a limit is reached.
+    [[nodiscard]] resolution_result saturate();
+
+    [[nodiscard]] std::size_t num_clauses() const;
+
+    // The clause as a disjunction of literals (contradiction for the empty clause), with its variables free.
+    [[nodiscard]] statement_ptr clause(std::size_t index) const;
+};
+
+// Whether stmt follows from the hypotheses, by resolution.
+[[nodiscard]] resolution_result prove_by_resolution(const std::vector<statement_ptr>& hypotheses,
+                                                    const statement_ptr& stmt,
+                                                    const resolution_options& options = {});
+
+}  // namespace tema
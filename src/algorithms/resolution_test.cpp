@@ -0,0 +1,137 @@
+#include "algorithms/resolution.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.resolution") {
+    const auto x = var("x");
+    const auto y = var("y");
+    const auto t = var("t");
+    const auto ex = var_expr(x);
+    const auto ey = var_expr(y);
+    const auto et = var_expr(t);
+    const auto a = var_expr(var("A"));
+    const auto b = var_expr(var("B"));
+    const auto c = var_expr(var("C"));
+    const auto p = var_stmt(var("p"));
+    const auto q = var_stmt(var("q"));
+    const auto r = var_stmt(var("r"));
+    const auto in = [](const expr_ptr& l, const expr_ptr& r) {
+        return rel_stmt(l, rel_type::in, r);
+    };
+    const auto inter = [](const expr_ptr& l, const expr_ptr& r) {
+        return binop(l, binop_type::set_intersection, r);
+    };
+    const auto included = [](const expr_ptr& l, const expr_ptr& r) {
+        return rel_stmt(l, rel_type::eq_is_included, r);
+    };
+    const auto intersection_def = equiv(in(ex, inter(a, b)), conj(in(ex, a), in(ex, b)));
+    const auto inclusion_def = equiv(included(a, b), forall(t, implies(in(et, a), in(et, b))));
+
+    group("propositional", [&] {
+        test("hypothetical syllogism", [&] {
+            const auto result = prove_by_resolution({}, implies(conj(implies(p, q), implies(q, r)), implies(p, r)));
+            expect(result.status, resolution_status::proved);
+        });
+
+        test("non-theorem", [&] {
+            const auto result = prove_by_resolution({}, implies(implies(p, q), implies(q, p)));
+            expect(result.status, resolution_status::saturated);
+        });
+
+        test("the free statement variables of hypotheses are universal", [&] {
+            // p→p for every p is consistent, but p for every p is not.
+            expect(prove_by_resolution({implies(p, p)}, q).status, resolution_status::saturated);
+            expect(prove_by_resolution({p}, q).status, resolution_status::proved);
+        });
+    });
+
+    group("first-order", [&] {
+        test("definitions as hypotheses", [&] {
+            const auto result = prove_by_resolution({intersection_def, inclusion_def}, included(inter(a, b), a));
+            expect(result.status, resolution_status::proved);
+            expect(result.stats.num_resolvents, isGreaterThan(0U));
+        });
+
+        test("transitivity of inclusion", [&] {
+            const auto result =
+                    prove_by_resolution({inclusion_def}, implies(conj(included(a, b), included(b, c)), included(a, c)));
+            expect(result.status, resolution_status::proved);
+        });
+
+        test("converse relationships are the same atom", [&] {
+            expect(prove_by_resolution({}, implies(included(a, b), rel_stmt(b, rel_type::eq_includes, a))).status,
+                   resolution_status::proved);
+            expect(prove_by_resolution({}, equiv(neg(in(ex, a)), rel_stmt(ex, rel_type::n_in, a))).status,
+                   resolution_status::proved);
+        });
+
+        test("drinker paradox needs Skolemization and factoring", [&] {
+            // ∃x (x∈A → ∀y y∈A)
+            const auto drinker = neg(forall(x, neg(implies(in(ex, a), forall(y, in(ey, a))))));
+            expect(prove_by_resolution({}, drinker).status, resolution_status::proved);
+        });
+
+        test("equality is an ordinary relation", [&] {
+            const auto eq = [](const expr_ptr& l, const expr_ptr& r) {
+                return rel_stmt(l, rel_type::eq, r);
+            };
+            expect(prove_by_resolution({}, implies(eq(a, b), eq(b, a))).status, resolution_status::saturated);
+            expect(prove_by_resolution({implies(eq(a, b), eq(b, a))}, implies(eq(c, ex), eq(ex, c))).status,
+                   resolution_status::proved);
+        });
+    });
+
+    group("prover", [&] {
+        test("clauses", [&] {
+            resolution_prover prover;
+            prover.add_hypothesis(implies(in(ex, a), in(ex, b)));
+            expect(prover.num_clauses(), 1U);
+            const auto clause = prover.clause(0);
+            expect(clause->is_disj(), isTrue);
+            expect(clause->as_disj().inner, hasSize(2));
+        });
+
+        test("hypotheses that are tautologies have no clauses", [&] {
+            resolution_prover prover;
+            prover.add_hypothesis(disj(in(ex, a), neg(in(ex, a))));
+            prover.add_hypothesis(truth());
+            expect(prover.num_clauses(), 0U);
+        });
+
+        test("subsumption", [&] {
+            resolution_options options;
+            options.set_of_support = false;
+            resolution_prover prover(options);
+            prover.add_hypothesis(in(ex, a));
+            prover.add_hypothesis(disj(in(ex, a), in(ex, b)));
+            prover.add_hypothesis(disj(in(ey, a), in(ex, b), in(ey, c)));
+            const auto result = prover.saturate();
+            expect(result.status, resolution_status::saturated);
+            expect(result.stats.num_forward_subsumed + result.stats.num_backward_subsumed, 2U);
+        });
+
+        test("clause limit", [&] {
+            const auto f = var_expr(var("f"));
+            resolution_options options;
+            options.max_clauses = 20;
+            // Every x∈A gives f(x)∈A, without end.
+            const auto generator = forall(x, implies(in(ex, a), in(call(f, {ex}), a)));
+            const auto result = prove_by_resolution({}, implies(conj(in(b, a), generator), in(c, b)), options);
+            expect(result.status, resolution_status::clause_limit);
+            expect(result.stats.num_clauses, isGreaterThan(20U));
+        });
+
+        test("the empty clause from the hypotheses", [&] {
+            resolution_prover prover;
+            prover.add_hypothesis(contradiction());
+            expect(prover.saturate().status, resolution_status::proved);
+            expect(equals(*prover.clause(0), *contradiction()), isTrue);
+        });
+    });
+}
@@ -0,0 +1,270 @@
+#include "algorithms/rewrite.h"
+
+#include "algorithms/apply_vars.h"
+#include "algorithms/match.h"
+
+namespace tema {
+
+namespace {
+
+bool can_orient(const statement& law) {
+    if (law.is_equiv()) {
+        return !law.as_equiv().left->is_var();
+    }
+    return law.is_rel() && law.as_rel().type == rel_type::eq && !law.as_rel().left->is_var();
+}
+
+// Whether rewriting with lhs -> rhs is possible (rhs only uses variables of lhs) and does not obviously loop forever
+// (rhs is not an instance of lhs).
+template<class T>
+bool is_usable(const std::shared_ptr<const T>& lhs, const std::shared_ptr<const T>& rhs) {
+    const auto identity = match(*lhs, lhs);
+    return identity.has_value() && apply_vars(rhs, *identity).unmatched_vars.empty() && !match(*lhs, rhs).has_value();
+}
+
+}  // namespace
+
+invalid_oriented_law::invalid_oriented_law(const std::string& name)
+    : std::runtime_error("Law \"" + name + "\" cannot be used for rewriting") {}
+
+rewrite_limit_exceeded::rewrite_limit_exceeded(std::size_t max_rewrites)
+    : std::runtime_error("Rewriting did not reach a normal form in " + std::to_string(max_rewrites) + " rewrites") {}
+
+oriented_law orient_law(std::string name, const statement_ptr& law) {
+    if (!can_orient(*law)) {
+        throw invalid_oriented_law(name);
+    }
+    if (law->is_equiv()) {
+        const auto& [left, right] = law->as_equiv();
+        return oriented_law{std::move(name), left, right, nullptr, nullptr};
+    }
+    const auto& rel = law->as_rel();
+    return oriented_law{std::move(name), nullptr, nullptr, rel.left, rel.right};
+}
+
+std::vector<oriented_law> oriented_laws(const module& mod) {
+    std::vector<oriented_law> laws;
+    for (const auto& decl: mod.get_decls()) {
+        if (!holds_alternative<stmt_decl>(decl)) {
+            continue;
+        }
+        const auto& law = get<stmt_decl>(decl);
+        if (!can_orient(*law.stmt)) {
+            continue;
+        }
+        auto oriented = orient_law(law.name, law.stmt);
+        const auto usable = oriented.stmt_lhs != nullptr ? is_usable(oriented.stmt_lhs, oriented.stmt_rhs)
+                                                         : is_usable(oriented.expr_lhs, oriented.expr_rhs);
+        if (usable) {
+            laws.push_back(std::move(oriented));
+        }
+    }
+    return laws;
+}
+
+rewriter::rewriter(std::vector<oriented_law> laws, rewrite_strategy strategy, std::size_t max_rewrites)
+    : law_list(std::move(laws)), strategy(strategy), max_rewrites(max_rewrites), counts(law_list.size(), 0) {}
+
+void rewriter::count_rewrite(std::size_t law_index) {
+    if (num_rewrites - call_start == max_rewrites) {
+        throw rewrite_limit_exceeded(max_rewrites);
+    }
+    num_rewrites++;
+    counts[law_index]++;
+}
+
+statement_ptr rewriter::rewrite_root(const statement_ptr& stmt) {
+    for (std::size_t i = 0; i < law_list.size(); i++) {
+        const auto& law = law_list[i];
+        if (law.stmt_lhs == nullptr) {
+            continue;
+        }
+        const auto replacements = match(*law.stmt_lhs, stmt);
+        if (!replacements.has_value()) {
+            continue;
+        }
+        auto result = apply_vars(law.stmt_rhs, *replacements);
+        if (result.unmatched_vars.empty()) {
+            count_rewrite(i);
+            return std::move(result.stmt);
+        }
+    }
+    return nullptr;
+}
+
+expr_ptr rewriter::rewrite_root(const expr_ptr& expr) {
+    for (std::size_t i = 0; i < law_list.size(); i++) {
+        const auto& law = law_list[i];
+        if (law.expr_lhs == nullptr) {
+            continue;
+        }
+        const auto replacements = match(*law.expr_lhs, expr);
+        if (!replacements.has_value()) {
+            continue;
+        }
+        auto result = apply_vars(law.expr_rhs, *replacements);
+        if (result.unmatched_vars.empty()) {
+            count_rewrite(i);
+            return std::move(result.expr);
+        }
+    }
+    return nullptr;
+}
+
+// Returns the statement with all its direct sub-terms normalized, or the statement itself if they all were already.
+statement_ptr rewriter::normalize_children(const statement_ptr& stmt) {
+    const auto normalize_all = [this](const std::vector<statement_ptr>& children) {
+        std::vector<statement_ptr> normalized;
+        normalized.reserve(children.size());
+        bool changed = false;
+        for (const auto& child: children) {
+            normalized.push_back(normalize_stmt(child));
+            changed = changed || normalized.back() != child;
+        }
+        return std::make_pair(changed, std::move(normalized));
+    };
+    if (stmt->is_neg()) {
+        auto inner = normalize_stmt(stmt->as_neg().inner);
+        return inner == stmt->as_neg().inner ? stmt : neg(std::move(inner));
+    }
+    if (stmt->is_implies()) {
+        const auto& [from, to] = stmt->as_implies();
+        auto new_from = normalize_stmt(from);
+        auto new_to = normalize_stmt(to);
+        return new_from == from && new_to == to ? stmt : implies(std::move(new_from), std::move(new_to));
+    }
+    if (stmt->is_equiv()) {
+        const auto& [left, right] = stmt->as_equiv();
+        auto new_left = normalize_stmt(left);
+        auto new_right = normalize_stmt(right);
+        return new_left == left && new_right == right ? stmt : equiv(std::move(new_left), std::move(new_right));
+    }
+    if (stmt->is_conj()) {
+        auto [changed, children] = normalize_all(stmt->as_conj().inner);
+        return changed ? conj(std::move(children)) : stmt;
+    }
+    if (stmt->is_disj()) {
+        auto [changed, children] = normalize_all(stmt->as_disj().inner);
+        return changed ? disj(std::move(children)) : stmt;
+    }
+    if (stmt->is_forall()) {
+        const auto& [var, inner] = stmt->as_forall();
+        auto new_inner = normalize_stmt(inner);
+        return new_inner == inner ? stmt : forall(var, std::move(new_inner));
+    }
+    if (stmt->is_rel()) {
+        const auto& rel = stmt->as_rel();
+        auto left = normalize_expr(rel.left);
+        auto right = normalize_expr(rel.right);
+        return left == rel.left && right == rel.right ? stmt : rel_stmt(std::move(left), rel.type, std::move(right));
+    }
+    return stmt;
+}
+
+expr_ptr rewriter::normalize_children(const expr_ptr& expr) {
+    if (expr->is_binop()) {
+        const auto& op = expr->as_binop();
+        auto left = normalize_expr(op.left);
+        auto right = normalize_expr(op.right);
+        return left == op.left && right == op.right ? expr : binop(std::move(left), op.type, std::move(right));
+    }
+    if (expr->is_call()) {
+        const auto& [callee, params] = expr->as_call();
+        auto new_callee = normalize_expr(callee);
+        bool changed = new_callee != callee;
+        std::vector<expr_ptr> new_params;
+        new_params.reserve(params.size());
+        for (const auto& param: params) {
+            new_params.push_back(normalize_expr(param));
+            changed = changed || new_params.back() != param;
+        }
+        return changed ? call(std::move(new_callee), std::move(new_params)) : expr;
+    }
+    return expr;
+}
+
+statement_ptr rewriter::normalize_stmt(const statement_ptr& stmt) {
+    const auto it = stmt_cache.find(stmt);
+    if (it != stmt_cache.end()) {
+        num_cache_hits++;
+        return it->second;
+    }
+    statement_ptr result;
+    if (strategy == rewrite_strategy::innermost) {
+        result = normalize_children(stmt);
+        if (auto rewritten = rewrite_root(result); rewritten != nullptr) {
+            result = normalize_stmt(rewritten);
+        }
+    } else {
+        result = stmt;
+        while (auto rewritten = rewrite_root(result)) {
+            result = std::move(rewritten);
+        }
+        if (auto with_children = normalize_children(result); with_children != result) {
+            // The root might have become reducible again.
+            result = normalize_stmt(with_children);
+        }
+    }
+    stmt_cache.emplace(stmt, result);
+    stmt_cache.emplace(result, result);
+    return result;
+}
+
+expr_ptr rewriter::normalize_expr(const expr_ptr& expr) {
+    const auto it = expr_cache.find(expr);
+    if (it != expr_cache.end()) {
+        num_cache_hits++;
+        return it->second;
+    }
+    expr_ptr result;
+    if (strategy == rewrite_strategy::innermost) {
+        result = normalize_children(expr);
+        if (auto rewritten = rewrite_root(result); rewritten != nullptr) {
+            result = normalize_expr(rewritten);
+        }
+    } else {
+        result = expr;
+        while (auto rewritten = rewrite_root(result)) {
+            result = std::move(rewritten);
+        }
+        if (auto with_children = normalize_children(result); with_children != result) {
+            result = normalize_expr(with_children);
+        }
+    }
+    expr_cache.emplace(expr, result);
+    expr_cache.emplace(result, result);
+    return result;
+}
+
+statement_ptr rewriter::normalize(const statement_ptr& stmt) {
+    call_start = num_rewrites;
+    return normalize_stmt(stmt);
+}
+
+expr_ptr rewriter::normalize(const expr_ptr& expr) {
+    call_start = num_rewrites;
+    return normalize_expr(expr);
+}
+
+const std::vector<oriented_law>& rewriter::laws() const {
+    return law_list;
+}
+
+const std::vector<std::size_t>& rewriter::rewrite_counts() const {
+    return counts;
+}
+
+std::size_t rewriter::total_rewrites() const {
+    return num_rewrites;
+}
+
+std::size_t rewriter::cache_hits() const {
+    return num_cache_hits;
+}
+
+void rewriter::clear_cache() {
+    stmt_cache.clear();
+    expr_cache.clear();
+}
+
+}  // namespace tema
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/module.h"
+#include "core/statement.h"
+
+namespace tema {
+
+// A law used left to right: every instance of lhs is replaced by the corresponding instance of rhs. Either both sides
+// are statements (given by an equiv law), or both are expressions (given by an = law).
+struct oriented_law {
+    std::string name;
+    statement_ptr stmt_lhs;
+    statement_ptr stmt_rhs;
+    expr_ptr expr_lhs;
+    expr_ptr expr_rhs;
+};
+
+struct invalid_oriented_law : std::runtime_error {
+    explicit invalid_oriented_law(const std::string& name);
+};
+
+// Orients an equiv or = law left to right. Throws invalid_oriented_law if the law is of another kind, or if its left
+// side is a bare variable (which would match everything).
+[[nodiscard]] oriented_law orient_law(std::string name, const statement_ptr& law);
+
+// The equiv and = laws of a module, oriented left to right. Laws are skipped when they cannot be oriented, when their
+// right side uses variables that their left side does not, and when their right side is itself an instance of their
+// left side (like p∧q ⟷ q∧p), because rewriting with them would never terminate. The remaining laws can still
+// undo each other (like the two DeMorgan laws together with double negation).
+[[nodiscard]] std::vector<oriented_law> oriented_laws(const module& mod);
+
+enum class rewrite_strategy {
+    // Sub-terms are normalized before the term containing them.
+    innermost,
+    // Laws are applied to a term as long as possible before normalizing its sub-terms.
+    outermost,
+};
+
+struct rewrite_limit_exceeded : std::runtime_error {
+    explicit rewrite_limit_exceeded(std::size_t max_rewrites);
+};
+
+// Rewrites statements and expressions to normal form, applying the laws at any position. When multiple laws apply to
+// the same term, the first one (in the given order) is used.
+//
+// Normal forms are cached by node identity, so sub-terms shared between statements (or repeated within the same one)
+// are only normalized once for as long as the rewriter lives.
+class rewriter {
+    std::vector<oriented_law> law_list;
+    rewrite_strategy strategy;
+    std::size_t max_rewrites;
+
+    std::vector<std::size_t> counts;
+    std::size_t num_rewrites = 0;
+    std::size_t call_start = 0;  // The value of num_rewrites when the current normalize call started.
+    std::size_t num_cache_hits = 0;
+
+    // The keys are kept alive, so that their addresses are not reused by other nodes.
+    std::unordered_map<statement_ptr, statement_ptr> stmt_cache;
+    std::unordered_map<expr_ptr, expr_ptr> expr_cache;
+
+    statement_ptr rewrite_root(const statement_ptr& stmt);
+    expr_ptr rewrite_root(const expr_ptr& expr);
+    statement_ptr normalize_children(const statement_ptr& stmt);
+    expr_ptr normalize_children(const expr_ptr& expr);
+    statement_ptr normalize_stmt(const statement_ptr& stmt);
+    expr_ptr normalize_expr(const expr_ptr& expr);
+    void count_rewrite(std::size_t law_index);
+
+public:
+    // normalize throws rewrite_limit_exceeded when a call needs more than max_rewrites rewrites.
+    explicit rewriter(std::vector<oriented_law> laws,
+                      rewrite_strategy strategy = rewrite_strategy::innermost,
+                      std::size_t max_rewrites = 100'000);
+
+    [[nodiscard]] statement_ptr normalize(const statement_ptr& stmt);
+    [[nodiscard]] expr_ptr normalize(const expr_ptr& expr);
+
+    [[nodiscard]] const std::vector<oriented_law>& laws() const;
+
+    // The number of rewrites done with each law, indexed like laws().
+    [[nodiscard]] const std::vector<std::size_t>& rewrite_counts() const;
+    [[nodiscard]] std::size_t total_rewrites() const;
+
+    // The number of times a normal form was found in the cache instead of being computed.
+    [[nodiscard]] std::size_t cache_hits() const;
+
+    void clear_cache();
+};
+
+}  // namespace tema
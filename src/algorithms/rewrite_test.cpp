@@ -0,0 +1,160 @@
+#include "algorithms/rewrite.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+void expect_normalizes_to(rewriter& rw, const statement_ptr& stmt, const statement_ptr& expected, Context context = Context()) {
+    const auto result = rw.normalize(stmt);
+    expectMsg(equals(*result, *expected),
+              print_utf8(*stmt) + " normalized to " + print_utf8(*result) + " instead of " + print_utf8(*expected),
+              std::move(context));
+}
+
+TEST_CASE("algorithms.rewrite") {
+    const auto p = var("p");
+    const auto q = var("q");
+    const auto a = var("a");
+    const auto b = var("b");
+    const auto vp = var_stmt(p);
+    const auto vq = var_stmt(q);
+    const auto va = var_stmt(a);
+    const auto vb = var_stmt(b);
+
+    const auto double_negation = orient_law("Double negation", equiv(neg(neg(vp)), vp));
+    const auto de_morgan = orient_law("DeMorgan law II", equiv(neg(conj(vp, vq)), disj(neg(vp), neg(vq))));
+
+    test("orienting laws", [&] {
+        expect(double_negation.stmt_lhs == nullptr, isFalse);
+        expect(double_negation.expr_lhs == nullptr, isTrue);
+
+        const auto sym_diff = orient_law("Symmetric difference",
+                                         rel_stmt(binop(var_expr(p), binop_type::set_sym_difference, var_expr(q)),
+                                                  rel_type::eq,
+                                                  binop(binop(var_expr(p), binop_type::set_difference, var_expr(q)),
+                                                        binop_type::set_union,
+                                                        binop(var_expr(q), binop_type::set_difference, var_expr(p)))));
+        expect(sym_diff.stmt_lhs == nullptr, isTrue);
+        expect(sym_diff.expr_lhs == nullptr, isFalse);
+
+        expect([&] { (void)orient_law("Implication", implies(neg(neg(vp)), vp)); }, throwsA<invalid_oriented_law>);
+        expect([&] { (void)orient_law("Bare variable", equiv(vp, conj(vp, vp))); }, throwsA<invalid_oriented_law>);
+        expect([&] { (void)orient_law("Not equal", rel_stmt(var_expr(p), rel_type::n_eq, var_expr(q))); },
+               throwsA<invalid_oriented_law>);
+    });
+
+    test("laws of a module", [&] {
+        module mod("laws", "laws.tema");
+        const auto add_law = [&](std::string name, statement_ptr law) {
+            mod.add_statement_decl(stmt_decl{{0, 0}, true, stmt_decl_type::theorem, std::move(name), std::move(law), std::nullopt});
+        };
+        add_law("Double negation", equiv(neg(neg(vp)), vp));
+        add_law("Idempotence of conjunction", equiv(vp, conj(vp, vp)));
+        add_law("Commutativity of conjunction", equiv(conj(vp, vq), conj(vq, vp)));
+        add_law("Counter position", equiv(implies(vp, vq), implies(neg(vq), neg(vp))));
+        add_law("New variable", equiv(neg(vp), vq));
+        add_law("Modus Ponens", implies(conj(vp, implies(vp, vq)), vq));
+        add_law("Union with itself", rel_stmt(binop(var_expr(p), binop_type::set_union, var_expr(p)), rel_type::eq, var_expr(p)));
+
+        const auto laws = oriented_laws(mod);
+        expect(laws, hasSize(2));
+        expect(laws[0].name, "Double negation");
+        expect(laws[1].name, "Union with itself");
+    });
+
+    test("rewriting deep inside a statement", [&] {
+        rewriter rw({double_negation});
+        expect_normalizes_to(rw, implies(va, disj(vb, neg(neg(va)))), implies(va, disj(vb, va)));
+        expect_normalizes_to(rw, forall(a, neg(neg(neg(neg(va))))), forall(a, va));
+        expect(rw.rewrite_counts(), std::vector<std::size_t>{3});
+        expect(rw.total_rewrites(), 3U);
+    });
+
+    test("statements already in normal form are returned as they are", [&] {
+        rewriter rw({double_negation, de_morgan});
+        const auto stmt = implies(conj(va, neg(vb)), disj(va, vb));
+        expect(rw.normalize(stmt) == stmt, isTrue);
+        expect(rw.total_rewrites(), 0U);
+    });
+
+    test("innermost and outermost strategies", [&] {
+        const auto stmt = neg(neg(conj(va, vb)));
+
+        rewriter innermost({double_negation, de_morgan}, rewrite_strategy::innermost);
+        expect_normalizes_to(innermost, stmt, neg(disj(neg(va), neg(vb))));
+        expect(innermost.rewrite_counts(), std::vector<std::size_t>{0, 1});
+
+        rewriter outermost({double_negation, de_morgan}, rewrite_strategy::outermost);
+        expect_normalizes_to(outermost, stmt, conj(va, vb));
+        expect(outermost.rewrite_counts(), std::vector<std::size_t>{1, 0});
+    });
+
+    test("outermost strategy retries the root after normalizing sub-terms", [&] {
+        // The root only becomes ¬¬a after its child is rewritten.
+        const auto or_contradiction = orient_law("Disjunction with contradiction", equiv(disj(vp, contradiction()), vp));
+        rewriter rw({double_negation, or_contradiction}, rewrite_strategy::outermost);
+        expect_normalizes_to(rw, neg(disj(neg(va), contradiction())), va);
+        expect(rw.rewrite_counts(), std::vector<std::size_t>{1, 1});
+    });
+
+    test("shared and repeated sub-terms are normalized once", [&] {
+        rewriter rw({double_negation, de_morgan});
+        const auto shared = neg(neg(neg(conj(va, vb))));
+        expect_normalizes_to(rw, conj(shared, implies(shared, shared)),
+                             conj(disj(neg(va), neg(vb)), implies(disj(neg(va), neg(vb)), disj(neg(va), neg(vb)))));
+        expect(rw.total_rewrites(), 2U);
+        expect(rw.cache_hits(), isGreaterThan(1U));
+
+        const auto hits = rw.cache_hits();
+        (void)rw.normalize(disj(vb, shared));
+        expect(rw.total_rewrites(), 2U);
+        expect(rw.cache_hits(), isGreaterThan(hits));
+
+        rw.clear_cache();
+        (void)rw.normalize(shared);
+        expect(rw.total_rewrites(), 4U);
+    });
+
+    test("expression laws", [&] {
+        const auto x = var("x");
+        const auto sym_diff = orient_law("Symmetric difference",
+                                         rel_stmt(binop(var_expr(p), binop_type::set_sym_difference, var_expr(q)),
+                                                  rel_type::eq,
+                                                  binop(binop(var_expr(p), binop_type::set_difference, var_expr(q)),
+                                                        binop_type::set_union,
+                                                        binop(var_expr(q), binop_type::set_difference, var_expr(p)))));
+        const auto union_with_itself = orient_law("Union with itself",
+                                                  rel_stmt(binop(var_expr(p), binop_type::set_union, var_expr(p)),
+                                                           rel_type::eq,
+                                                           var_expr(p)));
+        rewriter rw({sym_diff, union_with_itself});
+
+        const auto ea = var_expr(a);
+        const auto eb = var_expr(b);
+        expect_normalizes_to(rw,
+                             neg(rel_stmt(var_expr(x), rel_type::in, binop(ea, binop_type::set_sym_difference, eb))),
+                             neg(rel_stmt(var_expr(x),
+                                          rel_type::in,
+                                          binop(binop(ea, binop_type::set_difference, eb),
+                                                binop_type::set_union,
+                                                binop(eb, binop_type::set_difference, ea)))));
+        expect(equals(*rw.normalize(call(var_expr(x), {binop(ea, binop_type::set_union, ea)})), *call(var_expr(x), {ea})),
+               isTrue);
+        expect(rw.rewrite_counts(), std::vector<std::size_t>{1, 1});
+    });
+
+    test("rewriting that does not terminate", [&] {
+        rewriter rw({orient_law("Triple negation", equiv(neg(vp), neg(neg(neg(vp)))))}, rewrite_strategy::innermost, 100);
+        expect([&] { (void)rw.normalize(neg(va)); }, throwsA<rewrite_limit_exceeded>);
+        expect(rw.total_rewrites(), 100U);
+
+        // The limit is for each call.
+        expect([&] { (void)rw.normalize(neg(vb)); }, throwsA<rewrite_limit_exceeded>);
+        expect(rw.total_rewrites(), 200U);
+    });
+}
@@ -0,0 +1,537 @@
+#include "algorithms/sat_solver.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace tema {
+
+namespace {
+
+constexpr double var_decay = 0.95;
+constexpr double clause_decay = 0.999;
+constexpr std::uint64_t restart_base = 100;
+constexpr double learnts_growth = 1.1;
+
+// The Luby sequence (1, 1, 2, 1, 1, 2, 4, 1, ...), used to schedule restarts.
+std::uint64_t luby(std::uint64_t index) {
+    std::uint64_t size = 1;
+    std::uint64_t seq = 0;
+    while (size < index + 1) {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != index) {
+        size = (size - 1) >> 1U;
+        seq--;
+        index = index % size;
+    }
+    return std::uint64_t{1} << seq;
+}
+
+}  // namespace
+
+std::uint32_t sat_solver::clause_size(clause_ref ref) const {
+    return arena[ref].code;
+}
+
+sat_literal* sat_solver::clause_lits(clause_ref ref) {
+    return arena.data() + ref + clause_header_size;
+}
+
+bool sat_solver::is_learnt(clause_ref ref) const {
+    return (arena[ref + 1].code & learnt_flag) != 0;
+}
+
+float sat_solver::clause_activity(clause_ref ref) const {
+    return std::bit_cast<float>(arena[ref + 2].code);
+}
+
+void sat_solver::set_clause_activity(clause_ref ref, float new_activity) {
+    arena[ref + 2].code = std::bit_cast<std::uint32_t>(new_activity);
+}
+
+auto sat_solver::alloc_clause(const std::vector<sat_literal>& lits, bool learnt) -> clause_ref {
+    const auto ref = static_cast<clause_ref>(arena.size());
+    arena.push_back(sat_literal{static_cast<std::uint32_t>(lits.size())});
+    arena.push_back(sat_literal{learnt ? learnt_flag : 0});
+    arena.push_back(sat_literal{std::bit_cast<std::uint32_t>(0.0F)});
+    arena.insert(arena.end(), lits.begin(), lits.end());
+    return ref;
+}
+
+void sat_solver::attach_clause(clause_ref ref) {
+    const auto* lits = clause_lits(ref);
+    watches[lits[0].code].push_back({ref, lits[1]});
+    watches[lits[1].code].push_back({ref, lits[0]});
+}
+
+void sat_solver::detach_clause(clause_ref ref) {
+    const auto* lits = clause_lits(ref);
+    for (const auto lit: {lits[0], lits[1]}) {
+        auto& ws = watches[lit.code];
+        ws.erase(std::find_if(ws.begin(), ws.end(), [ref](const watcher& w) {
+            return w.clause == ref;
+        }));
+    }
+    arena[ref + 1].code |= deleted_flag;
+    wasted += clause_header_size + clause_size(ref);
+}
+
+bool sat_solver::is_locked(clause_ref ref) {
+    const auto first = clause_lits(ref)[0];
+    return reasons[first.var()] == ref && value(first) > 0;
+}
+
+void sat_solver::collect_garbage() {
+    // Only called at decision level 0, where reasons are never inspected, so they can simply be dropped.
+    std::vector<sat_literal> old_arena;
+    old_arena.swap(arena);
+    arena.reserve(old_arena.size() - wasted);
+    for (auto& ws: watches) {
+        ws.clear();
+    }
+    std::fill(reasons.begin(), reasons.end(), no_clause);
+    for (auto* refs: {&clauses, &learnts}) {
+        for (auto& ref: *refs) {
+            const auto new_ref = static_cast<clause_ref>(arena.size());
+            const auto total = clause_header_size + old_arena[ref].code;
+            arena.insert(arena.end(), old_arena.begin() + ref, old_arena.begin() + ref + total);
+            ref = new_ref;
+            attach_clause(ref);
+        }
+    }
+    wasted = 0;
+}
+
+std::int8_t sat_solver::value(sat_literal lit) const {
+    const auto assigned = assigns[lit.var()];
+    return lit.is_negated() ? static_cast<std::int8_t>(-assigned) : assigned;
+}
+
+std::uint32_t sat_solver::decision_level() const {
+    return static_cast<std::uint32_t>(trail_limits.size());
+}
+
+void sat_solver::enqueue(sat_literal lit, clause_ref reason) {
+    assigns[lit.var()] = lit.is_negated() ? std::int8_t{-1} : std::int8_t{1};
+    levels[lit.var()] = decision_level();
+    reasons[lit.var()] = reason;
+    trail.push_back(lit);
+}
+
+auto sat_solver::propagate() -> clause_ref {
+    auto conflict = no_clause;
+    while (propagation_head < trail.size()) {
+        const auto false_lit = ~trail[propagation_head++];
+        statistics.propagations++;
+        auto& ws = watches[false_lit.code];
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < ws.size()) {
+            const auto w = ws[i];
+            if (value(w.blocker) > 0) {
+                ws[j++] = ws[i++];
+                continue;
+            }
+            auto* lits = clause_lits(w.clause);
+            const auto size = clause_size(w.clause);
+            if (lits[0] == false_lit) {
+                std::swap(lits[0], lits[1]);
+            }
+            i++;
+            const auto first = lits[0];
+            if (first != w.blocker && value(first) > 0) {
+                ws[j++] = {w.clause, first};
+                continue;
+            }
+            bool found_watch = false;
+            for (std::uint32_t k = 2; k < size; k++) {
+                if (value(lits[k]) >= 0) {
+                    std::swap(lits[1], lits[k]);
+                    watches[lits[1].code].push_back({w.clause, first});
+                    found_watch = true;
+                    break;
+                }
+            }
+            if (found_watch) {
+                continue;
+            }
+            ws[j++] = {w.clause, first};
+            if (value(first) < 0) {
+                conflict = w.clause;
+                propagation_head = trail.size();
+                while (i < ws.size()) {
+                    ws[j++] = ws[i++];
+                }
+            } else {
+                enqueue(first, w.clause);
+            }
+        }
+        ws.resize(j);
+    }
+    return conflict;
+}
+
+void sat_solver::analyze(clause_ref conflict, std::vector<sat_literal>& learnt, std::uint32_t& backtrack_level) {
+    learnt.clear();
+    learnt.push_back(sat_literal{0});  // Placeholder for the asserting literal.
+    std::uint32_t path_count = 0;
+    std::optional<sat_literal> p;
+    auto index = trail.size();
+    do {
+        if (is_learnt(conflict)) {
+            bump_clause(conflict);
+        }
+        const auto* lits = clause_lits(conflict);
+        const auto size = clause_size(conflict);
+        // For reason clauses, the first literal is the one that was implied, skip it.
+        for (std::uint32_t k = p.has_value() ? 1 : 0; k < size; k++) {
+            const auto q = lits[k];
+            if (seen[q.var()] == 0 && levels[q.var()] > 0) {
+                bump_var(q.var());
+                seen[q.var()] = 1;
+                if (levels[q.var()] >= decision_level()) {
+                    path_count++;
+                } else {
+                    learnt.push_back(q);
+                }
+            }
+        }
+        do {
+            index--;
+        } while (seen[trail[index].var()] == 0);
+        p = trail[index];
+        conflict = reasons[p->var()];
+        seen[p->var()] = 0;
+        path_count--;
+    } while (path_count > 0);
+    learnt[0] = ~*p;
+
+    // Remove literals implied by the other literals of the learnt clause.
+    const std::vector<sat_literal> to_clear(learnt.begin() + 1, learnt.end());
+    learnt.erase(std::remove_if(learnt.begin() + 1, learnt.end(), [&](sat_literal lit) {
+                     return is_redundant(lit);
+                 }),
+                 learnt.end());
+    for (const auto lit: to_clear) {
+        seen[lit.var()] = 0;
+    }
+
+    backtrack_level = 0;
+    if (learnt.size() > 1) {
+        std::size_t max_index = 1;
+        for (std::size_t k = 2; k < learnt.size(); k++) {
+            if (levels[learnt[k].var()] > levels[learnt[max_index].var()]) {
+                max_index = k;
+            }
+        }
+        std::swap(learnt[1], learnt[max_index]);
+        backtrack_level = levels[learnt[1].var()];
+    }
+}
+
+bool sat_solver::is_redundant(sat_literal lit) {
+    const auto reason = reasons[lit.var()];
+    if (reason == no_clause) {
+        return false;
+    }
+    const auto* lits = clause_lits(reason);
+    const auto size = clause_size(reason);
+    for (std::uint32_t k = 1; k < size; k++) {
+        if (seen[lits[k].var()] == 0 && levels[lits[k].var()] > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void sat_solver::cancel_until(std::uint32_t level) {
+    if (decision_level() <= level) {
+        return;
+    }
+    for (auto k = trail.size(); k > trail_limits[level]; k--) {
+        const auto var = trail[k - 1].var();
+        saved_phase[var] = assigns[var] < 0;
+        assigns[var] = 0;
+        reasons[var] = no_clause;
+        heap_insert(var);
+    }
+    trail.resize(trail_limits[level]);
+    propagation_head = trail.size();
+    trail_limits.resize(level);
+}
+
+std::optional<sat_literal> sat_solver::pick_branch_literal() {
+    while (!heap.empty()) {
+        const auto var = heap_pop();
+        if (assigns[var] == 0) {
+            return sat_literal::make(var, saved_phase[var]);
+        }
+    }
+    return std::nullopt;
+}
+
+void sat_solver::reduce_learnts() {
+    std::sort(learnts.begin(), learnts.end(), [&](clause_ref a, clause_ref b) {
+        return clause_activity(a) < clause_activity(b);
+    });
+    const auto limit = clause_inc / static_cast<double>(learnts.size());
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < learnts.size(); i++) {
+        const auto ref = learnts[i];
+        const bool removable = clause_size(ref) > 2 && !is_locked(ref) &&
+                               (i < learnts.size() / 2 || static_cast<double>(clause_activity(ref)) < limit);
+        if (removable) {
+            detach_clause(ref);
+        } else {
+            learnts[j++] = ref;
+        }
+    }
+    learnts.resize(j);
+}
+
+sat_result sat_solver::search(std::uint64_t max_conflicts, const std::vector<sat_literal>& assumptions, std::uint64_t& budget_left) {
+    std::uint64_t conflicts = 0;
+    std::vector<sat_literal> learnt;
+    while (true) {
+        const auto conflict = propagate();
+        if (conflict != no_clause) {
+            statistics.conflicts++;
+            conflicts++;
+            if (budget_left > 0) {
+                budget_left--;
+            }
+            if (decision_level() == 0) {
+                ok = false;
+                return sat_result::unsatisfiable;
+            }
+            std::uint32_t backtrack_level = 0;
+            analyze(conflict, learnt, backtrack_level);
+            cancel_until(backtrack_level);
+            if (learnt.size() == 1) {
+                enqueue(learnt[0], no_clause);
+            } else {
+                const auto ref = alloc_clause(learnt, true);
+                learnts.push_back(ref);
+                attach_clause(ref);
+                bump_clause(ref);
+                enqueue(learnt[0], ref);
+                statistics.learnt_clauses++;
+            }
+            var_inc /= var_decay;
+            clause_inc /= clause_decay;
+            if (budget_left == 0) {
+                cancel_until(0);
+                return sat_result::unknown;
+            }
+            continue;
+        }
+
+        if (conflicts >= max_conflicts) {
+            cancel_until(0);
+            return sat_result::unknown;
+        }
+        if (static_cast<double>(learnts.size()) - static_cast<double>(trail.size()) >= max_learnts) {
+            reduce_learnts();
+        }
+
+        std::optional<sat_literal> next;
+        while (decision_level() < assumptions.size()) {
+            const auto assumption = assumptions[decision_level()];
+            const auto assumption_value = value(assumption);
+            if (assumption_value > 0) {
+                // Already true, introduce an empty decision level to keep levels aligned with assumptions.
+                trail_limits.push_back(trail.size());
+            } else if (assumption_value < 0) {
+                return sat_result::unsatisfiable;
+            } else {
+                next = assumption;
+                break;
+            }
+        }
+        if (!next.has_value()) {
+            statistics.decisions++;
+            next = pick_branch_literal();
+            if (!next.has_value()) {
+                return sat_result::satisfiable;
+            }
+        }
+        trail_limits.push_back(trail.size());
+        enqueue(*next, no_clause);
+    }
+}
+
+void sat_solver::bump_var(sat_var var) {
+    activity[var] += var_inc;
+    if (activity[var] > 1e100) {
+        for (auto& a: activity) {
+            a *= 1e-100;
+        }
+        var_inc *= 1e-100;
+    }
+    if (heap_index[var] >= 0) {
+        heap_sift_up(static_cast<std::size_t>(heap_index[var]));
+    }
+}
+
+void sat_solver::bump_clause(clause_ref ref) {
+    const auto bumped = clause_activity(ref) + static_cast<float>(clause_inc);
+    set_clause_activity(ref, bumped);
+    if (bumped > 1e20F) {
+        for (const auto learnt: learnts) {
+            set_clause_activity(learnt, clause_activity(learnt) * 1e-20F);
+        }
+        clause_inc *= 1e-20;
+    }
+}
+
+void sat_solver::heap_insert(sat_var var) {
+    if (heap_index[var] >= 0) {
+        return;
+    }
+    heap_index[var] = static_cast<std::int64_t>(heap.size());
+    heap.push_back(var);
+    heap_sift_up(heap.size() - 1);
+}
+
+sat_var sat_solver::heap_pop() {
+    const auto top = heap[0];
+    heap[0] = heap.back();
+    heap_index[heap[0]] = 0;
+    heap_index[top] = -1;
+    heap.pop_back();
+    if (!heap.empty()) {
+        heap_sift_down(0);
+    }
+    return top;
+}
+
+void sat_solver::heap_sift_up(std::size_t pos) {
+    const auto var = heap[pos];
+    while (pos > 0) {
+        const auto parent = (pos - 1) / 2;
+        if (activity[heap[parent]] >= activity[var]) {
+            break;
+        }
+        heap[pos] = heap[parent];
+        heap_index[heap[pos]] = static_cast<std::int64_t>(pos);
+        pos = parent;
+    }
+    heap[pos] = var;
+    heap_index[var] = static_cast<std::int64_t>(pos);
+}
+
+void sat_solver::heap_sift_down(std::size_t pos) {
+    const auto var = heap[pos];
+    while (2 * pos + 1 < heap.size()) {
+        auto child = 2 * pos + 1;
+        if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]]) {
+            child++;
+        }
+        if (activity[heap[child]] <= activity[var]) {
+            break;
+        }
+        heap[pos] = heap[child];
+        heap_index[heap[pos]] = static_cast<std::int64_t>(pos);
+        pos = child;
+    }
+    heap[pos] = var;
+    heap_index[var] = static_cast<std::int64_t>(pos);
+}
+
+sat_var sat_solver::new_var() {
+    const auto var = static_cast<sat_var>(assigns.size());
+    assigns.push_back(0);
+    levels.push_back(0);
+    reasons.push_back(no_clause);
+    saved_phase.push_back(true);
+    activity.push_back(0.0);
+    heap_index.push_back(-1);
+    seen.push_back(0);
+    watches.emplace_back();
+    watches.emplace_back();
+    heap_insert(var);
+    return var;
+}
+
+std::uint32_t sat_solver::num_vars() const {
+    return static_cast<std::uint32_t>(assigns.size());
+}
+
+bool sat_solver::add_clause(std::vector<sat_literal> lits) {
+    if (!ok) {
+        return false;
+    }
+    std::sort(lits.begin(), lits.end(), [](sat_literal a, sat_literal b) {
+        return a.code < b.code;
+    });
+    std::vector<sat_literal> kept;
+    kept.reserve(lits.size());
+    for (std::size_t i = 0; i < lits.size(); i++) {
+        const auto lit = lits[i];
+        if (value(lit) > 0 || (i + 1 < lits.size() && lits[i + 1] == ~lit)) {
+            // Satisfied at level 0, or a tautology.
+            return true;
+        }
+        if (value(lit) == 0 && (kept.empty() || kept.back() != lit)) {
+            kept.push_back(lit);
+        }
+    }
+    if (kept.empty()) {
+        ok = false;
+        return false;
+    }
+    if (kept.size() == 1) {
+        enqueue(kept[0], no_clause);
+        ok = propagate() == no_clause;
+        return ok;
+    }
+    const auto ref = alloc_clause(kept, false);
+    clauses.push_back(ref);
+    attach_clause(ref);
+    return true;
+}
+
+sat_result sat_solver::solve(const std::vector<sat_literal>& assumptions) {
+    model.clear();
+    if (!ok) {
+        return sat_result::unsatisfiable;
+    }
+    if (wasted * 2 > arena.size()) {
+        collect_garbage();
+    }
+    max_learnts = std::max(static_cast<double>(clauses.size()) / 3.0, max_learnts);
+    auto budget_left = conflict_budget.value_or(UINT64_MAX);
+    auto result = sat_result::unknown;
+    for (std::uint64_t restart = 0; result == sat_result::unknown && budget_left > 0; restart++) {
+        if (restart > 0) {
+            statistics.restarts++;
+        }
+        result = search(luby(restart) * restart_base, assumptions, budget_left);
+        max_learnts *= learnts_growth;
+    }
+    if (result == sat_result::satisfiable) {
+        model = assigns;
+    }
+    cancel_until(0);
+    return result;
+}
+
+void sat_solver::set_conflict_budget(std::optional<std::uint64_t> budget) {
+    conflict_budget = budget;
+}
+
+bool sat_solver::model_value(sat_var var) const {
+    // Variables left unassigned in a model are irrelevant, report them as false.
+    return var < model.size() && model[var] > 0;
+}
+
+bool sat_solver::model_value(sat_literal lit) const {
+    return model_value(lit.var()) != lit.is_negated();
+}
+
+const sat_statistics& sat_solver::stats() const {
+    return statistics;
+}
+
+}  // namespace tema
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace tema {
+
+using sat_var = std::uint32_t;
+
+struct sat_literal {
+    // 2 * var + (1 if negated else 0), so that a literal and its negation are adjacent.
+    std::uint32_t code;
+
+    [[nodiscard]] static constexpr sat_literal make(sat_var var, bool negated = false) {
+        return sat_literal{var * 2 + (negated ? 1U : 0U)};
+    }
+
+    [[nodiscard]] constexpr sat_var var() const {
+        return code >> 1U;
+    }
+
+    [[nodiscard]] constexpr bool is_negated() const {
+        return (code & 1U) != 0;
+    }
+
+    [[nodiscard]] constexpr sat_literal operator~() const {
+        return sat_literal{code ^ 1U};
+    }
+
+    constexpr bool operator==(const sat_literal&) const = default;
+};
+
+enum class sat_result {
+    satisfiable = 0,
+    unsatisfiable = 1,
+    // The conflict budget was exhausted before reaching an answer.
+    unknown = 2,
+};
+
+struct sat_statistics {
+    std::uint64_t decisions = 0;
+    std::uint64_t propagations = 0;
+    std::uint64_t conflicts = 0;
+    std::uint64_t restarts = 0;
+    std::uint64_t learnt_clauses = 0;
+};
+
+// Conflict-driven clause learning SAT solver: two watched literals for unit propagation, VSIDS branching with phase
+// saving, first-UIP clause learning with minimization, Luby restarts and activity-based learnt clause deletion.
+//
+// The solver is incremental: clauses can be added between calls to solve, and solve accepts assumptions (literals
+// that are only assumed true for that call). Learnt clauses are kept between calls.
+class sat_solver {
+    using clause_ref = std::uint32_t;
+    static constexpr clause_ref no_clause = UINT32_MAX;
+
+    struct watcher {
+        clause_ref clause;
+        // Another literal of the clause. If it is true, the clause does not need to be inspected.
+        sat_literal blocker;
+    };
+
+    // Clauses are stored contiguously in the arena: a header of three words (size, flags and activity), followed by
+    // the literals. The header words are stored in the code of a sat_literal as well.
+    static constexpr std::uint32_t clause_header_size = 3;
+    static constexpr std::uint32_t learnt_flag = 1;
+    static constexpr std::uint32_t deleted_flag = 2;
+
+    std::vector<sat_literal> arena;
+    std::size_t wasted = 0;
+    std::vector<clause_ref> clauses;
+    std::vector<clause_ref> learnts;
+    std::vector<std::vector<watcher>> watches;  // Indexed by literal code, visited when the literal becomes false.
+
+    std::vector<std::int8_t> assigns;  // 0 for unassigned, 1 for true, -1 for false.
+    std::vector<std::uint32_t> levels;
+    std::vector<clause_ref> reasons;
+    std::vector<bool> saved_phase;  // True if the variable was last assigned false.
+    std::vector<sat_literal> trail;
+    std::vector<std::size_t> trail_limits;
+    std::size_t propagation_head = 0;
+
+    std::vector<double> activity;
+    double var_inc = 1.0;
+    double clause_inc = 1.0;
+    std::vector<sat_var> heap;
+    std::vector<std::int64_t> heap_index;  // -1 if the variable is not in the heap.
+
+    std::vector<std::uint8_t> seen;
+    std::vector<std::int8_t> model;
+    double max_learnts = 0;
+    bool ok = true;
+    std::optional<std::uint64_t> conflict_budget;
+    sat_statistics statistics;
+
+    [[nodiscard]] std::uint32_t clause_size(clause_ref ref) const;
+    [[nodiscard]] sat_literal* clause_lits(clause_ref ref);
+    [[nodiscard]] bool is_learnt(clause_ref ref) const;
+    [[nodiscard]] float clause_activity(clause_ref ref) const;
+    void set_clause_activity(clause_ref ref, float activity);
+    [[nodiscard]] clause_ref alloc_clause(const std::vector<sat_literal>& lits, bool learnt);
+    void attach_clause(clause_ref ref);
+    void detach_clause(clause_ref ref);
+    [[nodiscard]] bool is_locked(clause_ref ref);
+    void collect_garbage();
+
+    [[nodiscard]] std::int8_t value(sat_literal lit) const;
+    [[nodiscard]] std::uint32_t decision_level() const;
+    void enqueue(sat_literal lit, clause_ref reason);
+    [[nodiscard]] clause_ref propagate();
+    void analyze(clause_ref conflict, std::vector<sat_literal>& learnt, std::uint32_t& backtrack_level);
+    [[nodiscard]] bool is_redundant(sat_literal lit);
+    void cancel_until(std::uint32_t level);
+    [[nodiscard]] std::optional<sat_literal> pick_branch_literal();
+    void reduce_learnts();
+    [[nodiscard]] sat_result search(std::uint64_t max_conflicts, const std::vector<sat_literal>& assumptions, std::uint64_t& budget_left);
+
+    void bump_var(sat_var var);
+    void bump_clause(clause_ref ref);
+    void heap_insert(sat_var var);
+    [[nodiscard]] sat_var heap_pop();
+    void heap_sift_up(std::size_t pos);
+    void heap_sift_down(std::size_t pos);
+
+public:
+    [[nodiscard]] sat_var new_var();
+    [[nodiscard]] std::uint32_t num_vars() const;
+
+    // Add a clause (a disjunction of literals). Returns false if the clauses became trivially unsatisfiable.
+    bool add_clause(std::vector<sat_literal> lits);
+
+    // Decide satisfiability of the clauses, assuming the given literals are true.
+    [[nodiscard]] sat_result solve(const std::vector<sat_literal>& assumptions = {});
+
+    // Maximum number of conflicts for each call to solve. std::nullopt (the default) means no limit.
+    void set_conflict_budget(std::optional<std::uint64_t> budget);
+
+    // Value of a variable in the model found by the last call to solve that returned sat_result::satisfiable.
+    [[nodiscard]] bool model_value(sat_var var) const;
+    [[nodiscard]] bool model_value(sat_literal lit) const;
+
+    [[nodiscard]] const sat_statistics& stats() const;
+};
+
+}  // namespace tema
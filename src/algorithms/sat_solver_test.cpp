@@ -0,0 +1,196 @@
+#include "algorithms/sat_solver.h"
+
+#include <random>
+
+#include <mcga/test_ext/matchers.hpp>
+
+using namespace tema;
+using namespace mcga::matchers;
+
+using clause_list = std::vector<std::vector<sat_literal>>;
+
+sat_literal lit(sat_var var) {
+    return sat_literal::make(var);
+}
+
+sat_literal nlit(sat_var var) {
+    return sat_literal::make(var, true);
+}
+
+bool satisfies(const clause_list& clauses, std::uint32_t assignment) {
+    return std::all_of(clauses.begin(), clauses.end(), [&](const std::vector<sat_literal>& clause) {
+        return std::any_of(clause.begin(), clause.end(), [&](sat_literal l) {
+            return (((assignment >> l.var()) & 1U) != 0) != l.is_negated();
+        });
+    });
+}
+
+bool brute_force_satisfiable(const clause_list& clauses, std::uint32_t num_vars) {
+    for (std::uint32_t assignment = 0; assignment < (1U << num_vars); assignment++) {
+        if (satisfies(clauses, assignment)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::uint32_t model_of(const sat_solver& solver, std::uint32_t num_vars) {
+    std::uint32_t assignment = 0;
+    for (sat_var v = 0; v < num_vars; v++) {
+        if (solver.model_value(v)) {
+            assignment |= 1U << v;
+        }
+    }
+    return assignment;
+}
+
+// n + 1 pigeons in n holes.
+clause_list pigeonhole(std::uint32_t n) {
+    const auto pigeon_in_hole = [n](std::uint32_t pigeon, std::uint32_t hole) {
+        return pigeon * n + hole;
+    };
+    clause_list clauses;
+    for (std::uint32_t pigeon = 0; pigeon <= n; pigeon++) {
+        auto& clause = clauses.emplace_back();
+        for (std::uint32_t hole = 0; hole < n; hole++) {
+            clause.push_back(lit(pigeon_in_hole(pigeon, hole)));
+        }
+    }
+    for (std::uint32_t hole = 0; hole < n; hole++) {
+        for (std::uint32_t a = 0; a <= n; a++) {
+            for (std::uint32_t b = a + 1; b <= n; b++) {
+                clauses.push_back({nlit(pigeon_in_hole(a, hole)), nlit(pigeon_in_hole(b, hole))});
+            }
+        }
+    }
+    return clauses;
+}
+
+void load(sat_solver& solver, const clause_list& clauses, std::uint32_t num_vars) {
+    while (solver.num_vars() < num_vars) {
+        (void) solver.new_var();
+    }
+    for (const auto& clause: clauses) {
+        solver.add_clause(clause);
+    }
+}
+
+TEST_CASE("algorithms.sat_solver") {
+    test("literals", [] {
+        const auto l = sat_literal::make(3);
+        expect(l.var(), 3U);
+        expect(l.is_negated(), isFalse);
+        expect((~l).var(), 3U);
+        expect((~l).is_negated(), isTrue);
+        expect(~~l == l, isTrue);
+    });
+
+    test("empty problem is satisfiable", [] {
+        sat_solver solver;
+        expect(solver.solve(), sat_result::satisfiable);
+    });
+
+    test("unit clauses", [] {
+        sat_solver solver;
+        const auto a = solver.new_var();
+        const auto b = solver.new_var();
+        expect(solver.add_clause({lit(a)}), isTrue);
+        expect(solver.add_clause({nlit(a), nlit(b)}), isTrue);
+        expect(solver.solve(), sat_result::satisfiable);
+        expect(solver.model_value(a), isTrue);
+        expect(solver.model_value(b), isFalse);
+        expect(solver.model_value(nlit(b)), isTrue);
+    });
+
+    test("trivially unsatisfiable", [] {
+        sat_solver solver;
+        const auto a = solver.new_var();
+        expect(solver.add_clause({lit(a)}), isTrue);
+        expect(solver.add_clause({nlit(a)}), isFalse);
+        expect(solver.solve(), sat_result::unsatisfiable);
+        expect(solver.add_clause({}), isFalse);
+    });
+
+    test("tautological and duplicate literals", [] {
+        sat_solver solver;
+        const auto a = solver.new_var();
+        const auto b = solver.new_var();
+        expect(solver.add_clause({lit(a), nlit(a)}), isTrue);
+        expect(solver.add_clause({lit(b), lit(b)}), isTrue);
+        expect(solver.solve(), sat_result::satisfiable);
+        expect(solver.model_value(b), isTrue);
+    });
+
+    test("pigeonhole principle is unsatisfiable", [] {
+        for (std::uint32_t n = 2; n <= 6; n++) {
+            sat_solver solver;
+            load(solver, pigeonhole(n), (n + 1) * n);
+            expect(solver.solve(), sat_result::unsatisfiable);
+        }
+    });
+
+    test("conflict budget", [] {
+        sat_solver solver;
+        load(solver, pigeonhole(8), 9 * 8);
+        solver.set_conflict_budget(10);
+        expect(solver.solve(), sat_result::unknown);
+        expect(solver.stats().conflicts, 10U);
+    });
+
+    test("random 3-SAT agrees with brute force", [] {
+        std::mt19937 rng(42);
+        constexpr std::uint32_t num_vars = 12;
+        for (int round = 0; round < 200; round++) {
+            clause_list clauses;
+            const auto num_clauses = 30 + round % 40;
+            for (int c = 0; c < num_clauses; c++) {
+                auto& clause = clauses.emplace_back();
+                for (int k = 0; k < 3; k++) {
+                    clause.push_back(sat_literal::make(static_cast<sat_var>(rng() % num_vars), rng() % 2 == 0));
+                }
+            }
+            sat_solver solver;
+            load(solver, clauses, num_vars);
+            const auto result = solver.solve();
+            expect(result == sat_result::satisfiable, brute_force_satisfiable(clauses, num_vars));
+            if (result == sat_result::satisfiable) {
+                expect(satisfies(clauses, model_of(solver, num_vars)), isTrue);
+            }
+        }
+    });
+
+    test("assumptions", [] {
+        sat_solver solver;
+        const auto a = solver.new_var();
+        const auto b = solver.new_var();
+        const auto c = solver.new_var();
+        solver.add_clause({nlit(a), lit(b)});
+        solver.add_clause({nlit(b), lit(c)});
+        expect(solver.solve({lit(a), nlit(c)}), sat_result::unsatisfiable);
+        expect(solver.solve({lit(a)}), sat_result::satisfiable);
+        expect(solver.model_value(c), isTrue);
+        // Assumptions are not kept between calls.
+        expect(solver.solve({nlit(c)}), sat_result::satisfiable);
+        expect(solver.model_value(a), isFalse);
+    });
+
+    test("incremental use", [] {
+        sat_solver solver;
+        const auto clauses = pigeonhole(5);
+        load(solver, {}, 6 * 5);
+        for (const auto& clause: clauses) {
+            expect(solver.solve(), sat_result::satisfiable);
+            solver.add_clause(clause);
+        }
+        expect(solver.solve(), sat_result::unsatisfiable);
+    });
+
+    test("statistics", [] {
+        sat_solver solver;
+        load(solver, pigeonhole(5), 6 * 5);
+        expect(solver.solve(), sat_result::unsatisfiable);
+        expect(solver.stats().conflicts > 0, isTrue);
+        expect(solver.stats().decisions > 0, isTrue);
+        expect(solver.stats().propagations > 0, isTrue);
+    });
+}
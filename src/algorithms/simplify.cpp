@@ -0,0 +1,178 @@
+#include "algorithms/simplify.h"
+
+#include <unordered_set>
+
+#include "algorithms/hash.h"
+
+namespace tema {
+
+void simplifier::apply(const std::string& law) {
+    counts[law] += 1;
+}
+
+const std::map<std::string, std::size_t>& simplifier::law_counts() const {
+    return counts;
+}
+
+statement_ptr simplifier::simplify(const statement_ptr& stmt) {
+    const auto it = memo.find(stmt.get());
+    if (it != memo.end()) {
+        return it->second.result;
+    }
+    statement_ptr result;
+    if (stmt->is_neg()) {
+        result = simplify_neg(simplify(stmt->as_neg().inner), stmt);
+    } else if (stmt->is_conj() || stmt->is_disj()) {
+        const auto& children = stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner;
+        std::vector<statement_ptr> simple_children;
+        simple_children.reserve(children.size());
+        for (const auto& child: children) {
+            simple_children.push_back(simplify(child));
+        }
+        result = stmt->is_conj() ? simplify_flat<true>(simple_children, stmt) : simplify_flat<false>(simple_children, stmt);
+    } else if (stmt->is_implies()) {
+        result = simplify_implies(simplify(stmt->as_implies().from), simplify(stmt->as_implies().to), stmt);
+    } else if (stmt->is_equiv()) {
+        result = simplify_equiv(simplify(stmt->as_equiv().left), simplify(stmt->as_equiv().right), stmt);
+    } else if (stmt->is_forall()) {
+        const auto& [var, inner] = stmt->as_forall();
+        const auto simple_inner = simplify(inner);
+        result = simple_inner == inner ? stmt : forall(var, simple_inner);
+    } else {
+        result = stmt;
+    }
+    memo.emplace(stmt.get(), memo_entry{stmt, result});
+    return result;
+}
+
+statement_ptr simplifier::simplify_neg(const statement_ptr& inner, const statement_ptr& original) {
+    if (inner->is_truth()) {
+        apply("Negation of truth");
+        return contradiction();
+    }
+    if (inner->is_contradiction()) {
+        apply("Negation of contradiction");
+        return truth();
+    }
+    if (inner->is_neg()) {
+        // The inner statement is already simplified, so its child is too.
+        apply("Double negation");
+        return inner->as_neg().inner;
+    }
+    if (original != nullptr && original->as_neg().inner == inner) {
+        return original;
+    }
+    return neg(inner);
+}
+
+template<bool is_conj>
+statement_ptr simplifier::simplify_flat(const std::vector<statement_ptr>& children, const statement_ptr& original) {
+    // Truth is the neutral element of conjunction and contradiction is its absorbing element, and the other way around
+    // for disjunction.
+    const auto is_neutral = [](const statement& stmt) {
+        return is_conj ? stmt.is_truth() : stmt.is_contradiction();
+    };
+    const auto is_absorbing = [](const statement& stmt) {
+        return is_conj ? stmt.is_contradiction() : stmt.is_truth();
+    };
+    const auto absorbing = [] {
+        return is_conj ? contradiction() : truth();
+    };
+
+    std::vector<statement_ptr> flat;
+    flat.reserve(children.size());
+    for (const auto& child: children) {
+        if (is_neutral(*child)) {
+            apply(is_conj ? "Identity of conjunction" : "Identity of disjunction");
+        } else if (is_absorbing(*child)) {
+            apply(is_conj ? "Domination of conjunction" : "Domination of disjunction");
+            return absorbing();
+        } else if (is_conj ? child->is_conj() : child->is_disj()) {
+            // The child is already simplified, so its own children are neither constants nor nested.
+            apply(is_conj ? "Associativity of conjunction" : "Associativity of disjunction");
+            const auto& grandchildren = is_conj ? child->as_conj().inner : child->as_disj().inner;
+            flat.insert(flat.end(), grandchildren.begin(), grandchildren.end());
+        } else {
+            flat.push_back(child);
+        }
+    }
+
+    // Remove duplicates, and fold complementary children (A and ¬A) to the absorbing element.
+    std::unordered_set<statement_ptr, structural_hash, structural_equal> seen;
+    std::unordered_set<statement_ptr, structural_hash, structural_equal> negated;
+    std::vector<statement_ptr> unique;
+    unique.reserve(flat.size());
+    for (const auto& child: flat) {
+        if (!seen.insert(child).second) {
+            apply(is_conj ? "Idempotence of conjunction" : "Idempotence of disjunction");
+            continue;
+        }
+        const bool complementary = child->is_neg() ? seen.contains(child->as_neg().inner) : negated.contains(child);
+        if (complementary) {
+            apply(is_conj ? "Contradiction" : "Law of excluded middle");
+            return absorbing();
+        }
+        if (child->is_neg()) {
+            negated.insert(child->as_neg().inner);
+        }
+        unique.push_back(child);
+    }
+
+    if (unique.empty()) {
+        return is_conj ? truth() : contradiction();
+    }
+    if (unique.size() == 1) {
+        return unique[0];
+    }
+    const auto& original_children = is_conj ? original->as_conj().inner : original->as_disj().inner;
+    if (original_children == unique) {
+        return original;
+    }
+    return is_conj ? conj(std::move(unique)) : disj(std::move(unique));
+}
+
+statement_ptr simplifier::simplify_implies(const statement_ptr& from, const statement_ptr& to, const statement_ptr& original) {
+    if (from->is_truth()) {
+        apply("Implication from truth");
+        return to;
+    }
+    if (from->is_contradiction()) {
+        apply("Negation of the premise");
+        return truth();
+    }
+    if (to->is_truth()) {
+        apply("Affirming the conclusion");
+        return truth();
+    }
+    if (to->is_contradiction()) {
+        apply("Implication of contradiction");
+        return simplify_neg(from, nullptr);
+    }
+    if (original->as_implies().from == from && original->as_implies().to == to) {
+        return original;
+    }
+    return implies(from, to);
+}
+
+statement_ptr simplifier::simplify_equiv(const statement_ptr& left, const statement_ptr& right, const statement_ptr& original) {
+    if (left->is_truth() || left->is_contradiction()) {
+        if (!right->is_truth() && !right->is_contradiction()) {
+            apply("Commutativity of equivalence");
+            return simplify_equiv(right, left, nullptr);
+        }
+    }
+    if (right->is_truth()) {
+        apply("Equivalence with truth");
+        return left;
+    }
+    if (right->is_contradiction()) {
+        apply("Equivalence with contradiction");
+        return simplify_neg(left, nullptr);
+    }
+    if (original != nullptr && original->as_equiv().left == left && original->as_equiv().right == right) {
+        return original;
+    }
+    return equiv(left, right);
+}
+
+}  // namespace tema
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/statement.h"
+
+namespace tema {
+
+// Single-pass simplification of statements with local identities: truth and contradiction are folded through the
+// connectives, double negations are removed, nested conjunctions and disjunctions are flattened, and their duplicate
+// and complementary children are removed. Relationships, variables and the bodies of forall statements are not
+// otherwise changed.
+//
+// Every simplification is an instance of a theorem of modules/propositional_logic.tema, and is counted under the name
+// of that theorem (see law_counts()). Sub-statements that are already simple are returned as they are, preserving
+// sharing.
+//
+// Results are memoized per sub-statement, so a simplifier should be reused when simplifying many statements that share
+// sub-statements (e.g. the results of applying the same law with different replacements).
+class simplifier {
+    struct memo_entry {
+        statement_ptr source;  // Keeps the key alive, so its address is not reused.
+        statement_ptr result;
+    };
+
+    std::unordered_map<const statement*, memo_entry> memo;
+    std::map<std::string, std::size_t> counts;
+
+    void apply(const std::string& law);
+    statement_ptr simplify_neg(const statement_ptr& inner, const statement_ptr& original);
+    template<bool is_conj>
+    statement_ptr simplify_flat(const std::vector<statement_ptr>& children, const statement_ptr& original);
+    statement_ptr simplify_implies(const statement_ptr& from, const statement_ptr& to, const statement_ptr& original);
+    statement_ptr simplify_equiv(const statement_ptr& left, const statement_ptr& right, const statement_ptr& original);
+
+public:
+    [[nodiscard]] statement_ptr simplify(const statement_ptr& stmt);
+
+    // The number of times each law was applied, by the name of the theorem. Memoized sub-statements are not counted
+    // again.
+    [[nodiscard]] const std::map<std::string, std::size_t>& law_counts() const;
+};
+
+}  // namespace tema
@@ -0,0 +1,98 @@
+#include "algorithms/simplify.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+#include "algorithms/print_utf8.h"
+#include "algorithms/truth_table.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.simplify") {
+    const auto vp = var_stmt(var("p"));
+    const auto vq = var_stmt(var("q"));
+    const auto vr = var_stmt(var("r"));
+
+    const auto expect_simplifies_to = [](simplifier& s, const statement_ptr& stmt, const statement_ptr& expected) {
+        const auto result = s.simplify(stmt);
+        expectMsg(equals(*result, *expected), print_utf8(*stmt) + " simplified to " + print_utf8(*result));
+        expectMsg(truth_table(equiv(stmt, result)).check_validity().valid,
+                  print_utf8(*stmt) + " is not equivalent to " + print_utf8(*result));
+    };
+
+    test("negation", [&] {
+        simplifier s;
+        expect_simplifies_to(s, neg(truth()), contradiction());
+        expect_simplifies_to(s, neg(contradiction()), truth());
+        expect_simplifies_to(s, neg(neg(vp)), vp);
+        expect_simplifies_to(s, neg(neg(neg(vp))), neg(vp));
+        expect_simplifies_to(s, neg(neg(neg(neg(conj(vp, vq))))), conj(vp, vq));
+        expect(s.law_counts().at("Double negation"), 4U);
+    });
+
+    test("conjunction and disjunction", [&] {
+        simplifier s;
+        expect_simplifies_to(s, conj(vp, truth(), vq), conj(vp, vq));
+        expect_simplifies_to(s, conj(vp, contradiction(), vq), contradiction());
+        expect_simplifies_to(s, disj(vp, contradiction()), vp);
+        expect_simplifies_to(s, disj(vp, truth(), vq), truth());
+        expect_simplifies_to(s, conj(truth(), truth()), truth());
+        expect_simplifies_to(s, disj(contradiction(), neg(truth())), contradiction());
+        expect_simplifies_to(s, conj(conj(vp, conj(vq, vp)), vr), conj(vp, vq, vr));
+        expect_simplifies_to(s, disj(vp, disj(vq, neg(neg(vp)))), disj(vp, vq));
+        expect_simplifies_to(s, conj(vp, vq, neg(vp)), contradiction());
+        expect_simplifies_to(s, conj(neg(vq), disj(vp, vr), vq), contradiction());
+        expect_simplifies_to(s, disj(neg(conj(vp, vq)), vr, conj(vq, vp), conj(vp, vq)), truth());
+        expect_simplifies_to(s, conj(conj(vp, vq), conj(vq, vp)), conj(vp, vq));
+        // Only equal children are folded, not equivalent ones.
+        expect_simplifies_to(s, disj(conj(vp, vq), conj(vq, vp)), disj(conj(vp, vq), conj(vq, vp)));
+        expect(s.law_counts().at("Contradiction"), 2U);
+        expect(s.law_counts().at("Law of excluded middle"), 1U);
+        expect(s.law_counts().at("Idempotence of conjunction"), 3U);
+    });
+
+    test("implication and equivalence", [&] {
+        simplifier s;
+        expect_simplifies_to(s, implies(truth(), vp), vp);
+        expect_simplifies_to(s, implies(contradiction(), vp), truth());
+        expect_simplifies_to(s, implies(vp, conj(vq, truth())), implies(vp, vq));
+        expect_simplifies_to(s, implies(vp, neg(truth())), neg(vp));
+        expect_simplifies_to(s, implies(neg(vp), contradiction()), vp);
+        expect_simplifies_to(s, equiv(vp, truth()), vp);
+        expect_simplifies_to(s, equiv(truth(), vp), vp);
+        expect_simplifies_to(s, equiv(contradiction(), neg(vp)), vp);
+        expect_simplifies_to(s, equiv(truth(), contradiction()), contradiction());
+        expect_simplifies_to(s, equiv(contradiction(), contradiction()), truth());
+        expect_simplifies_to(s, implies(disj(vp, contradiction()), vp), implies(vp, vp));
+    });
+
+    test("forall and relationships", [&] {
+        simplifier s;
+        const auto x = var("x");
+        const auto rel = rel_stmt(var_expr(x), rel_type::in, var_expr(var("A")));
+        expect(equals(*s.simplify(forall(x, conj(rel, truth()))), *forall(x, rel)), isTrue);
+        expect(equals(*s.simplify(conj(rel, neg(rel))), *contradiction()), isTrue);
+    });
+
+    test("simple statements are kept as they are", [&] {
+        simplifier s;
+        const auto stmt = implies(conj(vp, neg(vq)), forall(var("x"), disj(vq, vr)));
+        expect(s.simplify(stmt) == stmt, isTrue);
+        expect(s.law_counts(), isEmpty);
+
+        const auto shared = disj(vq, vr);
+        const auto result = s.simplify(conj(vp, truth(), shared));
+        expect(result->as_conj().inner[1] == shared, isTrue);
+    });
+
+    test("sub-statements are simplified once", [&] {
+        simplifier s;
+        const auto shared = neg(neg(vp));
+        (void)s.simplify(conj(shared, vq));
+        (void)s.simplify(disj(shared, vr));
+        (void)s.simplify(implies(vq, shared));
+        expect(s.law_counts().at("Double negation"), 1U);
+    });
+}
@@ -0,0 +1,446 @@
+#include "algorithms/term.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace tema {
+
+namespace {
+
+std::size_t hash_node(const term_symbol& symbol, std::span<const term_id> args) {
+    auto h = term_symbol_hash{}(symbol);
+    for (const auto arg: args) {
+        h = h * 1000003U ^ arg;
+    }
+    return h;
+}
+
+bool is_stmt_sort(term_kind kind) {
+    return kind != term_kind::expr_const && kind != term_kind::expr_var && kind != term_kind::call &&
+           kind != term_kind::binop;
+}
+
+}  // namespace
+
+std::size_t term_symbol_hash::operator()(const term_symbol& symbol) const {
+    return (static_cast<std::size_t>(symbol.kind) << 56U) ^ (static_cast<std::size_t>(symbol.arity) << 32U) ^
+           symbol.payload;
+}
+
+term_id term_bank::make(term_symbol symbol, std::span<const term_id> args) {
+    const auto h = hash_node(symbol, args);
+    const auto [begin, end] = memo.equal_range(h);
+    for (auto it = begin; it != end; it++) {
+        const auto& candidate = nodes[it->second];
+        if (candidate.symbol == symbol &&
+            std::equal(args.begin(), args.end(), arg_storage.begin() + static_cast<std::ptrdiff_t>(candidate.first_arg))) {
+            return it->second;
+        }
+    }
+    const auto is_var = symbol.kind == term_kind::stmt_var || symbol.kind == term_kind::expr_var;
+    node new_node{symbol, static_cast<std::uint32_t>(arg_storage.size()), 1, !is_var};
+    for (const auto arg: args) {
+        new_node.size += nodes[arg].size;
+        new_node.ground = new_node.ground && nodes[arg].ground;
+    }
+    // args might point into arg_storage, which can be reallocated by the insertion.
+    const std::vector<term_id> args_copy(args.begin(), args.end());
+    arg_storage.insert(arg_storage.end(), args_copy.begin(), args_copy.end());
+    const auto id = static_cast<term_id>(nodes.size());
+    nodes.push_back(new_node);
+    memo.emplace(h, id);
+    return id;
+}
+
+std::uint32_t term_bank::variable_index(const variable_ptr& var) {
+    const auto [it, inserted] = variable_ids.emplace(var.get(), static_cast<std::uint32_t>(variable_list.size()));
+    if (inserted) {
+        variable_list.push_back(var);
+    }
+    return it->second;
+}
+
+term_id term_bank::to_term(const statement& stmt, const law_var_filter& is_law_var, std::vector<const variable*>& bound) {
+    const auto make_n = [this](term_kind kind, std::uint32_t payload, std::span<const term_id> children) {
+        return make(term_symbol{kind, payload, static_cast<std::uint32_t>(children.size())}, children);
+    };
+    if (stmt.is_truth()) {
+        return make_n(term_kind::truth, 0, {});
+    }
+    if (stmt.is_contradiction()) {
+        return make_n(term_kind::contradiction, 0, {});
+    }
+    if (stmt.is_neg()) {
+        const term_id children[] = {to_term(*stmt.as_neg().inner, is_law_var, bound)};
+        return make_n(term_kind::neg, 0, children);
+    }
+    if (stmt.is_implies()) {
+        const term_id children[] = {to_term(*stmt.as_implies().from, is_law_var, bound),
+                                    to_term(*stmt.as_implies().to, is_law_var, bound)};
+        return make_n(term_kind::implies, 0, children);
+    }
+    if (stmt.is_equiv()) {
+        const term_id children[] = {to_term(*stmt.as_equiv().left, is_law_var, bound),
+                                    to_term(*stmt.as_equiv().right, is_law_var, bound)};
+        return make_n(term_kind::equiv, 0, children);
+    }
+    if (stmt.is_conj() || stmt.is_disj()) {
+        std::vector<term_id> children;
+        for (const auto& child: stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner) {
+            children.push_back(to_term(*child, is_law_var, bound));
+        }
+        return make_n(stmt.is_conj() ? term_kind::conj : term_kind::disj, 0, children);
+    }
+    if (stmt.is_forall()) {
+        const auto& [var, inner] = stmt.as_forall();
+        bound.push_back(var.get());
+        const term_id children[] = {to_term(*inner, is_law_var, bound)};
+        bound.pop_back();
+        return make_n(term_kind::forall, variable_index(var), children);
+    }
+    if (stmt.is_rel()) {
+        const auto& rel = stmt.as_rel();
+        const term_id children[] = {to_term(*rel.left, is_law_var, bound), to_term(*rel.right, is_law_var, bound)};
+        return make_n(term_kind::rel, static_cast<std::uint32_t>(rel.type), children);
+    }
+    const auto var = stmt.as_var();
+    const auto is_bound = std::find(bound.begin(), bound.end(), var.get()) != bound.end();
+    return make_n(!is_bound && is_law_var(*var) ? term_kind::stmt_var : term_kind::stmt_const, variable_index(var), {});
+}
+
+term_id term_bank::to_term(const expression& expr,
+                            const law_var_filter& is_law_var,
+                            const std::vector<const variable*>& bound) {
+    if (expr.is_binop()) {
+        const auto& op = expr.as_binop();
+        const term_id children[] = {to_term(*op.left, is_law_var, bound), to_term(*op.right, is_law_var, bound)};
+        return make(term_symbol{term_kind::binop, static_cast<std::uint32_t>(op.type), 2}, children);
+    }
+    if (expr.is_call()) {
+        const auto& [callee, params] = expr.as_call();
+        std::vector<term_id> children{to_term(*callee, is_law_var, bound)};
+        for (const auto& param: params) {
+            children.push_back(to_term(*param, is_law_var, bound));
+        }
+        return make(term_symbol{term_kind::call, 0, static_cast<std::uint32_t>(children.size())}, children);
+    }
+    const auto var = expr.as_var();
+    const auto is_bound = std::find(bound.begin(), bound.end(), var.get()) != bound.end();
+    return make(term_symbol{!is_bound && is_law_var(*var) ? term_kind::expr_var : term_kind::expr_const, variable_index(var), 0},
+                {});
+}
+
+term_id term_bank::from_statement(const statement& stmt, bool as_law) {
+    return from_statement(stmt, [as_law](const variable&) {
+        return as_law;
+    });
+}
+
+term_id term_bank::from_statement(const statement& stmt, const law_var_filter& is_law_var) {
+    std::vector<const variable*> bound;
+    return to_term(stmt, is_law_var, bound);
+}
+
+term_id term_bank::from_expression(const expression& expr, bool as_law) {
+    return to_term(
+            expr,
+            [as_law](const variable&) {
+                return as_law;
+            },
+            {});
+}
+
+statement_ptr term_bank::to_statement(term_id term) const {
+    const auto& [kind, payload, arity] = symbol(term);
+    const auto term_args = args(term);
+    switch (kind) {
+        case term_kind::truth: return truth();
+        case term_kind::contradiction: return contradiction();
+        case term_kind::neg: return neg(to_statement(term_args[0]));
+        case term_kind::implies: return implies(to_statement(term_args[0]), to_statement(term_args[1]));
+        case term_kind::equiv: return equiv(to_statement(term_args[0]), to_statement(term_args[1]));
+        case term_kind::conj:
+        case term_kind::disj: {
+            std::vector<statement_ptr> children;
+            for (const auto arg: term_args) {
+                children.push_back(to_statement(arg));
+            }
+            return kind == term_kind::conj ? conj(std::move(children)) : disj(std::move(children));
+        }
+        case term_kind::forall: return forall(variable_list[payload], to_statement(term_args[0]));
+        case term_kind::rel:
+            return rel_stmt(to_expression(term_args[0]), static_cast<rel_type>(payload), to_expression(term_args[1]));
+        case term_kind::stmt_const:
+        case term_kind::stmt_var: return var_stmt(variable_list[payload]);
+        default: throw std::invalid_argument("Term is an expression, not a statement");
+    }
+}
+
+expr_ptr term_bank::to_expression(term_id term) const {
+    const auto& [kind, payload, arity] = symbol(term);
+    const auto term_args = args(term);
+    switch (kind) {
+        case term_kind::binop:
+            return binop(to_expression(term_args[0]), static_cast<binop_type>(payload), to_expression(term_args[1]));
+        case term_kind::call: {
+            std::vector<expr_ptr> params;
+            for (const auto arg: term_args.subspan(1)) {
+                params.push_back(to_expression(arg));
+            }
+            return call(to_expression(term_args[0]), std::move(params));
+        }
+        case term_kind::expr_const:
+        case term_kind::expr_var: return var_expr(variable_list[payload]);
+        default: throw std::invalid_argument("Term is a statement, not an expression");
+    }
+}
+
+const term_symbol& term_bank::symbol(term_id term) const {
+    return nodes[term].symbol;
+}
+
+std::span<const term_id> term_bank::args(term_id term) const {
+    const auto& n = nodes[term];
+    return std::span<const term_id>(arg_storage).subspan(n.first_arg, n.symbol.arity);
+}
+
+bool term_bank::is_variable(term_id term) const {
+    const auto kind = nodes[term].symbol.kind;
+    return kind == term_kind::stmt_var || kind == term_kind::expr_var;
+}
+
+bool term_bank::is_statement(term_id term) const {
+    return is_stmt_sort(nodes[term].symbol.kind);
+}
+
+bool term_bank::is_ground(term_id term) const {
+    return nodes[term].ground;
+}
+
+std::uint32_t term_bank::size(term_id term) const {
+    return nodes[term].size;
+}
+
+std::size_t term_bank::num_terms() const {
+    return nodes.size();
+}
+
+void term_bank::collect_variables(term_id term, std::vector<term_id>& vars) const {
+    if (is_ground(term)) {
+        return;
+    }
+    if (is_variable(term)) {
+        if (std::find(vars.begin(), vars.end(), term) == vars.end()) {
+            vars.push_back(term);
+        }
+        return;
+    }
+    for (const auto arg: args(term)) {
+        collect_variables(arg, vars);
+    }
+}
+
+std::vector<term_id> term_bank::variables(term_id term) const {
+    std::vector<term_id> vars;
+    collect_variables(term, vars);
+    return vars;
+}
+
+term_id term_bank::pool_variable(bool stmt_sort, std::size_t index) {
+    auto& pool = stmt_sort ? stmt_pool : expr_pool;
+    while (pool.size() <= index) {
+        const auto name = (stmt_sort ? "P" : "X") + std::to_string(pool.size() + 1);
+        pool.push_back(make(term_symbol{stmt_sort ? term_kind::stmt_var : term_kind::expr_var,
+                                        variable_index(var(name)),
+                                        0},
+                            {}));
+    }
+    return pool[index];
+}
+
+std::pair<std::size_t, std::size_t> term_bank::rename_to_pool(std::span<term_id> terms,
+                                                              std::size_t first_stmt_index,
+                                                              std::size_t first_expr_index) {
+    std::vector<term_id> vars;
+    for (const auto term: terms) {
+        collect_variables(term, vars);
+    }
+    term_substitution renaming;
+    auto next_stmt = first_stmt_index;
+    auto next_expr = first_expr_index;
+    for (const auto var: vars) {
+        const auto stmt_sort = symbol(var).kind == term_kind::stmt_var;
+        renaming.emplace_back(var, pool_variable(stmt_sort, stmt_sort ? next_stmt++ : next_expr++));
+    }
+    for (auto& term: terms) {
+        term = substitute(term, renaming);
+    }
+    return {next_stmt - first_stmt_index, next_expr - first_expr_index};
+}
+
+term_id term_bank::substitute(term_id term, const term_substitution& subst) {
+    if (is_ground(term) || subst.empty()) {
+        return term;
+    }
+    if (is_variable(term)) {
+        const auto it = std::find_if(subst.begin(), subst.end(), [term](const auto& binding) {
+            return binding.first == term;
+        });
+        return it == subst.end() ? term : it->second;
+    }
+    const auto symbol_copy = symbol(term);
+    std::vector<term_id> new_args(args(term).begin(), args(term).end());
+    for (auto& arg: new_args) {
+        arg = substitute(arg, subst);
+    }
+    return make(symbol_copy, new_args);
+}
+
+term_id term_bank::walk(term_id term, const term_substitution& subst) const {
+    while (is_variable(term)) {
+        const auto it = std::find_if(subst.begin(), subst.end(), [term](const auto& binding) {
+            return binding.first == term;
+        });
+        if (it == subst.end()) {
+            break;
+        }
+        term = it->second;
+    }
+    return term;
+}
+
+bool term_bank::occurs(term_id var, term_id term, const term_substitution& subst) const {
+    term = walk(term, subst);
+    if (term == var) {
+        return true;
+    }
+    if (is_ground(term)) {
+        return false;
+    }
+    const auto term_args = args(term);
+    return std::any_of(term_args.begin(), term_args.end(), [&](term_id arg) {
+        return occurs(var, arg, subst);
+    });
+}
+
+bool term_bank::match_into(term_id pattern, term_id term, term_substitution& subst) const {
+    if (is_variable(pattern)) {
+        const auto it = std::find_if(subst.begin(), subst.end(), [pattern](const auto& binding) {
+            return binding.first == pattern;
+        });
+        if (it != subst.end()) {
+            return it->second == term;
+        }
+        if (is_stmt_sort(symbol(pattern).kind) != is_stmt_sort(symbol(term).kind)) {
+            return false;
+        }
+        subst.emplace_back(pattern, term);
+        return true;
+    }
+    if (is_ground(pattern)) {
+        return pattern == term;
+    }
+    if (symbol(pattern) != symbol(term)) {
+        return false;
+    }
+    const auto pattern_args = args(pattern);
+    const auto term_args = args(term);
+    for (std::size_t i = 0; i < pattern_args.size(); i++) {
+        if (!match_into(pattern_args[i], term_args[i], subst)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<term_substitution> term_bank::match(term_id pattern, term_id term) const {
+    term_substitution subst;
+    if (!match_into(pattern, term, subst)) {
+        return std::nullopt;
+    }
+    return subst;
+}
+
+bool term_bank::match(term_id pattern, term_id term, term_substitution& subst) const {
+    const auto size = subst.size();
+    if (!match_into(pattern, term, subst)) {
+        subst.resize(size);
+        return false;
+    }
+    return true;
+}
+
+bool term_bank::unify_into(term_id a, term_id b, term_substitution& subst) const {
+    a = walk(a, subst);
+    b = walk(b, subst);
+    if (a == b) {
+        return true;
+    }
+    if (!is_variable(a) && is_variable(b)) {
+        std::swap(a, b);
+    }
+    if (is_variable(a)) {
+        if (is_stmt_sort(symbol(a).kind) != is_stmt_sort(symbol(b).kind) || occurs(a, b, subst)) {
+            return false;
+        }
+        subst.emplace_back(a, b);
+        return true;
+    }
+    if (symbol(a) != symbol(b)) {
+        return false;
+    }
+    const auto a_args = args(a);
+    const auto b_args = args(b);
+    for (std::size_t i = 0; i < a_args.size(); i++) {
+        if (!unify_into(a_args[i], b_args[i], subst)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+term_id term_bank::resolve(term_id term, const term_substitution& subst) {
+    term = walk(term, subst);
+    if (is_ground(term) || is_variable(term)) {
+        return term;
+    }
+    const auto symbol_copy = symbol(term);
+    std::vector<term_id> new_args(args(term).begin(), args(term).end());
+    for (auto& arg: new_args) {
+        arg = resolve(arg, subst);
+    }
+    return make(symbol_copy, new_args);
+}
+
+std::optional<term_substitution> term_bank::unify(term_id a, term_id b) {
+    term_substitution triangular;
+    if (!unify_into(a, b, triangular)) {
+        return std::nullopt;
+    }
+    term_substitution subst;
+    subst.reserve(triangular.size());
+    for (const auto& [var, replacement]: triangular) {
+        subst.emplace_back(var, resolve(replacement, triangular));
+    }
+    return subst;
+}
+
+term_id term_bank::at(term_id term, std::span<const std::uint32_t> position) const {
+    for (const auto index: position) {
+        term = args(term)[index];
+    }
+    return term;
+}
+
+term_id term_bank::replace_at(term_id term, std::span<const std::uint32_t> position, term_id replacement) {
+    if (position.empty()) {
+        return replacement;
+    }
+    const auto symbol_copy = symbol(term);
+    std::vector<term_id> new_args(args(term).begin(), args(term).end());
+    new_args[position[0]] = replace_at(new_args[position[0]], position.subspan(1), replacement);
+    return make(symbol_copy, new_args);
+}
+
+}  // namespace tema
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/statement.h"
+
+namespace tema {
+
+// Statements and expressions as first-order terms, for algorithms that need to treat both uniformly (unification,
+// term orderings, completion).
+//
+// Every node of a statement or expression becomes a function symbol applied to its children. Variables are either term
+// variables (the free variables of a law, which can be substituted) or constants (the variables of the statements
+// being reasoned about, and variables bound by a forall).
+
+using term_id = std::uint32_t;
+
+// The order of the kinds is used by the default precedence of the term orderings (see term_order.h): constants are the
+// smallest symbols, then connectives, with relationships being the largest.
+enum class term_kind : std::uint8_t {
+    expr_const,
+    stmt_const,
+    truth,
+    contradiction,
+    call,
+    binop,
+    disj,
+    conj,
+    neg,
+    implies,
+    equiv,
+    forall,
+    rel,
+    expr_var,
+    stmt_var,
+};
+
+// payload is the index of the variable for constants, term variables and forall (the bound variable), the rel_type for
+// relationships and the binop_type for binary operations.
+struct term_symbol {
+    term_kind kind;
+    std::uint32_t payload;
+    std::uint32_t arity;
+
+    auto operator<=>(const term_symbol&) const = default;
+};
+
+struct term_symbol_hash {
+    [[nodiscard]] std::size_t operator()(const term_symbol& symbol) const;
+};
+
+// A substitution of term variables, as (variable, replacement) pairs.
+using term_substitution = std::vector<std::pair<term_id, term_id>>;
+
+// Hash-consed storage for terms: structurally equal terms always have the same id.
+class term_bank {
+public:
+    using law_var_filter = std::function<bool(const variable&)>;
+
+private:
+    struct node {
+        term_symbol symbol;
+        std::uint32_t first_arg;
+        std::uint32_t size;
+        bool ground;
+    };
+
+    std::vector<node> nodes;
+    std::vector<term_id> arg_storage;
+    std::unordered_multimap<std::size_t, term_id> memo;
+
+    std::vector<variable_ptr> variable_list;
+    std::unordered_map<const variable*, std::uint32_t> variable_ids;
+    std::vector<term_id> stmt_pool;
+    std::vector<term_id> expr_pool;
+
+    [[nodiscard]] std::uint32_t variable_index(const variable_ptr& var);
+    [[nodiscard]] term_id walk(term_id term, const term_substitution& subst) const;
+    [[nodiscard]] bool occurs(term_id var, term_id term, const term_substitution& subst) const;
+    [[nodiscard]] bool match_into(term_id pattern, term_id term, term_substitution& subst) const;
+    [[nodiscard]] bool unify_into(term_id a, term_id b, term_substitution& subst) const;
+    term_id resolve(term_id term, const term_substitution& subst);
+    term_id to_term(const statement& stmt, const law_var_filter& is_law_var, std::vector<const variable*>& bound);
+    term_id to_term(const expression& expr, const law_var_filter& is_law_var, const std::vector<const variable*>& bound);
+    void collect_variables(term_id term, std::vector<term_id>& vars) const;
+
+public:
+    // symbol.arity must be args.size().
+    term_id make(term_symbol symbol, std::span<const term_id> args);
+
+    // The free variables become term variables when as_law is true, and constants otherwise. Variables bound by forall
+    // statements are always constants.
+    term_id from_statement(const statement& stmt, bool as_law);
+    // Only the free variables for which is_law_var returns true become term variables.
+    term_id from_statement(const statement& stmt, const law_var_filter& is_law_var);
+    term_id from_expression(const expression& expr, bool as_law);
+
+    [[nodiscard]] statement_ptr to_statement(term_id term) const;
+    [[nodiscard]] expr_ptr to_expression(term_id term) const;
+
+    [[nodiscard]] const term_symbol& symbol(term_id term) const;
+    [[nodiscard]] std::span<const term_id> args(term_id term) const;
+    [[nodiscard]] bool is_variable(term_id term) const;
+    // Whether the term is a statement (as opposed to an expression).
+    [[nodiscard]] bool is_statement(term_id term) const;
+    [[nodiscard]] bool is_ground(term_id term) const;
+    // The number of symbol and variable occurrences.
+    [[nodiscard]] std::uint32_t size(term_id term) const;
+    [[nodiscard]] std::size_t num_terms() const;
+
+    // The term variables of the term, in order of first occurrence.
+    [[nodiscard]] std::vector<term_id> variables(term_id term) const;
+
+    // The i-th variable of a pool of term variables shared by all the terms of the bank, used for renaming terms into a
+    // canonical form or apart from each other.
+    term_id pool_variable(bool stmt_sort, std::size_t index);
+
+    // Renames the variables of the terms (taken together) to the pool variables, numbered from first_index in order of
+    // first occurrence, separately for statement and expression variables. Returns the number of pool variables used
+    // of each sort.
+    std::pair<std::size_t, std::size_t> rename_to_pool(std::span<term_id> terms,
+                                                       std::size_t first_stmt_index = 0,
+                                                       std::size_t first_expr_index = 0);
+
+    // Replaces the variables in one step: the replacements themselves are not substituted again.
+    term_id substitute(term_id term, const term_substitution& subst);
+
+    // The substitution that makes pattern equal to term, if any. Variables of term are not substituted.
+    [[nodiscard]] std::optional<term_substitution> match(term_id pattern, term_id term) const;
+
+    // Extends subst so that it makes pattern equal to term. On failure, returns false and leaves subst unchanged.
+    bool match(term_id pattern, term_id term, term_substitution& subst) const;
+
+    // The most general unifier of a and b, if any. Variables shared by a and b are the same variable.
+    [[nodiscard]] std::optional<term_substitution> unify(term_id a, term_id b);
+
+    // The sub-term at the given position (the indices of the arguments to follow from the root) and replacing it.
+    [[nodiscard]] term_id at(term_id term, std::span<const std::uint32_t> position) const;
+    term_id replace_at(term_id term, std::span<const std::uint32_t> position, term_id replacement);
+};
+
+}  // namespace tema
@@ -0,0 +1,106 @@
+#include "algorithms/term_order.h"
+
+#include <algorithm>
+
+namespace tema {
+
+namespace {
+
+bool contains(const term_bank& bank, term_id term, term_id sub) {
+    if (term == sub) {
+        return true;
+    }
+    if (bank.is_ground(term) && !bank.is_ground(sub)) {
+        return false;
+    }
+    const auto args = bank.args(term);
+    return std::any_of(args.begin(), args.end(), [&](term_id arg) {
+        return contains(bank, arg, sub);
+    });
+}
+
+void count_variables(const term_bank& bank, term_id term, int delta, std::vector<std::pair<term_id, int>>& counts) {
+    if (bank.is_ground(term)) {
+        return;
+    }
+    if (bank.is_variable(term)) {
+        const auto it = std::find_if(counts.begin(), counts.end(), [term](const auto& count) {
+            return count.first == term;
+        });
+        if (it == counts.end()) {
+            counts.emplace_back(term, delta);
+        } else {
+            it->second += delta;
+        }
+        return;
+    }
+    for (const auto arg: bank.args(term)) {
+        count_variables(bank, arg, delta, counts);
+    }
+}
+
+// Whether every variable occurs in s at least as many times as in t.
+bool has_more_variables(const term_bank& bank, term_id s, term_id t) {
+    std::vector<std::pair<term_id, int>> counts;
+    count_variables(bank, s, 1, counts);
+    count_variables(bank, t, -1, counts);
+    return std::all_of(counts.begin(), counts.end(), [](const auto& count) {
+        return count.second >= 0;
+    });
+}
+
+}  // namespace
+
+bool kbo_greater(const term_bank& bank, term_id s, term_id t) {
+    if (s == t || !has_more_variables(bank, s, t)) {
+        return false;
+    }
+    if (bank.size(s) != bank.size(t)) {
+        return bank.size(s) > bank.size(t);
+    }
+    // With all weights being 1, a variable can only be compared with a term of size 1, which is either the same
+    // variable or does not contain it.
+    if (bank.is_variable(s) || bank.is_variable(t)) {
+        return false;
+    }
+    if (bank.symbol(s) != bank.symbol(t)) {
+        return bank.symbol(t) < bank.symbol(s);
+    }
+    const auto s_args = bank.args(s);
+    const auto t_args = bank.args(t);
+    const auto [s_it, t_it] = std::mismatch(s_args.begin(), s_args.end(), t_args.begin());
+    return s_it != s_args.end() && kbo_greater(bank, *s_it, *t_it);
+}
+
+bool lpo_greater(const term_bank& bank, term_id s, term_id t) {
+    if (s == t || bank.is_variable(s)) {
+        return false;
+    }
+    if (bank.is_variable(t)) {
+        return contains(bank, s, t);
+    }
+    const auto s_args = bank.args(s);
+    const auto t_args = bank.args(t);
+    if (std::any_of(s_args.begin(), s_args.end(), [&](term_id arg) {
+            return arg == t || lpo_greater(bank, arg, t);
+        })) {
+        return true;
+    }
+    const auto greater_than_all_args = std::all_of(t_args.begin(), t_args.end(), [&](term_id arg) {
+        return lpo_greater(bank, s, arg);
+    });
+    if (bank.symbol(t) < bank.symbol(s)) {
+        return greater_than_all_args;
+    }
+    if (bank.symbol(s) != bank.symbol(t) || !greater_than_all_args) {
+        return false;
+    }
+    const auto [s_it, t_it] = std::mismatch(s_args.begin(), s_args.end(), t_args.begin());
+    return s_it != s_args.end() && lpo_greater(bank, *s_it, *t_it);
+}
+
+bool term_greater(const term_bank& bank, term_order_kind order, term_id s, term_id t) {
+    return order == term_order_kind::kbo ? kbo_greater(bank, s, t) : lpo_greater(bank, s, t);
+}
+
+}  // namespace tema
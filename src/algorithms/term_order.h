@@ -0,0 +1,25 @@
+#pragma once
+
+#include "algorithms/term.h"
+
+namespace tema {
+
+// Reduction orderings on terms, for orienting equations into rewrite rules that terminate: if l > r, then every
+// instance of l is greater than the corresponding instance of r, and replacing l by r inside a term makes it smaller.
+//
+// Both orderings use the order of term_symbol (kind first, see term_kind) as precedence. The Knuth-Bendix ordering
+// gives every symbol and variable a weight of 1, so it first compares terms by size. Both are total on ground terms.
+enum class term_order_kind {
+    kbo,
+    lpo,
+};
+
+// Knuth-Bendix ordering.
+[[nodiscard]] bool kbo_greater(const term_bank& bank, term_id s, term_id t);
+
+// Lexicographic path ordering.
+[[nodiscard]] bool lpo_greater(const term_bank& bank, term_id s, term_id t);
+
+[[nodiscard]] bool term_greater(const term_bank& bank, term_order_kind order, term_id s, term_id t);
+
+}  // namespace tema
@@ -0,0 +1,90 @@
+#include "algorithms/term_order.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.term_order") {
+    const auto vp = var_stmt(var("p"));
+    const auto vq = var_stmt(var("q"));
+    const auto vr = var_stmt(var("r"));
+    const auto va = var_stmt(var("a"));
+    const auto vb = var_stmt(var("b"));
+
+    term_bank bank;
+    const auto law = [&](const statement_ptr& stmt) {
+        return bank.from_statement(*stmt, true);
+    };
+    const auto ground = [&](const statement_ptr& stmt) {
+        return bank.from_statement(*stmt, false);
+    };
+
+    for (const auto order: {term_order_kind::kbo, term_order_kind::lpo}) {
+        const auto greater = [&](term_id s, term_id t) {
+            return term_greater(bank, order, s, t);
+        };
+        const auto name = order == term_order_kind::kbo ? std::string("kbo") : std::string("lpo");
+
+        test(name + ": sub-term property", [&] {
+            expect(greater(law(neg(neg(vp))), law(vp)), isTrue);
+            expect(greater(law(vp), law(neg(neg(vp)))), isFalse);
+            expect(greater(law(conj(vp, vp)), law(vp)), isTrue);
+            expect(greater(law(vp), law(vp)), isFalse);
+        });
+
+        test(name + ": variables", [&] {
+            // The right side has a variable that the left side does not.
+            expect(greater(law(conj(vp, vp)), law(vq)), isFalse);
+            expect(greater(law(neg(neg(vp))), law(vq)), isFalse);
+            // Commutativity cannot be oriented.
+            expect(greater(law(conj(vp, vq)), law(conj(vq, vp))), isFalse);
+            expect(greater(law(conj(vq, vp)), law(conj(vp, vq))), isFalse);
+        });
+
+        test(name + ": associativity", [&] {
+            expect(greater(law(conj(conj(vp, vq), vr)), law(conj(vp, conj(vq, vr)))), isTrue);
+            expect(greater(law(conj(vp, conj(vq, vr))), law(conj(conj(vp, vq), vr))), isFalse);
+        });
+
+        test(name + ": stable under substitution", [&] {
+            const auto s = law(conj(conj(vp, vq), vr));
+            const auto t = law(conj(vp, conj(vq, vr)));
+            const auto replacement = law(neg(conj(vq, vr)));
+            const term_substitution subst{{bank.variables(s)[0], replacement}};
+            expect(greater(bank.substitute(s, subst), bank.substitute(t, subst)), isTrue);
+        });
+
+        test(name + ": total on ground terms", [&] {
+            const std::vector<term_id> terms{
+                    ground(va),
+                    ground(vb),
+                    ground(truth()),
+                    ground(neg(va)),
+                    ground(conj(va, vb)),
+                    ground(conj(vb, va)),
+                    ground(disj(va, vb)),
+                    ground(implies(va, neg(vb))),
+                    ground(neg(disj(va, vb))),
+            };
+            for (const auto s: terms) {
+                for (const auto t: terms) {
+                    if (s != t) {
+                        expect(greater(s, t) != greater(t, s), isTrue);
+                    }
+                }
+            }
+        });
+    }
+
+    test("kbo compares by size first", [&] {
+        expect(kbo_greater(bank, law(disj(neg(vp), neg(vq))), law(neg(conj(vp, vq)))), isTrue);
+    });
+
+    test("lpo compares by precedence first", [&] {
+        // Negation is greater than conjunction and disjunction, so DeMorgan's laws push negations inwards.
+        expect(lpo_greater(bank, law(neg(conj(vp, vq))), law(disj(neg(vp), neg(vq)))), isTrue);
+        expect(lpo_greater(bank, law(neg(disj(vp, vq))), law(conj(neg(vp), neg(vq)))), isTrue);
+    });
+}
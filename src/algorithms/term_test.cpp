@@ -0,0 +1,156 @@
+#include "algorithms/term.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/equals.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.term") {
+    const auto p = var("p");
+    const auto q = var("q");
+    const auto r = var("r");
+    const auto vp = var_stmt(p);
+    const auto vq = var_stmt(q);
+    const auto vr = var_stmt(r);
+
+    test("structurally equal statements are the same term", [&] {
+        term_bank bank;
+        const auto a = bank.from_statement(*conj(vp, neg(vq)), false);
+        const auto b = bank.from_statement(*conj(vp, neg(vq)), false);
+        const auto c = bank.from_statement(*conj(vq, neg(vp)), false);
+        expect(a, b);
+        expect(a == c, isFalse);
+        expect(bank.size(a), 4U);
+        expect(bank.args(a), hasSize(2));
+        expect(bank.from_statement(*conj(vp, vq), false) == bank.from_statement(*disj(vp, vq), false), isFalse);
+        expect(bank.from_statement(*conj(vp, vq), false) == bank.from_statement(*conj(vp, vq, vr), false), isFalse);
+    });
+
+    test("converting back", [&] {
+        term_bank bank;
+        const auto x = var("x");
+        const auto stmts = {
+                implies(equiv(truth(), contradiction()), disj(vp, vq, vr)),
+                forall(x, rel_stmt(var_expr(x), rel_type::in, binop(var_expr(p), binop_type::set_union, var_expr(q)))),
+                rel_stmt(call(var_expr(p), {var_expr(q), var_expr(r)}), rel_type::n_eq_includes, var_expr(x)),
+        };
+        for (const auto& stmt: stmts) {
+            expect(equals(*bank.to_statement(bank.from_statement(*stmt, true)), *stmt), isTrue);
+            expect(equals(*bank.to_statement(bank.from_statement(*stmt, false)), *stmt), isTrue);
+        }
+        const auto expr = binop(var_expr(p), binop_type::set_sym_difference, var_expr(q));
+        expect(equals(*bank.to_expression(bank.from_expression(*expr, true)), *expr), isTrue);
+        expect([&] { (void)bank.to_expression(bank.from_statement(*vp, true)); }, throwsA<std::invalid_argument>);
+        expect([&] { (void)bank.to_statement(bank.from_expression(*expr, true)); }, throwsA<std::invalid_argument>);
+    });
+
+    test("variables and constants", [&] {
+        term_bank bank;
+        const auto x = var("x");
+        const auto law = bank.from_statement(*forall(x, rel_stmt(var_expr(x), rel_type::in, var_expr(p))), true);
+        expect(bank.is_ground(law), isFalse);
+        expect(bank.variables(law), hasSize(1));
+        expect(bank.symbol(bank.variables(law)[0]).kind, term_kind::expr_var);
+
+        const auto stmt = bank.from_statement(*forall(x, rel_stmt(var_expr(x), rel_type::in, var_expr(p))), false);
+        expect(bank.is_ground(stmt), isTrue);
+        expect(law == stmt, isFalse);
+        expect(bank.is_statement(stmt), isTrue);
+        expect(bank.is_statement(bank.args(bank.args(stmt)[0])[0]), isFalse);
+    });
+
+    test("filtering the law variables", [&] {
+        term_bank bank;
+        const auto term = bank.from_statement(*conj(vp, vq), [&](const variable& var) {
+            return &var == p.get();
+        });
+        expect(bank.is_variable(bank.args(term)[0]), isTrue);
+        expect(bank.is_variable(bank.args(term)[1]), isFalse);
+        expect(bank.args(term)[1], bank.from_statement(*vq, false));
+    });
+
+    test("extending a substitution by matching", [&] {
+        term_bank bank;
+        const auto pattern = bank.from_statement(*neg(vp), true);
+        term_substitution subst;
+        expect(bank.match(pattern, bank.from_statement(*neg(vq), false), subst), isTrue);
+        expect(subst, hasSize(1));
+        expect(bank.match(pattern, bank.from_statement(*neg(vr), false), subst), isFalse);
+        expect(subst, hasSize(1));
+        expect(bank.match(bank.from_statement(*conj(vp, vq), true), bank.from_statement(*conj(vq, vr), false), subst),
+               isTrue);
+        expect(subst, hasSize(2));
+    });
+
+    test("matching", [&] {
+        term_bank bank;
+        const auto pattern = bank.from_statement(*neg(conj(vp, vq)), true);
+        const auto term = bank.from_statement(*neg(conj(neg(vr), vr)), false);
+        const auto replacements = bank.match(pattern, term);
+        expect(replacements.has_value(), isTrue);
+        const auto rhs = bank.from_statement(*disj(neg(vp), neg(vq)), true);
+        expect(bank.substitute(rhs, *replacements), bank.from_statement(*disj(neg(neg(vr)), neg(vr)), false));
+
+        expect(bank.match(bank.from_statement(*conj(vp, vp), true), bank.from_statement(*conj(vq, vr), false))
+                       .has_value(),
+               isFalse);
+        // Statement variables match any statement, including relationships.
+        expect(bank.match(bank.from_statement(*neg(vp), true),
+                          bank.from_statement(*neg(rel_stmt(var_expr(q), rel_type::eq, var_expr(r))), false))
+                       .has_value(),
+               isTrue);
+        expect(bank.match(bank.from_statement(*rel_stmt(var_expr(p), rel_type::eq, var_expr(p)), true),
+                          bank.from_statement(*rel_stmt(var_expr(q), rel_type::eq, var_expr(q)), false))
+                       .has_value(),
+               isTrue);
+    });
+
+    test("unification", [&] {
+        term_bank bank;
+        const auto a = bank.from_statement(*conj(vp, neg(vq)), true);
+        const auto b = bank.from_statement(*conj(neg(vr), vp), true);
+        const auto unifier = bank.unify(a, b);
+        expect(unifier.has_value(), isTrue);
+        expect(bank.substitute(a, *unifier), bank.substitute(b, *unifier));
+        expect(bank.substitute(a, *unifier), bank.from_statement(*conj(neg(vr), neg(vr)), true));
+
+        // Occurs check.
+        expect(bank.unify(bank.from_statement(*conj(vp, vp), true), bank.from_statement(*conj(vq, neg(vq)), true))
+                       .has_value(),
+               isFalse);
+        expect(bank.unify(bank.from_statement(*neg(vp), true), bank.from_statement(*implies(vq, vr), true))
+                       .has_value(),
+               isFalse);
+    });
+
+    test("positions", [&] {
+        term_bank bank;
+        const auto term = bank.from_statement(*implies(neg(vp), conj(vq, vr)), false);
+        const std::uint32_t position[] = {1, 0};
+        expect(bank.at(term, position), bank.from_statement(*vq, false));
+        expect(bank.replace_at(term, position, bank.from_statement(*truth(), false)),
+               bank.from_statement(*implies(neg(vp), conj(truth(), vr)), false));
+        expect(bank.replace_at(term, {}, bank.from_statement(*truth(), false)), bank.from_statement(*truth(), false));
+    });
+
+    test("renaming to the variable pool", [&] {
+        term_bank bank;
+        term_id first[] = {bank.from_statement(*conj(vp, vq), true), bank.from_statement(*disj(vq, vp), true)};
+        term_id second[] = {bank.from_statement(*conj(vq, vr), true), bank.from_statement(*disj(vr, vq), true)};
+        expect(first[0] == second[0], isFalse);
+        const auto num_vars = bank.rename_to_pool(first);
+        bank.rename_to_pool(second);
+        expect(num_vars, std::make_pair(std::size_t{2}, std::size_t{0}));
+        expect(first[0], second[0]);
+        expect(first[1], second[1]);
+
+        term_id apart[] = {bank.from_statement(*conj(vp, vq), true)};
+        bank.rename_to_pool(apart, 2, 0);
+        expect(bank.unify(first[0], apart[0]).has_value(), isTrue);
+        expect(bank.variables(apart[0])[0] == bank.variables(first[0])[0], isFalse);
+        expect(bank.pool_variable(true, 0) == bank.pool_variable(false, 0), isFalse);
+    });
+}
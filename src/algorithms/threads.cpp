@@ -0,0 +1,56 @@
+#include "algorithms/threads.h"
+
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tema {
+
+void run_on_threads(std::size_t num_threads,
+                    const std::function<void(std::size_t)>& worker,
+                    const std::function<void()>& stop) {
+    if (num_threads == 0) {
+        return;
+    }
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    const auto fail = [&](std::exception_ptr exception) {
+        {
+            const std::lock_guard lock(error_mutex);
+            if (!error) {
+                error = std::move(exception);
+            }
+        }
+        if (stop) {
+            stop();
+        }
+    };
+    const auto guarded_worker = [&](std::size_t index) {
+        try {
+            worker(index);
+        } catch (...) {
+            fail(std::current_exception());
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    try {
+        for (std::size_t i = 1; i < num_threads; i++) {
+            threads.emplace_back(guarded_worker, i);
+        }
+        guarded_worker(0);
+    } catch (...) {
+        // A thread couldn't be started.
+        fail(std::current_exception());
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace tema
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace tema {
+
+// Runs worker(0), ..., worker(num_threads - 1) concurrently: worker(0) on the calling thread, the others on new
+// threads, and returns when all of them are done.
+//
+// If a thread can't be started, or any worker throws, calls stop (which should make the workers still running return
+// early), waits for the running workers and rethrows the first exception. stop may be called from any of the threads,
+// and more than once when several workers throw.
+void run_on_threads(std::size_t num_threads,
+                    const std::function<void(std::size_t)>& worker,
+                    const std::function<void()>& stop = {});
+
+}  // namespace tema
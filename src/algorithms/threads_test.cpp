@@ -0,0 +1,90 @@
+#include "algorithms/threads.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <mcga/test_ext/matchers.hpp>
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("algorithms.threads") {
+    test("every worker runs once", [&] {
+        std::vector<std::atomic<int>> runs(5);
+        run_on_threads(runs.size(), [&](std::size_t index) {
+            runs[index].fetch_add(1);
+        });
+        for (const auto& count: runs) {
+            expect(count.load(), isEqualTo(1));
+        }
+    });
+
+    test("worker 0 runs on the calling thread", [&] {
+        const auto caller = std::this_thread::get_id();
+        std::thread::id first;
+        run_on_threads(3, [&](std::size_t index) {
+            if (index == 0) {
+                first = std::this_thread::get_id();
+            }
+        });
+        expect(first == caller, isTrue);
+    });
+
+    test("no threads", [&] {
+        bool ran = false;
+        run_on_threads(0, [&](std::size_t) {
+            ran = true;
+        });
+        expect(ran, isFalse);
+    });
+
+    test("exceptions on the calling thread stop the others", [&] {
+        std::atomic<bool> stopped{false};
+        std::atomic<int> finished{0};
+        const auto run = [&] {
+            run_on_threads(
+                    4,
+                    [&](std::size_t index) {
+                        if (index == 0) {
+                            throw std::runtime_error("failed");
+                        }
+                        while (!stopped.load()) {
+                            std::this_thread::yield();
+                        }
+                        finished.fetch_add(1);
+                    },
+                    [&] {
+                        stopped.store(true);
+                    });
+        };
+        expect(run, throwsA<std::runtime_error>);
+        // All the other workers were waited for.
+        expect(finished.load(), isEqualTo(3));
+    });
+
+    test("exceptions on the other threads stop the others", [&] {
+        std::atomic<bool> stopped{false};
+        std::atomic<int> finished{0};
+        const auto run = [&] {
+            run_on_threads(
+                    4,
+                    [&](std::size_t index) {
+                        if (index == 1) {
+                            throw std::runtime_error("failed");
+                        }
+                        while (!stopped.load()) {
+                            std::this_thread::yield();
+                        }
+                        finished.fetch_add(1);
+                    },
+                    [&] {
+                        stopped.store(true);
+                    });
+        };
+        expect(run, throwsA<std::runtime_error>);
+        expect(finished.load(), isEqualTo(3));
+    });
+}
@@ -0,0 +1,378 @@
+#include "algorithms/truth_table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <string>
+#include <thread>
+
+#include "algorithms/occurs.h"
+#include "algorithms/threads.h"
+
+namespace tema {
+
+namespace {
+
+using u64x1 = std::uint64_t __attribute__((vector_size(8)));
+using u64x4 = std::uint64_t __attribute__((vector_size(32)));
+using u64x8 = std::uint64_t __attribute__((vector_size(64)));
+
+constexpr std::uint64_t no_assignment = std::numeric_limits<std::uint64_t>::max();
+constexpr std::uint64_t all_ones = std::numeric_limits<std::uint64_t>::max();
+
+// Assignment number i gives atom k the value of bit k of i. Within a 64-bit word holding the assignments 64j, ...,
+// 64j+63, the first 6 atoms follow these fixed patterns, while the others are constant.
+constexpr std::uint64_t low_atom_patterns[6] = {
+  0xAAAAAAAAAAAAAAAAULL,
+  0xCCCCCCCCCCCCCCCCULL,
+  0xF0F0F0F0F0F0F0F0ULL,
+  0xFF00FF00FF00FF00ULL,
+  0xFFFF0000FFFF0000ULL,
+  0xFFFFFFFF00000000ULL,
+};
+
+std::uint64_t atom_word(std::uint32_t atom, std::uint64_t word_base) {
+    if (atom < 6) {
+        return low_atom_patterns[atom];
+    }
+    return ((word_base >> atom) & 1U) != 0 ? all_ones : 0;
+}
+
+std::uint64_t valid_bits(std::uint64_t word_base, std::uint64_t end) {
+    if (word_base + 64 <= end) {
+        return all_ones;
+    }
+    if (word_base >= end) {
+        return 0;
+    }
+    return (std::uint64_t{1} << (end - word_base)) - 1;
+}
+
+struct scan_job {
+    const truth_table_instruction* code;
+    std::size_t size;
+    std::uint32_t output;
+    std::uint64_t begin;
+    std::uint64_t end;
+    bool stop_at_falsifying;
+    const std::atomic<std::uint64_t>* best_falsifying;
+};
+
+struct scan_output {
+    std::uint64_t num_satisfying = 0;
+    std::uint64_t first_falsifying = no_assignment;
+};
+
+// Storage for the value of one instruction, wide enough for the widest vector. The vectors are loaded and stored with
+// memcpy, which the compiler turns into aligned vector moves.
+struct alignas(64) register_block {
+    std::uint64_t words[8];
+};
+
+template<class V>
+[[gnu::always_inline]] inline void evaluate_operation(const truth_table_instruction& instr,
+                                                      std::vector<register_block>& regs,
+                                                      std::size_t index) {
+    V left;
+    V right;
+    V result;
+    __builtin_memcpy(&left, regs[instr.left].words, sizeof(V));
+    __builtin_memcpy(&right, regs[instr.right].words, sizeof(V));
+    switch (instr.opcode) {
+        case truth_table_opcode::neg: result = ~left; break;
+        case truth_table_opcode::conj: result = left & right; break;
+        case truth_table_opcode::disj: result = left | right; break;
+        case truth_table_opcode::implies: result = ~left | right; break;
+        default: result = ~(left ^ right); break;
+    }
+    __builtin_memcpy(regs[index].words, &result, sizeof(V));
+}
+
+// Evaluates the assignments [job.begin, job.end), one vector of 64 * lanes assignments at a time. Inlined into the
+// per-instruction-set entry points below, so that each of them is compiled for its own target.
+template<class V>
+[[gnu::always_inline]] inline void scan(const scan_job& job, scan_output& out) {
+    constexpr std::size_t lanes = sizeof(V) / sizeof(std::uint64_t);
+    constexpr std::uint64_t block_size = 64 * lanes;
+    std::vector<register_block> regs(job.size);
+    for (auto base = job.begin; base < job.end; base += block_size) {
+        if (job.stop_at_falsifying && (out.first_falsifying != no_assignment ||
+                                       job.best_falsifying->load(std::memory_order_relaxed) < base)) {
+            return;
+        }
+        for (std::size_t i = 0; i < job.size; i++) {
+            const auto& instr = job.code[i];
+            auto& words = regs[i].words;
+            switch (instr.opcode) {
+                case truth_table_opcode::atom:
+                    for (std::size_t lane = 0; lane < lanes; lane++) {
+                        words[lane] = atom_word(instr.left, base + 64 * lane);
+                    }
+                    break;
+                case truth_table_opcode::constant_true:
+                    for (std::size_t lane = 0; lane < lanes; lane++) {
+                        words[lane] = all_ones;
+                    }
+                    break;
+                case truth_table_opcode::constant_false:
+                    for (std::size_t lane = 0; lane < lanes; lane++) {
+                        words[lane] = 0;
+                    }
+                    break;
+                default: evaluate_operation<V>(instr, regs, i); break;
+            }
+        }
+        for (std::size_t lane = 0; lane < lanes; lane++) {
+            const auto word_base = base + 64 * lane;
+            const auto valid = valid_bits(word_base, job.end);
+            const auto word = regs[job.output].words[lane];
+            out.num_satisfying += static_cast<std::uint64_t>(std::popcount(word & valid));
+            const auto falsified = ~word & valid;
+            if (falsified != 0 && out.first_falsifying == no_assignment) {
+                out.first_falsifying = word_base + static_cast<std::uint64_t>(std::countr_zero(falsified));
+            }
+        }
+    }
+}
+
+void scan_scalar(const scan_job& job, scan_output& out) {
+    scan<u64x1>(job, out);
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2"))) void scan_avx2(const scan_job& job, scan_output& out) {
+    scan<u64x4>(job, out);
+}
+
+__attribute__((target("avx512f"))) void scan_avx512(const scan_job& job, scan_output& out) {
+    scan<u64x8>(job, out);
+}
+#endif
+
+using scan_function = void (*)(const scan_job&, scan_output&);
+
+scan_function select_scan(simd_level level) {
+#if defined(__x86_64__)
+    switch (std::min(level, detected_simd_level())) {
+        case simd_level::avx512: return scan_avx512;
+        case simd_level::avx2: return scan_avx2;
+        case simd_level::scalar: return scan_scalar;
+    }
+#endif
+    (void)level;
+    return scan_scalar;
+}
+
+void lower_to(std::atomic<std::uint64_t>& value, std::uint64_t candidate) {
+    auto current = value.load(std::memory_order_relaxed);
+    while (candidate < current && !value.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+    }
+}
+
+bool is_propositional_forall(const statement& stmt) {
+    return stmt.is_forall() && !occurs_as_expression(*stmt.as_forall().inner, stmt.as_forall().var.get());
+}
+
+}  // namespace
+
+truth_table_too_large::truth_table_too_large(std::size_t num_atoms, std::size_t max_atoms)
+    : std::runtime_error("Statement has " + std::to_string(num_atoms) + " atoms, the truth table evaluator supports at most " +
+                         std::to_string(max_atoms)) {}
+
+simd_level detected_simd_level() {
+#if defined(__x86_64__)
+    static const auto level = [] {
+        if (__builtin_cpu_supports("avx512f")) {
+            return simd_level::avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return simd_level::avx2;
+        }
+        return simd_level::scalar;
+    }();
+    return level;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+truth_table::truth_table(const statement_ptr& stmt, std::size_t max_atoms) {
+    output = compile(stmt);
+    if (atom_list.size() > std::min(max_atoms, std::size_t{63})) {
+        throw truth_table_too_large(atom_list.size(), std::min(max_atoms, std::size_t{63}));
+    }
+    compiled.clear();
+}
+
+std::uint32_t truth_table::emit(truth_table_opcode opcode, std::uint32_t left, std::uint32_t right) {
+    program.push_back(truth_table_instruction{opcode, left, right});
+    return static_cast<std::uint32_t>(program.size() - 1);
+}
+
+std::uint32_t truth_table::emit_atom(const statement_ptr& atom) {
+    atom_list.push_back(atom);
+    return emit(truth_table_opcode::atom, static_cast<std::uint32_t>(atom_list.size() - 1));
+}
+
+std::uint32_t truth_table::compile(const statement_ptr& stmt) {
+    const auto it = compiled.find(stmt.get());
+    if (it != compiled.end()) {
+        return it->second;
+    }
+    const auto result = compile_uncached(stmt);
+    compiled.emplace(stmt.get(), result);
+    return result;
+}
+
+std::uint32_t truth_table::compile_uncached(const statement_ptr& stmt) {
+    if (stmt->is_truth()) {
+        return emit(truth_table_opcode::constant_true);
+    }
+    if (stmt->is_contradiction()) {
+        return emit(truth_table_opcode::constant_false);
+    }
+    if (stmt->is_var()) {
+        const auto* var = stmt->as_var().get();
+        const auto bound = bound_vars.find(var);
+        if (bound != bound_vars.end()) {
+            return bound->second;
+        }
+        const auto atom = var_atoms.find(var);
+        if (atom != var_atoms.end()) {
+            return atom->second;
+        }
+        const auto instr = emit_atom(stmt);
+        var_atoms.emplace(var, instr);
+        return instr;
+    }
+    if (stmt->is_neg()) {
+        return emit(truth_table_opcode::neg, compile(stmt->as_neg().inner));
+    }
+    if (stmt->is_conj() || stmt->is_disj()) {
+        const auto& children = stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner;
+        const auto opcode = stmt->is_conj() ? truth_table_opcode::conj : truth_table_opcode::disj;
+        if (children.empty()) {
+            return emit(stmt->is_conj() ? truth_table_opcode::constant_true : truth_table_opcode::constant_false);
+        }
+        auto result = compile(children[0]);
+        for (std::size_t i = 1; i < children.size(); i++) {
+            result = emit(opcode, result, compile(children[i]));
+        }
+        return result;
+    }
+    if (stmt->is_implies()) {
+        const auto from = compile(stmt->as_implies().from);
+        return emit(truth_table_opcode::implies, from, compile(stmt->as_implies().to));
+    }
+    if (stmt->is_equiv()) {
+        const auto left = compile(stmt->as_equiv().left);
+        return emit(truth_table_opcode::equiv, left, compile(stmt->as_equiv().right));
+    }
+    if (is_propositional_forall(*stmt)) {
+        // The two instances are compiled with the variable bound to a constant. Sub-statements compiled outside of
+        // this forall may have a different meaning inside it, so they are compiled again.
+        const auto* var = stmt->as_forall().var.get();
+        const auto& inner = stmt->as_forall().inner;
+        auto outer_compiled = std::move(compiled);
+        auto outer_bound_vars = bound_vars;
+
+        compiled.clear();
+        bound_vars[var] = emit(truth_table_opcode::constant_false);
+        const auto when_false = compile(inner);
+        compiled.clear();
+        bound_vars[var] = emit(truth_table_opcode::constant_true);
+        const auto when_true = compile(inner);
+
+        bound_vars = std::move(outer_bound_vars);
+        compiled = std::move(outer_compiled);
+        return emit(truth_table_opcode::conj, when_false, when_true);
+    }
+    const auto atom = other_atoms.find(stmt);
+    if (atom != other_atoms.end()) {
+        return atom->second;
+    }
+    const auto instr = emit_atom(stmt);
+    other_atoms.emplace(stmt, instr);
+    return instr;
+}
+
+const std::vector<statement_ptr>& truth_table::atoms() const {
+    return atom_list;
+}
+
+const std::vector<truth_table_instruction>& truth_table::instructions() const {
+    return program;
+}
+
+std::uint32_t truth_table::output_instruction() const {
+    return output;
+}
+
+namespace {
+
+scan_output run_scan(const std::vector<truth_table_instruction>& program,
+                     std::uint32_t output,
+                     std::size_t num_atoms,
+                     bool stop_at_falsifying,
+                     const truth_table_options& options) {
+    const auto scan_fn = select_scan(options.simd.value_or(detected_simd_level()));
+    const auto total = std::uint64_t{1} << num_atoms;
+    std::atomic<std::uint64_t> best_falsifying{no_assignment};
+    const auto make_job = [&](std::uint64_t begin, std::uint64_t end) {
+        return scan_job{program.data(), program.size(), output, begin, end, stop_at_falsifying, &best_falsifying};
+    };
+
+    const std::size_t num_threads = options.num_threads != 0 ? options.num_threads : std::thread::hardware_concurrency();
+    if (num_atoms < options.min_parallel_atoms || num_threads <= 1) {
+        scan_output out;
+        scan_fn(make_job(0, total), out);
+        return out;
+    }
+
+    // Threads take chunks in increasing order, so that when looking for a falsifying assignment, the chunks after
+    // the first one found can be skipped. Chunks are a multiple of the widest vector.
+    const auto chunk_size = (std::max(total / (num_threads * 16), std::uint64_t{512}) + 511) & ~std::uint64_t{511};
+    std::atomic<std::uint64_t> next_chunk{0};
+    std::atomic<std::uint64_t> num_satisfying{0};
+    const auto worker = [&] {
+        scan_output total_out;
+        while (true) {
+            const auto begin = next_chunk.fetch_add(chunk_size, std::memory_order_relaxed);
+            if (begin >= total || (stop_at_falsifying && best_falsifying.load(std::memory_order_relaxed) < begin)) {
+                break;
+            }
+            scan_output out;
+            scan_fn(make_job(begin, std::min(begin + chunk_size, total)), out);
+            total_out.num_satisfying += out.num_satisfying;
+            if (out.first_falsifying != no_assignment) {
+                lower_to(best_falsifying, out.first_falsifying);
+            }
+        }
+        num_satisfying.fetch_add(total_out.num_satisfying, std::memory_order_relaxed);
+    };
+    run_on_threads(num_threads, [&](std::size_t) {
+        worker();
+    });
+    return scan_output{num_satisfying.load(), best_falsifying.load()};
+}
+
+}  // namespace
+
+truth_table_check_result truth_table::check_validity(const truth_table_options& options) const {
+    const auto out = run_scan(program, output, atom_list.size(), true, options);
+    if (out.first_falsifying == no_assignment) {
+        return {true, {}};
+    }
+    std::vector<bool> counterexample(atom_list.size());
+    for (std::size_t i = 0; i < atom_list.size(); i++) {
+        counterexample[i] = ((out.first_falsifying >> i) & 1U) != 0;
+    }
+    return {false, std::move(counterexample)};
+}
+
+std::uint64_t truth_table::count_models(const truth_table_options& options) const {
+    return run_scan(program, output, atom_list.size(), false, options).num_satisfying;
+}
+
+}  // namespace tema
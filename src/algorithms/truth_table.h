@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "algorithms/hash.h"
+#include "core/statement.h"
+
+namespace tema {
+
+struct truth_table_too_large : std::runtime_error {
+    truth_table_too_large(std::size_t num_atoms, std::size_t max_atoms);
+};
+
+enum class truth_table_opcode : std::uint8_t {
+    atom,
+    constant_true,
+    constant_false,
+    neg,
+    conj,
+    disj,
+    implies,
+    equiv,
+};
+
+// One step of a compiled statement. Every instruction produces one value, and refers to the values of earlier
+// instructions by their index. For atom instructions, left is the index of the atom instead.
+struct truth_table_instruction {
+    truth_table_opcode opcode;
+    std::uint32_t left = 0;
+    std::uint32_t right = 0;
+};
+
+enum class simd_level {
+    scalar,  // 64 assignments at once, in a machine word.
+    avx2,    // 256 assignments at once.
+    avx512,  // 512 assignments at once.
+};
+
+// The widest level supported by the CPU running the program.
+[[nodiscard]] simd_level detected_simd_level();
+
+struct truth_table_options {
+    // Defaults to detected_simd_level(). Levels the CPU does not support are lowered to the best supported one.
+    std::optional<simd_level> simd;
+    // Defaults to the number of hardware threads.
+    std::size_t num_threads = 0;
+    // Statements with fewer atoms than this are evaluated on the calling thread only.
+    std::size_t min_parallel_atoms = 20;
+};
+
+struct truth_table_check_result {
+    bool valid;
+    // When the statement is not valid, the values of the atoms (in the order of truth_table::atoms()) for the first
+    // falsifying assignment.
+    std::vector<bool> counterexample;
+};
+
+// Brute-force decision procedure for propositional statements with few atoms. The statement is compiled once into a
+// flat list of instructions, which is then run on all the 2^n assignments of its n atoms, 64, 256 or 512 at a time
+// as bitwise operations on machine words or SIMD vectors.
+//
+// Atoms are the variables used as statements (var_stmt), the relationships (equal relationships are the same atom)
+// and the forall statements over a variable used as an expression. A forall over a variable used only as a statement
+// is compiled as the conjunction of its two instances.
+class truth_table {
+    std::vector<statement_ptr> atom_list;
+    std::vector<truth_table_instruction> program;
+    std::uint32_t output = 0;
+
+    // The instruction loading each atom.
+    std::unordered_map<const variable*, std::uint32_t> var_atoms;
+    std::unordered_map<statement_ptr, std::uint32_t, structural_hash, structural_equal> other_atoms;
+    // The constant instructions replacing the variables of the propositional forall statements being compiled.
+    std::unordered_map<const variable*, std::uint32_t> bound_vars;
+    std::unordered_map<const statement*, std::uint32_t> compiled;
+
+    std::uint32_t compile(const statement_ptr& stmt);
+    std::uint32_t compile_uncached(const statement_ptr& stmt);
+    std::uint32_t emit(truth_table_opcode opcode, std::uint32_t left = 0, std::uint32_t right = 0);
+    std::uint32_t emit_atom(const statement_ptr& atom);
+
+public:
+    static constexpr std::size_t default_max_atoms = 30;
+
+    // Throws truth_table_too_large if the statement has more than max_atoms atoms.
+    explicit truth_table(const statement_ptr& stmt, std::size_t max_atoms = default_max_atoms);
+
+    [[nodiscard]] const std::vector<statement_ptr>& atoms() const;
+    [[nodiscard]] const std::vector<truth_table_instruction>& instructions() const;
+    // The index of the instruction computing the value of the whole statement.
+    [[nodiscard]] std::uint32_t output_instruction() const;
+
+    [[nodiscard]] truth_table_check_result check_validity(const truth_table_options& options = {}) const;
+
+    // The number of assignments of the atoms that satisfy the statement.
+    [[nodiscard]] std::uint64_t count_models(const truth_table_options& options = {}) const;
+};
+
+}  // namespace tema
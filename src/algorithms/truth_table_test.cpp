@@ -0,0 +1,147 @@
+#include "algorithms/truth_table.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+std::vector<truth_table_options> all_option_sets() {
+    std::vector<truth_table_options> result;
+    for (const auto level: {simd_level::scalar, simd_level::avx2, simd_level::avx512}) {
+        result.push_back(truth_table_options{level, 1, 20});
+        result.push_back(truth_table_options{level, 4, 0});
+    }
+    return result;
+}
+
+std::vector<statement_ptr> make_atoms(std::size_t count) {
+    std::vector<statement_ptr> atoms;
+    for (std::size_t i = 0; i < count; i++) {
+        atoms.push_back(var_stmt(var("a" + std::to_string(i))));
+    }
+    return atoms;
+}
+
+statement_ptr parity(const std::vector<statement_ptr>& atoms) {
+    auto result = atoms[0];
+    for (std::size_t i = 1; i < atoms.size(); i++) {
+        result = neg(equiv(result, atoms[i]));
+    }
+    return result;
+}
+
+TEST_CASE("algorithms.truth_table") {
+    const auto p = var("p");
+    const auto q = var("q");
+    const auto r = var("r");
+    const auto vp = var_stmt(p);
+    const auto vq = var_stmt(q);
+    const auto vr = var_stmt(r);
+
+    test("compilation", [&] {
+        const auto p_implies_q = implies(vp, vq);
+        const truth_table table(conj(p_implies_q, p_implies_q, vr));
+        expect(table.atoms(), hasSize(3));
+        // p, q, p→q, r and two conjunctions. The repeated implication is compiled once.
+        expect(table.instructions(), hasSize(6));
+        expect(table.output_instruction(), std::uint32_t{5});
+
+        const truth_table same_atoms(conj(vp, var_stmt(p)));
+        expect(same_atoms.atoms(), hasSize(1));
+    });
+
+    test("textbook tautologies", [&] {
+        for (const auto& stmt: {disj(vp, neg(vp)),
+                                implies(conj(vp, implies(vp, vq)), vq),
+                                equiv(implies(vp, vq), implies(neg(vq), neg(vp))),
+                                equiv(disj(vp, conj(vq, vr)), conj(disj(vp, vq), disj(vp, vr))),
+                                truth(),
+                                neg(contradiction())}) {
+            for (const auto& options: all_option_sets()) {
+                expectMsg(truth_table(stmt).check_validity(options).valid, print_utf8(*stmt) + " is not valid");
+            }
+        }
+    });
+
+    test("counterexamples", [&] {
+        const truth_table table(implies(implies(vp, vq), vp));
+        for (const auto& options: all_option_sets()) {
+            const auto result = table.check_validity(options);
+            expect(result.valid, isFalse);
+            expect(result.counterexample, hasSize(2));
+            expect(result.counterexample[0], false);
+        }
+        expect(truth_table(contradiction()).check_validity().valid, isFalse);
+    });
+
+    test("counting models", [&] {
+        expect(truth_table(conj(vp, vq)).count_models(), std::uint64_t{1});
+        expect(truth_table(disj(vp, vq, vr)).count_models(), std::uint64_t{7});
+        expect(truth_table(truth()).count_models(), std::uint64_t{1});
+        const auto atoms = make_atoms(12);
+        for (const auto& options: all_option_sets()) {
+            expect(truth_table(parity(atoms)).count_models(options), std::uint64_t{1} << 11U);
+            expect(truth_table(conj(atoms)).count_models(options), std::uint64_t{1});
+        }
+    });
+
+    test("the first falsifying assignment is found, also with threads", [&] {
+        // Only falsified when all of a0, ..., a21 are true, which is the last assignment.
+        const auto atoms = make_atoms(22);
+        const truth_table table(neg(conj(atoms)));
+        for (const auto& options: all_option_sets()) {
+            const auto result = table.check_validity(options);
+            expect(result.valid, isFalse);
+            expect(std::count(result.counterexample.begin(), result.counterexample.end(), true), 22);
+        }
+        const truth_table valid_table(disj(parity(atoms), neg(parity(atoms))));
+        expect(valid_table.check_validity(truth_table_options{std::nullopt, 4, 0}).valid, isTrue);
+    });
+
+    test("thread counts that are not powers of two", [&] {
+        // The chunks of 2^21 assignments split between 3 or 6 threads must still be aligned to the widest vector.
+        const auto atoms = make_atoms(21);
+        const truth_table tautology(disj(parity(atoms), neg(parity(atoms))));
+        const truth_table parity_table(parity(atoms));
+        const truth_table all_true(neg(conj(atoms)));
+        for (const auto level: {simd_level::scalar, simd_level::avx2, simd_level::avx512}) {
+            const truth_table_options single{level, 1, 0};
+            for (const std::size_t num_threads: {std::size_t{3}, std::size_t{6}}) {
+                const truth_table_options options{level, num_threads, 0};
+                expect(tautology.count_models(options), isEqualTo(tautology.count_models(single)));
+                expect(tautology.count_models(options), isEqualTo(std::uint64_t{1} << 21U));
+                expect(parity_table.count_models(options), isEqualTo(parity_table.count_models(single)));
+                expect(all_true.check_validity(options).counterexample,
+                       isEqualTo(all_true.check_validity(single).counterexample));
+            }
+        }
+    });
+
+    test("forall over a propositional variable", [&] {
+        expect(truth_table(forall(p, disj(vp, neg(vp)))).check_validity().valid, isTrue);
+        expect(truth_table(forall(p, vp)).count_models(), std::uint64_t{0});
+        const truth_table table(equiv(forall(p, disj(vp, vq)), vq));
+        expect(table.atoms(), hasSize(1));
+        expect(table.check_validity().valid, isTrue);
+        // The bound p is different from the free p.
+        expect(truth_table(implies(vp, forall(p, vp))).check_validity().valid, isFalse);
+    });
+
+    test("relationships are atoms", [&] {
+        const auto x = var_expr(var("x"));
+        const auto y = var_expr(var("y"));
+        const truth_table table(disj(rel_stmt(x, rel_type::in, y), neg(rel_stmt(x, rel_type::in, y))));
+        expect(table.atoms(), hasSize(1));
+        expect(table.check_validity().valid, isTrue);
+    });
+
+    test("too many atoms", [&] {
+        const auto atoms = make_atoms(8);
+        expect([&] {
+            (void)truth_table(conj(atoms), 7);
+        }, throwsA<truth_table_too_large>);
+    });
+}
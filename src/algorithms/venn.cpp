@@ -0,0 +1,204 @@
+#include "algorithms/venn.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+
+namespace tema {
+
+namespace {
+
+constexpr std::uint64_t all_ones = ~std::uint64_t{0};
+
+// Within a word, the first 6 sets follow these fixed patterns, while the others fill whole words.
+constexpr std::uint64_t low_set_patterns[6] = {
+  0xAAAAAAAAAAAAAAAAULL,
+  0xCCCCCCCCCCCCCCCCULL,
+  0xF0F0F0F0F0F0F0F0ULL,
+  0xFF00FF00FF00FF00ULL,
+  0xFFFF0000FFFF0000ULL,
+  0xFFFFFFFF00000000ULL,
+};
+
+bool is_subset(const std::vector<std::uint64_t>& a, const std::vector<std::uint64_t>& b) {
+    for (std::size_t i = 0; i < a.size(); i++) {
+        if ((a[i] & ~b[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void collect_set_vars(const expression& expr,
+                      std::vector<variable_ptr>& sets,
+                      std::unordered_set<const variable*>& seen) {
+    if (expr.is_var()) {
+        if (seen.insert(expr.as_var().get()).second) {
+            sets.push_back(expr.as_var());
+        }
+    } else if (expr.is_binop()) {
+        collect_set_vars(*expr.as_binop().left, sets, seen);
+        collect_set_vars(*expr.as_binop().right, sets, seen);
+    }
+}
+
+void collect_set_vars(const statement& stmt,
+                      std::vector<variable_ptr>& sets,
+                      std::unordered_set<const variable*>& seen) {
+    if (stmt.is_rel()) {
+        collect_set_vars(*stmt.as_rel().left, sets, seen);
+        collect_set_vars(*stmt.as_rel().right, sets, seen);
+    } else if (stmt.is_conj()) {
+        for (const auto& child: stmt.as_conj().inner) {
+            collect_set_vars(*child, sets, seen);
+        }
+    } else if (stmt.is_forall()) {
+        collect_set_vars(*stmt.as_forall().inner, sets, seen);
+    }
+}
+
+std::optional<bool> decide(const venn_diagram& diagram, const statement& stmt) {
+    if (stmt.is_truth()) {
+        return true;
+    }
+    if (stmt.is_rel()) {
+        return diagram.holds(stmt.as_rel());
+    }
+    if (stmt.is_forall()) {
+        // The sets are already universally quantified.
+        return decide(diagram, *stmt.as_forall().inner);
+    }
+    if (stmt.is_conj()) {
+        bool all_hold = true;
+        for (const auto& child: stmt.as_conj().inner) {
+            const auto result = decide(diagram, *child);
+            if (!result.has_value()) {
+                return std::nullopt;
+            }
+            all_hold = all_hold && *result;
+        }
+        return all_hold;
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+venn_too_many_sets::venn_too_many_sets(std::size_t num_sets, std::size_t max_sets)
+    : std::runtime_error("Venn diagram of " + std::to_string(num_sets) + " sets, at most " + std::to_string(max_sets) +
+                         " are supported") {}
+
+venn_diagram::venn_diagram(std::vector<variable_ptr> sets, std::size_t max_sets): sets(std::move(sets)) {
+    if (this->sets.size() > std::min(max_sets, std::size_t{32})) {
+        throw venn_too_many_sets(this->sets.size(), std::min(max_sets, std::size_t{32}));
+    }
+    for (std::size_t i = 0; i < this->sets.size(); i++) {
+        set_indices.emplace(this->sets[i].get(), i);
+    }
+    num_words = std::max(num_regions() / 64, std::size_t{1});
+}
+
+const std::vector<variable_ptr>& venn_diagram::set_vars() const {
+    return sets;
+}
+
+std::size_t venn_diagram::num_regions() const {
+    return std::size_t{1} << sets.size();
+}
+
+bool venn_diagram::region_mask(const expression& expr, std::vector<std::uint64_t>& mask) const {
+    if (expr.is_call()) {
+        return false;
+    }
+    if (expr.is_var()) {
+        const auto it = set_indices.find(expr.as_var().get());
+        if (it == set_indices.end()) {
+            return false;
+        }
+        const auto index = it->second;
+        if (index < 6) {
+            // With fewer than 6 sets, the bits after the last region stay clear.
+            const auto valid = num_regions() >= 64 ? all_ones : (std::uint64_t{1} << num_regions()) - 1;
+            std::fill(mask.begin(), mask.end(), low_set_patterns[index] & valid);
+        } else {
+            for (std::size_t word = 0; word < num_words; word++) {
+                mask[word] = ((word >> (index - 6)) & 1U) != 0 ? all_ones : 0;
+            }
+        }
+        return true;
+    }
+    std::vector<std::uint64_t> right(num_words);
+    if (!region_mask(*expr.as_binop().left, mask) || !region_mask(*expr.as_binop().right, right)) {
+        return false;
+    }
+    // Plain word loops, which the compiler vectorizes.
+    switch (expr.as_binop().type) {
+        case binop_type::set_union:
+            for (std::size_t i = 0; i < num_words; i++) {
+                mask[i] |= right[i];
+            }
+            break;
+        case binop_type::set_intersection:
+            for (std::size_t i = 0; i < num_words; i++) {
+                mask[i] &= right[i];
+            }
+            break;
+        case binop_type::set_difference:
+            for (std::size_t i = 0; i < num_words; i++) {
+                mask[i] &= ~right[i];
+            }
+            break;
+        case binop_type::set_sym_difference:
+            for (std::size_t i = 0; i < num_words; i++) {
+                mask[i] ^= right[i];
+            }
+            break;
+    }
+    return true;
+}
+
+std::optional<std::vector<std::uint64_t>> venn_diagram::region_mask(const expression& expr) const {
+    std::vector<std::uint64_t> mask(num_words);
+    if (!region_mask(expr, mask)) {
+        return std::nullopt;
+    }
+    return mask;
+}
+
+std::optional<bool> venn_diagram::holds(const relationship& rel) const {
+    switch (rel.type) {
+        case rel_type::eq:
+        case rel_type::n_eq:
+        case rel_type::includes:
+        case rel_type::n_includes:
+        case rel_type::eq_includes:
+        case rel_type::n_eq_includes:
+        case rel_type::is_included:
+        case rel_type::n_is_included:
+        case rel_type::eq_is_included:
+        case rel_type::n_eq_is_included: break;
+        default: return std::nullopt;
+    }
+    const auto left = region_mask(*rel.left);
+    const auto right = region_mask(*rel.right);
+    if (!left.has_value() || !right.has_value()) {
+        return std::nullopt;
+    }
+    switch (rel.type) {
+        case rel_type::eq: return *left == *right;
+        case rel_type::eq_includes:
+        case rel_type::n_is_included: return is_subset(*right, *left);
+        case rel_type::eq_is_included:
+        case rel_type::n_includes: return is_subset(*left, *right);
+        default: return false;
+    }
+}
+
+std::optional<bool> decide_set_algebra(const statement_ptr& stmt, std::size_t max_sets) {
+    std::vector<variable_ptr> sets;
+    std::unordered_set<const variable*> seen;
+    collect_set_vars(*stmt, sets, seen);
+    return decide(venn_diagram(std::move(sets), max_sets), *stmt);
+}
+
+}  // namespace tema
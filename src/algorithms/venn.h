@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "core/statement.h"
+
+namespace tema {
+
+struct venn_too_many_sets : std::runtime_error {
+    venn_too_many_sets(std::size_t num_sets, std::size_t max_sets);
+};
+
+// The Venn diagram of n set variables has 2^n regions: region r is made of the elements that belong exactly to the
+// sets whose index is a bit of r. Every expression built from the set variables with binops is a union of regions,
+// represented as a bitmask over the regions stored in 64-bit words.
+//
+// Since every region can independently be empty or not, a relationship holds for every interpretation of the set
+// variables exactly when the masks of its two sides compare accordingly:
+//  - A=B holds when the masks are equal,
+//  - A⊆B holds when the mask of A is included in the mask of B,
+//  - A⊂B never holds for every interpretation (not when all sets are empty),
+//  - A≠B and A⊈B never hold (again, not when all sets are empty),
+//  - A⊄B holds when the mask of B is included in the mask of A (otherwise B can have elements outside A, while A is
+//    empty),
+// and similarly for ⊇, ⊃ and their negations, with the sides swapped.
+class venn_diagram {
+    std::vector<variable_ptr> sets;
+    std::unordered_map<const variable*, std::size_t> set_indices;
+    std::size_t num_words;
+
+    [[nodiscard]] bool region_mask(const expression& expr, std::vector<std::uint64_t>& mask) const;
+
+public:
+    static constexpr std::size_t default_max_sets = 20;
+
+    // Throws venn_too_many_sets if there are more than max_sets sets.
+    explicit venn_diagram(std::vector<variable_ptr> sets, std::size_t max_sets = default_max_sets);
+
+    [[nodiscard]] const std::vector<variable_ptr>& set_vars() const;
+    [[nodiscard]] std::size_t num_regions() const;
+
+    // The regions making up the expression, or nullopt if the expression uses a call or a variable that is not one
+    // of the sets of the diagram.
+    [[nodiscard]] std::optional<std::vector<std::uint64_t>> region_mask(const expression& expr) const;
+
+    // Whether the relationship holds for every interpretation of the sets, or nullopt if it is not a relationship
+    // between sets (=, ≠, ⊆, ⊂, ⊇, ⊃ or their negations) whose sides have a region mask.
+    [[nodiscard]] std::optional<bool> holds(const relationship& rel) const;
+};
+
+// Decides whether a set-algebra statement holds for every interpretation of its variables. Supported statements are
+// the relationships handled by venn_diagram::holds, conjunctions of supported statements, and forall statements
+// around a supported statement. Returns nullopt for anything else, and throws venn_too_many_sets if the statement
+// uses more than max_sets set variables.
+[[nodiscard]] std::optional<bool> decide_set_algebra(const statement_ptr& stmt,
+                                                     std::size_t max_sets = venn_diagram::default_max_sets);
+
+}  // namespace tema
@@ -0,0 +1,100 @@
+#include "algorithms/venn.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/print_utf8.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+void expect_decided(const statement_ptr& stmt, bool expected, Context context = Context()) {
+    const auto result = decide_set_algebra(stmt);
+    expectMsg(result.has_value(), print_utf8(*stmt) + " was not decided", context);
+    expectMsg(result == expected, print_utf8(*stmt) + (expected ? " does not hold" : " holds"), std::move(context));
+}
+
+TEST_CASE("algorithms.venn") {
+    const auto a = var_expr(var("A"));
+    const auto b = var_expr(var("B"));
+    const auto c = var_expr(var("C"));
+    const auto set_union = [](expr_ptr l, expr_ptr r) {
+        return binop(std::move(l), binop_type::set_union, std::move(r));
+    };
+    const auto set_intersection = [](expr_ptr l, expr_ptr r) {
+        return binop(std::move(l), binop_type::set_intersection, std::move(r));
+    };
+    const auto set_difference = [](expr_ptr l, expr_ptr r) {
+        return binop(std::move(l), binop_type::set_difference, std::move(r));
+    };
+    const auto set_sym_difference = [](expr_ptr l, expr_ptr r) {
+        return binop(std::move(l), binop_type::set_sym_difference, std::move(r));
+    };
+
+    test("region masks", [&] {
+        const venn_diagram diagram({a->as_var(), b->as_var()});
+        expect(diagram.num_regions(), std::size_t{4});
+        expect(*diagram.region_mask(*a), std::vector<std::uint64_t>{0b1010});
+        expect(*diagram.region_mask(*b), std::vector<std::uint64_t>{0b1100});
+        expect(*diagram.region_mask(*set_union(a, b)), std::vector<std::uint64_t>{0b1110});
+        expect(*diagram.region_mask(*set_difference(a, b)), std::vector<std::uint64_t>{0b0010});
+        expect(diagram.region_mask(*c).has_value(), isFalse);
+        expect(diagram.region_mask(*call(a, {b})).has_value(), isFalse);
+    });
+
+    test("set identities", [&] {
+        expect_decided(rel_stmt(set_sym_difference(a, b), rel_type::eq, set_union(set_difference(a, b), set_difference(b, a))), true);
+        expect_decided(rel_stmt(set_union(a, b), rel_type::eq, set_union(b, a)), true);
+        expect_decided(rel_stmt(set_difference(a, set_union(b, c)), rel_type::eq, set_intersection(set_difference(a, b), set_difference(a, c))), true);
+        expect_decided(rel_stmt(set_intersection(a, set_union(b, c)), rel_type::eq, set_union(set_intersection(a, b), set_intersection(a, c))), true);
+        expect_decided(rel_stmt(set_sym_difference(set_sym_difference(a, b), c), rel_type::eq, set_sym_difference(a, set_sym_difference(b, c))), true);
+        expect_decided(rel_stmt(set_union(a, b), rel_type::eq, a), false);
+        expect_decided(rel_stmt(set_difference(a, b), rel_type::eq, set_difference(b, a)), false);
+    });
+
+    test("inclusions", [&] {
+        expect_decided(rel_stmt(set_intersection(a, b), rel_type::eq_is_included, a), true);
+        expect_decided(rel_stmt(set_union(a, b), rel_type::eq_includes, b), true);
+        expect_decided(rel_stmt(a, rel_type::eq_is_included, set_intersection(a, b)), false);
+        expect_decided(rel_stmt(a, rel_type::n_eq_is_included, set_intersection(a, b)), false);
+        // Strict inclusion does not hold when all sets are empty.
+        expect_decided(rel_stmt(set_difference(a, b), rel_type::is_included, set_union(a, b)), false);
+        expect_decided(rel_stmt(a, rel_type::n_is_included, a), true);
+        expect_decided(rel_stmt(a, rel_type::n_is_included, set_intersection(a, b)), true);
+        expect_decided(rel_stmt(a, rel_type::n_is_included, set_union(a, b)), false);
+        expect_decided(rel_stmt(set_union(a, b), rel_type::n_includes, a), false);
+        expect_decided(rel_stmt(a, rel_type::n_eq, set_sym_difference(a, a)), false);
+    });
+
+    test("statements around relationships", [&] {
+        const auto commutes = rel_stmt(set_union(a, b), rel_type::eq, set_union(b, a));
+        expect_decided(forall(a->as_var(), commutes), true);
+        expect_decided(conj(commutes, rel_stmt(a, rel_type::eq_is_included, set_union(a, c))), true);
+        expect_decided(conj(commutes, rel_stmt(a, rel_type::eq, c)), false);
+        expect(decide_set_algebra(rel_stmt(a, rel_type::in, b)).has_value(), isFalse);
+        expect(decide_set_algebra(rel_stmt(a, rel_type::less, b)).has_value(), isFalse);
+        expect(decide_set_algebra(rel_stmt(call(var_expr(var("f")), {a}), rel_type::eq, a)).has_value(), isFalse);
+        expect(decide_set_algebra(implies(commutes, commutes)).has_value(), isFalse);
+    });
+
+    test("many sets span multiple words", [&] {
+        std::vector<expr_ptr> sets;
+        for (int i = 0; i < 10; i++) {
+            sets.push_back(var_expr(var("S" + std::to_string(i))));
+        }
+        auto left = sets[0];
+        auto right = sets[9];
+        for (std::size_t i = 1; i < sets.size(); i++) {
+            left = set_union(left, sets[i]);
+            right = set_union(sets[9 - i], right);
+        }
+        expect_decided(rel_stmt(left, rel_type::eq, right), true);
+        expect_decided(rel_stmt(set_sym_difference(left, sets[9]), rel_type::eq, set_difference(left, sets[9])), true);
+        expect_decided(rel_stmt(sets[9], rel_type::eq, sets[8]), false);
+        expect_decided(rel_stmt(set_intersection(sets[9], sets[0]), rel_type::eq_is_included, sets[0]), true);
+
+        expect([&] {
+            (void)decide_set_algebra(rel_stmt(left, rel_type::eq, right), 9);
+        }, throwsA<venn_too_many_sets>);
+    });
+}
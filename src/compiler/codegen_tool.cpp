@@ -0,0 +1,46 @@
+#include "compiler/codegen_tool.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "compiler/parser.h"
+
+namespace tema {
+
+namespace {
+
+void write_file(const std::filesystem::path& path, const std::string& content) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << content;
+    if (!out) {
+        throw std::runtime_error("Could not write " + path.string());
+    }
+}
+
+}  // namespace
+
+int run_codegen_tool(std::span<char* const> args, std::ostream& errors, const code_generator& generate) {
+    if (args.size() != 6) {
+        errors << "Usage: " << (args.empty() ? "tool" : args[0])
+               << " <module.tema> <namespace> <header include> <output.h> <output.cpp>\n";
+        return 2;
+    }
+    try {
+        const std::filesystem::path module_path = args[1];
+        std::ifstream stream(module_path);
+        if (!stream) {
+            errors << "Could not open " << module_path << "\n";
+            return 1;
+        }
+        const auto mod = parse_module(stream, module_path);
+        const auto code = generate(mod, args[2], args[3]);
+        write_file(args[4], code.header);
+        write_file(args[5], code.source);
+    } catch (const std::exception& e) {
+        errors << args[1] << ": " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace tema
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <span>
+#include <string>
+
+#include "core/module.h"
+
+namespace tema {
+
+// The code a generator tool writes for a module: a header and the source that implements it.
+struct generated_code {
+    std::string header;
+    std::string source;
+};
+
+using code_generator = std::function<
+        generated_code(const module& mod, const std::string& name_space, const std::string& header_include)>;
+
+// The main function of the tools that generate C++ code for a module at build time (tema_matcher_codegen and
+// tema_module_embed), called as
+//      <tool> <module.tema> <namespace> <header include> <output.h> <output.cpp>
+// Parses the module, writes the header and the source that generate produces for it, and returns the exit code of the
+// tool: 0 on success, 1 when the module can't be read or parsed or the outputs can't be written (reported to errors),
+// and 2 on a wrong command line.
+[[nodiscard]] int run_codegen_tool(std::span<char* const> args, std::ostream& errors, const code_generator& generate);
+
+}  // namespace tema
@@ -0,0 +1,92 @@
+#include "compiler/codegen_tool.h"
+
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "compiler/temporary_directory.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+namespace {
+
+std::string read_file(const std::filesystem::path& path) {
+    std::ifstream stream(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << stream.rdbuf();
+    return std::move(contents).str();
+}
+
+// Runs the tool with the arguments, as main would get them.
+int run(std::vector<std::string> args, std::ostream& errors) {
+    std::vector<char*> argv;
+    for (auto& arg: args) {
+        argv.push_back(arg.data());
+    }
+    return run_codegen_tool(argv, errors, [](const module& mod, const std::string& name_space, const std::string& header_include) {
+        return generated_code{
+                .header = name_space + " " + header_include,
+                .source = std::string{mod.get_name()} + " " + std::to_string(mod.get_decls().size()),
+        };
+    });
+}
+
+}  // namespace
+
+TEST_CASE("compiler.codegen_tool") {
+    std::optional<temporary_directory> dir;
+    std::filesystem::path module_path;
+    std::filesystem::path header_path;
+    std::filesystem::path source_path;
+    std::ostringstream errors;
+
+    setUp([&] {
+        dir.emplace("tema_codegen_tool_test");
+        module_path = dir->path() / "laws.tema";
+        header_path = dir->path() / "laws.h";
+        source_path = dir->path() / "laws.cpp";
+        std::ofstream(module_path) << "var p\ntheorem \"Identity\" p→p\nproof missing\n";
+        errors.str("");
+    });
+
+    tearDown([&] {
+        dir.reset();
+    });
+
+    test("writes the generated header and source", [&] {
+        const auto code = run({"tool", module_path, "laws", "generated/laws.h", header_path, source_path}, errors);
+        expect(code, isEqualTo(0));
+        expect(read_file(header_path), isEqualTo("laws generated/laws.h"));
+        expect(read_file(source_path), isEqualTo("laws 2"));
+        expect(errors.str(), isEmpty);
+    });
+
+    test("wrong number of arguments", [&] {
+        expect(run({"tool", module_path}, errors), isEqualTo(2));
+        expect(errors.str().starts_with("Usage: tool <module.tema>"), isTrue);
+    });
+
+    test("missing module", [&] {
+        const auto missing = dir->path() / "missing.tema";
+        expect(run({"tool", missing, "laws", "generated/laws.h", header_path, source_path}, errors), isEqualTo(1));
+        expect(errors.str().starts_with("Could not open"), isTrue);
+        expect(std::filesystem::exists(header_path), isFalse);
+    });
+
+    test("parse errors are reported with the module", [&] {
+        std::ofstream(module_path) << "theorem";
+        expect(run({"tool", module_path, "laws", "generated/laws.h", header_path, source_path}, errors), isEqualTo(1));
+        expect(errors.str().starts_with(module_path.string() + ": "), isTrue);
+    });
+
+    test("unwritable outputs", [&] {
+        const auto unwritable = dir->path() / "missing" / "laws.h";
+        expect(run({"tool", module_path, "laws", "generated/laws.h", unwritable, source_path}, errors), isEqualTo(1));
+        expect(errors.str().starts_with(module_path.string() + ": Could not write"), isTrue);
+    });
+}
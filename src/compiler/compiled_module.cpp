@@ -0,0 +1,191 @@
+#include "compiler/compiled_module.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+
+namespace tema {
+
+namespace {
+
+constexpr std::uint32_t file_magic = 0x434D4554;  // "TEMC"
+
+constexpr std::size_t header_words = 3;  // magic, version, number of modules
+constexpr std::size_t toc_words = 4;     // name offset, name size, image offset, image size
+constexpr std::size_t image_alignment = 8;
+
+void append(std::vector<std::byte>& bytes, std::uint32_t word) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        bytes.push_back(static_cast<std::byte>((word >> shift) & 0xFFU));
+    }
+}
+
+void align(std::vector<std::byte>& bytes) {
+    bytes.resize((bytes.size() + image_alignment - 1) / image_alignment * image_alignment);
+}
+
+}  // namespace
+
+std::vector<std::byte> write_compiled_modules(std::span<const module* const> modules) {
+    std::vector<std::vector<std::byte>> images;
+    images.reserve(modules.size());
+    for (const auto* mod: modules) {
+        images.push_back(write_module_image(*mod));
+    }
+
+    // Names right after the table of contents, then the images.
+    auto offset = (header_words + toc_words * modules.size()) * 4;
+    std::vector<std::uint32_t> name_offsets;
+    for (const auto* mod: modules) {
+        name_offsets.push_back(static_cast<std::uint32_t>(offset));
+        offset += mod->get_name().size();
+    }
+    std::vector<std::uint32_t> image_offsets;
+    for (const auto& image: images) {
+        offset = (offset + image_alignment - 1) / image_alignment * image_alignment;
+        image_offsets.push_back(static_cast<std::uint32_t>(offset));
+        offset += image.size();
+    }
+
+    std::vector<std::byte> bytes;
+    bytes.reserve(offset);
+    append(bytes, file_magic);
+    append(bytes, compiled_module_version);
+    append(bytes, static_cast<std::uint32_t>(modules.size()));
+    for (std::size_t i = 0; i < modules.size(); i++) {
+        append(bytes, name_offsets[i]);
+        append(bytes, static_cast<std::uint32_t>(modules[i]->get_name().size()));
+        append(bytes, image_offsets[i]);
+        append(bytes, static_cast<std::uint32_t>(images[i].size()));
+    }
+    for (const auto* mod: modules) {
+        for (const auto ch: mod->get_name()) {
+            bytes.push_back(static_cast<std::byte>(ch));
+        }
+    }
+    for (const auto& image: images) {
+        align(bytes);
+        bytes.insert(bytes.end(), image.begin(), image.end());
+    }
+    return bytes;
+}
+
+void save_compiled_modules(const std::filesystem::path& path, std::span<const module* const> modules) {
+    const auto bytes = write_compiled_modules(modules);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    const auto* data = reinterpret_cast<const char*>(bytes.data());  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    out.write(data, static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+        throw std::runtime_error("Could not write " + path.string());
+    }
+}
+
+struct compiled_module_file::mapping {
+    void* address;
+    std::size_t size;
+
+    mapping(void* address, std::size_t size): address(address), size(size) {}
+
+    mapping(const mapping&) = delete;
+    mapping& operator=(const mapping&) = delete;
+
+    ~mapping() {
+        munmap(address, size);
+    }
+};
+
+std::uint32_t compiled_module_file::word(std::size_t offset) const {
+    if (offset + 4 > bytes.size()) {
+        throw module_format_error("Truncated compiled module file");
+    }
+    std::uint32_t value = 0;
+    for (std::size_t i = 0; i < 4; i++) {
+        value |= static_cast<std::uint32_t>(bytes[offset + i]) << (8 * i);
+    }
+    return value;
+}
+
+std::uint32_t compiled_module_file::toc_field(std::size_t index, std::size_t f) const {
+    if (index >= count) {
+        throw std::out_of_range("Module index out of range");
+    }
+    return word((header_words + index * toc_words + f) * 4);
+}
+
+compiled_module_file::compiled_module_file(std::span<const std::byte> bytes): bytes(bytes) {
+    if (bytes.size() < header_words * 4 || word(0) != file_magic) {
+        throw module_format_error("Not a compiled module file");
+    }
+    if (word(4) != compiled_module_version) {
+        throw module_format_error("Unsupported compiled module file version " + std::to_string(word(4)));
+    }
+    count = word(8);
+    if ((header_words + std::size_t{count} * toc_words) * 4 > bytes.size()) {
+        throw module_format_error("Truncated compiled module file");
+    }
+    for (std::size_t i = 0; i < count; i++) {
+        if (std::size_t{toc_field(i, 0)} + toc_field(i, 1) > bytes.size() ||
+            std::size_t{toc_field(i, 2)} + toc_field(i, 3) > bytes.size()) {
+            throw module_format_error("Truncated compiled module file");
+        }
+    }
+}
+
+compiled_module_file compiled_module_file::open(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);  // NOLINT(cppcoreguidelines-pro-type-vararg)
+    if (fd < 0) {
+        throw std::runtime_error("Could not open " + path.string());
+    }
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Could not read " + path.string());
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    if (size == 0) {
+        close(fd);
+        throw module_format_error("Not a compiled module file: " + path.string());
+    }
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the file is closed.
+    close(fd);
+    if (address == MAP_FAILED) {  // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        throw std::runtime_error("Could not map " + path.string());
+    }
+    auto mapped = std::make_shared<const mapping>(address, size);
+    compiled_module_file file(std::span{static_cast<const std::byte*>(address), size});
+    file.mapped = std::move(mapped);
+    return file;
+}
+
+std::size_t compiled_module_file::size() const {
+    return count;
+}
+
+std::string_view compiled_module_file::module_name(std::size_t index) const {
+    const auto* data = reinterpret_cast<const char*>(bytes.data());  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    return {data + toc_field(index, 0), toc_field(index, 1)};
+}
+
+std::span<const std::byte> compiled_module_file::image(std::size_t index) const {
+    return bytes.subspan(toc_field(index, 2), toc_field(index, 3));
+}
+
+std::optional<std::size_t> compiled_module_file::find(std::string_view name) const {
+    for (std::size_t i = 0; i < count; i++) {
+        if (module_name(i) == name) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+module_image_view compiled_module_file::view(std::size_t index) const {
+    return module_image_view(image(index));
+}
+
+}  // namespace tema
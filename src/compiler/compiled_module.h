@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "compiler/module_image.h"
+#include "core/module.h"
+
+namespace tema {
+
+inline constexpr std::string_view compiled_module_extension = ".temac";
+
+// Incremented on every change of the layout of compiled module files (but not of the images they hold).
+inline constexpr std::uint32_t compiled_module_version = 1;
+
+// A compiled module file (.temac) is a bundle of module images (see compiler/module_image.h). It starts with a header
+// holding the format version and a table of contents with the name, offset and size of each image, and the images
+// follow, each aligned to 8 bytes within the file.
+[[nodiscard]] std::vector<std::byte> write_compiled_modules(std::span<const module* const> modules);
+
+// Throws std::runtime_error when the file can't be written.
+void save_compiled_modules(const std::filesystem::path& path, std::span<const module* const> modules);
+
+// A compiled module file mapped in memory (or any block of bytes holding one). Only the header and the table of
+// contents are read up front: the images are read in place, through module_image_view, so loading a large bundle
+// touches only the pages of the declarations that are used.
+//
+// Copies share the mapping, which is released with the last one. The views must not outlive the file.
+class compiled_module_file {
+    struct mapping;
+
+    std::shared_ptr<const mapping> mapped;
+    std::span<const std::byte> bytes;
+    std::uint32_t count = 0;
+
+    [[nodiscard]] std::uint32_t word(std::size_t offset) const;
+    [[nodiscard]] std::uint32_t toc_field(std::size_t index, std::size_t f) const;
+
+public:
+    // Throws module_format_error when the bytes are not a compiled module file of the current version.
+    explicit compiled_module_file(std::span<const std::byte> bytes);
+
+    // Maps the file in memory. Throws std::runtime_error when it can't be opened or mapped.
+    [[nodiscard]] static compiled_module_file open(const std::filesystem::path& path);
+
+    [[nodiscard]] std::size_t size() const;
+    [[nodiscard]] std::string_view module_name(std::size_t index) const;
+    [[nodiscard]] std::span<const std::byte> image(std::size_t index) const;
+    [[nodiscard]] std::optional<std::size_t> find(std::string_view name) const;
+
+    [[nodiscard]] module_image_view view(std::size_t index) const;
+};
+
+}  // namespace tema
@@ -0,0 +1,38 @@
+#include <fstream>
+#include <iostream>
+
+#include "compiler/compiled_module.h"
+#include "compiler/parser.h"
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <output.temac> <module.tema>...\n";
+        return 2;
+    }
+    std::vector<tema::module> modules;
+    for (int i = 2; i < argc; i++) {
+        const std::filesystem::path module_path = argv[i];
+        std::ifstream stream(module_path);
+        if (!stream) {
+            std::cerr << "Could not open " << module_path << "\n";
+            return 1;
+        }
+        try {
+            modules.push_back(tema::parse_module(stream, module_path));
+        } catch (const std::exception& e) {
+            std::cerr << argv[i] << ": " << e.what() << "\n";
+            return 1;
+        }
+    }
+    std::vector<const tema::module*> module_ptrs;
+    for (const auto& mod: modules) {
+        module_ptrs.push_back(&mod);
+    }
+    try {
+        tema::save_compiled_modules(argv[1], module_ptrs);
+    } catch (const std::exception& e) {
+        std::cerr << argv[1] << ": " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "compiler/compiled_module.h"
+
+#include <fstream>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/print_utf8.h"
+#include "compiler/parser.h"
+#include "compiler/temporary_directory.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("compiler.compiled_module") {
+    const auto first = parse_module(R"(
+var p
+var q
+theorem "Modus Ponens" (p∧(p→q))→q
+proof missing
+)");
+    const module second("second", "second.tema");
+    const std::vector<const module*> modules{&first, &second};
+
+    test("bundle has a table of contents", [&] {
+        const auto bytes = write_compiled_modules(modules);
+        const compiled_module_file file(bytes);
+        expect(file.size(), isEqualTo(2U));
+        expect(file.module_name(0), isEqualTo(first.get_name()));
+        expect(file.module_name(1), isEqualTo("second"));
+        expect(file.find("second") == std::optional<std::size_t>{1}, isTrue);
+        expect(file.find("third").has_value(), isFalse);
+        for (std::size_t i = 0; i < file.size(); i++) {
+            expect(reinterpret_cast<std::uintptr_t>(file.image(i).data()) % 8 ==
+                           reinterpret_cast<std::uintptr_t>(bytes.data()) % 8,
+                   isTrue);
+        }
+        auto view = file.view(0);
+        expect(view.num_decls(), isEqualTo(3U));
+        const auto& expected = std::get<stmt_decl>(first.get_decls()[2]).stmt;
+        expect(print_utf8(*view.get_statement(2)), isEqualTo(print_utf8(*expected)));
+        expect(file.view(1).num_decls(), isEqualTo(0U));
+    });
+
+    test("saved files are mapped", [&] {
+        const temporary_directory dir("tema_compiled_module_test");
+        const auto path = dir.path() / "modules.temac";
+        save_compiled_modules(path, modules);
+        const auto file = compiled_module_file::open(path);
+        expect(file.size(), isEqualTo(2U));
+        const auto mod = file.view(0).load();
+        expect(mod.get_decls(), hasSize(3U));
+        expect(std::get<stmt_decl>(mod.get_decls()[2]).name, isEqualTo("Modus Ponens"));
+    });
+
+    test("invalid files are rejected", [&] {
+        auto bytes = write_compiled_modules(modules);
+        expect([&] { (void)compiled_module_file({}); }, throwsA<module_format_error>);
+        expect([&] { (void)compiled_module_file(std::span{bytes}.first(20)); }, throwsA<module_format_error>);
+        bytes[4] = std::byte{2};
+        expect([&] { (void)compiled_module_file(bytes); }, throwsA<module_format_error>);
+        expect([&] { (void)compiled_module_file::open("/nonexistent/file.temac"); }, throwsA<std::runtime_error>);
+    });
+}
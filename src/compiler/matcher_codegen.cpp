@@ -0,0 +1,473 @@
+#include "compiler/matcher_codegen.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "algorithms/print_utf8.h"
+
+namespace tema {
+
+namespace {
+
+std::string escape(std::string_view text) {
+    std::string escaped;
+    for (const auto ch: text) {
+        if (ch == '"' || ch == '\\') {
+            escaped += '\\';
+            escaped += ch;
+        } else if (ch == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += ch;
+        }
+    }
+    return escaped;
+}
+
+// A variable of a law, as a statement or as an expression (match and apply_vars keep the two apart).
+using var_key = std::pair<const variable*, bool>;
+
+// The declarations shared by all the laws: the variables and the parts of the conclusions that don't depend on the
+// application, which are built once.
+struct shared_declarations {
+    std::map<const variable*, std::string> var_names;
+    std::map<std::string, std::string> constant_names;
+    std::ostringstream code;
+
+    const std::string& var_name(const variable_ptr& var) {
+        auto it = var_names.find(var.get());
+        if (it == var_names.end()) {
+            auto name = "var_" + std::to_string(var_names.size());
+            code << "const variable_ptr " << name << " = var(\"" << escape(var->name) << "\");\n";
+            it = var_names.emplace(var.get(), std::move(name)).first;
+        }
+        return it->second;
+    }
+
+    std::string constant(std::string_view type, const std::string& value) {
+        if (value == "truth()" || value == "contradiction()") {
+            // Already built once.
+            return value;
+        }
+        auto it = constant_names.find(value);
+        if (it == constant_names.end()) {
+            auto name = "constant_" + std::to_string(constant_names.size());
+            code << "const " << type << " " << name << " = " << value << ";\n";
+            it = constant_names.emplace(value, std::move(name)).first;
+        }
+        return it->second;
+    }
+};
+
+// One direction of a law: matching the premise against the application, then building the conclusion.
+class direction_writer {
+    shared_declarations& shared;
+    std::ostringstream body;
+    std::size_t num_nodes = 0;
+    // The variables of the premise that need to be remembered: those repeated in the premise or used in the
+    // conclusion.
+    std::set<var_key> needed_vars;
+    std::map<var_key, std::size_t> premise_var_counts;
+    // The node each remembered variable of the premise was bound to.
+    std::map<var_key, std::string> slots;
+    // The variables bound by the enclosing foralls of the premise, with the variable of the application they are bound
+    // to.
+    std::vector<std::pair<const variable*, std::string>> bound;
+
+    void count_premise_vars(const expression& expr, std::vector<const variable*>& bound_vars) {  // NOLINT(misc-no-recursion)
+        if (expr.is_var()) {
+            if (std::find(bound_vars.begin(), bound_vars.end(), expr.as_var().get()) == bound_vars.end()) {
+                premise_var_counts[{expr.as_var().get(), false}] += 1;
+            }
+        } else if (expr.is_binop()) {
+            count_premise_vars(*expr.as_binop().left, bound_vars);
+            count_premise_vars(*expr.as_binop().right, bound_vars);
+        } else {
+            count_premise_vars(*expr.as_call().callee, bound_vars);
+            for (const auto& param: expr.as_call().params) {
+                count_premise_vars(*param, bound_vars);
+            }
+        }
+    }
+
+    void count_premise_vars(const statement& stmt, std::vector<const variable*>& bound_vars) {  // NOLINT(misc-no-recursion)
+        if (stmt.is_var()) {
+            if (std::find(bound_vars.begin(), bound_vars.end(), stmt.as_var().get()) == bound_vars.end()) {
+                premise_var_counts[{stmt.as_var().get(), true}] += 1;
+            }
+        } else if (stmt.is_neg()) {
+            count_premise_vars(*stmt.as_neg().inner, bound_vars);
+        } else if (stmt.is_implies()) {
+            count_premise_vars(*stmt.as_implies().from, bound_vars);
+            count_premise_vars(*stmt.as_implies().to, bound_vars);
+        } else if (stmt.is_equiv()) {
+            count_premise_vars(*stmt.as_equiv().left, bound_vars);
+            count_premise_vars(*stmt.as_equiv().right, bound_vars);
+        } else if (stmt.is_conj() || stmt.is_disj()) {
+            for (const auto& term: stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner) {
+                count_premise_vars(*term, bound_vars);
+            }
+        } else if (stmt.is_forall()) {
+            bound_vars.push_back(stmt.as_forall().var.get());
+            count_premise_vars(*stmt.as_forall().inner, bound_vars);
+            bound_vars.pop_back();
+        } else if (stmt.is_rel()) {
+            count_premise_vars(*stmt.as_rel().left, bound_vars);
+            count_premise_vars(*stmt.as_rel().right, bound_vars);
+        }
+    }
+
+    // Like apply_vars, every occurrence of a variable in the conclusion is replaced, even when bound by a forall.
+    void collect_conclusion_vars(const expression& expr) {  // NOLINT(misc-no-recursion)
+        if (expr.is_var()) {
+            needed_vars.emplace(expr.as_var().get(), false);
+        } else if (expr.is_binop()) {
+            collect_conclusion_vars(*expr.as_binop().left);
+            collect_conclusion_vars(*expr.as_binop().right);
+        } else {
+            collect_conclusion_vars(*expr.as_call().callee);
+            for (const auto& param: expr.as_call().params) {
+                collect_conclusion_vars(*param);
+            }
+        }
+    }
+
+    void collect_conclusion_vars(const statement& stmt) {  // NOLINT(misc-no-recursion)
+        if (stmt.is_var()) {
+            needed_vars.emplace(stmt.as_var().get(), true);
+        } else if (stmt.is_neg()) {
+            collect_conclusion_vars(*stmt.as_neg().inner);
+        } else if (stmt.is_implies()) {
+            collect_conclusion_vars(*stmt.as_implies().from);
+            collect_conclusion_vars(*stmt.as_implies().to);
+        } else if (stmt.is_equiv()) {
+            collect_conclusion_vars(*stmt.as_equiv().left);
+            collect_conclusion_vars(*stmt.as_equiv().right);
+        } else if (stmt.is_conj() || stmt.is_disj()) {
+            for (const auto& term: stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner) {
+                collect_conclusion_vars(*term);
+            }
+        } else if (stmt.is_forall()) {
+            collect_conclusion_vars(*stmt.as_forall().inner);
+        } else if (stmt.is_rel()) {
+            collect_conclusion_vars(*stmt.as_rel().left);
+            collect_conclusion_vars(*stmt.as_rel().right);
+        }
+    }
+
+    std::string declare_node(bool is_stmt, const std::string& access) {
+        auto name = (is_stmt ? "s" : "e") + std::to_string(num_nodes++);
+        body << "    const auto& " << name << " = " << access << ";\n";
+        return name;
+    }
+
+    void fail_unless(const std::string& condition) {
+        body << "    if (!(" << condition << ")) {\n"
+             << "        return std::nullopt;\n"
+             << "    }\n";
+    }
+
+    void match_var(const variable_ptr& var, bool is_stmt, const std::string& access) {
+        const auto bound_it = std::find_if(bound.begin(), bound.end(), [&](const auto& entry) {
+            return entry.first == var.get();
+        });
+        if (bound_it != bound.end()) {
+            fail_unless("(" + access + ")->is_var() && (" + access + ")->as_var().get() == " + bound_it->second);
+            return;
+        }
+        const var_key key{var.get(), is_stmt};
+        if (premise_var_counts[key] == 1 && !needed_vars.contains(key)) {
+            // Matches anything, and is never looked at again.
+            return;
+        }
+        const auto slot_it = slots.find(key);
+        if (slot_it == slots.end()) {
+            slots.emplace(key, declare_node(is_stmt, access));
+        } else {
+            fail_unless("equals(*" + slot_it->second + ", *" + access + ")");
+        }
+    }
+
+    void match(const expression& expr, const std::string& access) {  // NOLINT(misc-no-recursion)
+        if (expr.is_var()) {
+            match_var(expr.as_var(), false, access);
+            return;
+        }
+        const auto node = declare_node(false, access);
+        if (expr.is_binop()) {
+            const auto& [type, left, right] = expr.as_binop();
+            fail_unless(node + "->is_binop() && " + node + "->as_binop().type == static_cast<binop_type>(" +
+                        std::to_string(static_cast<int>(type)) + ")");
+            match(*left, node + "->as_binop().left");
+            match(*right, node + "->as_binop().right");
+        } else {
+            const auto& [callee, params] = expr.as_call();
+            fail_unless(node + "->is_call() && " + node + "->as_call().params.size() == " + std::to_string(params.size()));
+            match(*callee, node + "->as_call().callee");
+            for (std::size_t i = 0; i < params.size(); i++) {
+                match(*params[i], node + "->as_call().params[" + std::to_string(i) + "]");
+            }
+        }
+    }
+
+    void match(const statement& stmt, const std::string& access) {  // NOLINT(misc-no-recursion)
+        if (stmt.is_var()) {
+            match_var(stmt.as_var(), true, access);
+            return;
+        }
+        const auto node = declare_node(true, access);
+        if (stmt.is_truth()) {
+            fail_unless(node + "->is_truth()");
+        } else if (stmt.is_contradiction()) {
+            fail_unless(node + "->is_contradiction()");
+        } else if (stmt.is_neg()) {
+            fail_unless(node + "->is_neg()");
+            match(*stmt.as_neg().inner, node + "->as_neg().inner");
+        } else if (stmt.is_implies()) {
+            fail_unless(node + "->is_implies()");
+            match(*stmt.as_implies().from, node + "->as_implies().from");
+            match(*stmt.as_implies().to, node + "->as_implies().to");
+        } else if (stmt.is_equiv()) {
+            fail_unless(node + "->is_equiv()");
+            match(*stmt.as_equiv().left, node + "->as_equiv().left");
+            match(*stmt.as_equiv().right, node + "->as_equiv().right");
+        } else if (stmt.is_conj() || stmt.is_disj()) {
+            const auto kind = std::string{stmt.is_conj() ? "conj" : "disj"};
+            const auto& inner = stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner;
+            fail_unless(node + "->is_" + kind + "() && " + node + "->as_" + kind + "().inner.size() == " +
+                        std::to_string(inner.size()));
+            for (std::size_t i = 0; i < inner.size(); i++) {
+                match(*inner[i], node + "->as_" + kind + "().inner[" + std::to_string(i) + "]");
+            }
+        } else if (stmt.is_forall()) {
+            const auto& [var, inner] = stmt.as_forall();
+            if (std::any_of(bound.begin(), bound.end(), [&](const auto& entry) {
+                    return entry.first == var.get();
+                })) {
+                throw std::runtime_error("Invalid statement, forall twice with the same variable");
+            }
+            fail_unless(node + "->is_forall()");
+            bound.emplace_back(var.get(), node + "->as_forall().var.get()");
+            match(*inner, node + "->as_forall().inner");
+            bound.pop_back();
+        } else {
+            const auto& [type, left, right] = stmt.as_rel();
+            fail_unless(node + "->is_rel() && " + node + "->as_rel().type == static_cast<rel_type>(" +
+                        std::to_string(static_cast<int>(type)) + ")");
+            match(*left, node + "->as_rel().left");
+            match(*right, node + "->as_rel().right");
+        }
+    }
+
+    struct built {
+        std::string code;
+        // Whether the code uses nodes of the application, or can be built once.
+        bool depends = false;
+    };
+
+    std::string shared_part(const built& part, std::string_view type) {
+        return part.depends ? part.code : shared.constant(type, part.code);
+    }
+
+    // The code of a part of a node: when the node is built once, so are its parts.
+    std::string part(const built& node_part, bool node_depends, std::string_view type) {
+        return node_depends ? shared_part(node_part, type) : node_part.code;
+    }
+
+    built build(const expression& expr) {  // NOLINT(misc-no-recursion)
+        if (expr.is_var()) {
+            const auto it = slots.find({expr.as_var().get(), false});
+            if (it != slots.end()) {
+                return {it->second, true};
+            }
+            return {"var_expr(" + shared.var_name(expr.as_var()) + ")", false};
+        }
+        if (expr.is_binop()) {
+            const auto& [type, left, right] = expr.as_binop();
+            const auto l = build(*left);
+            const auto r = build(*right);
+            const auto depends = l.depends || r.depends;
+            return {"binop(" + part(l, depends, "expr_ptr") + ", static_cast<binop_type>(" +
+                            std::to_string(static_cast<int>(type)) + "), " + part(r, depends, "expr_ptr") + ")",
+                    depends};
+        }
+        const auto& [callee, params] = expr.as_call();
+        const auto c = build(*callee);
+        std::vector<built> ps;
+        bool depends = c.depends;
+        for (const auto& param: params) {
+            ps.push_back(build(*param));
+            depends = depends || ps.back().depends;
+        }
+        std::string code = "call(" + part(c, depends, "expr_ptr") + ", std::vector<expr_ptr>{";
+        for (std::size_t i = 0; i < ps.size(); i++) {
+            code += (i == 0 ? "" : ", ") + part(ps[i], depends, "expr_ptr");
+        }
+        return {code + "})", depends};
+    }
+
+    built build(const statement& stmt) {  // NOLINT(misc-no-recursion)
+        if (stmt.is_truth()) {
+            return {"truth()", false};
+        }
+        if (stmt.is_contradiction()) {
+            return {"contradiction()", false};
+        }
+        if (stmt.is_var()) {
+            const auto it = slots.find({stmt.as_var().get(), true});
+            if (it != slots.end()) {
+                return {it->second, true};
+            }
+            return {"var_stmt(" + shared.var_name(stmt.as_var()) + ")", false};
+        }
+        if (stmt.is_neg()) {
+            const auto inner = build(*stmt.as_neg().inner);
+            return {"neg(" + inner.code + ")", inner.depends};
+        }
+        if (stmt.is_implies() || stmt.is_equiv()) {
+            const auto l = build(stmt.is_implies() ? *stmt.as_implies().from : *stmt.as_equiv().left);
+            const auto r = build(stmt.is_implies() ? *stmt.as_implies().to : *stmt.as_equiv().right);
+            const auto depends = l.depends || r.depends;
+            return {std::string{stmt.is_implies() ? "implies(" : "equiv("} + part(l, depends, "statement_ptr") + ", " +
+                            part(r, depends, "statement_ptr") + ")",
+                    depends};
+        }
+        if (stmt.is_conj() || stmt.is_disj()) {
+            std::vector<built> parts;
+            bool depends = false;
+            for (const auto& term: stmt.is_conj() ? stmt.as_conj().inner : stmt.as_disj().inner) {
+                parts.push_back(build(*term));
+                depends = depends || parts.back().depends;
+            }
+            std::string code = stmt.is_conj() ? "conj(std::vector<statement_ptr>{" : "disj(std::vector<statement_ptr>{";
+            for (std::size_t i = 0; i < parts.size(); i++) {
+                code += (i == 0 ? "" : ", ") + part(parts[i], depends, "statement_ptr");
+            }
+            return {code + "})", depends};
+        }
+        if (stmt.is_forall()) {
+            const auto& [var, inner] = stmt.as_forall();
+            const auto built_inner = build(*inner);
+            if (slots.contains({var.get(), true}) || slots.contains({var.get(), false})) {
+                // apply_vars drops the forall of a replaced variable.
+                return built_inner;
+            }
+            return {"forall(" + shared.var_name(var) + ", " + built_inner.code + ")", built_inner.depends};
+        }
+        const auto& [type, left, right] = stmt.as_rel();
+        const auto l = build(*left);
+        const auto r = build(*right);
+        const auto depends = l.depends || r.depends;
+        return {"rel_stmt(" + part(l, depends, "expr_ptr") + ", static_cast<rel_type>(" +
+                        std::to_string(static_cast<int>(type)) + "), " + part(r, depends, "expr_ptr") + ")",
+                depends};
+    }
+
+public:
+    explicit direction_writer(shared_declarations& shared): shared(shared) {}
+
+    // The body of a function "application -> optional<statement_ptr>".
+    std::string write(const statement& premise, const statement& conclusion) {
+        std::vector<const variable*> bound_vars;
+        count_premise_vars(premise, bound_vars);
+        collect_conclusion_vars(conclusion);
+        for (const auto& [key, count]: premise_var_counts) {
+            if (count > 1) {
+                needed_vars.insert(key);
+            }
+        }
+        match(premise, "application");
+        const auto result = build(conclusion);
+        body << "    return " << (result.depends ? result.code : shared.constant("statement_ptr", result.code)) << ";\n";
+        return body.str();
+    }
+};
+
+}  // namespace
+
+std::string generate_matchers_header(const matcher_codegen_options& options) {
+    std::ostringstream out;
+    out << "// Generated by tema_matcher_codegen. Do not edit.\n"
+        << "#pragma once\n\n"
+        << "#include <span>\n\n"
+        << "#include \"algorithms/generated_law.h\"\n\n"
+        << "namespace tema::" << options.name_space << " {\n\n"
+        << "// The laws of the module, sorted by name.\n"
+        << "[[nodiscard]] std::span<const generated_law> laws();\n\n"
+        << "}  // namespace tema::" << options.name_space << "\n";
+    return out.str();
+}
+
+std::string generate_matchers_source(const module& mod, const matcher_codegen_options& options) {
+    shared_declarations shared;
+    std::ostringstream functions;
+    std::vector<std::pair<std::string, std::string>> registry;  // (law name, function)
+    for (const auto& decl: mod.get_decls()) {
+        if (!std::holds_alternative<stmt_decl>(decl)) {
+            continue;
+        }
+        const auto& [loc, exported, type, name, stmt, proof] = std::get<stmt_decl>(decl);
+        if (!stmt->is_implies() && !stmt->is_equiv()) {
+            continue;
+        }
+        const auto function = "law_" + std::to_string(registry.size());
+        // The directions tried by mp_deduce, in order.
+        std::vector<std::pair<const statement*, const statement*>> directions;
+        if (stmt->is_implies()) {
+            directions.emplace_back(stmt->as_implies().from.get(), stmt->as_implies().to.get());
+        } else {
+            directions.emplace_back(stmt->as_equiv().left.get(), stmt->as_equiv().right.get());
+            directions.emplace_back(stmt->as_equiv().right.get(), stmt->as_equiv().left.get());
+        }
+        functions << "// " << name << " (line " << loc.line << "): " << print_utf8(*stmt) << "\n";
+        for (std::size_t i = 0; i < directions.size(); i++) {
+            functions << "std::optional<statement_ptr> " << function << "_" << i
+                      << "([[maybe_unused]] const statement_ptr& application) {\n"
+                      << direction_writer(shared).write(*directions[i].first, *directions[i].second) << "}\n\n";
+        }
+        functions << "std::optional<statement_ptr> " << function << "(const statement_ptr& application) {\n";
+        if (directions.size() == 1) {
+            functions << "    return " << function << "_0(application);\n";
+        } else {
+            functions << "    if (auto result = " << function << "_0(application)) {\n"
+                      << "        return result;\n"
+                      << "    }\n"
+                      << "    return " << function << "_1(application);\n";
+        }
+        functions << "}\n\n";
+        registry.emplace_back(name, function);
+    }
+    std::stable_sort(registry.begin(), registry.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    std::ostringstream out;
+    out << "// Generated by tema_matcher_codegen from " << mod.get_file_name() << ". Do not edit.\n"
+        << "#include \"" << options.header_include << "\"\n\n"
+        << "#include <array>\n"
+        << "#include <optional>\n"
+        << "#include <vector>\n\n"
+        << "#include \"algorithms/equals.h\"\n\n"
+        << "namespace tema::" << options.name_space << " {\n\n"
+        << "namespace {\n\n"
+        << shared.code.str() << (shared.code.tellp() > 0 ? "\n" : "")
+        << functions.str()
+        << "const std::array<generated_law, " << registry.size() << "> registry{{\n";
+    for (const auto& [name, function]: registry) {
+        out << "        {\"" << escape(name) << "\", " << function << "},\n";
+    }
+    out << "}};\n\n"
+        << "}  // namespace\n\n"
+        << "std::span<const generated_law> laws() {\n"
+        << "    return registry;\n"
+        << "}\n\n"
+        << "}  // namespace tema::" << options.name_space << "\n";
+    return out.str();
+}
+
+}  // namespace tema
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+#include "core/module.h"
+
+namespace tema {
+
+struct matcher_codegen_options {
+    // The namespace of the generated code, nested in namespace tema.
+    std::string name_space;
+    // The path by which the generated source includes the generated header.
+    std::string header_include;
+};
+
+// C++ code with one function per law of a module (every statement declaration that is an implication or an
+// equivalence), equivalent to mp_deduce with the law, but with the matching and the building of the conclusion
+// inlined for the law. The header declares laws(), the registry of the generated functions sorted by law name (see
+// algorithms/generated_law.h). The generated code has its own variables, one per variable of the module, which take the
+// place of the module's variables in conclusions that use them without binding them by matching.
+[[nodiscard]] std::string generate_matchers_header(const matcher_codegen_options& options);
+[[nodiscard]] std::string generate_matchers_source(const module& mod, const matcher_codegen_options& options);
+
+}  // namespace tema
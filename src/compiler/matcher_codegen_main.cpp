@@ -0,0 +1,17 @@
+#include <iostream>
+
+#include "compiler/codegen_tool.h"
+#include "compiler/matcher_codegen.h"
+
+int main(int argc, char** argv) {
+    return tema::run_codegen_tool(
+            {argv, static_cast<std::size_t>(argc)},
+            std::cerr,
+            [](const tema::module& mod, const std::string& name_space, const std::string& header_include) {
+                const tema::matcher_codegen_options options{name_space, header_include};
+                return tema::generated_code{
+                        .header = tema::generate_matchers_header(options),
+                        .source = tema::generate_matchers_source(mod, options),
+                };
+            });
+}
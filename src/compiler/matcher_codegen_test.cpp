@@ -0,0 +1,85 @@
+#include "compiler/matcher_codegen.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "compiler/parser.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+namespace {
+
+bool contains(const std::string& text, std::string_view part) {
+    return text.find(part) != std::string::npos;
+}
+
+std::size_t count(const std::string& text, std::string_view part) {
+    std::size_t num = 0;
+    for (auto pos = text.find(part); pos != std::string::npos; pos = text.find(part, pos + 1)) {
+        num += 1;
+    }
+    return num;
+}
+
+}  // namespace
+
+TEST_CASE("compiler.matcher_codegen") {
+    const matcher_codegen_options options{"test_laws", "generated/test_laws.h"};
+
+    test("header declares the registry in the namespace", [&] {
+        const auto header = generate_matchers_header(options);
+        expect(contains(header, "#pragma once"), isTrue);
+        expect(contains(header, "namespace tema::test_laws {"), isTrue);
+        expect(contains(header, "std::span<const generated_law> laws();"), isTrue);
+    });
+
+    test("one function per implication or equivalence", [&] {
+        const auto source = generate_matchers_source(parse_module(R"(
+var p
+var q
+definition "Truth" ⊤
+theorem "Modus Ponens" (p∧(p→q))→q
+proof missing
+theorem "Double negation" ¬¬p⟷p
+proof missing
+)"),
+                                                     options);
+        expect(contains(source, "#include \"generated/test_laws.h\""), isTrue);
+        // The implication has one direction, the equivalence has two.
+        expect(contains(source, "law_0_0("), isTrue);
+        expect(contains(source, "law_0_1("), isFalse);
+        expect(contains(source, "law_1_0("), isTrue);
+        expect(contains(source, "law_1_1("), isTrue);
+        expect(contains(source, "law_2"), isFalse);
+        // p is repeated in the premise of Modus Ponens.
+        expect(count(source, "equals("), isEqualTo(1U));
+        // Sorted by name.
+        expect(source.find("{\"Double negation\", law_1}") < source.find("{\"Modus Ponens\", law_0}"), isTrue);
+    });
+
+    test("conclusions that don't depend on the application are built once", [&] {
+        const auto source = generate_matchers_source(parse_module(R"(
+var p
+var q
+theorem "T" p→(q→q)
+proof missing
+)"),
+                                                     options);
+        expect(contains(source, "const variable_ptr var_0 = var(\"q\");"), isTrue);
+        expect(contains(source, "const statement_ptr constant_0 = implies(var_stmt(var_0), var_stmt(var_0));"),
+               isTrue);
+        expect(contains(source, "return constant_0;"), isTrue);
+    });
+
+    test("names are escaped", [&] {
+        const auto source = generate_matchers_source(parse_module(R"(
+var p
+theorem "Quote \" and backslash \\" p→p
+proof missing
+)"),
+                                                     options);
+        // The name keeps the escapes of the module, which are escaped again in C++.
+        expect(contains(source, R"({"Quote \\\" and backslash \\\\", law_0})"), isTrue);
+    });
+}
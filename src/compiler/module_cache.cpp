@@ -0,0 +1,137 @@
+#include "compiler/module_cache.h"
+
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "compiler/compiled_module.h"
+
+namespace tema {
+
+namespace {
+
+// Incremented when the key or the contents of the entries change in a way the versions of the formats don't cover.
+constexpr std::uint32_t cache_version = 1;
+
+// Two independent 64-bit hashes of the key, so that the 128-bit name of an entry is practically collision-free.
+struct key_hasher {
+    std::uint64_t fnv = 0xcbf29ce484222325ULL;
+    std::uint64_t mix = 0x9e3779b97f4a7c15ULL;
+
+    void add(std::string_view bytes) {
+        for (const auto ch: bytes) {
+            const auto byte = static_cast<std::uint8_t>(ch);
+            fnv = (fnv ^ byte) * 0x100000001b3ULL;
+            mix = (mix ^ byte) * 0xff51afd7ed558ccdULL;
+            mix ^= mix >> 29U;
+        }
+    }
+
+    void add(std::uint64_t value) {
+        std::array<char, 8> bytes{};
+        for (std::size_t i = 0; i < bytes.size(); i++) {
+            bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFFU);
+        }
+        add(std::string_view{bytes.data(), bytes.size()});
+    }
+
+    // Prefixed with its size, so that the fields of the key can't run into each other.
+    void add_field(std::string_view bytes) {
+        add(std::uint64_t{bytes.size()});
+        add(bytes);
+    }
+
+    [[nodiscard]] std::string hex() const {
+        constexpr std::string_view digits = "0123456789abcdef";
+        std::string result;
+        for (const auto value: {fnv, mix}) {
+            for (int shift = 60; shift >= 0; shift -= 4) {
+                result += digits[(value >> shift) & 0xFU];
+            }
+        }
+        return result;
+    }
+};
+
+std::string read_file(const std::filesystem::path& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("Could not open " + path.string());
+    }
+    std::ostringstream contents;
+    contents << stream.rdbuf();
+    return std::move(contents).str();
+}
+
+std::string temporary_suffix() {
+    thread_local std::mt19937_64 generator{std::random_device{}()};
+    return ".tmp." + std::to_string(getpid()) + "." + std::to_string(generator());
+}
+
+}  // namespace
+
+module_cache::module_cache(std::filesystem::path directory, const parse_options& options)
+    : directory(std::move(directory)), options(options) {}
+
+std::filesystem::path module_cache::entry_path(std::string_view contents,
+                                               const std::filesystem::path& module_path) const {
+    key_hasher hasher;
+    hasher.add(cache_version);
+    hasher.add(module_image_version);
+    hasher.add(compiled_module_version);
+    hasher.add(std::uint64_t{options.canonical});
+    hasher.add_field(module_path.string());
+    hasher.add_field(contents);
+    return directory / (hasher.hex() + std::string{compiled_module_extension});
+}
+
+module module_cache::load(const std::filesystem::path& module_path) {
+    const auto contents = read_file(module_path);
+    const auto entry = entry_path(contents, module_path);
+
+    try {
+        const auto file = compiled_module_file::open(entry);
+        if (file.size() == 1) {
+            auto view = file.view(0);
+            if (view.file_name() == module_path.string()) {
+                auto mod = view.load();
+                hits += 1;
+                return mod;
+            }
+        }
+    } catch (const std::exception&) {
+        // Missing, or written by something else than this cache: parse the module and replace the entry.
+    }
+
+    std::istringstream stream(contents);
+    auto mod = parse_module(stream, module_path, options);
+    misses += 1;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    auto temporary = entry;
+    temporary += temporary_suffix();
+    try {
+        const std::array<const module*, 1> modules{&mod};
+        save_compiled_modules(temporary, modules);
+        std::filesystem::rename(temporary, entry);
+    } catch (const std::exception&) {
+        std::filesystem::remove(temporary, error);
+    }
+    return mod;
+}
+
+std::size_t module_cache::num_hits() const {
+    return hits;
+}
+
+std::size_t module_cache::num_misses() const {
+    return misses;
+}
+
+}  // namespace tema
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+#include "compiler/parser.h"
+#include "core/module.h"
+
+namespace tema {
+
+// An on-disk cache of parsed modules, shared by any number of processes. Each entry is a compiled module file (see
+// compiler/compiled_module.h), named after a hash of everything the parsed module depends on: the file name, the
+// contents, the parse options and the versions of the formats. A changed module or a new format version therefore
+// never reads a stale entry, it just misses.
+//
+// Entries are written to a temporary file that is then renamed over the entry, so readers only ever see complete
+// entries, and a reader that mapped an entry keeps its contents even if another process replaces it.
+class module_cache {
+    std::filesystem::path directory;
+    parse_options options;
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+
+    [[nodiscard]] std::filesystem::path entry_path(std::string_view contents,
+                                                   const std::filesystem::path& module_path) const;
+
+public:
+    explicit module_cache(std::filesystem::path directory, const parse_options& options = {});
+
+    // The parsed module, read from the cache without lexing or parsing it when it was cached before, or parsed and
+    // then cached. Throws parse_error like parse_module, and std::runtime_error when the module can't be read. The
+    // cache itself is best-effort: when an entry can't be read or written, the module is parsed instead.
+    [[nodiscard]] module load(const std::filesystem::path& module_path);
+
+    [[nodiscard]] std::size_t num_hits() const;
+    [[nodiscard]] std::size_t num_misses() const;
+};
+
+}  // namespace tema
@@ -0,0 +1,123 @@
+#include "compiler/module_cache.h"
+
+#include <fstream>
+#include <optional>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/print_utf8.h"
+#include "compiler/temporary_directory.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+namespace {
+
+void write_file(const std::filesystem::path& path, std::string_view contents) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << contents;
+}
+
+std::size_t count_files(const std::filesystem::path& directory) {
+    std::size_t count = 0;
+    for ([[maybe_unused]] const auto& entry: std::filesystem::directory_iterator(directory)) {
+        count += 1;
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST_CASE("compiler.module_cache") {
+    std::optional<temporary_directory> root;
+    std::filesystem::path cache_dir;
+    std::filesystem::path module_path;
+
+    setUp([&] {
+        root.emplace("tema_module_cache_test");
+        cache_dir = root->path() / "cache";
+        module_path = root->path() / "laws.tema";
+        write_file(module_path, R"(
+var p
+var q
+theorem "Modus Ponens" (p∧(p→q))→q
+proof missing
+)");
+    });
+
+    tearDown([&] {
+        root.reset();
+    });
+
+    test("second load is read from the cache", [&] {
+        module_cache cache(cache_dir);
+        const auto parsed = cache.load(module_path);
+        const auto cached = cache.load(module_path);
+        expect(cache.num_misses(), isEqualTo(1U));
+        expect(cache.num_hits(), isEqualTo(1U));
+        expect(cached.get_name(), isEqualTo("laws"));
+        expect(cached.get_file_name(), isEqualTo(module_path.string()));
+        expect(print_utf8(*std::get<stmt_decl>(cached.get_decls()[2]).stmt),
+               isEqualTo(print_utf8(*std::get<stmt_decl>(parsed.get_decls()[2]).stmt)));
+        // No temporary files are left behind.
+        expect(count_files(cache_dir), isEqualTo(1U));
+    });
+
+    test("entries are shared between caches on the same directory", [&] {
+        (void)module_cache(cache_dir).load(module_path);
+        module_cache cache(cache_dir);
+        (void)cache.load(module_path);
+        expect(cache.num_hits(), isEqualTo(1U));
+    });
+
+    test("changed contents miss", [&] {
+        module_cache cache(cache_dir);
+        (void)cache.load(module_path);
+        write_file(module_path, "var p\ntheorem \"Identity\" p→p\nproof missing\n");
+        const auto mod = cache.load(module_path);
+        expect(cache.num_misses(), isEqualTo(2U));
+        expect(std::get<stmt_decl>(mod.get_decls()[1]).name, isEqualTo("Identity"));
+    });
+
+    test("different parse options miss", [&] {
+        (void)module_cache(cache_dir).load(module_path);
+        module_cache canonical_cache(cache_dir, parse_options{.canonical = true});
+        (void)canonical_cache.load(module_path);
+        expect(canonical_cache.num_misses(), isEqualTo(1U));
+    });
+
+    test("corrupted entries are replaced", [&] {
+        (void)module_cache(cache_dir).load(module_path);
+        for (const auto& entry: std::filesystem::directory_iterator(cache_dir)) {
+            write_file(entry.path(), "garbage");
+        }
+        module_cache cache(cache_dir);
+        (void)cache.load(module_path);
+        (void)cache.load(module_path);
+        expect(cache.num_misses(), isEqualTo(1U));
+        expect(cache.num_hits(), isEqualTo(1U));
+    });
+
+    test("unusable cache directory falls back to parsing", [&] {
+        write_file(cache_dir, "not a directory");
+        module_cache cache(cache_dir);
+        const auto mod = cache.load(module_path);
+        (void)cache.load(module_path);
+        expect(mod.get_decls(), hasSize(3U));
+        expect(cache.num_misses(), isEqualTo(2U));
+    });
+
+    test("parse errors are not cached", [&] {
+        write_file(module_path, "theorem");
+        module_cache cache(cache_dir);
+        expect([&] { (void)cache.load(module_path); }, throwsA<parse_error>);
+        expect([&] { (void)cache.load(module_path); }, throwsA<parse_error>);
+        expect(std::filesystem::exists(cache_dir), isFalse);
+    });
+
+    test("missing modules throw", [&] {
+        module_cache cache(cache_dir);
+        expect([&] { (void)cache.load(root->path() / "missing.tema"); }, throwsA<std::runtime_error>);
+    });
+}
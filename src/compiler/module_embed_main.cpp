@@ -0,0 +1,18 @@
+#include <iostream>
+
+#include "compiler/codegen_tool.h"
+#include "compiler/module_image.h"
+
+int main(int argc, char** argv) {
+    return tema::run_codegen_tool(
+            {argv, static_cast<std::size_t>(argc)},
+            std::cerr,
+            [](const tema::module& mod, const std::string& name_space, const std::string& header_include) {
+                const auto image = tema::write_module_image(mod);
+                const tema::module_embed_options options{name_space, header_include};
+                return tema::generated_code{
+                        .header = tema::generate_embedded_module_header(options),
+                        .source = tema::generate_embedded_module_source(image, options),
+                };
+            });
+}
@@ -0,0 +1,565 @@
+#include "compiler/module_image.h"
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+namespace tema {
+
+namespace {
+
+constexpr std::uint32_t image_magic = 0x494D4554;  // "TEMI"
+
+enum class node_kind : std::uint8_t {
+    truth = 0,
+    contradiction = 1,
+    implies = 2,
+    equiv = 3,
+    neg = 4,
+    conj = 5,
+    disj = 6,
+    forall = 7,
+    stmt_var = 8,
+    rel = 9,
+    expr_var = 10,
+    binop = 11,
+    call = 12,
+};
+
+constexpr std::uint32_t num_node_kinds = 13;
+
+bool is_expr_kind(node_kind kind) {
+    return kind >= node_kind::expr_var;
+}
+
+// The sizes, in 32-bit words, of the header and of the records of the tables.
+constexpr std::size_t header_words = 14;
+constexpr std::size_t string_words = 2;  // offset, size
+constexpr std::size_t var_words = 1;     // name
+constexpr std::size_t node_words = 3;    // kind | type << 8, first operand, number of operands
+constexpr std::size_t decl_words = 5;    // kind | exported << 8 | stmt_decl_type << 16 | has proof << 24, line, col, a, b
+
+enum class decl_kind : std::uint8_t {
+    var = 0,
+    stmt = 1,
+};
+
+class image_writer {
+    std::vector<std::uint32_t> strings;  // offset, size, relative to the string bytes
+    std::string string_bytes;
+    std::map<std::string, std::uint32_t, std::less<>> string_indices;
+    std::vector<std::uint32_t> vars;
+    std::map<const variable*, std::uint32_t> var_indices;
+    std::vector<std::uint32_t> nodes;
+    std::vector<std::uint32_t> operands;
+    std::map<const void*, std::uint32_t> node_indices;
+    std::map<std::vector<std::uint32_t>, std::uint32_t> structural_indices;
+    std::vector<std::uint32_t> decls;
+
+    std::uint32_t add_string(std::string_view str) {
+        const auto it = string_indices.find(str);
+        if (it != string_indices.end()) {
+            return it->second;
+        }
+        const auto index = static_cast<std::uint32_t>(strings.size() / string_words);
+        strings.push_back(static_cast<std::uint32_t>(string_bytes.size()));
+        strings.push_back(static_cast<std::uint32_t>(str.size()));
+        string_bytes += str;
+        string_indices.emplace(std::string{str}, index);
+        return index;
+    }
+
+    std::uint32_t add_var(const variable_ptr& var) {
+        const auto it = var_indices.find(var.get());
+        if (it != var_indices.end()) {
+            return it->second;
+        }
+        const auto index = static_cast<std::uint32_t>(vars.size());
+        vars.push_back(add_string(var->name));
+        var_indices.emplace(var.get(), index);
+        return index;
+    }
+
+    std::uint32_t add_node(node_kind kind, std::uint32_t type, const std::vector<std::uint32_t>& node_operands) {
+        // The operands are already deduplicated, so structurally equal nodes have equal keys.
+        std::vector<std::uint32_t> key{static_cast<std::uint32_t>(kind) | (type << 8)};
+        key.insert(key.end(), node_operands.begin(), node_operands.end());
+        const auto next_index = static_cast<std::uint32_t>(nodes.size() / node_words);
+        const auto [it, inserted] = structural_indices.emplace(std::move(key), next_index);
+        if (!inserted) {
+            return it->second;
+        }
+        nodes.push_back(static_cast<std::uint32_t>(kind) | (type << 8));
+        nodes.push_back(static_cast<std::uint32_t>(operands.size()));
+        nodes.push_back(static_cast<std::uint32_t>(node_operands.size()));
+        operands.insert(operands.end(), node_operands.begin(), node_operands.end());
+        return next_index;
+    }
+
+    std::uint32_t add(const expr_ptr& expr) {  // NOLINT(misc-no-recursion)
+        const auto it = node_indices.find(expr.get());
+        if (it != node_indices.end()) {
+            return it->second;
+        }
+        std::uint32_t index = 0;
+        if (expr->is_var()) {
+            index = add_node(node_kind::expr_var, 0, {add_var(expr->as_var())});
+        } else if (expr->is_binop()) {
+            const auto& [type, left, right] = expr->as_binop();
+            index = add_node(node_kind::binop, static_cast<std::uint32_t>(type), {add(left), add(right)});
+        } else {
+            const auto& [callee, params] = expr->as_call();
+            std::vector<std::uint32_t> node_operands{add(callee)};
+            for (const auto& param: params) {
+                node_operands.push_back(add(param));
+            }
+            index = add_node(node_kind::call, 0, node_operands);
+        }
+        node_indices.emplace(expr.get(), index);
+        return index;
+    }
+
+    std::uint32_t add(const statement_ptr& stmt) {  // NOLINT(misc-no-recursion)
+        const auto it = node_indices.find(stmt.get());
+        if (it != node_indices.end()) {
+            return it->second;
+        }
+        std::uint32_t index = 0;
+        if (stmt->is_truth()) {
+            index = add_node(node_kind::truth, 0, {});
+        } else if (stmt->is_contradiction()) {
+            index = add_node(node_kind::contradiction, 0, {});
+        } else if (stmt->is_implies()) {
+            index = add_node(node_kind::implies, 0, {add(stmt->as_implies().from), add(stmt->as_implies().to)});
+        } else if (stmt->is_equiv()) {
+            index = add_node(node_kind::equiv, 0, {add(stmt->as_equiv().left), add(stmt->as_equiv().right)});
+        } else if (stmt->is_neg()) {
+            index = add_node(node_kind::neg, 0, {add(stmt->as_neg().inner)});
+        } else if (stmt->is_conj() || stmt->is_disj()) {
+            std::vector<std::uint32_t> node_operands;
+            for (const auto& term: stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner) {
+                node_operands.push_back(add(term));
+            }
+            index = add_node(stmt->is_conj() ? node_kind::conj : node_kind::disj, 0, node_operands);
+        } else if (stmt->is_forall()) {
+            const auto var_index = add_var(stmt->as_forall().var);
+            index = add_node(node_kind::forall, 0, {var_index, add(stmt->as_forall().inner)});
+        } else if (stmt->is_var()) {
+            index = add_node(node_kind::stmt_var, 0, {add_var(stmt->as_var())});
+        } else {
+            const auto& [type, left, right] = stmt->as_rel();
+            index = add_node(node_kind::rel, static_cast<std::uint32_t>(type), {add(left), add(right)});
+        }
+        node_indices.emplace(stmt.get(), index);
+        return index;
+    }
+
+    static void append(std::vector<std::byte>& image, std::uint32_t word) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            image.push_back(static_cast<std::byte>((word >> shift) & 0xFFU));
+        }
+    }
+
+public:
+    void add(const decl& declaration) {
+        if (std::holds_alternative<var_decl>(declaration)) {
+            const auto& [loc, exported, var] = std::get<var_decl>(declaration);
+            decls.push_back(static_cast<std::uint32_t>(decl_kind::var) | (exported ? 1U << 8 : 0U));
+            decls.push_back(static_cast<std::uint32_t>(loc.line));
+            decls.push_back(static_cast<std::uint32_t>(loc.col));
+            decls.push_back(add_var(var));
+            decls.push_back(0);
+        } else {
+            const auto& [loc, exported, type, name, stmt, proof] = std::get<stmt_decl>(declaration);
+            if (proof.has_value() && (!proof->own_vars().empty() || !proof->own_statements().empty())) {
+                throw module_format_error("Statement proofs are not supported in module images");
+            }
+            decls.push_back(static_cast<std::uint32_t>(decl_kind::stmt) | (exported ? 1U << 8 : 0U) |
+                            (static_cast<std::uint32_t>(type) << 16) | (proof.has_value() ? 1U << 24 : 0U));
+            decls.push_back(static_cast<std::uint32_t>(loc.line));
+            decls.push_back(static_cast<std::uint32_t>(loc.col));
+            decls.push_back(add_string(name));
+            decls.push_back(add(stmt));
+        }
+    }
+
+    [[nodiscard]] std::vector<std::byte> write(std::string_view name, std::string_view file_name) {
+        const auto name_index = add_string(name);
+        const auto file_name_index = add_string(file_name);
+
+        // The tables follow the header, in order, then the string bytes.
+        const std::vector<std::pair<std::size_t, const std::vector<std::uint32_t>*>> tables = {
+                {string_words, &strings},
+                {var_words, &vars},
+                {node_words, &nodes},
+                {1, &operands},
+                {decl_words, &decls},
+        };
+        std::vector<std::uint32_t> header{image_magic, module_image_version, name_index, file_name_index};
+        auto offset = header_words * 4;
+        for (const auto& [words, table]: tables) {
+            header.push_back(static_cast<std::uint32_t>(table->size() / words));
+            header.push_back(static_cast<std::uint32_t>(offset));
+            offset += table->size() * 4;
+        }
+        // The string offsets are relative to the start of the image.
+        for (std::size_t i = 0; i < strings.size(); i += string_words) {
+            strings[i] += static_cast<std::uint32_t>(offset);
+        }
+
+        std::vector<std::byte> image;
+        image.reserve(offset + string_bytes.size());
+        for (const auto word: header) {
+            append(image, word);
+        }
+        for (const auto& [words, table]: tables) {
+            for (const auto word: *table) {
+                append(image, word);
+            }
+        }
+        for (const auto ch: string_bytes) {
+            image.push_back(static_cast<std::byte>(ch));
+        }
+        return image;
+    }
+};
+
+}  // namespace
+
+std::vector<std::byte> write_module_image(const module& mod) {
+    image_writer writer;
+    for (const auto& declaration: mod.get_decls()) {
+        writer.add(declaration);
+    }
+    return writer.write(mod.get_name(), mod.get_file_name());
+}
+
+std::uint32_t module_image_view::word(std::size_t offset) const {
+    if (offset + 4 > image.size()) {
+        throw module_format_error("Truncated module image");
+    }
+    std::uint32_t value = 0;
+    for (std::size_t i = 0; i < 4; i++) {
+        value |= static_cast<std::uint32_t>(image[offset + i]) << (8 * i);
+    }
+    return value;
+}
+
+std::uint32_t module_image_view::field(const table& t, std::size_t words, std::uint32_t index, std::size_t f) const {
+    if (index >= t.count) {
+        throw module_format_error("Invalid reference in module image");
+    }
+    return word(t.offset + (index * words + f) * 4);
+}
+
+module_image_view::table module_image_view::read_table(std::size_t header_index, std::size_t words) const {
+    const table t{word(header_index * 4), word((header_index + 1) * 4)};
+    if (t.offset + std::size_t{t.count} * words * 4 > image.size()) {
+        throw module_format_error("Truncated module image");
+    }
+    return t;
+}
+
+std::string_view module_image_view::string(std::uint32_t index) const {
+    const auto offset = field(strings, string_words, index, 0);
+    const auto size = field(strings, string_words, index, 1);
+    if (std::size_t{offset} + size > image.size()) {
+        throw module_format_error("Truncated module image");
+    }
+    const auto* data = reinterpret_cast<const char*>(image.data());  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    return {data + offset, size};
+}
+
+std::uint32_t module_image_view::decl_field(std::size_t index, std::size_t f) const {
+    if (index >= decls.count) {
+        throw std::out_of_range("Declaration index out of range");
+    }
+    return field(decls, decl_words, static_cast<std::uint32_t>(index), f);
+}
+
+const variable_ptr& module_image_view::var_at(std::uint32_t index) {
+    if (index >= vars.count) {
+        throw module_format_error("Invalid variable in module image");
+    }
+    if (materialized_vars.empty()) {
+        materialized_vars.resize(vars.count);
+    }
+    if (materialized_vars[index] == nullptr) {
+        materialized_vars[index] = var(string(field(vars, var_words, index, 0)));
+    }
+    return materialized_vars[index];
+}
+
+bool module_image_view::is_materialized(std::uint32_t index) const {
+    return index < stmt_nodes.size() && (stmt_nodes[index] != nullptr || expr_nodes[index] != nullptr);
+}
+
+void module_image_view::materialize_node(std::uint32_t index, const std::vector<std::uint32_t>& ops) {
+    const auto kind_and_type = field(nodes, node_words, index, 0);
+    const auto kind = static_cast<node_kind>(kind_and_type & 0xFFU);
+    const auto type = kind_and_type >> 8;
+    const auto expect_operands = [&](std::size_t n) {
+        if (ops.size() != n) {
+            throw module_format_error("Invalid node in module image");
+        }
+    };
+    const auto stmt_at = [&](std::uint32_t op) -> const statement_ptr& {
+        if (op >= index || stmt_nodes[op] == nullptr) {
+            throw module_format_error("Invalid statement in module image");
+        }
+        return stmt_nodes[op];
+    };
+    const auto expr_at = [&](std::uint32_t op) -> const expr_ptr& {
+        if (op >= index || expr_nodes[op] == nullptr) {
+            throw module_format_error("Invalid expression in module image");
+        }
+        return expr_nodes[op];
+    };
+    if (is_expr_kind(kind)) {
+        if (kind == node_kind::expr_var) {
+            expect_operands(1);
+            expr_nodes[index] = var_expr(var_at(ops[0]));
+        } else if (kind == node_kind::binop) {
+            expect_operands(2);
+            if (type > static_cast<std::uint32_t>(binop_type::set_sym_difference)) {
+                throw module_format_error("Invalid node in module image");
+            }
+            expr_nodes[index] = binop(expr_at(ops[0]), static_cast<binop_type>(type), expr_at(ops[1]));
+        } else {
+            if (ops.empty()) {
+                throw module_format_error("Invalid node in module image");
+            }
+            std::vector<expr_ptr> params;
+            for (std::size_t i = 1; i < ops.size(); i++) {
+                params.push_back(expr_at(ops[i]));
+            }
+            expr_nodes[index] = call(expr_at(ops[0]), std::move(params));
+        }
+        return;
+    }
+    switch (kind) {
+        case node_kind::truth:
+            expect_operands(0);
+            stmt_nodes[index] = truth();
+            break;
+        case node_kind::contradiction:
+            expect_operands(0);
+            stmt_nodes[index] = contradiction();
+            break;
+        case node_kind::implies:
+            expect_operands(2);
+            stmt_nodes[index] = implies(stmt_at(ops[0]), stmt_at(ops[1]));
+            break;
+        case node_kind::equiv:
+            expect_operands(2);
+            stmt_nodes[index] = equiv(stmt_at(ops[0]), stmt_at(ops[1]));
+            break;
+        case node_kind::neg:
+            expect_operands(1);
+            stmt_nodes[index] = neg(stmt_at(ops[0]));
+            break;
+        case node_kind::conj:
+        case node_kind::disj: {
+            std::vector<statement_ptr> inner;
+            for (const auto op: ops) {
+                inner.push_back(stmt_at(op));
+            }
+            stmt_nodes[index] = kind == node_kind::conj ? conj(std::move(inner)) : disj(std::move(inner));
+            break;
+        }
+        case node_kind::forall:
+            expect_operands(2);
+            stmt_nodes[index] = forall(var_at(ops[0]), stmt_at(ops[1]));
+            break;
+        case node_kind::stmt_var:
+            expect_operands(1);
+            stmt_nodes[index] = var_stmt(var_at(ops[0]));
+            break;
+        default: {
+            expect_operands(2);
+            if (type > static_cast<std::uint32_t>(rel_type::n_eq_is_included)) {
+                throw module_format_error("Invalid node in module image");
+            }
+            stmt_nodes[index] = rel_stmt(expr_at(ops[0]), static_cast<rel_type>(type), expr_at(ops[1]));
+        }
+    }
+}
+
+void module_image_view::materialize(std::uint32_t index) {
+    if (index >= nodes.count) {
+        throw module_format_error("Invalid reference in module image");
+    }
+    if (stmt_nodes.empty()) {
+        stmt_nodes.resize(nodes.count);
+        expr_nodes.resize(nodes.count);
+    }
+    // Iterative, so that a deep DAG (or a malformed image) can't overflow the stack. Nodes only refer to earlier nodes,
+    // so there are no cycles.
+    std::vector<std::pair<std::uint32_t, bool>> stack{{index, false}};
+    std::vector<std::uint32_t> ops;
+    while (!stack.empty()) {
+        const auto [node, expanded] = stack.back();
+        stack.pop_back();
+        if (is_materialized(node)) {
+            continue;
+        }
+        const auto kind_and_type = field(nodes, node_words, node, 0);
+        const auto first = field(nodes, node_words, node, 1);
+        const auto count = field(nodes, node_words, node, 2);
+        if ((kind_and_type & 0xFFU) >= num_node_kinds || std::size_t{first} + count > operands.count) {
+            throw module_format_error("Invalid node in module image");
+        }
+        const auto kind = static_cast<node_kind>(kind_and_type & 0xFFU);
+        ops.clear();
+        for (std::uint32_t i = 0; i < count; i++) {
+            ops.push_back(field(operands, 1, first + i, 0));
+        }
+        if (expanded) {
+            materialize_node(node, ops);
+            continue;
+        }
+        stack.emplace_back(node, true);
+        // The first operand of variables and of foralls is a variable, not a node.
+        const auto first_node = kind == node_kind::forall ? 1U : 0U;
+        if (kind == node_kind::stmt_var || kind == node_kind::expr_var) {
+            continue;
+        }
+        for (auto i = first_node; i < ops.size(); i++) {
+            if (ops[i] >= node) {
+                throw module_format_error("Invalid reference in module image");
+            }
+            if (!is_materialized(ops[i])) {
+                stack.emplace_back(ops[i], false);
+            }
+        }
+    }
+}
+
+module_image_view::module_image_view(std::span<const std::byte> image): image(image) {
+    if (image.size() < header_words * 4 || word(0) != image_magic) {
+        throw module_format_error("Not a module image");
+    }
+    if (word(4) != module_image_version) {
+        throw module_format_error("Unsupported module image version " + std::to_string(word(4)));
+    }
+    strings = read_table(4, string_words);
+    vars = read_table(6, var_words);
+    nodes = read_table(8, node_words);
+    operands = read_table(10, 1);
+    decls = read_table(12, decl_words);
+}
+
+std::string_view module_image_view::name() const {
+    return string(word(8));
+}
+
+std::string_view module_image_view::file_name() const {
+    return string(word(12));
+}
+
+std::size_t module_image_view::num_decls() const {
+    return decls.count;
+}
+
+bool module_image_view::is_var_decl(std::size_t index) const {
+    return (decl_field(index, 0) & 0xFFU) == static_cast<std::uint32_t>(decl_kind::var);
+}
+
+std::string_view module_image_view::decl_name(std::size_t index) const {
+    const auto a = decl_field(index, 3);
+    return is_var_decl(index) ? string(field(vars, var_words, a, 0)) : string(a);
+}
+
+file_location module_image_view::decl_location(std::size_t index) const {
+    return {static_cast<int>(decl_field(index, 1)), static_cast<int>(decl_field(index, 2))};
+}
+
+decl module_image_view::get_decl(std::size_t index) {
+    const auto flags = decl_field(index, 0);
+    const bool exported = ((flags >> 8) & 0xFFU) != 0;
+    if ((flags & 0xFFU) == static_cast<std::uint32_t>(decl_kind::var)) {
+        return var_decl{decl_location(index), exported, var_at(decl_field(index, 3))};
+    }
+    if ((flags & 0xFFU) != static_cast<std::uint32_t>(decl_kind::stmt) ||
+        ((flags >> 16) & 0xFFU) > static_cast<std::uint32_t>(stmt_decl_type::exercise)) {
+        throw module_format_error("Invalid declaration in module image");
+    }
+    return stmt_decl{
+            .loc = decl_location(index),
+            .exported = exported,
+            .type = static_cast<stmt_decl_type>((flags >> 16) & 0xFFU),
+            .name = std::string{decl_name(index)},
+            .stmt = get_statement(index),
+            .proof_description = ((flags >> 24) & 0xFFU) != 0 ? std::optional<scope>{scope{}} : std::nullopt,
+    };
+}
+
+statement_ptr module_image_view::get_statement(std::size_t index) {
+    if (is_var_decl(index)) {
+        throw std::invalid_argument("Declaration " + std::to_string(index) + " is not a statement");
+    }
+    const auto node = decl_field(index, 4);
+    materialize(node);
+    if (stmt_nodes[node] == nullptr) {
+        throw module_format_error("Invalid statement in module image");
+    }
+    return stmt_nodes[node];
+}
+
+module module_image_view::load() {
+    module mod(std::string{name()}, std::string{file_name()});
+    for (std::size_t i = 0; i < num_decls(); i++) {
+        auto declaration = get_decl(i);
+        if (std::holds_alternative<var_decl>(declaration)) {
+            mod.add_variable_decl(std::get<var_decl>(std::move(declaration)));
+        } else {
+            mod.add_statement_decl(std::get<stmt_decl>(std::move(declaration)));
+        }
+    }
+    return mod;
+}
+
+module read_module_image(std::span<const std::byte> image) {
+    return module_image_view(image).load();
+}
+
+std::string generate_embedded_module_header(const module_embed_options& options) {
+    std::ostringstream out;
+    out << "// Generated by tema_module_embed. Do not edit.\n"
+        << "#pragma once\n\n"
+        << "#include <cstddef>\n"
+        << "#include <span>\n\n"
+        << "#include \"core/module.h\"\n\n"
+        << "namespace tema::" << options.name_space << " {\n\n"
+        << "// The image of the module (see compiler/module_image.h).\n"
+        << "[[nodiscard]] std::span<const std::byte> module_image();\n\n"
+        << "[[nodiscard]] module load();\n\n"
+        << "}  // namespace tema::" << options.name_space << "\n";
+    return out.str();
+}
+
+std::string generate_embedded_module_source(std::span<const std::byte> image, const module_embed_options& options) {
+    // The array is never empty, and aligned so that the image could be read in place.
+    std::ostringstream out;
+    out << "// Generated by tema_module_embed. Do not edit.\n"
+        << "#include \"" << options.header_include << "\"\n\n"
+        << "#include \"compiler/module_image.h\"\n\n"
+        << "namespace tema::" << options.name_space << " {\n\n"
+        << "namespace {\n\n"
+        << "alignas(8) constexpr unsigned char image_data[" << std::max(image.size(), std::size_t{1}) << "] = {";
+    for (std::size_t i = 0; i < image.size(); i++) {
+        out << (i % 16 == 0 ? "\n    " : " ") << std::to_integer<unsigned>(image[i]) << ",";
+    }
+    out << "\n};\n\n"
+        << "}  // namespace\n\n"
+        << "std::span<const std::byte> module_image() {\n"
+        << "    return std::as_bytes(std::span{image_data}).first(" << image.size() << ");\n"
+        << "}\n\n"
+        << "module load() {\n"
+        << "    return read_module_image(module_image());\n"
+        << "}\n\n"
+        << "}  // namespace tema::" << options.name_space << "\n";
+    return out.str();
+}
+
+}  // namespace tema
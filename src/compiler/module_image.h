@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/module.h"
+
+namespace tema {
+
+struct module_format_error : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// Incremented on every change of the layout of module images, which can't be read by other versions.
+inline constexpr std::uint32_t module_image_version = 1;
+
+// A module serialized into one contiguous, position-independent block of bytes, which can be embedded in an
+// executable and read back without lexing or parsing.
+//
+// All the fields are little-endian 32-bit integers, and references are indices or offsets from the start of the image.
+// After the header come the tables of strings (offset and size of each in the string bytes), of variables (their
+// names), of statement and expression nodes, of node operands and of declarations, then the string bytes. The nodes
+// form a DAG stored in topological order: the operands of a node are earlier nodes (or variables), and structurally
+// equal sub-statements and sub-expressions are stored once, even when the module does not share them.
+[[nodiscard]] std::vector<std::byte> write_module_image(const module& mod);
+
+// A module image read in place, without copying it. The names are views into the image, and the statements of the
+// declarations are built on first access, along with the parts of the DAG they need, then cached. The image must
+// outlive the view and the string views it returns.
+//
+// Variables are created once per view, so the statements share them like the statements of a parsed module do. Not
+// thread-safe: the caches are filled by the accessors.
+class module_image_view {
+    std::span<const std::byte> image;
+
+    struct table {
+        std::uint32_t count;
+        std::uint32_t offset;
+    };
+
+    table strings{};
+    table vars{};
+    table nodes{};
+    table operands{};
+    table decls{};
+
+    std::vector<variable_ptr> materialized_vars;
+    // Every node is either a statement or an expression.
+    std::vector<statement_ptr> stmt_nodes;
+    std::vector<expr_ptr> expr_nodes;
+
+    [[nodiscard]] std::uint32_t word(std::size_t offset) const;
+    [[nodiscard]] std::uint32_t field(const table& t, std::size_t words, std::uint32_t index, std::size_t f) const;
+    [[nodiscard]] table read_table(std::size_t header_index, std::size_t words) const;
+    [[nodiscard]] std::string_view string(std::uint32_t index) const;
+    [[nodiscard]] std::uint32_t decl_field(std::size_t index, std::size_t f) const;
+
+    [[nodiscard]] const variable_ptr& var_at(std::uint32_t index);
+    [[nodiscard]] bool is_materialized(std::uint32_t index) const;
+    void materialize_node(std::uint32_t index, const std::vector<std::uint32_t>& ops);
+    void materialize(std::uint32_t index);
+
+public:
+    // Throws module_format_error when the header or the tables don't fit in the image. The rest is validated as it is
+    // accessed.
+    explicit module_image_view(std::span<const std::byte> image);
+
+    [[nodiscard]] std::string_view name() const;
+    [[nodiscard]] std::string_view file_name() const;
+
+    [[nodiscard]] std::size_t num_decls() const;
+    [[nodiscard]] bool is_var_decl(std::size_t index) const;
+    // The name of the variable or of the statement.
+    [[nodiscard]] std::string_view decl_name(std::size_t index) const;
+    [[nodiscard]] file_location decl_location(std::size_t index) const;
+
+    [[nodiscard]] decl get_decl(std::size_t index);
+    [[nodiscard]] statement_ptr get_statement(std::size_t index);
+
+    // Materializes every declaration.
+    [[nodiscard]] module load();
+};
+
+// Throws module_format_error when the image is not valid.
+[[nodiscard]] module read_module_image(std::span<const std::byte> image);
+
+struct module_embed_options {
+    // The namespace of the generated code, nested in namespace tema.
+    std::string name_space;
+    // The path by which the generated source includes the generated header.
+    std::string header_include;
+};
+
+// C++ code embedding the image of a module in an executable. The header declares module_image(), the bytes of the
+// image, and load(), which reads the module from them.
+[[nodiscard]] std::string generate_embedded_module_header(const module_embed_options& options);
+[[nodiscard]] std::string generate_embedded_module_source(std::span<const std::byte> image,
+                                                          const module_embed_options& options);
+
+}  // namespace tema
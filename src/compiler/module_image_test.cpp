@@ -0,0 +1,166 @@
+#include "compiler/module_image.h"
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/print_utf8.h"
+#include "compiler/parser.h"
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+namespace {
+
+std::string describe(const module& mod) {
+    std::string description = std::string{mod.get_name()} + "|" + std::string{mod.get_file_name()} + "\n";
+    for (const auto& decl: mod.get_decls()) {
+        if (std::holds_alternative<var_decl>(decl)) {
+            const auto& [loc, exported, var] = std::get<var_decl>(decl);
+            description += std::to_string(loc.line) + ":" + std::to_string(loc.col) + (exported ? " export" : "") +
+                           " var " + var->name + "\n";
+        } else {
+            const auto& [loc, exported, type, name, stmt, proof] = std::get<stmt_decl>(decl);
+            description += std::to_string(loc.line) + ":" + std::to_string(loc.col) + (exported ? " export " : " ") +
+                           std::to_string(static_cast<int>(type)) + " " + name + " " + print_utf8(*stmt) +
+                           (proof.has_value() ? " proof" : "") + "\n";
+        }
+    }
+    return description;
+}
+
+const char* const module_text = R"(
+var A
+export var B
+var x
+var p
+definition "Union" ∀x (x∈(A∪B) ⟷ (x∈A ∨ x∈B))
+theorem "Intersection" ∀x (x∈(A∩B) → x∈A)
+proof missing
+exercise "Mixed" (p∧¬p)→⊥ ∧ (⊤∨p) ∧ A⊆((A\B)⊖B)
+proof missing
+)";
+
+}  // namespace
+
+TEST_CASE("compiler.module_image") {
+    test("round trip keeps the declarations", [&] {
+        const auto mod = parse_module(module_text);
+        const auto image = write_module_image(mod);
+        expect(describe(read_module_image(image)), isEqualTo(describe(mod)));
+    });
+
+    test("round trip of an empty module", [&] {
+        const module mod("empty", "empty.tema");
+        const auto read = read_module_image(write_module_image(mod));
+        expect(read.get_name(), isEqualTo("empty"));
+        expect(read.get_file_name(), isEqualTo("empty.tema"));
+        expect(read.get_decls(), hasSize(0U));
+    });
+
+    test("statements share the variables of the module", [&] {
+        const auto read = read_module_image(write_module_image(parse_module(module_text)));
+        const auto& decls = read.get_decls();
+        const auto& a = std::get<var_decl>(decls[0]).var;
+        const auto& intersection_stmt = std::get<stmt_decl>(decls[5]).stmt;
+        const auto& bound = intersection_stmt->as_forall().var;
+        const auto& in_a = intersection_stmt->as_forall().inner->as_implies().to->as_rel();
+        expect(in_a.left->as_var() == bound, isTrue);
+        expect(in_a.right->as_var() == a, isTrue);
+    });
+
+    test("shared sub-statements are stored once", [&] {
+        module mod("shared", "shared.tema");
+        const auto p = var("p");
+        mod.add_variable_decl(var_decl{{1, 1}, false, p});
+        auto stmt = var_stmt(p);
+        for (int i = 0; i < 20; i++) {
+            stmt = conj(stmt, stmt);
+        }
+        mod.add_statement_decl(stmt_decl{{2, 1}, false, stmt_decl_type::definition, "Big", stmt, std::nullopt});
+        // Written as a tree the statement would have 2^20 leaves.
+        expect(write_module_image(mod).size(), isLessThan(std::size_t{2048}));
+        const auto read = read_module_image(write_module_image(mod));
+        const auto& read_stmt = std::get<stmt_decl>(read.get_decls()[1]).stmt;
+        expect(read_stmt->as_conj().inner[0] == read_stmt->as_conj().inner[1], isTrue);
+    });
+
+    test("structurally equal sub-statements are stored once", [&] {
+        const auto mod = parse_module(R"(
+var p
+var q
+theorem "T1" (p∧q)→(p∧q)
+proof missing
+theorem "T2" ¬(p∧q)
+proof missing
+)");
+        const auto read = read_module_image(write_module_image(mod));
+        const auto& t1 = std::get<stmt_decl>(read.get_decls()[2]).stmt;
+        const auto& t2 = std::get<stmt_decl>(read.get_decls()[3]).stmt;
+        expect(t1->as_implies().from == t1->as_implies().to, isTrue);
+        expect(t1->as_implies().from == t2->as_neg().inner, isTrue);
+    });
+
+    test("view reads declarations lazily", [&] {
+        const auto mod = parse_module(module_text);
+        const auto image = write_module_image(mod);
+        module_image_view view(image);
+        expect(view.name(), isEqualTo(mod.get_name()));
+        expect(view.num_decls(), isEqualTo(mod.get_decls().size()));
+        expect(view.is_var_decl(0), isTrue);
+        expect(view.is_var_decl(4), isFalse);
+        expect(view.decl_name(1), isEqualTo("B"));
+        expect(view.decl_name(5), isEqualTo("Intersection"));
+        expect(view.decl_location(5) == std::get<stmt_decl>(mod.get_decls()[5]).loc, isTrue);
+        // Names point into the image.
+        expect(view.decl_name(5).data() >= reinterpret_cast<const char*>(image.data()), isTrue);
+        expect(view.decl_name(5).data() < reinterpret_cast<const char*>(image.data() + image.size()), isTrue);
+
+        const auto stmt = view.get_statement(5);
+        expect(print_utf8(*stmt), isEqualTo(print_utf8(*std::get<stmt_decl>(mod.get_decls()[5]).stmt)));
+        expect(view.get_statement(5) == stmt, isTrue);
+        expect([&] { (void)view.get_statement(0); }, throwsA<std::invalid_argument>);
+        expect([&] { (void)view.get_statement(100); }, throwsA<std::out_of_range>);
+        // Declarations materialized later share the variables of the earlier ones.
+        const auto a = std::get<var_decl>(view.get_decl(0)).var;
+        expect(stmt->as_forall().inner->as_implies().to->as_rel().right->as_var() == a, isTrue);
+    });
+
+    test("invalid images are rejected", [&] {
+        const auto image = write_module_image(parse_module(module_text));
+        expect([&] { (void)read_module_image({}); }, throwsA<module_format_error>);
+        expect([&] { (void)read_module_image(std::span{image}.first(image.size() / 2)); },
+               throwsA<module_format_error>);
+
+        auto bad_magic = image;
+        bad_magic[0] = std::byte{'X'};
+        expect([&] { (void)read_module_image(bad_magic); }, throwsA<module_format_error>);
+
+        auto bad_version = image;
+        bad_version[4] = std::byte{99};
+        expect([&] { (void)read_module_image(bad_version); }, throwsA<module_format_error>);
+    });
+
+    test("corrupted images never crash", [&] {
+        const auto image = write_module_image(parse_module(module_text));
+        for (std::size_t i = 8; i < image.size(); i++) {
+            auto corrupted = image;
+            corrupted[i] ^= std::byte{0xA5};
+            try {
+                (void)read_module_image(corrupted);
+            } catch (const module_format_error&) {
+            }
+        }
+    });
+
+    test("embedded module code", [&] {
+        const module_embed_options options{"test_module", "generated/test_module.h"};
+        const auto header = generate_embedded_module_header(options);
+        expect(header.find("namespace tema::test_module {") != std::string::npos, isTrue);
+        expect(header.find("std::span<const std::byte> module_image();") != std::string::npos, isTrue);
+        const std::vector<std::byte> image{std::byte{1}, std::byte{255}, std::byte{0}};
+        const auto source = generate_embedded_module_source(image, options);
+        expect(source.find("#include \"generated/test_module.h\"") != std::string::npos, isTrue);
+        expect(source.find("image_data[3] = {\n    1, 255, 0,\n};") != std::string::npos, isTrue);
+        expect(source.find(".first(3)") != std::string::npos, isTrue);
+    });
+}
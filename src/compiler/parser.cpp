@@ -5,6 +5,7 @@
 
 #include <mcga/meta/tpack.hpp>
 
+#include "algorithms/canonical.h"
 #include "compiler/lexer.h"
 
 namespace tema {
@@ -403,10 +404,13 @@ std::optional<scope> parse_proof(flex_lexer_scanner& scanner, const module&) {
     scanner.throw_parse_error("Statement proofs are not currently supported. Use the 'proof missing' keyword.");
 }
 
-void parse_stmt_decl(flex_lexer_scanner& scanner, module& mod, stmt_decl_type stmt_type) {
+void parse_stmt_decl(flex_lexer_scanner& scanner, module& mod, stmt_decl_type stmt_type, const parse_options& options) {
     auto decl_loc = scanner.current_loc();
     auto stmt_name = parse_stmt_name(scanner);
     auto stmt = parse_stmt(scanner, mod.get_internal_scope(), true);
+    if (options.canonical) {
+        stmt = canonicalize(stmt);
+    }
     std::optional<scope> proof;
     if (stmt_type != stmt_decl_type::definition) {
         proof = parse_proof(scanner, mod);
@@ -422,7 +426,7 @@ void parse_stmt_decl(flex_lexer_scanner& scanner, module& mod, stmt_decl_type st
     });
 }
 
-bool parse_decl(flex_lexer_scanner& scanner, module& mod) {
+bool parse_decl(flex_lexer_scanner& scanner, module& mod, const parse_options& options) {
     auto tok = scanner.consume_token(true).first;
     if (tok == tok_eof) {
         return false;
@@ -437,13 +441,13 @@ bool parse_decl(flex_lexer_scanner& scanner, module& mod) {
     }
     switch (tok) {
         case tok_definition:
-            parse_stmt_decl(scanner, mod, stmt_decl_type::definition);
+            parse_stmt_decl(scanner, mod, stmt_decl_type::definition, options);
             break;
         case tok_theorem:
-            parse_stmt_decl(scanner, mod, stmt_decl_type::theorem);
+            parse_stmt_decl(scanner, mod, stmt_decl_type::theorem, options);
             break;
         case tok_exercise:
-            parse_stmt_decl(scanner, mod, stmt_decl_type::exercise);
+            parse_stmt_decl(scanner, mod, stmt_decl_type::exercise, options);
             break;
         default:
             scanner.throw_parse_error("Expected variable or statement declaration.");
@@ -453,20 +457,20 @@ bool parse_decl(flex_lexer_scanner& scanner, module& mod) {
 
 }  // namespace
 
-module parse_module(std::istream& stream, const std::filesystem::path& file_name) {
+module parse_module(std::istream& stream, const std::filesystem::path& file_name, const parse_options& options) {
     flex_lexer_scanner scanner(stream, file_name);
     module mod(file_name.stem(), file_name);
-    while (parse_decl(scanner, mod)) {
+    while (parse_decl(scanner, mod, options)) {
     }
     return mod;
 }
 
-module parse_module(std::string_view code) {
+module parse_module(std::string_view code, const parse_options& options) {
     std::stringstream string_stream;
     // TODO: This is quite inefficient, why do we need to copy the data / allocate? We should just
     //  be able to read from the string_view directly.
     string_stream.write(code.data(), static_cast<std::streamsize>(code.size()));
-    return parse_module(string_stream, "<anonymous module>");
+    return parse_module(string_stream, "<anonymous module>", options);
 }
 
 }  // namespace tema
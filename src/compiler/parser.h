@@ -13,7 +13,15 @@ struct parse_error : std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
-[[nodiscard]] module parse_module(std::istream& stream, const std::filesystem::path& file_name);
-[[nodiscard]] module parse_module(std::string_view code);
+struct parse_options {
+    // Build every conjunction and disjunction in canonical form (see canonicalize in algorithms/canonical.h), instead
+    // of as nested binary nodes in the order they are written.
+    bool canonical = false;
+};
+
+[[nodiscard]] module parse_module(std::istream& stream,
+                                  const std::filesystem::path& file_name,
+                                  const parse_options& options = {});
+[[nodiscard]] module parse_module(std::string_view code, const parse_options& options = {});
 
 }  // namespace tema
@@ -193,6 +193,23 @@ TEST_CASE("compiler parser") {
                                var_expr(b)));
     });
 
+    test("canonical conjunctions and disjunctions", [] {
+        const auto code = "var p\nvar q\nvar r\n"
+                          "theorem \"first\" (q∧p)∧(r∧q) proof missing\n"
+                          "theorem \"second\" r∧(p∧q) proof missing\n"
+                          "theorem \"third\" ¬(q∨p)→∀x (x∨p∨x) proof missing\n";
+        const auto written = parse_module(std::string_view{code});
+        const auto canonical = parse_module(std::string_view{code}, {.canonical = true});
+        const auto stmt = [](const tema::module& mod, std::size_t index) {
+            return get<stmt_decl>(mod.get_decls()[index]).stmt;
+        };
+        expect(equals(*stmt(written, 3), *stmt(written, 4)), isFalse);
+        expect(equals(*stmt(canonical, 3), *stmt(canonical, 4)), isTrue);
+        expect(stmt(canonical, 3)->as_conj().inner, hasSize(3));
+        // Bound variables come before free variables.
+        expect(print_utf8(*stmt(canonical, 5)), "¬(p∨q)→(∀x (x∨p))");
+    });
+
     test("invalid statements", [] {
         fail_to_parse_stmts({"p", "q", "e"},
                             {
@@ -0,0 +1,28 @@
+#include "compiler/temporary_directory.h"
+
+#include <unistd.h>
+
+#include <random>
+#include <string>
+
+namespace tema {
+
+temporary_directory::temporary_directory(std::string_view prefix) {
+    thread_local std::mt19937_64 generator{std::random_device{}()};
+    const auto parent = std::filesystem::temp_directory_path();
+    do {
+        dir = parent / (std::string{prefix} + "_" + std::to_string(getpid()) + "_" + std::to_string(generator()));
+        // create_directory returns false when the directory already exists.
+    } while (!std::filesystem::create_directory(dir));
+}
+
+temporary_directory::~temporary_directory() {
+    std::error_code error;
+    std::filesystem::remove_all(dir, error);
+}
+
+const std::filesystem::path& temporary_directory::path() const {
+    return dir;
+}
+
+}  // namespace tema
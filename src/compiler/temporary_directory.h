@@ -0,0 +1,25 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+namespace tema {
+
+// A new directory under the system's temporary directory, with a name no other process or object uses at the same
+// time, removed together with everything in it when the object is destroyed.
+class temporary_directory {
+    std::filesystem::path dir;
+
+public:
+    // The name of the directory starts with prefix. Throws std::filesystem::filesystem_error when it can't be created.
+    explicit temporary_directory(std::string_view prefix);
+
+    temporary_directory(const temporary_directory&) = delete;
+    temporary_directory& operator=(const temporary_directory&) = delete;
+
+    ~temporary_directory();
+
+    [[nodiscard]] const std::filesystem::path& path() const;
+};
+
+}  // namespace tema
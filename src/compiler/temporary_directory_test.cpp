@@ -0,0 +1,35 @@
+#include "compiler/temporary_directory.h"
+
+#include <fstream>
+
+#include <mcga/test_ext/matchers.hpp>
+
+using namespace tema;
+using namespace mcga::matchers;
+using namespace mcga::test;
+
+TEST_CASE("compiler.temporary_directory") {
+    test("is created empty", [&] {
+        const temporary_directory dir("tema_temporary_directory_test");
+        expect(std::filesystem::is_directory(dir.path()), isTrue);
+        expect(std::filesystem::is_empty(dir.path()), isTrue);
+        expect(dir.path().filename().string().starts_with("tema_temporary_directory_test_"), isTrue);
+    });
+
+    test("every directory is new", [&] {
+        const temporary_directory first("tema_temporary_directory_test");
+        const temporary_directory second("tema_temporary_directory_test");
+        expect(first.path() != second.path(), isTrue);
+    });
+
+    test("is removed with its contents", [&] {
+        std::filesystem::path path;
+        {
+            const temporary_directory dir("tema_temporary_directory_test");
+            path = dir.path();
+            std::filesystem::create_directories(path / "nested");
+            std::ofstream(path / "nested" / "file") << "contents";
+        }
+        expect(std::filesystem::exists(path), isFalse);
+    });
+}
@@ -19,7 +19,7 @@ auto expression::as_call() const -> const call& {
 bool expression::is_var() const noexcept {
     return holds_alternative<variable_ptr>(data);
 }
-variable_ptr expression::as_var() const {
+const variable_ptr& expression::as_var() const {
     return get<variable_ptr>(data);
 }
 
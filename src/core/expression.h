@@ -59,7 +59,7 @@ public:
     [[nodiscard]] const call& as_call() const;
 
     [[nodiscard]] bool is_var() const noexcept;
-    [[nodiscard]] variable_ptr as_var() const;
+    [[nodiscard]] const variable_ptr& as_var() const;
 
     template<class V>
     void accept(V&& visitor) const {
@@ -61,7 +61,7 @@ auto statement::as_forall() const -> const forall& {
 bool statement::is_var() const noexcept {
     return holds_alternative<var_stmt>(data);
 }
-variable_ptr statement::as_var() const {
+const variable_ptr& statement::as_var() const {
     return get<var_stmt>(data).var;
 }
 
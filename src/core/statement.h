@@ -97,7 +97,7 @@ public:
     [[nodiscard]] const forall& as_forall() const;
 
     [[nodiscard]] bool is_var() const noexcept;
-    [[nodiscard]] variable_ptr as_var() const;
+    [[nodiscard]] const variable_ptr& as_var() const;
 
     [[nodiscard]] bool is_rel() const noexcept;
     [[nodiscard]] const relationship& as_rel() const;
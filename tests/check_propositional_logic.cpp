@@ -0,0 +1,23 @@
+#include <fstream>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/propositional_checker.h"
+#include "compiler/parser.h"
+
+using namespace tema;
+using namespace mcga::test;
+using namespace mcga::matchers;
+
+TEST_CASE("check propositional logic module") {
+    const std::filesystem::path module_path{"./modules/propositional_logic.tema"};
+    std::ifstream file_stream(module_path);
+    const auto mod = parse_module(file_stream, module_path);
+
+    propositional_checker checker;
+    for (const auto& check: checker.check_module(mod)) {
+        test(check.name, [&] {
+            expectMsg(check.valid, "Theorem \"" + check.name + "\" is not a tautology");
+        });
+    }
+}
@@ -0,0 +1,49 @@
+#include <filesystem>
+#include <fstream>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/print_utf8.h"
+#include "compiler/compiled_module.h"
+#include "compiler/parser.h"
+#include "compiler/temporary_directory.h"
+
+using namespace tema;
+using namespace mcga::test;
+using namespace mcga::matchers;
+
+TEST_CASE("compile pre-built modules into one bundle") {
+    std::vector<module> modules;
+    for (const auto& entry: std::filesystem::directory_iterator("./modules")) {
+        if (entry.is_regular_file() && entry.path().extension() == ".tema") {
+            std::ifstream file_stream(entry.path());
+            modules.push_back(parse_module(file_stream, entry.path()));
+        }
+    }
+    std::vector<const module*> module_ptrs;
+    for (const auto& mod: modules) {
+        module_ptrs.push_back(&mod);
+    }
+    const temporary_directory bundle_dir("tema_compiled_modules");
+    const auto bundle_path = bundle_dir.path() / "modules.temac";
+    save_compiled_modules(bundle_path, module_ptrs);
+    const auto file = compiled_module_file::open(bundle_path);
+
+    for (const auto& mod: modules) {
+        test(std::string{mod.get_name()}, [&] {
+            const auto index = file.find(mod.get_name());
+            expect(index.has_value(), isTrue);
+            auto view = file.view(*index);
+            expect(view.num_decls(), isEqualTo(mod.get_decls().size()));
+            for (std::size_t i = 0; i < view.num_decls(); i++) {
+                const auto& decl = mod.get_decls()[i];
+                expect(view.is_var_decl(i), isEqualTo(std::holds_alternative<var_decl>(decl)));
+                if (std::holds_alternative<stmt_decl>(decl)) {
+                    expect(view.decl_name(i), isEqualTo(std::get<stmt_decl>(decl).name));
+                    expect(print_utf8(*view.get_statement(i)),
+                           isEqualTo(print_utf8(*std::get<stmt_decl>(decl).stmt)));
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,56 @@
+#include <fstream>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/print_utf8.h"
+#include "compiler/parser.h"
+#include "generated/propositional_logic_module.h"
+#include "generated/set_theory_module.h"
+
+using namespace tema;
+using namespace mcga::test;
+using namespace mcga::matchers;
+
+namespace {
+
+void expect_same_decls(const module& embedded, const module& parsed) {
+    expect(embedded.get_name(), isEqualTo(parsed.get_name()));
+    expect(embedded.get_decls(), hasSize(parsed.get_decls().size()));
+    for (std::size_t i = 0; i < parsed.get_decls().size(); i++) {
+        const auto& expected = parsed.get_decls()[i];
+        const auto& actual = embedded.get_decls()[i];
+        expect(actual.index(), isEqualTo(expected.index()));
+        if (std::holds_alternative<var_decl>(expected)) {
+            expect(std::get<var_decl>(actual).var->name, isEqualTo(std::get<var_decl>(expected).var->name));
+            expect(std::get<var_decl>(actual).exported, isEqualTo(std::get<var_decl>(expected).exported));
+        } else {
+            const auto& expected_stmt = std::get<stmt_decl>(expected);
+            const auto& actual_stmt = std::get<stmt_decl>(actual);
+            expect(actual_stmt.name, isEqualTo(expected_stmt.name));
+            expect(actual_stmt.type == expected_stmt.type, isTrue);
+            expect(actual_stmt.loc.line, isEqualTo(expected_stmt.loc.line));
+            expect(actual_stmt.loc.col, isEqualTo(expected_stmt.loc.col));
+            expect(actual_stmt.exported, isEqualTo(expected_stmt.exported));
+            expect(actual_stmt.proof_description.has_value(), isEqualTo(expected_stmt.proof_description.has_value()));
+            expect(print_utf8(*actual_stmt.stmt), isEqualTo(print_utf8(*expected_stmt.stmt)));
+        }
+    }
+}
+
+module parse_module_file(const std::filesystem::path& module_path) {
+    std::ifstream file_stream(module_path);
+    return parse_module(file_stream, module_path);
+}
+
+}  // namespace
+
+TEST_CASE("embedded modules") {
+    test("propositional logic", [&] {
+        expect_same_decls(propositional_logic_module::load(),
+                          parse_module_file("./modules/propositional_logic.tema"));
+    });
+
+    test("set theory", [&] {
+        expect_same_decls(set_theory_module::load(), parse_module_file("./modules/set_theory.tema"));
+    });
+}
@@ -0,0 +1,112 @@
+#include <fstream>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/deduce.h"
+#include "algorithms/print_utf8.h"
+#include "compiler/parser.h"
+#include "generated/propositional_logic_laws.h"
+
+using namespace tema;
+using namespace mcga::test;
+using namespace mcga::matchers;
+
+namespace {
+
+void add_sub_statements(const statement_ptr& stmt, std::vector<statement_ptr>& stmts) {  // NOLINT(misc-no-recursion)
+    stmts.push_back(stmt);
+    if (stmt->is_neg()) {
+        add_sub_statements(stmt->as_neg().inner, stmts);
+    } else if (stmt->is_implies()) {
+        add_sub_statements(stmt->as_implies().from, stmts);
+        add_sub_statements(stmt->as_implies().to, stmts);
+    } else if (stmt->is_equiv()) {
+        add_sub_statements(stmt->as_equiv().left, stmts);
+        add_sub_statements(stmt->as_equiv().right, stmts);
+    } else if (stmt->is_conj() || stmt->is_disj()) {
+        for (const auto& term: stmt->is_conj() ? stmt->as_conj().inner : stmt->as_disj().inner) {
+            add_sub_statements(term, stmts);
+        }
+    }
+}
+
+}  // namespace
+
+TEST_CASE("generated laws of the propositional logic module") {
+    const std::filesystem::path module_path{"./modules/propositional_logic.tema"};
+    std::ifstream file_stream(module_path);
+    const auto mod = parse_module(file_stream, module_path);
+
+    // The statements of the module and their parts, and a few combinations of them.
+    std::vector<statement_ptr> applications;
+    std::vector<statement_ptr> laws;
+    for (const auto& decl: mod.get_decls()) {
+        if (std::holds_alternative<stmt_decl>(decl)) {
+            const auto& stmt = std::get<stmt_decl>(decl).stmt;
+            add_sub_statements(stmt, applications);
+            if (stmt->is_implies() || stmt->is_equiv()) {
+                laws.push_back(stmt);
+            }
+        }
+    }
+    const auto num_parts = applications.size();
+    for (std::size_t i = 0; i < num_parts; i += 7) {
+        for (std::size_t j = 0; j < num_parts; j += 11) {
+            applications.push_back(conj(applications[i], implies(applications[i], applications[j])));
+            applications.push_back(disj(applications[i], neg(applications[j])));
+        }
+    }
+
+    test("every law is generated", [&] {
+        expect(propositional_logic::laws().size(), isEqualTo(laws.size()));
+    });
+
+    for (const auto& decl: mod.get_decls()) {
+        if (!std::holds_alternative<stmt_decl>(decl)) {
+            continue;
+        }
+        const auto& [loc, exported, type, name, stmt, proof] = std::get<stmt_decl>(decl);
+        if (!stmt->is_implies() && !stmt->is_equiv()) {
+            continue;
+        }
+        test(name, [&] {
+            const auto* law = find_generated_law(propositional_logic::laws(), name);
+            expect(law != nullptr, isTrue);
+            for (const auto& application: applications) {
+                const auto expected = mp_deduce(*stmt, application);
+                const auto actual = law->deduce(application);
+                expectMsg(actual.has_value() == expected.has_value(), print_utf8(*application));
+                if (actual.has_value() && expected.has_value()) {
+                    // The unbound variables of the conclusions are not the ones of the parsed module (see
+                    // algorithms/generated_law.h).
+                    expect(print_utf8(**actual), isEqualTo(print_utf8(**expected)));
+                }
+            }
+        });
+    }
+
+    test("unbound conclusion variables are the generated code's own", [&] {
+        // q is not bound by matching the premise of ¬p→(p→q).
+        const auto* law = find_generated_law(propositional_logic::laws(), "Negation of the premise");
+        expect(law != nullptr, isTrue);
+        const auto module_q = mod.get_internal_scope().get_var("q");
+        const auto a = var_stmt(var("a"));
+        const auto first = law->deduce(neg(a));
+        const auto second = law->deduce(neg(neg(a)));
+        expect(first.has_value() && second.has_value(), isTrue);
+        const auto& generated_q = (*first)->as_implies().to->as_var();
+        expect(generated_q->name, isEqualTo("q"));
+        expect(generated_q != module_q, isTrue);
+        // Shared by every result.
+        expect((*second)->as_implies().to->as_var() == generated_q, isTrue);
+        // mp_deduce uses the variable of the module instead.
+        for (const auto& decl: mod.get_decls()) {
+            if (std::holds_alternative<stmt_decl>(decl) && std::get<stmt_decl>(decl).name == "Negation of the premise") {
+                const auto expected = mp_deduce(*std::get<stmt_decl>(decl).stmt, neg(a));
+                expect(expected.has_value(), isTrue);
+                expect((*expected)->as_implies().to->as_var() == module_q, isTrue);
+                expect(print_utf8(**first), isEqualTo(print_utf8(**expected)));
+            }
+        }
+    });
+}
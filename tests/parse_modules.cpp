@@ -3,7 +3,9 @@
 
 #include <mcga/test_ext/matchers.hpp>
 
+#include "compiler/module_cache.h"
 #include "compiler/parser.h"
+#include "compiler/temporary_directory.h"
 
 using namespace tema;
 using namespace mcga::test;
@@ -26,4 +28,36 @@ TEST_CASE("compile & load pre-built modules") {
             }
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("load pre-built modules through the compile cache") {
+    const temporary_directory temporary_dir("tema_parse_modules_cache");
+    const auto cache_dir = temporary_dir.path();
+
+    std::vector<std::filesystem::path> module_paths;
+    for (const auto& entry: std::filesystem::directory_iterator("./modules")) {
+        if (entry.is_regular_file() && entry.path().extension() == ".tema") {
+            module_paths.push_back(entry.path());
+        }
+    }
+
+    test("cold run parses every module", [&] {
+        tema::module_cache cache(cache_dir);
+        for (const auto& module_path: module_paths) {
+            (void)cache.load(module_path);
+        }
+        expect(cache.num_misses(), isEqualTo(module_paths.size()));
+    });
+
+    test("warm run parses no module", [&] {
+        tema::module_cache cache(cache_dir);
+        for (const auto& module_path: module_paths) {
+            std::ifstream file_stream(module_path);
+            const auto parsed = tema::parse_module(file_stream, module_path);
+            const auto cached = cache.load(module_path);
+            expect(cached.get_decls(), hasSize(parsed.get_decls().size()));
+        }
+        expect(cache.num_hits(), isEqualTo(module_paths.size()));
+        expect(cache.num_misses(), isEqualTo(0U));
+    });
+}
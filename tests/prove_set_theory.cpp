@@ -0,0 +1,63 @@
+#include <fstream>
+
+#include <mcga/test_ext/matchers.hpp>
+
+#include "algorithms/resolution.h"
+#include "compiler/parser.h"
+
+using namespace tema;
+using namespace mcga::test;
+using namespace mcga::matchers;
+
+namespace {
+
+std::vector<stmt_decl> statement_decls(const module& mod) {
+    std::vector<stmt_decl> decls;
+    for (const auto& decl: mod.get_decls()) {
+        if (std::holds_alternative<stmt_decl>(decl)) {
+            decls.push_back(std::get<stmt_decl>(decl));
+        }
+    }
+    return decls;
+}
+
+}  // namespace
+
+TEST_CASE("prove set theory by resolution") {
+    const std::filesystem::path module_path{"./modules/set_theory.tema"};
+    std::ifstream file_stream(module_path);
+    const auto mod = parse_module(file_stream, module_path);
+    std::vector<statement_ptr> definitions;
+    for (const auto& decl: statement_decls(mod)) {
+        definitions.push_back(decl.stmt);
+    }
+
+    const auto theorems = parse_module(R"(
+var A
+var B
+var C
+theorem "intersection is included" A∩B⊆A proof missing
+theorem "union includes" A⊆A∪B proof missing
+theorem "difference is included" A\B⊆A proof missing
+theorem "commutativity of intersection inclusion" A∩B⊆B∩A proof missing
+theorem "transitivity of inclusion" (A⊆B ∧ B⊆C) → A⊆C proof missing
+)");
+    for (const auto& decl: statement_decls(theorems)) {
+        test(decl.name, [&] {
+            const auto result = prove_by_resolution(definitions, decl.stmt);
+            expectMsg(result.status == resolution_status::proved, "Theorem \"" + decl.name + "\" was not proved");
+        });
+    }
+
+    test("non-theorem", [&] {
+        const auto non_theorems = parse_module(R"(
+var A
+var B
+theorem "included in intersection" A⊆A∩B proof missing
+)");
+        resolution_options options;
+        options.max_clauses = 5'000;
+        const auto result = prove_by_resolution(definitions, statement_decls(non_theorems)[0].stmt, options);
+        expect(result.status == resolution_status::proved, isFalse);
+    });
+}